@@ -0,0 +1,157 @@
+#ifndef _H_SIMPLE_AI_BENCHMARKS_BENCH_UTILS_H_
+#define _H_SIMPLE_AI_BENCHMARKS_BENCH_UTILS_H_
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/allocator_manager.h"
+#include "ir/model.h"
+#include "kernels/kernel_manager.h"
+
+namespace simple_ai {
+namespace benchmarks {
+
+using AttributeMap = std::unordered_map<std::string, std::unique_ptr<ir::NodeAttribute>>;
+using TensorMap = std::unordered_map<std::string, std::unique_ptr<ir::Tensor>>;
+
+inline IAllocator* cpu_allocator() { return AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU); }
+
+inline ir::TensorShape make_shape(const std::vector<int64_t>& dims) {
+    ir::TensorShape shape;
+    shape.set_dims(dims);
+    return shape;
+}
+
+inline std::unique_ptr<ir::Tensor> make_tensor(const std::string& name, const std::vector<int64_t>& dims,
+                                               float seed) {
+    auto tensor = std::make_unique<ir::Tensor>(name);
+    tensor->init(PrimitiveDataType::FLOAT32, make_shape(dims), cpu_allocator());
+    float* data = tensor->data_as<float>();
+    for (int64_t i = 0; i < tensor->shape().element_num(); ++i) {
+        data[i] = std::sin(seed + 0.37f * i);
+    }
+    return tensor;
+}
+
+/**
+ * @brief A helper to build the graph by hand
+ */
+class GraphBuilder {
+public:
+    GraphBuilder() {
+        m_model = std::make_shared<ir::Model>();
+        m_model->set_graph(std::make_unique<ir::Graph>(*m_model));
+    }
+
+    ir::Graph* graph() { return m_model->get_graph(); }
+
+    void add_input(const std::string& name, const std::vector<int64_t>& dims) {
+        graph()->get_or_create_nodearg(name, ir::NodeArg(name, PrimitiveDataType::FLOAT32, make_shape(dims)));
+        graph()->add_input_name(name);
+    }
+
+    void add_output(const std::string& name) { graph()->add_output_name(name); }
+
+    void add_initializer(const std::string& name, const std::vector<int64_t>& dims, float seed) {
+        auto tensor = make_tensor(name, dims, seed);
+        graph()->get_or_create_nodearg(name, ir::NodeArg(name, PrimitiveDataType::FLOAT32, tensor->shape()));
+        graph()->add_initializer(std::move(tensor));
+    }
+
+    void add_node(const std::string& type, const std::vector<std::string>& inputs,
+                  const std::vector<std::string>& outputs, AttributeMap&& attributes = AttributeMap()) {
+        auto create_args = [this](const std::vector<std::string>& names) {
+            std::vector<ir::NodeArg*> args;
+            for (auto& name : names) {
+                ir::NodeArg* arg = graph()->get_nodearg(name);
+                args.emplace_back(arg ? arg : graph()->get_or_create_nodearg(name, ir::NodeArg(name)));
+            }
+            return args;
+        };
+
+        auto node = std::make_unique<ir::Node>(m_node_id++, *graph());
+        node->init(type + std::to_string(m_node_id), type, "", "", create_args(inputs), create_args(outputs),
+                   std::move(attributes));
+        graph()->add_node(std::move(node));
+    }
+
+    Status build() {
+        auto ret = graph()->initialize();
+        if (!ret.is_ok()) {
+            return ret;
+        }
+        return graph()->construct_topology();
+    }
+
+private:
+    std::shared_ptr<ir::Model> m_model;
+    int m_node_id{0};
+};
+
+/**
+ * @brief run the graph with the cpu kernels. the intermediate tensors are allocated once and reused by the
+ * following runs
+ */
+inline Status run_graph(ir::Graph& graph, TensorMap& values) {
+    for (ir::Node* node : graph.get_topological_nodes()) {
+        std::vector<const ir::Tensor*> inputs;
+        for (auto* arg : node->input_args()) {
+            if (arg->name().empty()) {
+                inputs.emplace_back(nullptr);
+            } else if (values.count(arg->name())) {
+                inputs.emplace_back(values[arg->name()].get());
+            } else {
+                inputs.emplace_back(graph.get_initializer(arg->name()));
+            }
+        }
+
+        std::vector<ir::Tensor*> outputs;
+        for (auto* arg : node->output_args()) {
+            auto& tensor = values[arg->name()];
+            if (!tensor) {
+                tensor = std::make_unique<ir::Tensor>(arg->name());
+                tensor->init(PrimitiveDataType::FLOAT32, arg->shape(), cpu_allocator());
+            }
+            outputs.emplace_back(tensor.get());
+        }
+
+        kernels::IKernel* kernel = kernels::KernelManager::instance()->get_kernel(node->type());
+        if (!kernel) {
+            return Status(StatusCode::NOT_IMPLEMENTED, "no kernel for " + node->type());
+        }
+
+        auto ret = kernel->compute(node->name(), node->params(), inputs, outputs);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief run the function `iterations` times after a warm up run
+ *
+ * @return double the average milliseconds per run
+ */
+inline double time_ms(const std::function<void()>& func, int iterations) {
+    func();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+}    // namespace benchmarks
+}    // namespace simple_ai
+
+#endif
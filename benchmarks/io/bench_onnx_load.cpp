@@ -0,0 +1,171 @@
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "io/onnx_serializer.h"
+#include "ir/node_shape_manager.h"
+#include "onnx.proto3.pb.h"
+
+using namespace simple_ai;
+
+namespace {
+
+// the number of heap allocations, counted by the replaced operator new
+std::atomic<size_t> g_allocations{0};
+
+}    // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+size_t heap_bytes() { return mallinfo2().uordblks; }
+
+double rss_mb() {
+    long pages = 0;
+    long resident = 0;
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+    }
+    return resident * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+double peak_rss_mb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+void set_value_info(onnx::ValueInfoProto* value_info, const std::string& name) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+    tensor_type->mutable_shape()->add_dim()->set_dim_value(1);
+    tensor_type->mutable_shape()->add_dim()->set_dim_value(4);
+}
+
+/**
+ * @brief A serialized onnx model of `layers` Add nodes, each adding a small bias to the previous output. the tensor
+ * names are as long as the exported transformer ones, every intermediate has a value info
+ */
+std::string build_model(int layers) {
+    onnx::ModelProto model;
+    model.set_ir_version(7);
+    model.add_opset_import()->set_version(13);
+
+    auto* graph = model.mutable_graph();
+    set_value_info(graph->add_input(), "input_ids");
+
+    const float bias[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+    std::string input = "input_ids";
+    for (int i = 0; i < layers; ++i) {
+        const std::string prefix = "/model/decoder/layers." + std::to_string(i) + "/mlp/";
+        const std::string bias_name = "model.decoder.layers." + std::to_string(i) + ".mlp.bias";
+        const std::string output = i == layers - 1 ? "logits" : prefix + "Add_output_0";
+
+        auto* initializer = graph->add_initializer();
+        initializer->set_name(bias_name);
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        initializer->add_dims(4);
+        initializer->set_raw_data(bias, sizeof(bias));
+
+        auto* node = graph->add_node();
+        node->set_name(prefix + "Add");
+        node->set_op_type("Add");
+        node->add_input(input);
+        node->add_input(bias_name);
+        node->add_output(output);
+
+        if (i != layers - 1) {
+            set_value_info(graph->add_value_info(), output);
+        }
+        input = output;
+    }
+    set_value_info(graph->add_output(), "logits");
+
+    return model.SerializeAsString();
+}
+
+/**
+ * @brief load the model in a child process, so that the peak RSS is its own. the model is built before the fork, the
+ * child only holds its serialized data
+ */
+void run_case(int layers) {
+    std::string data = build_model(layers);
+    malloc_trim(0);
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) {
+        int wstatus = 0;
+        waitpid(pid, &wstatus, 0);
+        return;
+    }
+
+    const double rss_before = rss_mb();
+    const size_t heap_before = heap_bytes();
+    const size_t allocations_before = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+
+    std::shared_ptr<ir::Model> model;
+    auto status = io::OnnxSerializer::load_from_memory(data.data(), data.size(), model);
+    auto loaded = std::chrono::steady_clock::now();
+    const size_t load_allocations = g_allocations.load() - allocations_before;
+    const double peak_load = peak_rss_mb();
+    if (status.is_ok()) {
+        status = model->get_graph()->construct_topology();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    if (!status.is_ok()) {
+        std::printf("load model failed: %s\n", status.to_string().c_str());
+        _exit(1);
+    }
+    const size_t topology_allocations = g_allocations.load() - allocations_before - load_allocations;
+
+    // the heap kept by the loaded model, including the initializer data
+    const size_t heap_after = heap_bytes();
+    std::printf("layers %7d | tensors %7d | load %9.2f ms | topology and shapes %8.2f ms | model heap %8.2f MB | "
+                "%6.0f bytes/tensor | peak RSS during load %8.2f MB | allocations %8zu + %8zu\n",
+                layers, 2 * layers + 1, std::chrono::duration<double, std::milli>(loaded - start).count(),
+                std::chrono::duration<double, std::milli>(end - loaded).count(),
+                (heap_after - heap_before) / (1024.0 * 1024.0),
+                static_cast<double>(heap_after - heap_before) / (2 * layers + 1), peak_load - rss_before,
+                load_allocations, topology_allocations);
+    std::fflush(stdout);
+    _exit(0);
+}
+
+}    // namespace
+
+int main() {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    std::printf("Onnx model loading with tens of thousands of tensors\n");
+    run_case(5000);
+    run_case(20000);
+    run_case(50000);
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "io/onnx_serializer.h"
+#include "ir/node_shape_manager.h"
+#include "onnx.proto3.pb.h"
+
+using namespace simple_ai;
+
+namespace {
+
+// 50 initializers of 10 MB
+constexpr int kLayers = 50;
+constexpr int64_t kWeightSize = 10 * 1024 * 1024 / sizeof(float);
+
+std::string weight_name(int layer) { return "model.layers." + std::to_string(layer) + ".bias"; }
+
+/**
+ * @brief write a model of `kLayers` Add nodes, each adding a 10 MB bias. the initializers are appended one by one as
+ * separate serialized models, which protobuf merges into the graph, so the writer never holds the whole model
+ */
+void write_model(const std::string& file_path) {
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    onnx::ModelProto model;
+    model.set_ir_version(7);
+    model.add_opset_import()->set_version(13);
+    auto* graph = model.mutable_graph();
+    std::string input = "X";
+    for (auto* value_info : {graph->add_input(), graph->add_output()}) {
+        value_info->set_name(value_info == &graph->input(0) ? "X" : "Y");
+        auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+        tensor_type->mutable_shape()->add_dim()->set_dim_value(kWeightSize);
+    }
+    for (int i = 0; i < kLayers; ++i) {
+        auto* node = graph->add_node();
+        node->set_op_type("Add");
+        node->add_input(input);
+        node->add_input(weight_name(i));
+        input = i == kLayers - 1 ? "Y" : "add_" + std::to_string(i);
+        node->add_output(input);
+    }
+    ofs << model.SerializeAsString();
+
+    std::vector<float> weight(kWeightSize);
+    for (int i = 0; i < kLayers; ++i) {
+        for (int64_t j = 0; j < kWeightSize; ++j) {
+            weight[j] = static_cast<float>((i + j) % 97);
+        }
+
+        onnx::ModelProto part;
+        auto* initializer = part.mutable_graph()->add_initializer();
+        initializer->set_name(weight_name(i));
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        initializer->add_dims(kWeightSize);
+        initializer->set_raw_data(weight.data(), weight.size() * sizeof(float));
+        ofs << part.SerializeAsString();
+    }
+}
+
+double rss_mb() {
+    long pages = 0;
+    long resident = 0;
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+    }
+    return resident * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+double peak_rss_mb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+// how the model is loaded
+enum class LoadMode { STREAM, MMAP, MEMORY_COPY, MEMORY_BORROWED };
+
+const char* mode_name(LoadMode mode) {
+    switch (mode) {
+        case LoadMode::STREAM:
+            return "stream";
+        case LoadMode::MMAP:
+            return "mmap";
+        case LoadMode::MEMORY_COPY:
+            return "memory, copy";
+        default:
+            return "memory, borrowed";
+    }
+}
+
+/**
+ * @brief load the model in a child process, so that the peak RSS is its own. in the memory modes, the file is read
+ * into a buffer of the child first, as an embedded or received model would be
+ */
+void run_case(const std::string& file_path, LoadMode mode) {
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) {
+        int wstatus = 0;
+        waitpid(pid, &wstatus, 0);
+        return;
+    }
+
+    char* buffer = nullptr;
+    size_t buffer_size = 0;
+    if (mode == LoadMode::MEMORY_COPY || mode == LoadMode::MEMORY_BORROWED) {
+        std::ifstream ifs(file_path, std::ios::in | std::ios::binary | std::ios::ate);
+        buffer_size = static_cast<size_t>(ifs.tellg());
+        buffer = static_cast<char*>(std::aligned_alloc(64, (buffer_size + 63) / 64 * 64));
+        ifs.seekg(0);
+        ifs.read(buffer, static_cast<std::streamsize>(buffer_size));
+    }
+
+    const double rss_before = rss_mb();
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<ir::Model> model;
+    Status status;
+    if (buffer) {
+        status = io::OnnxSerializer::load_from_memory(buffer, buffer_size, model, mode == LoadMode::MEMORY_BORROWED);
+    } else {
+        status = io::OnnxSerializer::load_from_file(file_path, model, mode == LoadMode::MMAP);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (!status.is_ok()) {
+        std::printf("load model failed: %s\n", status.to_string().c_str());
+        _exit(1);
+    }
+    const double peak_load = peak_rss_mb();
+    const double rss_loaded = rss_mb();
+
+    // read all the weights, the mapped pages become resident
+    int in_place = 0;
+    double sum = 0.0;
+    for (int i = 0; i < kLayers; ++i) {
+        ir::Tensor* tensor = model->get_graph()->get_initializer(weight_name(i));
+        in_place += tensor->owns_buffer() ? 0 : 1;
+        const float* data = tensor->data_as<float>();
+        for (int64_t j = 0; j < kWeightSize; j += 1024) {
+            sum += data[j];
+        }
+    }
+
+    std::printf("%-16s | load %8.2f ms | peak RSS during load %8.2f MB | RSS after load %8.2f MB | "
+                "RSS after reading the weights %8.2f MB | in place %2d/%d (checksum %.0f)\n",
+                mode_name(mode), std::chrono::duration<double, std::milli>(end - start).count(),
+                peak_load - rss_before, rss_loaded - rss_before, rss_mb() - rss_before, in_place, kLayers, sum);
+    std::fflush(stdout);
+    _exit(0);
+}
+
+}    // namespace
+
+int main() {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    const std::string file_path = "/tmp/simple_ai_bench_mmap_load.onnx";
+    write_model(file_path);
+
+    std::printf("Loading a 500 MB onnx model with %d initializers of 10 MB, the file is in the page cache\n", kLayers);
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        for (LoadMode mode : {LoadMode::STREAM, LoadMode::MMAP, LoadMode::MEMORY_COPY, LoadMode::MEMORY_BORROWED}) {
+            run_case(file_path, mode);
+        }
+    }
+
+    std::remove(file_path.c_str());
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "io/onnx_serializer.h"
+#include "ir/node_shape_manager.h"
+#include "onnx.proto3.pb.h"
+#include "utils/thread_pool/simple_thread_pool.h"
+
+using namespace simple_ai;
+using simple_ai::utils::thread_pool::SimpleThreadPool;
+
+namespace {
+
+// 64 initializers of 4 MB
+constexpr int kLayers = 64;
+constexpr int64_t kWeightSize = 4 * 1024 * 1024 / sizeof(float);
+
+std::string weight_name(int layer) { return "model.layers." + std::to_string(layer) + ".bias"; }
+
+/**
+ * @brief write a model of `kLayers` Add nodes, each adding a 4 MB bias. the initializers are stored as float data,
+ * which is decoded element by element, or as raw data
+ */
+void write_model(const std::string& file_path, bool float_data) {
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    onnx::ModelProto model;
+    model.set_ir_version(7);
+    model.add_opset_import()->set_version(13);
+    auto* graph = model.mutable_graph();
+    std::string input = "X";
+    for (auto* value_info : {graph->add_input(), graph->add_output()}) {
+        value_info->set_name(value_info == &graph->input(0) ? "X" : "Y");
+        auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+        tensor_type->mutable_shape()->add_dim()->set_dim_value(kWeightSize);
+    }
+    for (int i = 0; i < kLayers; ++i) {
+        auto* node = graph->add_node();
+        node->set_op_type("Add");
+        node->add_input(input);
+        node->add_input(weight_name(i));
+        input = i == kLayers - 1 ? "Y" : "add_" + std::to_string(i);
+        node->add_output(input);
+    }
+    ofs << model.SerializeAsString();
+
+    std::vector<float> weight(kWeightSize);
+    for (int i = 0; i < kLayers; ++i) {
+        for (int64_t j = 0; j < kWeightSize; ++j) {
+            weight[j] = static_cast<float>((i + j) % 97);
+        }
+
+        onnx::ModelProto part;
+        auto* initializer = part.mutable_graph()->add_initializer();
+        initializer->set_name(weight_name(i));
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        initializer->add_dims(kWeightSize);
+        if (float_data) {
+            initializer->mutable_float_data()->Add(weight.begin(), weight.end());
+        } else {
+            initializer->set_raw_data(weight.data(), weight.size() * sizeof(float));
+        }
+        ofs << part.SerializeAsString();
+    }
+}
+
+/**
+ * @brief the best load time of a few runs, the initializers are decoded on `num_threads` threads
+ */
+double load_ms(const std::string& file_path, bool use_mmap, int num_threads) {
+    std::unique_ptr<SimpleThreadPool> thread_pool;
+    if (num_threads > 1) {
+        thread_pool = std::make_unique<SimpleThreadPool>(num_threads - 1);
+    }
+
+    double best = 0.0;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        std::shared_ptr<ir::Model> model;
+        auto start = std::chrono::steady_clock::now();
+        auto status = io::OnnxSerializer::load_from_file(file_path, model, use_mmap, true, thread_pool.get());
+        auto end = std::chrono::steady_clock::now();
+        if (!status.is_ok()) {
+            std::printf("load model failed: %s\n", status.to_string().c_str());
+            return 0.0;
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        best = repeat == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+}    // namespace
+
+int main() {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    const std::string file_path = "/tmp/simple_ai_bench_parallel_load.onnx";
+    std::printf("Loading a 256 MB onnx model with %d initializers of 4 MB, %u hardware threads\n", kLayers,
+                std::thread::hardware_concurrency());
+    struct Case {
+        const char* label;
+        bool float_data;
+        bool use_mmap;
+    };
+    for (const Case& c : {Case{"float data, mmap", true, true}, Case{"raw data, stream", false, false}}) {
+        write_model(file_path, c.float_data);
+        double serial = 0.0;
+        for (int num_threads : {1, 2, 4, 8, 16}) {
+            double elapsed = load_ms(file_path, c.use_mmap, num_threads);
+            serial = num_threads == 1 ? elapsed : serial;
+            std::printf("%-16s | threads %2d | load %8.2f ms | speedup %5.2fx\n", c.label, num_threads, elapsed,
+                        elapsed > 0.0 ? serial / elapsed : 0.0);
+        }
+    }
+
+    std::remove(file_path.c_str());
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "bench_utils.h"
+#include "ir/graph_transaction.h"
+#include "ir/node_shape_manager.h"
+#include "optimizer/dead_node_elimination.h"
+
+using namespace simple_ai;
+using namespace simple_ai::benchmarks;
+
+namespace {
+
+/**
+ * @brief A deep unrolled graph of `nodes` nodes: every Add reads the two previous outputs, the nodes are added in
+ * reverse order so that the graph order is not already topological
+ */
+void build_unrolled_graph(GraphBuilder& builder, int nodes) {
+    builder.add_input("X", {1, 4});
+    builder.add_output("v" + std::to_string(nodes - 1));
+
+    for (int i = nodes - 1; i >= 0; --i) {
+        std::string first = i >= 1 ? "v" + std::to_string(i - 1) : "X";
+        std::string second = i >= 2 ? "v" + std::to_string(i - 2) : "X";
+        builder.add_node("Add", {first, second}, {"v" + std::to_string(i)});
+    }
+}
+
+size_t heap_bytes() { return mallinfo2().uordblks; }
+
+/**
+ * @brief A local rewrite: insert a Relu after the producer of `v<index>`, and move its consumers to the Relu output.
+ * the Relu is appended to the graph, so the incremental commit has to sort it before its consumers
+ *
+ * @return double the milliseconds to rewrite and restore a consistent topology
+ */
+double insert_relu(ir::Graph& graph, int index, int node_id, bool incremental) {
+    auto start = std::chrono::steady_clock::now();
+
+    ir::NodeArg* input = graph.get_nodearg("v" + std::to_string(index));
+    const std::string output_name = "r" + std::to_string(index);
+    ir::NodeArg* output = graph.get_or_create_nodearg(output_name, ir::NodeArg(output_name));
+    std::vector<ir::Node*> consumers;
+    const ir::GraphView& view = graph.get_view();
+    for (int consumer : view.consumers(input->id())) {
+        consumers.emplace_back(view.node(consumer));
+    }
+
+    auto relu = std::make_unique<ir::Node>(node_id, graph);
+    relu->init(output_name, "Relu", "", "", {input}, {output}, {});
+
+    Status status;
+    if (incremental) {
+        ir::GraphTransaction transaction(graph);
+        transaction.add_node(std::move(relu));
+        for (ir::Node* consumer : consumers) {
+            for (size_t i = 0; i < consumer->input_args().size(); ++i) {
+                if (consumer->input_args()[i] == input) {
+                    transaction.replace_input_arg(consumer, i, output);
+                }
+            }
+        }
+        status = transaction.commit();
+    } else {
+        graph.add_node(std::move(relu));
+        for (ir::Node* consumer : consumers) {
+            for (size_t i = 0; i < consumer->input_args().size(); ++i) {
+                if (consumer->input_args()[i] == input) {
+                    consumer->replace_input_arg(i, output);
+                }
+            }
+        }
+        status = graph.construct_topology();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    if (!status.is_ok()) {
+        std::printf("rewrite failed: %s\n", status.to_string().c_str());
+    }
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void run_case(int nodes, int iterations, int rewrites) {
+    const size_t heap_before = heap_bytes();
+    GraphBuilder builder;
+    build_unrolled_graph(builder, nodes);
+
+    auto start = std::chrono::steady_clock::now();
+    auto status = builder.build();
+    auto end = std::chrono::steady_clock::now();
+    if (!status.is_ok()) {
+        std::printf("build graph failed: %s\n", status.to_string().c_str());
+        return;
+    }
+    double first = std::chrono::duration<double, std::milli>(end - start).count();
+    const size_t graph_bytes = heap_bytes() - heap_before;
+
+    // the graph passes construct the topology again after every rewrite
+    ir::Graph* graph = builder.graph();
+    double rebuild = time_ms([graph]() { graph->construct_topology(); }, iterations);
+
+    // a traversal only pass, nothing is dead
+    double dce = time_ms(
+        [graph]() {
+            bool modified = false;
+            optimizer::DeadNodeEliminationPass().apply(*graph, modified);
+        },
+        iterations);
+
+    // local rewrites, each one followed by an incremental commit or a full reconstruction
+    int node_id = ir::GraphTransaction(*graph).next_node_id();
+    double incremental = 0.0;
+    double full = 0.0;
+    for (int i = 0; i < rewrites; ++i) {
+        const int index = (2 * i + 1) * (nodes / (2 * rewrites + 2));
+        incremental += insert_relu(*graph, index, node_id++, true);
+        full += insert_relu(*graph, index + 1, node_id++, false);
+    }
+
+    std::printf("nodes %8d | first construction %9.2f ms | reconstruction %9.2f ms (%6.1f ns/node) | "
+                "dce %8.2f ms | graph heap %7.1f MB\n",
+                nodes, first, rebuild, rebuild * 1e6 / nodes, dce, graph_bytes / (1024.0 * 1024.0));
+    std::printf("                 %3d local rewrites | incremental commit %9.2f ms/rewrite | "
+                "full reconstruction %9.2f ms/rewrite\n",
+                rewrites, incremental / rewrites, full / rewrites);
+}
+
+}    // namespace
+
+int main() {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    std::printf("Graph topology construction on unrolled graphs\n");
+    run_case(10000, 5, 32);
+    run_case(100000, 3, 32);
+    run_case(1000000, 1, 8);
+
+    return 0;
+}
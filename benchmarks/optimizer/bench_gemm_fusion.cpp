@@ -0,0 +1,92 @@
+#include <cstdio>
+
+#include "bench_utils.h"
+#include "ir/node_shape_manager.h"
+#include "optimizer/gemm_epilogue_fusion.h"
+
+using namespace simple_ai;
+using namespace simple_ai::benchmarks;
+
+namespace {
+
+/**
+ * @brief A MLP with `layers` hidden layers: Gemm -> Add(bias) -> Relu, and a residual Add every two layers
+ */
+void build_mlp(GraphBuilder& builder, int64_t batch, int64_t hidden, int layers) {
+    builder.add_input("X", {batch, hidden});
+    builder.add_output("Y");
+
+    std::string input = "X";
+    std::string shortcut = "X";
+    for (int i = 0; i < layers; ++i) {
+        std::string id = std::to_string(i);
+        builder.add_initializer("W" + id, {hidden, hidden}, 0.1f * i);
+        builder.add_initializer("B" + id, {hidden}, 0.2f * i);
+
+        builder.add_node("Gemm", {input, "W" + id}, {"gemm" + id});
+        builder.add_node("Add", {"gemm" + id, "B" + id}, {"bias" + id});
+
+        std::string pre_act = "bias" + id;
+        if (i % 2 == 1) {
+            builder.add_node("Add", {pre_act, shortcut}, {"res" + id});
+            pre_act = "res" + id;
+        }
+
+        std::string output = (i == layers - 1) ? "Y" : "relu" + id;
+        builder.add_node("Relu", {pre_act}, {output});
+        if (i % 2 == 1) {
+            shortcut = output;
+        }
+        input = output;
+    }
+}
+
+void run_case(int64_t batch, int64_t hidden, int layers, int iterations) {
+    GraphBuilder unfused;
+    build_mlp(unfused, batch, hidden, layers);
+    auto status = unfused.build();
+    if (!status.is_ok()) {
+        std::printf("build graph failed: %s\n", status.to_string().c_str());
+        return;
+    }
+
+    GraphBuilder fused;
+    build_mlp(fused, batch, hidden, layers);
+    status = fused.build();
+    bool modified = false;
+    if (status.is_ok()) {
+        status = optimizer::GemmEpilogueFusionPass().apply(*fused.graph(), modified);
+    }
+    if (!status.is_ok()) {
+        std::printf("fuse graph failed: %s\n", status.to_string().c_str());
+        return;
+    }
+
+    TensorMap unfused_values;
+    unfused_values["X"] = make_tensor("X", {batch, hidden}, 0.5f);
+    TensorMap fused_values;
+    fused_values["X"] = make_tensor("X", {batch, hidden}, 0.5f);
+
+    double before = time_ms([&]() { run_graph(*unfused.graph(), unfused_values); }, iterations);
+    double after = time_ms([&]() { run_graph(*fused.graph(), fused_values); }, iterations);
+
+    std::printf("batch %4ld hidden %4ld layers %2d | nodes %3zu -> %3zu | before %9.3f ms after %9.3f ms | %.2fx\n",
+                static_cast<long>(batch), static_cast<long>(hidden), layers,
+                unfused.graph()->get_topological_nodes().size(), fused.graph()->get_topological_nodes().size(),
+                before, after, before / after);
+}
+
+}    // namespace
+
+int main() {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    kernels::KernelManager::instance()->register_all_kernels();
+
+    std::printf("Gemm epilogue fusion on MLP-shaped graphs\n");
+    run_case(1, 512, 8, 50);
+    run_case(16, 512, 8, 10);
+    run_case(64, 256, 8, 10);
+    run_case(64, 64, 32, 20);
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <cstdio>
+
+#include "bench_utils.h"
+#include "ir/node_shape_manager.h"
+#include "ir/op_defines.h"
+#include "optimizer/conv_epilogue_fusion.h"
+#include "optimizer/layout_transformation.h"
+
+using namespace simple_ai;
+using namespace simple_ai::benchmarks;
+
+namespace {
+
+AttributeMap conv_attributes() {
+    AttributeMap attributes;
+    auto pads = std::make_unique<ir::NodeAttribute>("pads", ir::NodeAttributeType::INT64_ARRAY);
+    for (int i = 0; i < 4; ++i) {
+        pads->add_int64(1);
+    }
+    attributes.emplace("pads", std::move(pads));
+    return attributes;
+}
+
+/**
+ * @brief A CNN of `blocks` ResNet basic blocks: Conv -> Add(bias) -> Relu -> Conv -> Add(bias) -> Add(shortcut)
+ * -> Relu, all convolutions are 3x3 with `channels` input and output channels
+ */
+void build_cnn(GraphBuilder& builder, int64_t channels, int64_t size, int blocks) {
+    builder.add_input("X", {1, channels, size, size});
+    builder.add_output("Y");
+
+    std::string input = "X";
+    for (int i = 0; i < blocks; ++i) {
+        std::string id = std::to_string(i);
+        builder.add_initializer("Wa" + id, {channels, channels, 3, 3}, 0.1f * i);
+        builder.add_initializer("Ba" + id, {1, channels, 1, 1}, 0.2f * i);
+        builder.add_initializer("Wb" + id, {channels, channels, 3, 3}, 0.3f * i);
+        builder.add_initializer("Bb" + id, {1, channels, 1, 1}, 0.4f * i);
+
+        builder.add_node("Conv", {input, "Wa" + id}, {"conva" + id}, conv_attributes());
+        builder.add_node("Add", {"conva" + id, "Ba" + id}, {"biasa" + id});
+        builder.add_node("Relu", {"biasa" + id}, {"relu" + id});
+        builder.add_node("Conv", {"relu" + id, "Wb" + id}, {"convb" + id}, conv_attributes());
+        builder.add_node("Add", {"convb" + id, "Bb" + id}, {"biasb" + id});
+        builder.add_node("Add", {"biasb" + id, input}, {"res" + id});
+
+        std::string output = (i == blocks - 1) ? "Y" : "block" + id;
+        builder.add_node("Relu", {"res" + id}, {output});
+        input = output;
+    }
+}
+
+Status build_fused(GraphBuilder& builder, int64_t channels, int64_t size, int blocks, bool transform_layout) {
+    build_cnn(builder, channels, size, blocks);
+    auto status = builder.build();
+    bool modified = false;
+    if (status.is_ok()) {
+        status = optimizer::ConvEpilogueFusionPass().apply(*builder.graph(), modified);
+    }
+    if (status.is_ok() && transform_layout) {
+        status = optimizer::LayoutTransformationPass().apply(*builder.graph(), modified);
+    }
+    return status;
+}
+
+void run_case(int64_t channels, int64_t size, int blocks, int iterations) {
+    GraphBuilder nchw;
+    GraphBuilder nhwc;
+    auto status = build_fused(nchw, channels, size, blocks, false);
+    if (status.is_ok()) {
+        status = build_fused(nhwc, channels, size, blocks, true);
+    }
+    if (!status.is_ok()) {
+        std::printf("build graph failed: %s\n", status.to_string().c_str());
+        return;
+    }
+
+    size_t reorders = 0;
+    for (const auto* node : nhwc.graph()->get_topological_nodes()) {
+        reorders += node->type() == ir::kReorderOpType ? 1 : 0;
+    }
+
+    TensorMap nchw_values;
+    nchw_values["X"] = make_tensor("X", {1, channels, size, size}, 0.5f);
+    TensorMap nhwc_values;
+    nhwc_values["X"] = make_tensor("X", {1, channels, size, size}, 0.5f);
+
+    double before = time_ms([&]() { run_graph(*nchw.graph(), nchw_values); }, iterations);
+    double after = time_ms([&]() { run_graph(*nhwc.graph(), nhwc_values); }, iterations);
+
+    std::printf("channels %3ld size %3ld blocks %2d | reorders %zu | NCHW %9.3f ms NHWC %9.3f ms | %.2fx\n",
+                static_cast<long>(channels), static_cast<long>(size), blocks, reorders, before, after,
+                before / after);
+}
+
+}    // namespace
+
+int main() {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    kernels::KernelManager::instance()->register_all_kernels();
+
+    std::printf("Layout transformation on fused ResNet-shaped graphs\n");
+    run_case(16, 28, 2, 5);
+    run_case(32, 14, 4, 5);
+    run_case(64, 7, 4, 5);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "onnx.proto3.pb.h"
+#include "runtime/session.h"
+
+using namespace simple_ai;
+
+namespace {
+
+constexpr int kLayers = 400;
+constexpr int64_t kHidden = 256;
+
+/**
+ * @brief write a model of `kLayers` Gemm -> Relu layers of [kHidden, kHidden] weights, about 100 MB. the extended
+ * pipeline fuses every pair
+ */
+void write_model(const std::string& file_path) {
+    onnx::ModelProto model;
+    model.set_ir_version(7);
+    model.add_opset_import()->set_version(13);
+
+    auto* graph = model.mutable_graph();
+    for (auto* value_info : {graph->add_input(), graph->add_output()}) {
+        value_info->set_name(value_info == &graph->input(0) ? "X" : "Y");
+        auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+        tensor_type->mutable_shape()->add_dim()->set_dim_value(1);
+        tensor_type->mutable_shape()->add_dim()->set_dim_value(kHidden);
+    }
+
+    std::vector<float> weight(kHidden * kHidden);
+    std::string input = "X";
+    for (int i = 0; i < kLayers; ++i) {
+        const std::string weight_name = "layers." + std::to_string(i) + ".weight";
+        for (size_t j = 0; j < weight.size(); ++j) {
+            weight[j] = std::sin(0.37f * (i + j)) / kHidden;
+        }
+        auto* initializer = graph->add_initializer();
+        initializer->set_name(weight_name);
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        initializer->add_dims(kHidden);
+        initializer->add_dims(kHidden);
+        initializer->set_raw_data(weight.data(), weight.size() * sizeof(float));
+
+        const std::string gemm = "layers." + std::to_string(i) + ".gemm";
+        const std::string output = i == kLayers - 1 ? "Y" : "layers." + std::to_string(i) + ".relu";
+        auto* node = graph->add_node();
+        node->set_op_type("Gemm");
+        node->add_input(input);
+        node->add_input(weight_name);
+        node->add_output(gemm);
+        node = graph->add_node();
+        node->set_op_type("Relu");
+        node->add_input(gemm);
+        node->add_output(output);
+        input = output;
+    }
+
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    ofs << model.SerializeAsString();
+}
+
+/**
+ * @brief load the model in a child process, so that every case starts from a fresh process
+ */
+void run_case(const char* label, const std::string& file_path, const std::string& cache_dir) {
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) {
+        int wstatus = 0;
+        waitpid(pid, &wstatus, 0);
+        return;
+    }
+
+    runtime::SessionOptions options;
+    options.optimization_pipeline = optimizer::kExtendedPipeline;
+    options.model_cache_dir = cache_dir;
+    runtime::InferenceSession session(options);
+    auto start = std::chrono::steady_clock::now();
+    auto status = session.load(file_path);
+    auto end = std::chrono::steady_clock::now();
+    if (!status.is_ok()) {
+        std::printf("load model failed: %s\n", status.to_string().c_str());
+        _exit(1);
+    }
+
+    std::printf("%-22s | load %9.2f ms | nodes %4zu | from cache %d\n", label,
+                std::chrono::duration<double, std::milli>(end - start).count(), session.execution_order().size(),
+                session.loaded_from_cache() ? 1 : 0);
+    std::fflush(stdout);
+    _exit(0);
+}
+
+}    // namespace
+
+int main() {
+    const std::string file_path = "/tmp/simple_ai_bench_model_cache.onnx";
+    const std::string cache_dir = "/tmp/simple_ai_bench_model_cache";
+    std::filesystem::remove_all(cache_dir);
+    write_model(file_path);
+
+    std::printf("Session load of %d Gemm -> Relu layers of [%ld, %ld] weights, the files are in the page cache\n",
+                kLayers, static_cast<long>(kHidden), static_cast<long>(kHidden));
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        run_case("onnx, no cache", file_path, "");
+    }
+    run_case("onnx, compile and save", file_path, cache_dir);
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        run_case("precompiled cache hit", file_path, cache_dir);
+    }
+
+    std::filesystem::remove_all(cache_dir);
+    std::remove(file_path.c_str());
+    return 0;
+}
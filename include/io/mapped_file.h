@@ -0,0 +1,80 @@
+#ifndef _H_SIMPLE_AI_IO_MAPPED_FILE_H_
+#define _H_SIMPLE_AI_IO_MAPPED_FILE_H_
+
+#include <memory>
+#include <string>
+
+#include "common/common.h"
+
+namespace simple_ai {
+namespace io {
+
+/**
+ * @brief A file mapped into memory. the mapping is private and writable: the pages are read from the page cache on
+ * demand and only copied if they are written, so the tensors which point into the mapping can be modified in place
+ * without changing the file.
+ */
+class MappedFile final {
+public:
+    ~MappedFile();
+
+    /**
+     * @brief map the whole file into memory
+     *
+     * @param file_path the file path
+     * @param mapped_file output parameter. the mapped file
+     * @return Status if the file can not be opened or is empty, return FILE_NOT_FOUND or INVALID_PARAM
+     */
+    static Status map(const std::string& file_path, std::shared_ptr<MappedFile>& mapped_file);
+
+    /**
+     * @brief map anonymous zeroed memory, e.g. to read a large tensor into. it is page aligned, and transparent huge
+     * pages are requested for it
+     *
+     * @param size the size
+     * @param mapped_file output parameter. the anonymous mapping
+     * @return Status if the size is 0 or the memory can not be mapped, return INVALID_PARAM or OUT_OF_MEMORY
+     */
+    static Status allocate(size_t size, std::shared_ptr<MappedFile>& mapped_file);
+
+    const char* data() const { return m_data; }
+    char* data() { return m_data; }
+
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief drop the resident pages which are entirely in the range, e.g. after the data has been copied out. the
+     * pages are read from the file again if they are accessed later, so the range must not have been written. the
+     * anonymous mappings keep their pages
+     *
+     * @param data the range begin, which is in the mapping
+     * @param size the range size
+     */
+    void release_pages(const char* data, size_t size);
+
+    /**
+     * @brief ask the kernel to read the pages of the range ahead, without waiting for them. the pages are mapped on
+     * the first access as usual
+     *
+     * @param data the range begin, which is in the mapping
+     * @param size the range size
+     */
+    void prefetch(const char* data, size_t size);
+
+private:
+    MappedFile(char* data, size_t size, bool anonymous) : m_data(data), m_size(size), m_anonymous(anonymous) {}
+
+private:
+    char* m_data{nullptr};
+    size_t m_size{0};
+    // not backed by a file, see `allocate`
+    bool m_anonymous{false};
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MappedFile);
+};
+
+}    // namespace io
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef _H_SIMPLE_AI_IO_NATIVE_SERIALIZER_H_
+#define _H_SIMPLE_AI_IO_NATIVE_SERIALIZER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common.h"
+#include "ir/model.h"
+
+namespace simple_ai {
+namespace io {
+
+// the magic at the begin of a precompiled model file
+constexpr char kNativeModelMagic[8] = {'S', 'A', 'I', 'M', 'O', 'D', 'E', 'L'};
+// the version of the precompiled model format, it is bumped whenever the layout changes. the files of the other
+// versions are rejected
+constexpr uint32_t kNativeModelVersion = 3;
+// the weights section begins at a page, the weights which are at least a page large are page aligned too
+constexpr size_t kNativePageAlignment = 4096;
+// the alignment of the smaller weights
+constexpr size_t kNativeWeightAlignment = 64;
+
+/**
+ * @brief The precompiled model format: the optimized graph, the types and shapes of its node args, the execution
+ * order and the weights. it is loaded with a single mmap and a flat decode of the graph section, without protobuf
+ * parsing and without running the optimization pipeline again.
+ *
+ * the layout is [header][graph section][weights section]. the graph section is encoded in the native byte order and
+ * the strings are length prefixed, so the files are only meant for the machine which writes them, see
+ * `runtime::ModelCache`. the loaded initializers point into the mapping, which is held by the model
+ */
+class NativeSerializer final {
+public:
+    NativeSerializer() = default;
+    ~NativeSerializer() = default;
+
+    /**
+     * @brief save the model to a precompiled model file. the node ids are renumbered in the execution order
+     *
+     * @param model the model, its graph topology has been constructed
+     * @param execution_order all the graph nodes in the order they run
+     * @param file_path the file path
+     * @return Status if the execution order does not cover the graph nodes, return INVALID_PARAM
+     */
+    static Status save_to_file(const ir::Model& model, const std::vector<ir::Node*>& execution_order,
+                               const std::string& file_path);
+
+    /**
+     * @brief load a precompiled model file. the graph is initialized, its topology is not constructed yet
+     *
+     * @param file_path the file path
+     * @param model_ptr output parameter. the loaded model
+     * @param execution_order output parameter. the graph nodes in the saved execution order
+     * @return Status if the file is not a precompiled model of this version or is truncated, return INVALID_MODEL
+     */
+    static Status load_from_file(const std::string& file_path, std::shared_ptr<ir::Model>& model_ptr,
+                                 std::vector<ir::Node*>& execution_order);
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NativeSerializer);
+};
+
+}    // namespace io
+}    // namespace simple_ai
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef _H_SIMPLE_AI_IO_ONNX_SERIALIZER_H_
 #define _H_SIMPLE_AI_IO_ONNX_SERIALIZER_H_
 
+#include <istream>
+
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
@@ -9,8 +11,10 @@
 #include "common/common.h"
 #include "framework/allocator.h"
 #include "framework/allocator_manager.h"
+#include "io/mapped_file.h"
 #include "ir/model.h"
 #include "onnx.proto3.pb.h"
+#include "utils/thread_pool/thread_pool.h"
 #include "utils/utils.h"
 
 using namespace simple_ai::common;
@@ -33,9 +37,19 @@ public:
      *
      * @param file_path the file path
      * @param model_ptr output parameter. the loaded model
+     * @param use_mmap map the file into memory instead of reading it. the initializers with raw data point into the
+     * mapping instead of being copied, the mapping is held by the model. if false, the file is streamed: the large raw
+     * data is read straight into page-aligned buffers which the tensors point into, the rest is read into the proto
+     * and copied
+     * @param prefetch_external_data read the external data files of the initializers ahead on a background thread,
+     * otherwise their pages are read on the first access. the external data is mapped whatever `use_mmap` is
+     * @param thread_pool the pool which the initializers are decoded on, together with the loading thread. nullptr
+     * decodes them on the loading thread
      * @return Status
      */
-    static Status load_from_file(const std::string& file_path, std::shared_ptr<Model>& model_ptr);
+    static Status load_from_file(const std::string& file_path, std::shared_ptr<Model>& model_ptr,
+                                 bool use_mmap = true, bool prefetch_external_data = true,
+                                 utils::thread_pool::IThreadPool* thread_pool = nullptr);
 
     /**
      * @brief load from memory
@@ -43,19 +57,114 @@ public:
      * @param data the data memory pointer
      * @param data_len the data length
      * @param model_ptr output parameter. the loaded model
-     * @return Status
+     * @param borrow_buffer the caller guarantees that the data outlives the model and is not modified. the wire format
+     * is walked to the raw data of the initializers, which the tensors point into instead of copying them, unless it
+     * is misaligned for the data type. if false, the data is parsed into the proto and every initializer is copied, a
+     * model over 2 GB is streamed as a file is
+     * @param thread_pool the pool which the initializers are decoded on, together with the loading thread. nullptr
+     * decodes them on the loading thread
+     * @return Status if an initializer is stored in an external data file, return INVALID_MODEL, since the location
+     * of the file is relative to the model file
      */
-    static Status load_from_memory(const void* data, size_t data_len, std::shared_ptr<Model>& model_ptr);
+    static Status load_from_memory(const void* data, size_t data_len, std::shared_ptr<Model>& model_ptr,
+                                   bool borrow_buffer = false, utils::thread_pool::IThreadPool* thread_pool = nullptr);
+
+    /**
+     * @brief save the model to an onnx file, so that an optimized graph is loaded by the other hosts without running
+     * the optimization pipeline again. the fused nodes keep their custom domain, whose opset is imported. the args
+     * produced by the nodes get a value info with their inferred type and shape, except the args in a layout other
+     * than NCHW, which onnx can not express, their layouts are inferred from the Reorder nodes again on load.
+     *
+     * the graph proto is encoded without the initializer data, the raw data of each initializer is written from its
+     * tensor buffer straight into the file afterwards, so the weights are not copied and a model over 2 GB is saved.
+     * the raw data is aligned in the file, so that the weights of the loaded model point into its mapping
+     *
+     * @param model the model, its graph topology has been constructed. the nodes are saved in the topological order
+     * @param file_path the file path
+     * @return Status if the topology is not constructed, an initializer has a dynamic shape or a data type is unknown,
+     * return INVALID_PARAM
+     */
+    static Status save_to_file(const Model& model, const std::string& file_path);
 
 private:
+    /**
+     * @brief The raw data of an initializer which is left in the loaded buffer instead of being copied into the proto,
+     * or which is in the mapped external data file
+     */
+    struct RawDataRef {
+        const char* data;
+        size_t size;
+        // the mapping which the data points into, its pages are released if the data is copied. nullptr for the
+        // other buffers
+        MappedFile* mapped_file;
+        // the buffer which the data has been read into, it is held by the model. nullptr if the buffer is held
+        // otherwise
+        std::shared_ptr<const void> owner;
+    };
+
+    // the raw data left in the loaded buffer, by the initializers in the proto
+    using RawDataRefs = std::unordered_map<const onnx::TensorProto*, RawDataRef>;
+
     /**
      * @brief load onnx proto model
      *
-     * @param loader the loader
+     * @param loader the loader, it parses the proto and collects the raw data left in the buffer
+     * @param buffer the buffer which the raw data refs point into, it is held by the loaded model. nullptr if the
+     * loader copies all the data into the proto
+     * @param model_dir the directory of the model file, which the external data locations are relative to. empty if
+     * the model is not loaded from a file
+     * @param prefetch_external_data read the external data files ahead on a background thread
+     * @param thread_pool the pool which the initializers are decoded on, nullptr decodes them on the calling thread
      * @param model_ptr output parameter. the model ir
      * @return Status
      */
-    static Status load_with_loader(std::function<Status(onnx::ModelProto&)> loader, std::shared_ptr<Model>& model_ptr);
+    static Status load_with_loader(std::function<Status(onnx::ModelProto&, RawDataRefs&)> loader,
+                                   std::shared_ptr<const void> buffer, const std::string& model_dir,
+                                   bool prefetch_external_data, utils::thread_pool::IThreadPool* thread_pool,
+                                   std::shared_ptr<Model>& model_ptr);
+
+    /**
+     * @brief map the external data files of the initializers, and refer to the data of each initializer in them. the
+     * mappings are held by the model
+     *
+     * @param onnx_graph the onnx graph
+     * @param model_dir the directory of the model file, which the external data locations are relative to
+     * @param prefetch read the referred data ahead on a background thread
+     * @param ir_model the model which holds the mappings
+     * @param raw_data_refs output parameter. the external data of the initializers are added
+     * @return Status if a location is absolute, escapes the model directory, can not be mapped or the data is out of
+     * the file, return INVALID_MODEL or FILE_NOT_FOUND
+     */
+    static Status resolve_external_data(const onnx::GraphProto& onnx_graph, const std::string& model_dir,
+                                        bool prefetch, Model& ir_model, RawDataRefs& raw_data_refs);
+
+    /**
+     * @brief parse the serialized onnx model without copying the raw data of the initializers. the wire format is
+     * walked down to the initializers, the other fields are merged into the proto as they are
+     *
+     * @param data the serialized model
+     * @param size the serialized model size
+     * @param mapped_file the mapping which `data` is in, nullptr if `data` is not mapped
+     * @param onnx_model output parameter. the onnx model, the initializers have no raw data
+     * @param raw_data_refs output parameter. the raw data of the initializers, which point into `data`
+     * @return Status
+     */
+    static Status parse_onnx_model_zero_copy(const char* data, size_t size, MappedFile* mapped_file,
+                                             onnx::ModelProto& onnx_model, RawDataRefs& raw_data_refs);
+
+    /**
+     * @brief parse the serialized onnx model from a stream, without protobuf's 2 GB limit. the fields of the model
+     * are merged into the proto by bounded runs, and the large raw data of the initializers is read straight into
+     * their own anonymous mappings, which huge pages are requested for, instead of into the proto
+     *
+     * @param input the stream
+     * @param size the serialized model size
+     * @param onnx_model output parameter. the onnx model, the initializers with large raw data have none
+     * @param raw_data_refs output parameter. the large raw data of the initializers, which own their mappings
+     * @return Status
+     */
+    static Status parse_onnx_model_streamed(std::istream& input, uint64_t size, onnx::ModelProto& onnx_model,
+                                            RawDataRefs& raw_data_refs);
 
     /**
      * @brief Validate the onnx proto model
@@ -69,19 +178,27 @@ private:
      * @brief parse onnx model to ir model
      *
      * @param onnx_model the onnx model
+     * @param raw_data_refs the raw data of the initializers left in the loaded buffer
+     * @param thread_pool the pool which the initializers are decoded on, nullptr decodes them on the calling thread
      * @param ir_model output parameter. the ir model
      * @return Status
      */
-    static Status parse_onnx_model(const onnx::ModelProto& onnx_model, std::shared_ptr<Model>& ir_model);
+    static Status parse_onnx_model(const onnx::ModelProto& onnx_model, const RawDataRefs& raw_data_refs,
+                                   utils::thread_pool::IThreadPool* thread_pool, std::shared_ptr<Model>& ir_model);
 
     /**
      * @brief parse onnx graph to ir graph
      *
      * @param onnx_graph the onnx graph
+     * @param raw_data_refs the raw data of the initializers left in the loaded buffer
+     * @param thread_pool the pool which the initializers are decoded on, nullptr decodes them on the calling thread.
+     * each initializer is decoded into its own tensor, the tensors are added to the graph in the proto order
+     * afterwards, so the graph does not depend on the number of threads
      * @param ir_graph output parameter. the ir graph
-     * @return Status
+     * @return Status if several initializers fail, the error of the first one in the proto order
      */
-    static Status parse_onnx_graph(const onnx::GraphProto& onnx_graph, std::unique_ptr<Graph>& ir_graph);
+    static Status parse_onnx_graph(const onnx::GraphProto& onnx_graph, const RawDataRefs& raw_data_refs,
+                                   utils::thread_pool::IThreadPool* thread_pool, std::unique_ptr<Graph>& ir_graph);
 
     /**
      * @brief parse onnx node to ir node
@@ -89,12 +206,11 @@ private:
      * @param onnx_node the onnx node
      * @param ir_node output parameter. the ir node
      * @param node_id the ir node id
-     * @param graph the graph which the ir node belongs to
-     * @param nodearg_map the node args
+     * @param graph the graph which the ir node belongs to, the node args are created in it
      * @return Status
      */
     static Status parse_onnx_node(const onnx::NodeProto& onnx_node, std::unique_ptr<Node>& ir_node, int node_id,
-                                  Graph* graph, const std::unordered_map<std::string, NodeArg>& nodearg_map);
+                                  Graph* graph);
 
     /**
      * @brief parse onnx node attribute to ir node attribute
@@ -112,10 +228,13 @@ private:
      * @param ir_tensor output parameter. the ir tensor
      * @param allocator the allocator for ir tensor to allocate memory
      * @param name the name of the tensor
+     * @param raw_data_ref the raw data left in the loaded buffer, nullptr if the data is in the proto. the ir tensor
+     * points into the buffer if the data is aligned, otherwise the data is copied
      * @return Status
      */
     static Status retrieve_tensor_data(const onnx::TensorProto& proto_tensor, std::unique_ptr<Tensor>& ir_tensor,
-                                       IAllocator* allocator, const std::string& name);
+                                       IAllocator* allocator, const std::string& name,
+                                       const RawDataRef* raw_data_ref = nullptr);
 
     /**
      * @brief Convert 'Constant' proto node to tensor
@@ -150,6 +269,53 @@ private:
      */
     static NodeAttributeType convert_to_node_attrtype(const onnx::AttributeProto_AttributeType& type);
 
+    /**
+     * @brief convert ir graph to onnx graph, without the initializers
+     *
+     * @param graph the ir graph, its topology has been constructed
+     * @param onnx_graph output parameter. the onnx graph
+     * @return Status
+     */
+    static Status graph_to_proto(const Graph& graph, onnx::GraphProto& onnx_graph);
+
+    /**
+     * @brief convert ir node attribute to onnx node attribute
+     *
+     * @param node_attr the ir node attribute
+     * @param proto_attr output parameter. the onnx node attribute
+     * @return Status
+     */
+    static Status attribute_to_proto(const NodeAttribute& node_attr, onnx::AttributeProto& proto_attr);
+
+    /**
+     * @brief convert ir tensor to proto tensor
+     *
+     * @param tensor the ir tensor, its shape is static
+     * @param with_data copy the tensor data into the raw data of the proto tensor. false only fills the name, the
+     * data type and the dims, for the data which is written on its own
+     * @param proto_tensor output parameter. the proto tensor
+     * @param byte_size output parameter. the byte size of the tensor data
+     * @return Status
+     */
+    static Status tensor_to_proto(const Tensor& tensor, bool with_data, onnx::TensorProto& proto_tensor,
+                                  size_t& byte_size);
+
+    /**
+     * @brief convert primitive data type to proto tensor data type
+     *
+     * @param data_type the primitive data type
+     * @return onnx::TensorProto_DataType UNDEFINED if the data type is unknown
+     */
+    static onnx::TensorProto_DataType primitive_to_tensor_datatype(PrimitiveDataType data_type);
+
+    /**
+     * @brief convert tensor shape to proto shape, the dynamic dims keep their symbols
+     *
+     * @param shape the tensor shape
+     * @param shape_proto output parameter. the proto shape
+     */
+    static void tensorshape_to_shapeproto(const TensorShape& shape, onnx::TensorShapeProto& shape_proto);
+
 private:
     SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxSerializer);
 };
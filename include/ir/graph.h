@@ -9,6 +9,8 @@
 #include <vector>
 
 #include "common/common.h"
+#include "graph_view.h"
+#include "name_table.h"
 #include "node.h"
 #include "node_arg.h"
 #include "tensor.h"
@@ -24,6 +26,8 @@ class Model;
  *
  */
 class Graph {
+    friend class GraphTransaction;
+
 public:
     virtual ~Graph() = default;
 
@@ -70,14 +74,22 @@ public:
     bool has_initializer(const std::string& name);
 
     /**
-     * @brief Add an ir node
+     * @brief Get the initializer tensor
+     *
+     * @param name the initializer name
+     * @return Tensor* nullptr if the initializer does not exist. otherwise return its pointer
+     */
+    Tensor* get_initializer(const std::string& name) const;
+
+    /**
+     * @brief Add an ir node. the node is indexed by its id, which should be non-negative and unique in the graph
      *
      * @param node the ir node
      */
     void add_node(std::unique_ptr<Node>&& node);
 
     /**
-     * @brief Get or create the node arg with name
+     * @brief Get or create the node arg with name. the name is interned and the created arg is assigned its id
      *
      * @param name the unique node arg name
      * @param node_arg the node arg
@@ -91,7 +103,29 @@ public:
      * @param name the node arg name
      * @return NodeArg* nullptr if the arg does not exist. otherwise return its pointer
      */
-    NodeArg* get_nodearg(const std::string& name);
+    NodeArg* get_nodearg(const std::string& name) const;
+
+    /**
+     * @brief Get the node arg by its id
+     *
+     * @param id the node arg id
+     * @return NodeArg* nullptr if the arg does not exist. otherwise return its pointer
+     */
+    NodeArg* get_nodearg(int id) const;
+
+    /**
+     * @brief Get the upper bound of the node arg ids. the per-arg data can be kept in flat vectors of this size
+     *
+     * @return size_t
+     */
+    size_t get_nodearg_id_bound() const;
+
+    /**
+     * @brief Get the initializers in the graph
+     *
+     * @return const std::unordered_map<std::string, std::unique_ptr<Tensor>>& key: the initializer name
+     */
+    const std::unordered_map<std::string, std::unique_ptr<Tensor>>& get_initializers() const;
 
     /**
      * @brief Get the nodes in the graph
@@ -100,6 +134,79 @@ public:
      */
     const std::vector<std::unique_ptr<Node>>& get_nodes() const;
 
+    /**
+     * @brief Get the node by id
+     *
+     * @param id the node id
+     * @return Node* nullptr if the node does not exist
+     */
+    Node* get_node(int id) const;
+
+    /**
+     * @brief Get the node which produces the node arg
+     *
+     * @param arg_name the node arg name
+     * @return Node* nullptr if the arg is a graph input, an initializer or does not exist
+     */
+    Node* get_producer_node(const std::string& arg_name) const;
+
+    /**
+     * @brief Get the node which produces the node arg
+     *
+     * @param arg the node arg owned by this graph
+     * @return Node* nullptr if the arg is a graph input, an initializer or is not produced by any node
+     */
+    Node* get_producer_node(const NodeArg* arg) const;
+
+    /**
+     * @brief Get the graph inputs, excluding the initializers
+     *
+     * @return const std::vector<NodeArg*>&
+     */
+    const std::vector<NodeArg*>& get_inputs() const;
+
+    /**
+     * @brief Get the graph inputs, including the overridable initializers
+     *
+     * @return const std::vector<NodeArg*>&
+     */
+    const std::vector<NodeArg*>& get_inputs_include_initializers() const;
+
+    /**
+     * @brief Get the graph outputs
+     *
+     * @return const std::vector<NodeArg*>&
+     */
+    const std::vector<NodeArg*>& get_outputs() const;
+
+    /**
+     * @brief Check if the node arg is one of the graph inputs, including the overridable initializers
+     *
+     * @param arg the node arg
+     * @return true
+     * @return false
+     */
+    bool is_graph_input(const NodeArg* arg) const;
+
+    /**
+     * @brief Check if the node arg is one of the graph outputs
+     *
+     * @param arg the node arg
+     * @return true
+     * @return false
+     */
+    bool is_graph_output(const NodeArg* arg) const;
+
+    /**
+     * @brief Erase a node from the graph.
+     * The graph view is NOT maintained, `construct_topology()` must be called after rewriting. the local rewrites
+     * should use `GraphTransaction`, which maintains the topology incrementally
+     *
+     * @param id the node id
+     * @return Status
+     */
+    Status erase_node(int id);
+
     /**
      * @brief Get the nodes of the graph in topological order
      * 
@@ -107,6 +214,14 @@ public:
      */
     const std::vector<Node*>& get_topological_nodes() const;
 
+    /**
+     * @brief Get the CSR view of the node connections, which is built in topological order by
+     * `construct_topology()`
+     *
+     * @return const GraphView&
+     */
+    const GraphView& get_view() const;
+
     /**
      * @brief construct the topological structure of this graph, ensure that the graph is valid, initialized,
      * and be able to be executed.
@@ -141,63 +256,34 @@ private:
     Status check_no_duplicate_names();
 
     /**
-     * @brief build the nodes connections
+     * @brief check the nodes connections, every node input should be produced by a node, or be a graph input or
+     * an initializer. the nodes without inputs and outputs are removed
      *
      * @return Status
      */
     Status build_nodes_connections();
 
     /**
-     * @brief remove a node
-     *
-     * @param id the node id
-     * @return Status
-     */
-    Status remove_node(int id);
-
-    /**
-     * @brief Add an edge between the source node and destination node
+     * @brief do topological sort, and build the graph view in topological order
      *
-     * @param src_node_id source node id
-     * @param dest_node_id destination node id
-     * @param src_arg_index source arg index
-     * @param dst_arg_index destination arg index
-     *
-     * @return Status
-     */
-    Status add_edge(int src_node_id, int dest_node_id, int src_arg_index, int dst_arg_index);
-
-    /**
-     * @brief Remove an edge between the source node and destination node
-     *
-     * @param src_node_id source node id
-     * @param dest_node_id destination node id
-     * @param src_arg_index source arg index
-     * @param dst_arg_index destination arg index
-     * @return Status
+     * @return Status if the graph is not a DAG, return fail
      */
-    Status remove_edge(int src_node_id, int dest_node_id, int src_arg_index, int dst_arg_index);
+    Status topological_sort();
 
     /**
-     * @brief intialize the node args, connect its producer and consumer nodes
+     * @brief do node input/output shape inference
      *
      * @return Status
      */
-    Status init_node_arg_to_connected_nodes();
-
-    /**
-     * @brief do topological sort
-     *
-     * @return Status if the graph is not a DAG, return fail
-     */
-    Status topological_sort();
+    Status infer_shape();
 
     /**
-     * @brief do node input/output shape inference
+     * @brief do the shape inference of a node, whose inputs have been inferred
      *
+     * @param node the node
      * @return Status
      */
-    Status infer_shape();
+    Status infer_node_shape(Node* node);
 
     /**
      * @brief clean up unused initializers and node args
@@ -214,11 +300,10 @@ private:
     struct TopologyContext {
         TopologyContext(const Graph& owner) : m_graph{owner} {}
 
-        // inputs and initializers names
-        std::unordered_set<std::string_view> inputs_and_initializers;
-        // outputs. key: output argument name, value: the output arg's attached node and the argument index in the
-        // node's outputs
-        std::unordered_map<std::string_view, std::pair<Node*, int>> output_args;
+        // whether the arg is a graph input or an initializer, indexed by the node arg id
+        std::vector<bool> inputs_and_initializers;
+        // the node producing the output arg, indexed by the node arg id. nullptr if the arg is not a node output
+        std::vector<const Node*> output_args;
         // node name to node id. key: node name, value: node id
         std::unordered_map<std::string_view, int> node_name_to_id;
 
@@ -245,11 +330,17 @@ private:
     // the nodes in the graph
     std::vector<std::unique_ptr<Node>> m_nodes;
 
+    // the nodes indexed by their dense ids, erased nodes leave a nullptr hole
+    std::vector<Node*> m_node_index;
+
     // key: the initializer tensor name, value: the initializer tensor unique pointer
     std::unordered_map<std::string, std::unique_ptr<Tensor>> m_initializer_map;
 
-    // key: node arg name, value: the NodeArg unique pointer
-    std::unordered_map<std::string, std::unique_ptr<NodeArg>> m_nodearg_map;
+    // the interned node arg names, the name id is the node arg id
+    NameTable m_nodearg_names;
+
+    // the node args indexed by id. a released arg leaves a nullptr hole, its id is reused if the name comes back
+    std::vector<std::unique_ptr<NodeArg>> m_nodeargs;
 
     // the graph inputs, including the initializers which are treated as inputs to the graph
     std::vector<NodeArg*> m_inputs_include_initializer;
@@ -264,14 +355,8 @@ private:
     // in this case, the initializers can be override by the user input
     std::vector<NodeArg*> m_overridable_initializers;
 
-    // the nodes in topological order
-    std::vector<Node*> m_topological_nodes;
-
-    // node arg to its producer node, key: node arg name, value: producer node id
-    std::unordered_map<std::string, int> m_node_arg_to_producer_node;
-
-    // node arg to its consumer nodes, key: node arg name, value: consumer node id set
-    std::unordered_map<std::string, std::unordered_set<int>> m_node_arg_to_consumer_nodes;
+    // the CSR view of the node connections, the nodes are in topological order
+    GraphView m_view;
 
     // the topology context
     TopologyContext m_topology_context{*this};
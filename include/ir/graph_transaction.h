@@ -0,0 +1,230 @@
+#ifndef _H_SIMPLE_AI_IR_GRAPH_TRANSACTION_H_
+#define _H_SIMPLE_AI_IR_GRAPH_TRANSACTION_H_
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common.h"
+#include "graph.h"
+#include "node.h"
+#include "node_arg.h"
+#include "node_attribute.h"
+
+namespace simple_ai {
+namespace ir {
+
+/**
+ * @brief A batch of local rewrites on a graph whose topology has been constructed.
+ *
+ * The mutations are applied to the nodes right away and recorded in an undo log, the erased nodes are only marked
+ * and stay in the graph until the commit, so the graph view can still be used to match the patterns. `commit()`
+ * maintains the topology incrementally instead of calling `construct_topology()`:
+ *
+ * 1. only the changed nodes are validated: their args are owned by the graph, their outputs are unique and their
+ *    inputs are resolvable. the args which lost their producer must not be consumed any more.
+ * 2. the topological order is kept: the erased nodes are dropped, the added nodes are inserted after their
+ *    producers, and only the edges of the changed nodes which go backward are repaired locally. the view is rebuilt
+ *    from the previous one, only the args of the changed nodes are read.
+ * 3. the shapes are inferred for the changed nodes, and downstream only while the output shapes change.
+ * 4. the initializers and node args which lost all their consumers and their producer are released.
+ *
+ * If the commit fails, or the transaction is destroyed before commit, all the changes are rolled back. the passes
+ * which change the graph inputs or initializers should call `construct_topology()` instead.
+ */
+class GraphTransaction final {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param graph the graph whose topology has been constructed
+     */
+    explicit GraphTransaction(Graph& graph);
+
+    /**
+     * @brief Destructor, the uncommitted changes are rolled back
+     */
+    ~GraphTransaction();
+
+    Graph& graph() const { return m_graph; }
+
+    /**
+     * @brief Get the id for a new node, which is not used by any node of the graph
+     *
+     * @return int
+     */
+    int next_node_id() const;
+
+    /**
+     * @brief Add a node to the graph
+     *
+     * @param node the node, its id should be allocated by `next_node_id()`
+     * @return Node* the added node
+     */
+    Node* add_node(std::unique_ptr<Node>&& node);
+
+    /**
+     * @brief Mark a node as erased, it is removed from the graph on commit
+     *
+     * @param id the node id
+     * @return Status fail if the node does not exist or has been erased
+     */
+    Status erase_node(int id);
+
+    /**
+     * @brief Check if the node is erased in this transaction
+     *
+     * @param id the node id
+     * @return true
+     * @return false
+     */
+    bool is_erased(int id) const;
+
+    /**
+     * @brief append an input arg to the node
+     *
+     * @param node the node
+     * @param arg the input arg
+     */
+    void add_input_arg(Node* node, NodeArg* arg);
+
+    /**
+     * @brief replace the input arg of the node at `index`
+     *
+     * @param node the node
+     * @param index the input arg index
+     * @param arg the new input arg
+     */
+    void replace_input_arg(Node* node, size_t index, NodeArg* arg);
+
+    /**
+     * @brief replace the output arg of the node at `index`
+     *
+     * @param node the node
+     * @param index the output arg index
+     * @param arg the new output arg
+     */
+    void replace_output_arg(Node* node, size_t index, NodeArg* arg);
+
+    /**
+     * @brief change the operator of the node
+     *
+     * @param node the node
+     * @param type the new node type
+     * @param domain the new node domain
+     */
+    void set_op_type(Node* node, const std::string& type, const std::string& domain);
+
+    /**
+     * @brief add or replace an attribute of the node
+     *
+     * @param node the node
+     * @param attr the node attribute
+     */
+    void set_attribute(Node* node, std::unique_ptr<NodeAttribute>&& attr);
+
+    /**
+     * @brief Check if nothing has been changed in this transaction
+     *
+     * @return true
+     * @return false
+     */
+    bool empty() const;
+
+    /**
+     * @brief apply the changes and maintain the topology incrementally
+     *
+     * @return Status if the rewritten graph is invalid, the changes are rolled back and the error is returned
+     */
+    Status commit();
+
+    /**
+     * @brief undo the uncommitted changes of this transaction
+     */
+    void rollback();
+
+private:
+    /**
+     * @brief A record in the undo log
+     */
+    struct Change {
+        enum class Type { ADD_NODE, ADD_INPUT, REPLACE_INPUT, REPLACE_OUTPUT, SET_OP_TYPE, SET_ATTRIBUTE };
+
+        Type type;
+        Node* node{nullptr};
+        // the arg index, for ADD_INPUT the index of the appended arg
+        size_t index{0};
+        // the replaced arg
+        NodeArg* arg{nullptr};
+        // the replaced op type and domain, or the attribute name
+        std::string name;
+        std::string domain;
+        // the replaced attribute, nullptr if the attribute did not exist
+        std::unique_ptr<NodeAttribute> attribute;
+    };
+
+    /**
+     * @brief The type and shape of a node arg before the shape inference
+     */
+    struct ArgState {
+        NodeArg* arg;
+        PrimitiveDataType data_type;
+        TensorShape shape;
+    };
+
+    /**
+     * @brief record the node as changed
+     */
+    void touch(Node* node);
+
+    /**
+     * @brief check the changed nodes and the args which lost their producer against the new view
+     *
+     * @param view the new view
+     * @param changed_nodes the ids of the changed nodes in the new view
+     * @param changed whether the node is changed or added, indexed by the node id
+     * @param erased whether the node is erased, indexed by the node id
+     * @return Status
+     */
+    Status validate(const GraphView& view, const std::vector<int>& changed_nodes, const std::vector<bool>& changed,
+                    const std::vector<bool>& erased) const;
+
+    /**
+     * @brief repair the topological order around the edges of the changed nodes
+     *
+     * @param view the new view, the unchanged nodes are in topological order
+     * @param changed_nodes the ids of the changed nodes in the new view
+     * @param order output parameter. the node indices in the repaired order, empty if the view is in order
+     * @return Status if the graph is not a DAG, return fail
+     */
+    Status repair_order(const GraphView& view, const std::vector<int>& changed_nodes, std::vector<int>& order) const;
+
+    /**
+     * @brief infer the shapes from the changed nodes downstream, the replaced shapes are recorded for the rollback
+     *
+     * @param view the new view in topological order
+     * @param changed_nodes the ids of the changed nodes in the new view
+     * @param replaced_states output parameter. the output args states before the inference
+     * @return Status
+     */
+    Status infer_shape(const GraphView& view, const std::vector<int>& changed_nodes,
+                       std::vector<ArgState>& replaced_states) const;
+
+private:
+    Graph& m_graph;
+    // the undo log
+    std::vector<Change> m_changes;
+    // the nodes changed or added in this transaction, by id
+    std::vector<int> m_changed_nodes;
+    // the nodes marked as erased, by id
+    std::unordered_set<int> m_erased_nodes;
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransaction);
+};
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
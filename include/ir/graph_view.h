@@ -0,0 +1,149 @@
+#ifndef _H_SIMPLE_AI_IR_GRAPH_VIEW_H_
+#define _H_SIMPLE_AI_IR_GRAPH_VIEW_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace simple_ai {
+namespace ir {
+
+class Graph;
+class Node;
+
+/**
+ * @brief A read-only range over a contiguous array
+ */
+template <typename T>
+class ArrayRange {
+public:
+    ArrayRange(const T* begin, const T* end) : m_begin(begin), m_end(end) {}
+
+    const T* begin() const { return m_begin; }
+    const T* end() const { return m_end; }
+    size_t size() const { return static_cast<size_t>(m_end - m_begin); }
+    bool empty() const { return m_begin == m_end; }
+    const T& operator[](size_t i) const { return m_begin[i]; }
+
+private:
+    const T* m_begin;
+    const T* m_end;
+};
+
+/**
+ * @brief An edge between two nodes of a graph view. an input edge is from the producer node `node` to the owner
+ * node, an output edge is from the owner node to the consumer node `node`
+ */
+struct GraphEdge {
+    // the index of the other node in the view
+    int node;
+    // the index of the arg in the producer node's outputs
+    int src_arg_index;
+    // the index of the arg in the consumer node's inputs
+    int dst_arg_index;
+};
+
+/**
+ * @brief An immutable compressed sparse row (CSR) view of the graph connections. the nodes are indexed densely by
+ * their position in the view, the edges of all nodes live in two flat arrays addressed by per-node offsets, and the
+ * producer and consumers of every node arg are indexed by the node arg id.
+ *
+ * The graph builds its view in topological order in `construct_topology()`, and `GraphTransaction` rebuilds it
+ * from the previous view after local rewrites. the view is a snapshot: it is not updated by `add_node()` or
+ * `erase_node()`, so the passes which rewrite the graph should check the erased nodes by id
+ */
+class GraphView final {
+public:
+    GraphView() = default;
+    ~GraphView() = default;
+
+    /**
+     * @brief build the view over the nodes of the graph
+     *
+     * @param graph the graph which owns the nodes and their args
+     * @param nodes the nodes, the node index in the view is its position in this list
+     */
+    void build(const Graph& graph, std::vector<Node*> nodes);
+
+    /**
+     * @brief build the view from the previous view of the same graph. only the args of the changed nodes are read,
+     * the connections of the other nodes are copied from the previous view
+     *
+     * @param graph the graph which owns the nodes and their args
+     * @param previous the previous view
+     * @param nodes the nodes, the node index in the view is its position in this list
+     * @param previous_indices the index of every node in the previous view, -1 if the node is not in it
+     * @param changed whether the args of the node are changed since the previous view, indexed by the node index
+     */
+    void rebuild(const Graph& graph, const GraphView& previous, std::vector<Node*> nodes,
+                 const std::vector<int>& previous_indices, const std::vector<bool>& changed);
+
+    void clear();
+
+    size_t node_num() const { return m_nodes.size(); }
+
+    // the nodes in the view order
+    const std::vector<Node*>& nodes() const { return m_nodes; }
+
+    Node* node(int index) const { return m_nodes[index]; }
+
+    // the node id is also valid after the node is erased from the graph
+    int node_id(int index) const { return m_node_ids[index]; }
+
+    /**
+     * @brief Get the index of the node in the view
+     *
+     * @param node_id the node id
+     * @return int -1 if the node is not in the view
+     */
+    int index_of(int node_id) const;
+
+    // the input edges of the node, in the order of the node inputs
+    ArrayRange<GraphEdge> input_edges(int index) const {
+        return {m_input_edges.data() + m_input_offsets[index], m_input_edges.data() + m_input_offsets[index + 1]};
+    }
+
+    // the output edges of the node, in the order of the consumers in the view
+    ArrayRange<GraphEdge> output_edges(int index) const {
+        return {m_output_edges.data() + m_output_offsets[index], m_output_edges.data() + m_output_offsets[index + 1]};
+    }
+
+    /**
+     * @brief Get the producer node of the node arg
+     *
+     * @param arg_id the node arg id
+     * @return int the producer node index. -1 if the arg is not produced by the nodes in the view
+     */
+    int producer(int arg_id) const;
+
+    /**
+     * @brief Get the nodes consuming the node arg
+     *
+     * @param arg_id the node arg id
+     * @return ArrayRange<int> the distinct consumer node indices, in ascending order
+     */
+    ArrayRange<int> consumers(int arg_id) const;
+
+private:
+    // the nodes and their ids, indexed by the node index
+    std::vector<Node*> m_nodes;
+    std::vector<int> m_node_ids;
+    // the node index, indexed by the node id
+    std::vector<int> m_node_index;
+
+    // the edges of node i are [offsets[i], offsets[i + 1])
+    std::vector<size_t> m_input_offsets;
+    std::vector<GraphEdge> m_input_edges;
+    std::vector<size_t> m_output_offsets;
+    std::vector<GraphEdge> m_output_edges;
+
+    // the producer node index, indexed by the node arg id
+    std::vector<int> m_arg_producers;
+    // the consumers of arg i are [offsets[i], offsets[i + 1])
+    std::vector<size_t> m_arg_consumer_offsets;
+    std::vector<int> m_arg_consumers;
+};
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
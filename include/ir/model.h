@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/common.h"
 #include "graph.h"
@@ -47,6 +48,14 @@ public:
     const std::unordered_map<std::string, int64_t>& get_domain_version() const;
     void set_domain_version(const std::unordered_map<std::string, int64_t>& dom_ver_map);
 
+    /**
+     * @brief keep a buffer alive as long as the model, the tensors of the graph which do not own their data may point
+     * into it, e.g. the initializers loaded from a mapped file
+     *
+     * @param buffer the buffer
+     */
+    void hold_buffer(std::shared_ptr<const void> buffer);
+
 private:
     int64_t m_ir_version;
     std::string m_producer_name;
@@ -61,6 +70,9 @@ private:
     // the opset map
     std::unordered_map<std::string, int64_t> m_domain_version;
 
+    // the buffers which the tensors of the graph point into, they are released after the graph
+    std::vector<std::shared_ptr<const void>> m_buffers;
+
     // the graph
     std::unique_ptr<Graph> m_graph;
 };
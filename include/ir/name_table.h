@@ -0,0 +1,69 @@
+#ifndef _H_SIMPLE_AI_IR_NAME_TABLE_H_
+#define _H_SIMPLE_AI_IR_NAME_TABLE_H_
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "common/common.h"
+
+namespace simple_ai {
+namespace ir {
+
+// the id of a name which is not interned
+constexpr int kInvalidNameId = -1;
+
+/**
+ * @brief An interned name table. every distinct name is stored once and assigned a dense id in [0, size()),
+ * so that the per-name data can be kept in flat vectors indexed by the id instead of maps keyed by the name.
+ * the ids are stable, names are never removed
+ */
+class NameTable final {
+public:
+    NameTable() = default;
+    ~NameTable() = default;
+
+    /**
+     * @brief intern the name
+     *
+     * @param name the name
+     * @return int the id of the name, a new id is assigned if the name is not interned yet
+     */
+    int intern(std::string_view name);
+
+    /**
+     * @brief find the id of the name
+     *
+     * @param name the name
+     * @return int the id of the name. kInvalidNameId if the name is not interned
+     */
+    int find(std::string_view name) const;
+
+    /**
+     * @brief get the name by id
+     *
+     * @param id the id, it should be in [0, size())
+     * @return const std::string& the interned name
+     */
+    const std::string& name(int id) const { return m_names[id]; }
+
+    /**
+     * @brief the number of interned names, which is also the upper bound of the ids
+     */
+    size_t size() const { return m_names.size(); }
+
+private:
+    // the interned names indexed by id. the deque keeps the string addresses stable for the string_view keys
+    std::deque<std::string> m_names;
+    // key: the interned name, value: the name id
+    std::unordered_map<std::string_view, int> m_ids;
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NameTable);
+};
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
@@ -2,60 +2,27 @@
 #define _H_SIMPLE_AI_IR_NODE_H_
 
 #include <memory>
-#include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/common.h"
 #include "node_arg.h"
 #include "node_attribute.h"
+#include "op_params.h"
 
 namespace simple_ai {
 namespace ir {
 
 class Graph;
 class Node;
-class Edge;
-struct EdgeCompare;
-
-/**
- * @brief The edge which links nodes in the graph.
- *
- */
-class Edge {
-public:
-    /**
-     * @brief Constructor
-     *
-     * @param other_node the other node this edge links
-     * @param src_arg_index the node argument index of source node of this edge
-     * @param dst_arg_index the node argument index of destination node of this edge
-     */
-    Edge(const Node& other_node, int src_arg_index, int dst_arg_index)
-        : m_other_node(other_node), m_src_arg_index(src_arg_index), m_dst_arg_index(dst_arg_index) {}
-
-    const Node& other_node() const { return m_other_node; }
-    int src_arg_index() const { return m_src_arg_index; }
-    int dst_arg_index() const { return m_dst_arg_index; }
-
-private:
-    // the other node relative to the current node which owns this Edge
-    const Node& m_other_node;
-    // the source NodeArg index
-    int m_src_arg_index;
-    // the destination NodeArg index
-    int m_dst_arg_index;
-};
-
-struct EdgeCompare {
-    bool operator()(const Edge& lhs, const Edge& rhs) const;
-};
-
-using EdgeSet = std::set<Edge, EdgeCompare>;
 
 /**
  * @brief Node shape infer interface
  *
+ * The inputs may have dynamic dims. an output dim which is passed through from an input keeps its symbol, the
+ * derived dims are left dynamic, and the checks which involve dynamic dims are deferred to the run time, when the
+ * inference runs again with the bound input shapes.
  */
 class IShapeInfer {
 public:
@@ -74,12 +41,11 @@ public:
      *
      * @param node_name the node name
      * @param inputs the node inputs args
-     * @param attributes the node attributes
+     * @param params the node attributes decoded for the node type
      * @param outputs input/output parameter. the node output args
      * @return Status
      */
-    virtual Status infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                         const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
+    virtual Status infer(const std::string& node_name, const std::vector<NodeArg*>& inputs, const OpParams& params,
                          std::vector<NodeArg*>& outputs) = 0;
 };
 
@@ -120,19 +86,87 @@ public:
 
     const std::string& name() const { return m_name; }
     const std::string& type() const { return m_type; }
+    const std::string& domain() const { return m_domain; }
+
+    const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes() const { return m_attributes; }
 
     const std::vector<NodeArg*>& input_args() const;
     const std::vector<NodeArg*>& output_args() const;
 
-    const EdgeSet& input_edges() const;
-    const EdgeSet& output_edges() const;
+    /**
+     * @brief change the operator of this node, used by the graph rewrite passes
+     *
+     * @param type the new node type
+     * @param domain the new node domain
+     */
+    void set_op_type(const std::string& type, const std::string& domain);
+
+    /**
+     * @brief append an input arg to this node
+     *
+     * @param arg the input arg
+     */
+    void add_input_arg(NodeArg* arg);
+
+    /**
+     * @brief replace the input arg at `index`
+     *
+     * @param index the input arg index
+     * @param arg the new input arg
+     */
+    void replace_input_arg(size_t index, NodeArg* arg);
+
+    /**
+     * @brief remove the input arg at `index`
+     *
+     * @param index the input arg index
+     */
+    void remove_input_arg(size_t index);
+
+    /**
+     * @brief replace the output arg at `index`
+     *
+     * @param index the output arg index
+     * @param arg the new output arg
+     */
+    void replace_output_arg(size_t index, NodeArg* arg);
+
+    /**
+     * @brief add an attribute to this node. if the attribute has already existed, it will be replaced
+     *
+     * @param attr the node attribute
+     */
+    void set_attribute(std::unique_ptr<NodeAttribute>&& attr);
+
+    /**
+     * @brief remove an attribute from this node
+     *
+     * @param name the attribute name
+     * @return std::unique_ptr<NodeAttribute> the removed attribute. nullptr if the attribute does not exist
+     */
+    std::unique_ptr<NodeAttribute> release_attribute(const std::string& name);
 
-    void add_input_edge(const Edge& edge);
-    void add_output_edge(const Edge& edge);
+    /**
+     * @brief Get the attributes decoded for the node type by `decode_params()`
+     *
+     * @return const OpParams&
+     */
+    const OpParams& params() const { return m_params; }
 
-    void remove_input_edge(const Edge& edge);
-    void remove_output_edge(const Edge& edge);
+    /**
+     * @brief decode the attributes into the params of the node type. it should be called again after the op type or
+     * the attributes are changed
+     *
+     * @return Status if an attribute value is not supported, return INVALID_PARAM or NOT_IMPLEMENTED
+     */
+    Status decode_params();
 
+    /**
+     * @brief decode the params, then infer the output shapes
+     *
+     * @param infer the shape infer of the node type
+     * @return Status
+     */
     Status infer_shape(IShapeInfer* infer);
 
 private:
@@ -154,12 +188,8 @@ private:
     std::vector<NodeArg*> m_output_args;
     // node attributes
     std::unordered_map<std::string, std::unique_ptr<NodeAttribute>> m_attributes;
-
-    // the edges for nodes that produce inputs to this Node
-    EdgeSet m_input_edges;
-
-    // the edges for nodes that consume outputs from this Node
-    EdgeSet m_output_edges;
+    // the attributes decoded for the node type
+    OpParams m_params;
 };
 
 }    // namespace ir
@@ -7,6 +7,7 @@
 
 #include "common/common.h"
 #include "framework/common_defines.h"
+#include "name_table.h"
 #include "tensor_shape.h"
 
 using namespace simple_ai::framework;
@@ -19,6 +20,8 @@ namespace ir {
  * including argument name, argument primitive data type and shape.
  */
 class NodeArg {
+    friend class Graph;
+
 public:
     NodeArg(const std::string& name);
     NodeArg(const std::string& name, PrimitiveDataType data_type, const TensorShape& shape);
@@ -32,13 +35,18 @@ public:
     bool operator!=(const NodeArg& rhs) const;
 
     const std::string& name() const;
+    // the dense id of the interned name in the graph which owns this arg. kInvalidNameId if the arg is not owned
+    // by a graph
+    int id() const { return m_id; }
     const PrimitiveDataType data_type() const;
     const TensorShape& shape() const;
 
     void set_shape(const TensorShape& shape);
+    void set_data_type(PrimitiveDataType data_type);
 
 private:
     std::string m_name;
+    int m_id{kInvalidNameId};
     PrimitiveDataType m_data_type;
     TensorShape m_shape;
 };
@@ -4,6 +4,8 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <variant>
+#include <vector>
 
 #include "common/common.h"
 #include "framework/common_defines.h"
@@ -33,61 +35,74 @@ enum class NodeAttributeType {
 };
 
 /**
- * @brief Node attributes
+ * @brief Node attributes. the value is a variant whose alternatives are in the order of `NodeAttributeType`, so an
+ * attribute only pays for the data of its own type. the getters return the zero value if the type mismatches, the
+ * setters change the type of the attribute to the type of the value
  */
 class NodeAttribute {
 public:
-    NodeAttribute(const std::string& name, const NodeAttributeType& type) : m_name(name), m_type(type) {}
+    NodeAttribute(const std::string& name, const NodeAttributeType& type);
+
+    /**
+     * @brief Get the node attribute name
+     *
+     * @return const std::string&
+     */
+    const std::string& name() const { return m_name; }
 
     /**
      * @brief Get the node attribute data type
      *
      * @return NodeAttributeType
      */
-    NodeAttributeType type() const { return m_type; }
+    NodeAttributeType type() const { return static_cast<NodeAttributeType>(m_value.index()); }
+
+    void set_float(float f) { m_value = f; }
+    float get_float() const;
 
-    void set_float(float f) { m_float = f; }
-    float get_float() const { return m_float; }
+    void set_int64(int64_t i) { m_value = i; }
+    int64_t get_int64() const;
 
-    void set_int64(int64_t i) { m_int64 = i; }
-    int64_t get_int64() const { return m_int64; }
+    void set_string(const std::string& str) { m_value = str; }
+    const std::string& get_string() const;
 
-    void set_string(const std::string& str) { m_string = str; }
-    const std::string& get_string() const { return m_string; }
+    void set_tensor(std::unique_ptr<Tensor>&& tensor) { m_value = std::move(tensor); }
+    Tensor* get_tensor() const;
 
-    void set_tensor(std::unique_ptr<Tensor>&& tensor) { m_tensor = std::move(tensor); }
-    Tensor* get_tensor() const { return m_tensor.get(); }
+    void add_float(float f) { mutable_value<std::vector<float>>().emplace_back(f); }
+    const std::vector<float>& get_floats() const;
 
-    void add_float(float f) { m_floats.emplace_back(f); }
-    const std::vector<float>& get_floats() const { return m_floats; }
+    void add_int64(int64_t i) { mutable_value<std::vector<int64_t>>().emplace_back(i); }
+    const std::vector<int64_t>& get_int64s() const;
 
-    void add_int64(int64_t i) { m_int64s.emplace_back(i); }
-    const std::vector<int64_t>& get_int64s() const { return m_int64s; }
+    void add_string(const std::string& str) { mutable_value<std::vector<std::string>>().emplace_back(str); }
+    const std::vector<std::string>& get_strings() const;
 
-    void add_string(const std::string& str) { m_strings.emplace_back(str); }
-    const std::vector<std::string>& get_strings() const { return m_strings; }
+    void add_tensor(std::unique_ptr<Tensor>&& tensor) {
+        mutable_value<std::vector<std::unique_ptr<Tensor>>>().emplace_back(std::move(tensor));
+    }
+    const std::vector<std::unique_ptr<Tensor>>& get_tensors() const;
 
-    void add_tensor(std::unique_ptr<Tensor>&& tensor) { m_tensors.emplace_back(std::move(tensor)); }
-    const std::vector<std::unique_ptr<Tensor>>& get_tensors() const { return m_tensors; }
+private:
+    /**
+     * @brief get the value of the type T, the value is reset to an empty T if the attribute has another type
+     */
+    template <typename T>
+    T& mutable_value() {
+        if (!std::holds_alternative<T>(m_value)) {
+            m_value.emplace<T>();
+        }
+        return std::get<T>(m_value);
+    }
 
 private:
     // name of the attribute
     std::string m_name;
 
-    // attribyte type
-    NodeAttributeType m_type;
-
-    // data section
-    float m_float;
-    int64_t m_int64;
-    std::string m_string;
-    std::unique_ptr<Tensor> m_tensor;
-
-    std::vector<float> m_floats;
-    std::vector<int64_t> m_int64s;
-    std::vector<std::string> m_strings;
-    std::vector<std::unique_ptr<Tensor>> m_tensors;
-    // end data section
+    // data section, the alternatives are in the order of NodeAttributeType
+    std::variant<int64_t, float, std::string, std::unique_ptr<Tensor>, std::vector<int64_t>, std::vector<float>,
+                 std::vector<std::string>, std::vector<std::unique_ptr<Tensor>>, std::monostate>
+        m_value;
 };
 
 }    // namespace ir
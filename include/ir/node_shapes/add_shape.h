@@ -14,8 +14,7 @@ class AddShapeInfer : public IShapeInfer {
 public:
     virtual std::string node_type() const override;
 
-    virtual Status infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                         const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
+    virtual Status infer(const std::string& node_name, const std::vector<NodeArg*>& inputs, const OpParams& params,
                          std::vector<NodeArg*>& outputs) override;
 };
 
@@ -0,0 +1,22 @@
+#ifndef _H_SIMPLE_AI_IR_NODE_SHAPES_FUSED_GEMM_H_
+#define _H_SIMPLE_AI_IR_NODE_SHAPES_FUSED_GEMM_H_
+
+#include "ir/node.h"
+
+namespace simple_ai {
+namespace ir {
+
+// Gemm with fused residual Add and activation epilogue.
+// inputs: A, B, C(optional), Z(optional, residual which has the same shape as the output)
+class FusedGemmShapeInfer : public IShapeInfer {
+public:
+    virtual std::string node_type() const override;
+
+    virtual Status infer(const std::string& node_name, const std::vector<NodeArg*>& inputs, const OpParams& params,
+                         std::vector<NodeArg*>& outputs) override;
+};
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
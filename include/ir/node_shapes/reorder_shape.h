@@ -0,0 +1,21 @@
+#ifndef _H_SIMPLE_AI_IR_NODE_SHAPES_REORDER_H_
+#define _H_SIMPLE_AI_IR_NODE_SHAPES_REORDER_H_
+
+#include "ir/node.h"
+
+namespace simple_ai {
+namespace ir {
+
+// convert the memory layout of a 4-D tensor from src_layout to dst_layout. the logical dims are not changed
+class ReorderShapeInfer : public IShapeInfer {
+public:
+    virtual std::string node_type() const override;
+
+    virtual Status infer(const std::string& node_name, const std::vector<NodeArg*>& inputs, const OpParams& params,
+                         std::vector<NodeArg*>& outputs) override;
+};
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
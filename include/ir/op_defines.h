@@ -0,0 +1,36 @@
+#ifndef _H_SIMPLE_AI_IR_OP_DEFINES_H_
+#define _H_SIMPLE_AI_IR_OP_DEFINES_H_
+
+#include <cstdint>
+
+namespace simple_ai {
+namespace ir {
+
+// the domain of the operators created by the graph optimization passes
+constexpr const char* kSimpleAIDomain = "com.simple_ai";
+// the opset version of the domain, it is imported by the exported onnx models which have the fused nodes
+constexpr int64_t kSimpleAIDomainVersion = 1;
+
+// Conv with fused epilogue. inputs: X, W, B(optional), Z(optional residual)
+constexpr const char* kFusedConvOpType = "FusedConv";
+
+// Gemm with fused epilogue. inputs: A, B, C(optional), Z(optional residual)
+constexpr const char* kFusedGemmOpType = "FusedGemm";
+
+// convert a 4-D tensor between the memory layouts, see `DataLayout`. attributes: src_layout, dst_layout
+constexpr const char* kReorderOpType = "Reorder";
+constexpr const char* kSrcLayoutAttrName = "src_layout";
+constexpr const char* kDstLayoutAttrName = "dst_layout";
+
+// the metadata key prefix of the exported onnx models, the key is followed by the name of an initializer which is
+// not in NCHW (e.g. the packed Conv weights) and the value is the layout string
+constexpr const char* kLayoutMetadataPrefix = "com.simple_ai.layout:";
+
+// the fused activation attribute name, its value is the activation node type, e.g. "Relu"
+constexpr const char* kActivationAttrName = "activation";
+constexpr const char* kReluActivation = "Relu";
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef _H_SIMPLE_AI_IR_OP_PARAMS_H_
+#define _H_SIMPLE_AI_IR_OP_PARAMS_H_
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include "common/common.h"
+#include "node_attribute.h"
+#include "tensor_shape.h"
+
+namespace simple_ai {
+namespace ir {
+
+/**
+ * @brief The onnx `auto_pad` attribute of the convolution and pooling operators
+ *
+ */
+enum class AutoPad { NOTSET, SAME_UPPER, SAME_LOWER, VALID };
+
+/**
+ * @brief convert the auto pad to string
+ *
+ * @param auto_pad the auto pad
+ * @return const char*
+ */
+const char* auto_pad_to_string(AutoPad auto_pad);
+
+/**
+ * @brief The activation fused into the epilogue of FusedConv and FusedGemm
+ *
+ */
+enum class FusedActivation { NONE, RELU };
+
+/**
+ * @brief The attributes of Conv and FusedConv. the int arrays are empty if the attributes are absent
+ *
+ */
+struct ConvParams {
+    AutoPad auto_pad{AutoPad::NOTSET};
+    int64_t group{1};
+    DimVector kernel_shape;
+    DimVector dilations;
+    DimVector pads;
+    DimVector strides;
+    FusedActivation activation{FusedActivation::NONE};
+};
+
+/**
+ * @brief The attributes of MaxPool. the int arrays are empty if the attributes are absent
+ *
+ */
+struct PoolParams {
+    AutoPad auto_pad{AutoPad::NOTSET};
+    int64_t ceil_mode{0};
+    int64_t storage_order{0};
+    DimVector kernel_shape;
+    DimVector dilations;
+    DimVector pads;
+    DimVector strides;
+};
+
+/**
+ * @brief The attributes of Gemm and FusedGemm
+ *
+ */
+struct GemmParams {
+    float alpha{1.0f};
+    float beta{1.0f};
+    bool trans_a{false};
+    bool trans_b{false};
+    FusedActivation activation{FusedActivation::NONE};
+};
+
+/**
+ * @brief The attributes of Flatten
+ *
+ */
+struct FlattenParams {
+    int64_t axis{1};
+};
+
+/**
+ * @brief The attributes of Reorder
+ *
+ */
+struct ReorderParams {
+    DataLayout src_layout{DataLayout::NCHW};
+    DataLayout dst_layout{DataLayout::NCHW};
+};
+
+/**
+ * @brief The attributes of a node decoded for its operator type, so that the shape inference and the kernels do not
+ * look up the attribute map by name. std::monostate for the operators without attributes
+ *
+ */
+using OpParams = std::variant<std::monostate, ConvParams, PoolParams, GemmParams, FlattenParams, ReorderParams>;
+
+/**
+ * @brief decode the node attributes into the params of the operator type
+ *
+ * @param op_type the operator type
+ * @param node_name the node name
+ * @param attributes the node attributes
+ * @param params output parameter. the decoded params
+ * @return Status if an attribute value is not supported, return INVALID_PARAM or NOT_IMPLEMENTED
+ */
+Status decode_op_params(const std::string& op_type, const std::string& node_name,
+                        const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
+                        OpParams& params);
+
+/**
+ * @brief get the decoded params of the operator type
+ *
+ * @tparam T the params type
+ * @param op_type the operator type, for the error message
+ * @param node_name the node name, for the error message
+ * @param params the decoded params
+ * @param typed_params output parameter. the params of the operator type
+ * @return Status if the params have not been decoded for this operator type, return INVALID_PARAM
+ */
+template <typename T>
+Status get_op_params(const std::string& op_type, const std::string& node_name, const OpParams& params,
+                     const T*& typed_params) {
+    typed_params = std::get_if<T>(&params);
+    if (!typed_params) {
+        std::ostringstream oss;
+        oss << "Node: " << op_type << "[" << node_name << "], the attributes have not been decoded";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace ir
+}    // namespace simple_ai
+
+#endif
@@ -55,12 +55,21 @@ public:
      */
     void release_buffer();
 
+    /**
+     * @brief check if the buffer is allocated and released by the tensor, otherwise it points into a buffer owned by
+     * others, e.g. a mapped model file
+     *
+     * @return true
+     * @return false
+     */
+    bool owns_buffer() const { return m_allocator != nullptr; }
+
     PrimitiveDataType data_type() const { return m_data_type; }
 
     const TensorShape& shape() const { return m_shape; }
     TensorShape& shape() { return m_shape; }
 
-    const std::string& name() { return m_name; }
+    const std::string& name() const { return m_name; }
 
     const MemoryInfo memory_info() const { return m_memory_info; }
 
@@ -69,8 +78,13 @@ public:
         return reinterpret_cast<T*>(static_cast<char*>(m_p_data) + m_byte_offset);
     }
 
+    template <typename T>
+    const T* data_as() const {
+        return reinterpret_cast<const T*>(static_cast<const char*>(m_p_data) + m_byte_offset);
+    }
+
     void* data_raw() { return static_cast<char*>(m_p_data) + m_byte_offset; }
-    const void* data_raw() const { return static_cast<char*>(m_p_data) + m_byte_offset; }
+    const void* data_raw() const { return static_cast<const char*>(m_p_data) + m_byte_offset; }
 
     std::ptrdiff_t byte_offset() const { return m_byte_offset; }
     void set_byte_offset(std::ptrdiff_t byte_offset) { m_byte_offset = byte_offset; }
@@ -79,7 +93,7 @@ public:
      * @brief Calculate the required storage room for the tensor
      *
      * @param data_type primitive data type
-     * @param shape tensor shape
+     * @param shape tensor shape, a shape without dims is a scalar of one element
      * @param size output parameter. the bytes length
      * @return Status
      */
@@ -10,9 +10,114 @@
 namespace simple_ai {
 namespace ir {
 
+/**
+ * @brief The physical memory layout of a 4-D activation tensor, or of the packed Conv weights. The dims of a
+ * TensorShape are always in the logical NCHW order, the layout only describes how the elements are arranged in
+ * memory.
+ *
+ */
+enum class DataLayout {
+    NCHW,     // the onnx default, also used by the tensors which are not 4-D
+    NHWC,     // channels last
+    NCHWc,    // channels blocked by kNCHWcBlockSize: [N, C / block, H, W, block]. C must be a multiple of block
+    HWIO,     // the Conv weights [M, C, kH, kW] packed as [kH, kW, C, M] for the NHWC convolution
+    ANY       // only used by the kernels to express that they follow the layout of their inputs
+};
+
+// the channel block size of DataLayout::NCHWc
+constexpr int64_t kNCHWcBlockSize = 8;
+
+// the value of a dim which is only known at run time
+constexpr int64_t kDynamicDim = -1;
+
+/**
+ * @brief convert the layout to string
+ *
+ * @param layout the layout
+ * @return const char*
+ */
+const char* layout_to_string(DataLayout layout);
+
+/**
+ * @brief convert the string to layout
+ *
+ * @param str the layout string
+ * @param layout output parameter. the layout
+ * @return true if the string is a valid layout
+ */
+bool string_to_layout(const std::string& str, DataLayout& layout);
+
+/**
+ * @brief The dims of a tensor shape. up to kInlineDimNum dims are stored inline, only the shapes of a higher rank
+ * fall back to the heap, so copying a shape does not allocate
+ *
+ */
+class DimVector final {
+public:
+    static constexpr size_t kInlineDimNum = 8;
+
+    DimVector() = default;
+    explicit DimVector(const std::vector<int64_t>& dims) { assign(dims.data(), dims.size()); }
+    ~DimVector();
+
+    DimVector(const DimVector& rhs);
+    DimVector(DimVector&& rhs) noexcept;
+    DimVector& operator=(const DimVector& rhs);
+    DimVector& operator=(DimVector&& rhs) noexcept;
+
+    bool operator==(const DimVector& rhs) const;
+    bool operator!=(const DimVector& rhs) const { return !(*this == rhs); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const int64_t* data() const { return m_data; }
+
+    int64_t operator[](size_t index) const { return m_data[index]; }
+    int64_t& operator[](size_t index) { return m_data[index]; }
+    int64_t front() const { return m_data[0]; }
+    int64_t back() const { return m_data[m_size - 1]; }
+
+    const int64_t* begin() const { return m_data; }
+    const int64_t* end() const { return m_data + m_size; }
+    const int64_t* cbegin() const { return m_data; }
+    const int64_t* cend() const { return m_data + m_size; }
+
+    void push_back(int64_t dim);
+
+    /**
+     * @brief change the number of dims, the new dims are 0
+     *
+     * @param num the number of dims
+     */
+    void resize(size_t num);
+
+    void assign(const int64_t* dims, size_t num);
+    void clear() { m_size = 0; }
+
+    std::vector<int64_t> to_vector() const { return std::vector<int64_t>(begin(), end()); }
+
+private:
+    /**
+     * @brief make room for `capacity` dims, move to the heap if they do not fit inline
+     */
+    void reserve(size_t capacity);
+
+    bool is_inline() const { return m_data == m_inline; }
+
+private:
+    int64_t m_inline[kInlineDimNum];
+    // points to m_inline or to the heap buffer
+    int64_t* m_data{m_inline};
+    size_t m_size{0};
+    size_t m_capacity{kInlineDimNum};
+};
+
 /**
  * @brief The tensor shape
  *
+ * A dim which is only known at run time is kDynamicDim. it may be named by a symbol, like the onnx `dim_param`, all
+ * the dynamic dims with the same symbol have the same value in a run. the shape inference keeps the symbol when a dim
+ * is passed through, the derived dims stay anonymous and are re-derived from the bound input shapes at run time.
  */
 class TensorShape final {
 public:
@@ -27,11 +132,28 @@ public:
     bool operator==(const TensorShape& rhs) const;
     bool operator!=(const TensorShape& rhs) const;
 
+    /**
+     * @brief check if the shapes can be equal at run time: the layouts and the ranks are equal, the static dims are
+     * equal, and the symbolic dims on both sides have the same symbol. an anonymous dynamic dim matches any dim
+     *
+     * @param rhs the other shape
+     * @return true
+     * @return false
+     */
+    bool is_compatible(const TensorShape& rhs) const;
+
     int64_t operator[](size_t index) const { return m_dims[index]; }
-    int64_t& operator[](size_t index) { return m_dims[index]; }
+
+    /**
+     * @brief set the dim at `index` to a static value, or to an anonymous dynamic dim
+     *
+     * @param index the dim index
+     * @param dim the dim value
+     */
+    void set_dim(size_t index, int64_t dim);
 
     size_t dims_num() const { return m_dims.size(); }
-    void set_dims_num(size_t num) { m_dims.resize(num); }
+    void set_dims_num(size_t num);
 
     /**
      * @brief check if this tensor is a scalar.
@@ -43,24 +165,88 @@ public:
      */
     bool is_scalar() const;
 
-    const std::vector<int64_t>& dims() const { return m_dims; }
-    std::vector<int64_t>& dims() { return m_dims; }
+    const DimVector& dims() const { return m_dims; }
 
-    void add_dim(int64_t dim) { m_dims.emplace_back(dim); }
-    void set_dims(const std::vector<int64_t>& dims){ m_dims = dims;}
+    void add_dim(int64_t dim);
+    void set_dims(const std::vector<int64_t>& dims);
+
+    /**
+     * @brief append a dynamic dim named by the symbol
+     *
+     * @param symbol the symbol, empty for an anonymous dynamic dim
+     */
+    void add_symbolic_dim(const std::string& symbol);
+
+    /**
+     * @brief append the dim of another shape, with its symbol
+     *
+     * @param shape the source shape
+     * @param index the dim index in the source shape
+     */
+    void add_dim(const TensorShape& shape, size_t index);
+
+    /**
+     * @brief set the dim at `index` to the dim of another shape, with its symbol
+     *
+     * @param index the dim index
+     * @param shape the source shape
+     * @param src_index the dim index in the source shape
+     */
+    void copy_dim(size_t index, const TensorShape& shape, size_t src_index);
 
     /**
-     * @brief get the elements number
+     * @brief Get the symbol of the dim
      *
-     * @return int64_t
+     * @param index the dim index
+     * @return const std::string& empty if the dim is static or anonymous
      */
-    int64_t element_num() const;
+    const std::string& symbol(size_t index) const;
+
+    /**
+     * @brief set the dim at `index` to a dynamic dim named by the symbol
+     *
+     * @param index the dim index
+     * @param symbol the symbol, empty for an anonymous dynamic dim
+     */
+    void set_symbol(size_t index, const std::string& symbol);
+
+    bool is_dynamic(size_t index) const { return m_dims[index] < 0; }
+
+    /**
+     * @brief check if all the dims are known
+     *
+     * @return true
+     * @return false
+     */
+    bool is_static() const { return m_element_num != kDynamicDim; }
+
+    DataLayout layout() const { return m_layout; }
+    void set_layout(DataLayout layout) { m_layout = layout; }
+
+    /**
+     * @brief get the elements number, it is cached when the dims change
+     *
+     * @return int64_t kDynamicDim if some dims are dynamic
+     */
+    int64_t element_num() const { return m_element_num; }
 
     std::string to_string() const;
 
+private:
+    /**
+     * @brief update the cached elements number after the dims changed
+     */
+    void update_element_num();
+
 private:
     // the dimensions
-    std::vector<int64_t> m_dims;
+    DimVector m_dims;
+    // the cached elements number, kDynamicDim if some dims are dynamic, 0 if there is no dim
+    int64_t m_element_num{0};
+    // the symbols of the dynamic dims, indexed by the dim index. empty if no dim has a symbol
+    std::vector<std::string> m_symbols;
+    // the memory layout
+    DataLayout m_layout{DataLayout::NCHW};
 };
 
 inline std::ostream& operator<<(std::ostream& out, const TensorShape& shape) { return out << shape.to_string(); }
@@ -0,0 +1,27 @@
+#ifndef _H_SIMPLE_AI_KERNELS_CPU_ADD_KERNEL_H_
+#define _H_SIMPLE_AI_KERNELS_CPU_ADD_KERNEL_H_
+
+#include "kernels/kernel.h"
+
+namespace simple_ai {
+namespace kernels {
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Add
+// https://github.com/onnx/onnx/blob/main/docs/Broadcasting.md
+class AddKernel : public IKernel {
+public:
+    virtual std::string node_type() const override;
+
+    // element-wise in any layout. in a non-default layout, the inputs must have the same shape or be a scalar
+    virtual DataLayout preferred_layout() const override;
+
+    virtual bool supports_layout(DataLayout layout) const override;
+
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) override;
+};
+
+}    // namespace kernels
+}    // namespace simple_ai
+
+#endif
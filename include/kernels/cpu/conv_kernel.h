@@ -0,0 +1,53 @@
+#ifndef _H_SIMPLE_AI_KERNELS_CPU_CONV_KERNEL_H_
+#define _H_SIMPLE_AI_KERNELS_CPU_CONV_KERNEL_H_
+
+#include "kernels/kernel.h"
+
+namespace simple_ai {
+namespace kernels {
+
+/**
+ * @brief pack the Conv weights [M, C, kH, kW] to the DataLayout::HWIO order [kH, kW, C, M] used by the NHWC
+ * convolution. `packed` must hold filters * channels * kernel_plane floats
+ *
+ * @param w the weights in the onnx order
+ * @param filters the output channels M
+ * @param channels the input channels C
+ * @param kernel_plane kH * kW
+ * @param packed the packed weights
+ */
+void pack_conv_weights_hwio(const float* w, int64_t filters, int64_t channels, int64_t kernel_plane, float* packed);
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Conv
+// 2D float convolution in NCHW or NHWC layout, NHWC is preferred. inputs: X, W, B(optional).
+// the NHWC convolution reads the weights in DataLayout::HWIO, they are packed once by the layout pass
+class ConvKernel : public IKernel {
+public:
+    virtual std::string node_type() const override;
+
+    virtual DataLayout preferred_layout() const override;
+
+    virtual bool supports_layout(DataLayout layout) const override;
+
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) override;
+};
+
+// Conv with fused epilogue. inputs: X, W, B(optional), Z(optional residual).
+// the bias, the residual Add and the activation are applied to the output tile before it is stored
+class FusedConvKernel : public IKernel {
+public:
+    virtual std::string node_type() const override;
+
+    virtual DataLayout preferred_layout() const override;
+
+    virtual bool supports_layout(DataLayout layout) const override;
+
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) override;
+};
+
+}    // namespace kernels
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _H_SIMPLE_AI_KERNELS_CPU_GEMM_KERNEL_H_
+#define _H_SIMPLE_AI_KERNELS_CPU_GEMM_KERNEL_H_
+
+#include "kernels/kernel.h"
+
+namespace simple_ai {
+namespace kernels {
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
+// float Y = alpha * A' * B' + beta * C. inputs: A, B, C(optional)
+class GemmKernel : public IKernel {
+public:
+    virtual std::string node_type() const override;
+
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) override;
+};
+
+// Gemm with fused epilogue. inputs: A, B, C(optional), Z(optional residual).
+// beta * C, the residual Add and the activation are applied in the store phase of the micro kernel
+class FusedGemmKernel : public IKernel {
+public:
+    virtual std::string node_type() const override;
+
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) override;
+};
+
+}    // namespace kernels
+}    // namespace simple_ai
+
+#endif
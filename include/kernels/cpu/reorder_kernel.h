@@ -0,0 +1,26 @@
+#ifndef _H_SIMPLE_AI_KERNELS_CPU_REORDER_KERNEL_H_
+#define _H_SIMPLE_AI_KERNELS_CPU_REORDER_KERNEL_H_
+
+#include "kernels/kernel.h"
+
+namespace simple_ai {
+namespace kernels {
+
+// convert a 4-D tensor between the NCHW, NHWC and NCHWc memory layouts. the layouts are taken from the input and
+// output tensor shapes
+class ReorderKernel : public IKernel {
+public:
+    virtual std::string node_type() const override;
+
+    virtual DataLayout preferred_layout() const override;
+
+    virtual bool supports_layout(DataLayout layout) const override;
+
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) override;
+};
+
+}    // namespace kernels
+}    // namespace simple_ai
+
+#endif
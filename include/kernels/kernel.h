@@ -0,0 +1,70 @@
+#ifndef _H_SIMPLE_AI_KERNELS_KERNEL_H_
+#define _H_SIMPLE_AI_KERNELS_KERNEL_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common.h"
+#include "ir/op_params.h"
+#include "ir/tensor.h"
+
+namespace simple_ai {
+namespace kernels {
+
+using ir::DataLayout;
+using ir::OpParams;
+using ir::Tensor;
+
+/**
+ * @brief Node compute kernel interface
+ *
+ */
+class IKernel {
+public:
+    IKernel() = default;
+    virtual ~IKernel() = default;
+
+    /**
+     * @brief Get the node type
+     *
+     * @return std::string
+     */
+    virtual std::string node_type() const = 0;
+
+    /**
+     * @brief Get the memory layout of the 4-D activation inputs this kernel runs fastest in.
+     * DataLayout::ANY means the kernel follows the layout of its inputs, e.g. the element-wise kernels
+     *
+     * @return DataLayout
+     */
+    virtual DataLayout preferred_layout() const { return DataLayout::NCHW; }
+
+    /**
+     * @brief check if the kernel can compute the 4-D activation inputs in the layout
+     *
+     * @param layout the memory layout
+     * @return true
+     * @return false
+     */
+    virtual bool supports_layout(DataLayout layout) const { return layout == DataLayout::NCHW; }
+
+    /**
+     * @brief do the computation
+     *
+     * @param node_name the node name
+     * @param params the node attributes decoded for the node type, see `ir::decode_op_params`
+     * @param inputs the node input tensors. an optional input which is absent is nullptr
+     * @param outputs input/output parameter. the node output tensors, which have been allocated with the inferred
+     * shapes
+     * @return Status
+     */
+    virtual Status compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) = 0;
+};
+
+}    // namespace kernels
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef _H_SIMPLE_AI_KERNELS_KERNEL_MANAGER_H_
+#define _H_SIMPLE_AI_KERNELS_KERNEL_MANAGER_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/common.h"
+#include "kernel.h"
+
+namespace simple_ai {
+namespace kernels {
+
+class KernelManager {
+public:
+    ~KernelManager() = default;
+    static KernelManager* instance();
+
+    /**
+     * @brief Get the kernel object
+     *
+     * @param node_type the node type
+     * @return IKernel* nullptr if the node type does not exist in the manager.
+     */
+    IKernel* get_kernel(const std::string& node_type);
+
+    /**
+     * @brief register all cpu kernels
+     *
+     */
+    void register_all_kernels();
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelManager);
+    KernelManager() = default;
+
+    template <typename T>
+    void register_kernel();
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<IKernel>> m_kernel_map;
+    std::once_flag m_init_flag;
+};
+
+}    // namespace kernels
+}    // namespace simple_ai
+
+#endif
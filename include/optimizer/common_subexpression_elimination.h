@@ -0,0 +1,52 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_COMMON_SUBEXPRESSION_ELIMINATION_H_
+#define _H_SIMPLE_AI_OPTIMIZER_COMMON_SUBEXPRESSION_ELIMINATION_H_
+
+#include <cstdint>
+
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+/**
+ * @brief The savings of the last `CommonSubexpressionEliminationPass::apply`
+ *
+ */
+struct CseStats {
+    // the duplicated nodes removed
+    size_t removed_nodes{0};
+    // the duplicated initializers removed
+    size_t removed_initializers{0};
+    // the estimated floating point operations of the removed nodes
+    int64_t saved_flops{0};
+    // the bytes of the removed initializers and node outputs
+    size_t saved_bytes{0};
+};
+
+/**
+ * @brief Merge the byte-identical initializers, then merge the nodes which have the same type, attributes and
+ * inputs, so the consumers of a duplicate read the outputs of the first equal node. Initializers which are graph
+ * inputs and nodes which produce graph outputs are kept.
+ *
+ */
+class CommonSubexpressionEliminationPass : public IGraphPass {
+public:
+    virtual std::string name() const override;
+
+    virtual Status apply(Graph& graph, bool& modified) override;
+
+    /**
+     * @brief Get the savings of the last apply
+     *
+     * @return const CseStats&
+     */
+    const CseStats& stats() const { return m_stats; }
+
+private:
+    CseStats m_stats;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
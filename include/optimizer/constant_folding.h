@@ -0,0 +1,26 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_CONSTANT_FOLDING_H_
+#define _H_SIMPLE_AI_OPTIMIZER_CONSTANT_FOLDING_H_
+
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+/**
+ * @brief Evaluate the nodes whose inputs are all constant initializers once with the cpu kernels, and replace
+ * their outputs with new initializers. The folding is propagated in topological order, so a whole
+ * initializer-only subgraph is folded in one run. Initializers which are also graph inputs can be overridden
+ * by the user and are not treated as constants.
+ *
+ */
+class ConstantFoldingPass : public IGraphPass {
+public:
+    virtual std::string name() const override;
+
+    virtual Status apply(Graph& graph, bool& modified) override;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
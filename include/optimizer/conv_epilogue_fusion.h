@@ -0,0 +1,31 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_CONV_EPILOGUE_FUSION_H_
+#define _H_SIMPLE_AI_OPTIMIZER_CONV_EPILOGUE_FUSION_H_
+
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+/**
+ * @brief Fuse the element-wise consumers of Conv into a FusedConv node, whose kernel applies them to the output
+ * tile before storing it. The supported patterns are:
+ *
+ * Conv -> Add(per-channel initializer) as the bias, when the Conv has no bias
+ * Conv -> Add(same shape tensor) as the residual
+ * Conv -> Relu as the activation
+ *
+ * and their combination in the above order, e.g. Conv -> Add -> Relu at the end of a ResNet block.
+ * Only the node output which has a single consumer and is not a graph output is fused.
+ *
+ */
+class ConvEpilogueFusionPass : public IGraphPass {
+public:
+    virtual std::string name() const override;
+
+    virtual Status apply(Graph& graph, bool& modified) override;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_DEAD_NODE_ELIMINATION_H_
+#define _H_SIMPLE_AI_OPTIMIZER_DEAD_NODE_ELIMINATION_H_
+
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+/**
+ * @brief Remove the nodes whose outputs never reach a graph output. The initializers and node args used only by
+ * the removed nodes are cleaned up when the topology is rebuilt.
+ *
+ */
+class DeadNodeEliminationPass : public IGraphPass {
+public:
+    virtual std::string name() const override;
+
+    virtual Status apply(Graph& graph, bool& modified) override;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_GEMM_EPILOGUE_FUSION_H_
+#define _H_SIMPLE_AI_OPTIMIZER_GEMM_EPILOGUE_FUSION_H_
+
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+/**
+ * @brief Fuse the element-wise consumers of Gemm into a FusedGemm node, whose micro kernel applies them in the
+ * store phase. The supported patterns are:
+ *
+ * Gemm -> Add(initializer broadcastable as the matrix C) as beta * C, when the Gemm has no C
+ * Gemm -> Add(same shape tensor) as the residual
+ * Gemm -> Relu as the activation
+ *
+ * and their combination in the above order, e.g. Gemm -> Add -> Relu in MLPs and classifier heads.
+ * Only the node output which has a single consumer and is not a graph output is fused.
+ *
+ */
+class GemmEpilogueFusionPass : public IGraphPass {
+public:
+    virtual std::string name() const override;
+
+    virtual Status apply(Graph& graph, bool& modified) override;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
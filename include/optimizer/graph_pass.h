@@ -0,0 +1,46 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_GRAPH_PASS_H_
+#define _H_SIMPLE_AI_OPTIMIZER_GRAPH_PASS_H_
+
+#include <string>
+
+#include "common/common.h"
+#include "ir/graph.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::Graph;
+
+/**
+ * @brief Graph optimization pass interface.
+ * A pass rewrites the graph in place, and leaves the graph in a consistent state (topology constructed) when it
+ * returns. the local rewrites are committed with `ir::GraphTransaction`, the passes which change the graph inputs or
+ * initializers construct the topology again.
+ *
+ */
+class IGraphPass {
+public:
+    IGraphPass() = default;
+    virtual ~IGraphPass() = default;
+
+    /**
+     * @brief Get the pass name
+     *
+     * @return std::string
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief apply the pass to the graph
+     *
+     * @param graph the graph whose topology has been constructed
+     * @param modified output parameter. true if the graph is rewritten
+     * @return Status
+     */
+    virtual Status apply(Graph& graph, bool& modified) = 0;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
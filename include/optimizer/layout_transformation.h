@@ -0,0 +1,28 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_LAYOUT_TRANSFORMATION_H_
+#define _H_SIMPLE_AI_OPTIMIZER_LAYOUT_TRANSFORMATION_H_
+
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+/**
+ * @brief Choose the memory layout of the 4-D activations from the registered kernels. A node whose kernel prefers
+ * a layout (e.g. Conv prefers NHWC) starts a region in that layout, the nodes whose kernels follow their inputs
+ * (Relu, Add) stay in the region, and the other nodes run in NCHW. Reorder nodes are inserted only where a tensor
+ * crosses a region boundary, each tensor is converted at most once per layout, and the graph inputs and outputs
+ * keep the NCHW layout. The weights of the NHWC Conv nodes are packed once into new DataLayout::HWIO initializers.
+ * Finally the adjacent inverse Reorder pairs are cancelled.
+ *
+ */
+class LayoutTransformationPass : public IGraphPass {
+public:
+    virtual std::string name() const override;
+
+    virtual Status apply(Graph& graph, bool& modified) override;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_PASS_MANAGER_H_
+#define _H_SIMPLE_AI_OPTIMIZER_PASS_MANAGER_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common.h"
+#include "graph_pass.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+// the environment variable which disables passes: a comma separated list of pass names, or "*" for all passes
+constexpr const char* kDisabledPassesEnv = "SIMPLE_AI_DISABLED_PASSES";
+
+// the built-in pipelines
+constexpr const char* kNonePipeline = "none";            // no pass
+constexpr const char* kBasicPipeline = "basic";          // constant folding, CSE and dead node elimination
+constexpr const char* kExtendedPipeline = "extended";    // basic and the epilogue fusions
+constexpr const char* kAllPipeline = "all";              // extended and the layout transformation
+
+/**
+ * @brief The statistics of a pass, accumulated over the fixed-point iterations
+ *
+ */
+struct PassStats {
+    std::string name;
+    // the number of times the pass has run
+    size_t runs{0};
+    // the number of runs which modified the graph
+    size_t modified_runs{0};
+    double time_ms{0.0};
+    size_t nodes_removed{0};
+    size_t nodes_added{0};
+    // the bytes of the initializers and the node outputs before the pass minus those after it. may be negative
+    int64_t bytes_saved{0};
+};
+
+/**
+ * @brief The report of the last `PassManager::run`
+ *
+ */
+struct PassManagerReport {
+    std::string pipeline;
+    // the number of times the whole pipeline has run
+    size_t iterations{0};
+    bool converged{false};
+    double total_time_ms{0.0};
+    // in pipeline order, the disabled passes are not included
+    std::vector<PassStats> passes;
+
+    std::string to_string() const;
+};
+
+/**
+ * @brief Run named pipelines of graph passes until the graph does not change anymore
+ *
+ */
+class PassManager {
+public:
+    /**
+     * @brief Constructor. the built-in passes and pipelines are registered
+     *
+     */
+    PassManager();
+    ~PassManager() = default;
+
+    /**
+     * @brief register a pass, which can be referenced by its name in the pipelines
+     *
+     * @param pass the pass
+     * @return Status fail if a pass with the same name has been registered
+     */
+    Status register_pass(std::unique_ptr<IGraphPass>&& pass);
+
+    /**
+     * @brief add or replace a pipeline
+     *
+     * @param name the pipeline name
+     * @param pass_names the passes in running order
+     * @return Status fail if a pass is not registered
+     */
+    Status add_pipeline(const std::string& name, const std::vector<std::string>& pass_names);
+
+    /**
+     * @brief enable or disable a pass. "*" means all passes
+     *
+     * @param name the pass name
+     * @param enabled whether the pass runs
+     */
+    void set_pass_enabled(const std::string& name, bool enabled);
+
+    /**
+     * @brief disable the passes listed in the environment variable `kDisabledPassesEnv`
+     *
+     */
+    void disable_passes_from_env();
+
+    /**
+     * @brief check if the pass runs
+     *
+     * @param name the pass name
+     * @return true
+     * @return false
+     */
+    bool is_pass_enabled(const std::string& name) const;
+
+    /**
+     * @brief Set the max number of iterations of a pipeline
+     *
+     * @param max_iterations the max iterations, at least 1
+     */
+    void set_max_iterations(size_t max_iterations);
+
+    /**
+     * @brief run the pipeline repeatedly until no pass modifies the graph or the max iterations are reached
+     *
+     * @param pipeline the pipeline name
+     * @param graph the graph whose topology has been constructed
+     * @return Status
+     */
+    Status run(const std::string& pipeline, Graph& graph);
+
+    /**
+     * @brief Get the report of the last run
+     *
+     * @return const PassManagerReport&
+     */
+    const PassManagerReport& report() const { return m_report; }
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PassManager);
+
+private:
+    // the registered passes. key: the pass name
+    std::unordered_map<std::string, std::unique_ptr<IGraphPass>> m_passes;
+    // the pipelines. key: the pipeline name, value: the pass names
+    std::unordered_map<std::string, std::vector<std::string>> m_pipelines;
+
+    std::unordered_set<std::string> m_disabled_passes;
+    bool m_all_disabled{false};
+    size_t m_max_iterations{5};
+
+    PassManagerReport m_report;
+};
+
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
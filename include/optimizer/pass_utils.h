@@ -0,0 +1,66 @@
+#ifndef _H_SIMPLE_AI_OPTIMIZER_PASS_UTILS_H_
+#define _H_SIMPLE_AI_OPTIMIZER_PASS_UTILS_H_
+
+#include <string>
+
+#include "ir/graph.h"
+#include "ir/graph_transaction.h"
+#include "ir/node.h"
+
+namespace simple_ai {
+namespace optimizer {
+namespace utils {
+
+/**
+ * @brief Get the single consumer of the node's only output
+ *
+ * @param transaction the graph transaction of the current pass, whose erased nodes are skipped
+ * @param node the producer node
+ * @return ir::Node* nullptr if the output is a graph output, or it has none or more than one consumers
+ */
+ir::Node* single_consumer(const ir::GraphTransaction& transaction, const ir::Node* node);
+
+/**
+ * @brief Get the other input of a binary node
+ *
+ * @param node the binary node
+ * @param input one of the node inputs
+ * @return ir::NodeArg* nullptr if the node is not binary
+ */
+ir::NodeArg* other_input(const ir::Node* node, const ir::NodeArg* input);
+
+/**
+ * @brief Set a string attribute on the node in the transaction
+ *
+ * @param transaction the graph transaction
+ * @param node the node
+ * @param name the attribute name
+ * @param value the attribute value
+ */
+void set_string_attr(ir::GraphTransaction& transaction, ir::Node* node, const std::string& name,
+                     const std::string& value);
+
+/**
+ * @brief Set a float attribute on the node in the transaction
+ *
+ * @param transaction the graph transaction
+ * @param node the node
+ * @param name the attribute name
+ * @param value the attribute value
+ */
+void set_float_attr(ir::GraphTransaction& transaction, ir::Node* node, const std::string& name, float value);
+
+/**
+ * @brief Estimate the floating point operations of the node from its inferred shapes. A multiply-add counts as two
+ * operations, the other nodes count one operation per output element
+ *
+ * @param node the node
+ * @return int64_t 0 if the shapes are unknown
+ */
+int64_t estimate_flops(const ir::Node* node);
+
+}    // namespace utils
+}    // namespace optimizer
+}    // namespace simple_ai
+
+#endif
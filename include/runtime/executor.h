@@ -0,0 +1,211 @@
+#ifndef _H_SIMPLE_AI_RUNTIME_EXECUTOR_H_
+#define _H_SIMPLE_AI_RUNTIME_EXECUTOR_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common.h"
+#include "ir/graph.h"
+#include "kernels/kernel.h"
+#include "run_options.h"
+
+using namespace simple_ai::common;
+
+namespace simple_ai {
+namespace runtime {
+
+using ir::Graph;
+using ir::Node;
+using ir::NodeArg;
+using ir::Tensor;
+
+using TensorFeeds = std::unordered_map<std::string, const Tensor*>;
+using TensorFetches = std::unordered_map<std::string, std::unique_ptr<Tensor>>;
+// the dims of the graph inputs, key: the input name
+using InputShapes = std::unordered_map<std::string, std::vector<int64_t>>;
+
+// the default number of input shapes whose bindings are kept by an executor
+constexpr size_t kDefaultShapeCacheCapacity = 8;
+
+/**
+ * @brief The counters of the shape binding cache of an executor
+ *
+ */
+struct ShapeCacheStats {
+    // the runs whose input shapes were bound already
+    size_t hits{0};
+    // the runs and preparations which bound new input shapes
+    size_t misses{0};
+    // the bindings dropped as the least recently used
+    size_t evictions{0};
+};
+
+/**
+ * @brief Run the graph node by node with the cpu kernels. The graph topology must be constructed and must not be
+ * changed during the executor lifetime. The node outputs which are not fetched are freed after their last consumer
+ * has run.
+ *
+ * If some graph inputs have dynamic dims, the shapes of the fed inputs are bound to them and all the node output
+ * shapes are re-derived in one pass before the run. the bindings of the recently used input shapes are kept in a
+ * bounded LRU cache, a run whose input shapes are cached skips the pass.
+ */
+class Executor {
+public:
+    /**
+     * @brief Constructor, the nodes run in the topological order of the graph
+     *
+     * @param graph the graph
+     */
+    explicit Executor(const Graph& graph);
+
+    /**
+     * @brief Constructor
+     *
+     * @param graph the graph
+     * @param execution_order all the graph nodes in a valid topological order
+     * @param shape_cache_capacity the number of input shapes whose bindings are kept, 0 binds on every run
+     */
+    Executor(const Graph& graph, const std::vector<Node*>& execution_order,
+             size_t shape_cache_capacity = kDefaultShapeCacheCapacity);
+    ~Executor() = default;
+
+    /**
+     * @brief run the graph
+     *
+     * @param run_options the run options
+     * @param feeds the graph input tensors, key: the input name
+     * @param fetches output parameter. the requested output tensors, key: the output name
+     * @return Status
+     */
+    Status run(const RunOptions& run_options, const TensorFeeds& feeds, TensorFetches& fetches);
+
+    /**
+     * @brief Get the nodes which are needed to compute the outputs, in execution order. The result is cached per
+     * output set.
+     *
+     * @param output_names the graph output names. empty means all graph outputs
+     * @param nodes output parameter. the execution nodes, valid during the executor lifetime
+     * @return Status
+     */
+    Status get_execution_nodes(const std::vector<std::string>& output_names, const std::vector<Node*>*& nodes);
+
+    /**
+     * @brief bind the input shapes ahead of the runs, so that the first run of these shapes hits the cache. the
+     * graph inputs which are not listed keep their declared shapes
+     *
+     * @param input_shapes the dims of the graph inputs
+     * @return Status
+     */
+    Status prepare_shapes(const InputShapes& input_shapes);
+
+    /**
+     * @brief Get the counters of the shape binding cache
+     *
+     * @return ShapeCacheStats
+     */
+    ShapeCacheStats shape_cache_stats() const;
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Executor);
+
+    /**
+     * @brief The nodes to run for an output set, their kernels, and the node outputs to free after each node
+     */
+    struct ExecutionPlan {
+        std::vector<Node*> nodes;
+        std::vector<kernels::IKernel*> kernels;
+        std::vector<std::vector<std::string>> release_names;
+    };
+
+    /**
+     * @brief The node args with the shapes bound to the input shapes of a run
+     */
+    struct ShapeBinding {
+        // the shapes of the graph inputs, in the order of `Graph::get_inputs()`. the declared shape if not fed
+        std::vector<ir::TensorShape> input_shapes;
+        // the copies of the graph node args, indexed by the node arg id
+        std::vector<NodeArg> args;
+    };
+
+    /**
+     * @brief check the fed tensors against the graph inputs and the initializers they replace, before any kernel
+     * trusts their shapes. the data types must match, and the dims too unless the graph input has dynamic dims,
+     * whose fed dims are checked when the shapes are bound
+     *
+     * @param feeds the fed tensors
+     * @return Status if a fed tensor mismatches, return INVALID_PARAM
+     */
+    Status check_feeds(const TensorFeeds& feeds) const;
+
+    /**
+     * @brief get the cached binding of the input shapes, bind them if they are not cached
+     *
+     * @param input_shapes the shapes of the graph inputs, in the order of `Graph::get_inputs()`
+     * @param binding output parameter. the binding, kept alive by the pointer during the run
+     * @return Status
+     */
+    Status bind_shapes(const std::vector<const ir::TensorShape*>& input_shapes,
+                       std::shared_ptr<const ShapeBinding>& binding);
+
+    /**
+     * @brief find the binding of the input shapes in the cache and mark it as the most recently used, m_mutex must
+     * be held
+     *
+     * @param input_shapes the shapes of the graph inputs, in the order of `Graph::get_inputs()`
+     * @return std::shared_ptr<const ShapeBinding> nullptr if the shapes are not cached
+     */
+    std::shared_ptr<const ShapeBinding> find_shape_binding(const std::vector<const ir::TensorShape*>& input_shapes);
+
+    /**
+     * @brief bind the fed input shapes to the graph inputs and infer the shapes of all the node outputs
+     *
+     * @param input_shapes the shapes of the graph inputs, in the order of `Graph::get_inputs()`
+     * @param binding output parameter. the binding
+     * @return Status if the input shapes do not match the graph inputs, return INVALID_PARAM
+     */
+    Status create_shape_binding(const std::vector<ir::TensorShape>& input_shapes, ShapeBinding& binding) const;
+
+    /**
+     * @brief get the cached plan of the outputs, create it if it does not exist
+     *
+     * @param output_names the graph output names. empty means all graph outputs
+     * @param plan output parameter. the execution plan, valid during the executor lifetime
+     * @return Status
+     */
+    Status get_execution_plan(const std::vector<std::string>& output_names, const ExecutionPlan*& plan);
+
+    /**
+     * @brief compute the ancestor cone of the outputs and when their intermediate outputs can be freed
+     *
+     * @param output_names the sorted graph output names
+     * @param plan output parameter. the execution plan
+     * @return Status
+     */
+    Status create_execution_plan(const std::vector<std::string>& output_names, ExecutionPlan& plan) const;
+
+private:
+    const Graph& m_graph;
+    // all the graph nodes in execution order
+    std::vector<Node*> m_execution_order;
+
+    // execution plan cache. key: the sorted output names
+    std::map<std::vector<std::string>, ExecutionPlan> m_execution_plan_cache;
+    mutable std::mutex m_mutex;
+
+    // whether some graph inputs have dynamic dims. if not, the shapes of the graph node args are used directly
+    bool m_dynamic_shapes{false};
+    // the shape bindings cache, the most recently used first. guarded by m_mutex
+    std::list<std::shared_ptr<const ShapeBinding>> m_shape_bindings;
+    size_t m_shape_cache_capacity;
+    ShapeCacheStats m_shape_cache_stats;
+};
+
+}    // namespace runtime
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef _H_SIMPLE_AI_RUNTIME_MODEL_CACHE_H_
+#define _H_SIMPLE_AI_RUNTIME_MODEL_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/common.h"
+#include "ir/model.h"
+#include "session_options.h"
+
+namespace simple_ai {
+namespace runtime {
+
+/**
+ * @brief The on-disk cache of the precompiled models, see `io::NativeSerializer`. An entry is keyed by the content
+ * hash of the onnx file, the cpu isa, the format version and the session options which change the compiled graph,
+ * so a new entry is compiled whenever one of them changes. The stale entries are left in the directory.
+ *
+ * the content hash of an onnx file is kept in a stamp next to the entries with the file size and modification time,
+ * the file is hashed again only if one of them changes.
+ *
+ * the external data files of the onnx model are not hashed, a model whose external weights are rewritten in place
+ * needs a new cache directory
+ */
+class ModelCache final {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param cache_dir the cache directory, it is created on the first save
+     */
+    explicit ModelCache(const std::string& cache_dir) : m_cache_dir(cache_dir) {}
+    ~ModelCache() = default;
+
+    /**
+     * @brief get the path of the cache entry of the onnx model compiled with the options, it may not exist
+     *
+     * @param model_path the onnx model file path
+     * @param options the session options
+     * @param entry_path output parameter. the cache entry path
+     * @return Status if the onnx model can not be read, return FILE_NOT_FOUND
+     */
+    Status get_entry_path(const std::string& model_path, const SessionOptions& options,
+                          std::string& entry_path) const;
+
+    /**
+     * @brief save the compiled model as the cache entry. the entry is written aside and renamed, so the concurrent
+     * sessions never read a partial entry
+     *
+     * @param entry_path the cache entry path
+     * @param model the compiled model
+     * @param execution_order all the graph nodes in the execution order
+     * @return Status
+     */
+    Status save(const std::string& entry_path, const ir::Model& model,
+                const std::vector<ir::Node*>& execution_order) const;
+
+    /**
+     * @brief Get the name of the cpu architecture and of the vector extensions it supports
+     *
+     * @return std::string
+     */
+    static std::string cpu_isa();
+
+    /**
+     * @brief hash the content of a file, it is read by chunks
+     *
+     * @param file_path the file path
+     * @param hash output parameter. the 64-bit hash
+     * @return Status
+     */
+    static Status hash_file(const std::string& file_path, uint64_t& hash);
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ModelCache);
+
+    /**
+     * @brief get the content hash of the onnx model from its stamp, hash the file and write the stamp if the stamp
+     * is missing or stale
+     *
+     * @param model_path the onnx model file path
+     * @param hash output parameter. the content hash
+     * @return Status
+     */
+    Status get_model_hash(const std::string& model_path, uint64_t& hash) const;
+
+private:
+    std::string m_cache_dir;
+};
+
+}    // namespace runtime
+}    // namespace simple_ai
+
+#endif
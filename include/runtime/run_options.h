@@ -0,0 +1,22 @@
+#ifndef _H_SIMPLE_AI_RUNTIME_RUN_OPTIONS_H_
+#define _H_SIMPLE_AI_RUNTIME_RUN_OPTIONS_H_
+
+#include <string>
+#include <vector>
+
+namespace simple_ai {
+namespace runtime {
+
+/**
+ * @brief The options of a single run
+ *
+ */
+struct RunOptions {
+    // the graph outputs to compute. empty means all graph outputs. only the nodes these outputs depend on are run
+    std::vector<std::string> output_names;
+};
+
+}    // namespace runtime
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef _H_SIMPLE_AI_RUNTIME_SCHEDULER_H_
+#define _H_SIMPLE_AI_RUNTIME_SCHEDULER_H_
+
+#include <vector>
+
+#include "common/common.h"
+#include "ir/graph.h"
+
+using namespace simple_ai::common;
+
+namespace simple_ai {
+namespace runtime {
+
+/**
+ * @brief The node execution order
+ *
+ */
+enum class ExecutionOrder {
+    DEFAULT,            // the topological order of the graph
+    MEMORY_EFFICIENT    // a topological order which reduces the peak bytes of the live node outputs
+};
+
+/**
+ * @brief Get the node execution order of the graph
+ *
+ * @param graph the graph whose topology has been constructed
+ * @param order the order kind
+ * @param nodes output parameter. the nodes in execution order
+ * @return Status
+ */
+Status get_execution_order(const ir::Graph& graph, ExecutionOrder order, std::vector<ir::Node*>& nodes);
+
+/**
+ * @brief Calculate the peak bytes of the live node outputs when the nodes run in the order. A node output is
+ * allocated before its producer runs and freed after its last consumer has run, the graph outputs are kept to the
+ * end. The graph inputs and the initializers are not counted
+ *
+ * @param graph the graph whose topology has been constructed
+ * @param nodes the nodes in execution order
+ * @param peak_bytes output parameter. the peak bytes
+ * @return Status
+ */
+Status calc_peak_memory(const ir::Graph& graph, const std::vector<ir::Node*>& nodes, size_t& peak_bytes);
+
+}    // namespace runtime
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef _H_SIMPLE_AI_RUNTIME_SESSION_H_
+#define _H_SIMPLE_AI_RUNTIME_SESSION_H_
+
+#include <memory>
+#include <string>
+
+#include "common/common.h"
+#include "executor.h"
+#include "ir/model.h"
+#include "optimizer/pass_manager.h"
+#include "run_options.h"
+#include "session_options.h"
+
+namespace simple_ai {
+namespace runtime {
+
+using ir::Model;
+
+/**
+ * @brief The peak bytes of the live node outputs for a run of all the graph outputs, see `calc_peak_memory`
+ *
+ */
+struct MemoryReport {
+    // in the default topological order
+    size_t default_peak_bytes{0};
+    // in the memory efficient order
+    size_t memory_efficient_peak_bytes{0};
+};
+
+/**
+ * @brief Inference session, which prepares a loaded model and runs it
+ *
+ */
+class InferenceSession {
+public:
+    explicit InferenceSession(const SessionOptions& options = SessionOptions());
+    ~InferenceSession() = default;
+
+    /**
+     * @brief prepare the model to run: construct the graph topology, run the optimization pipeline and decide the
+     * execution order
+     *
+     * @param model the model whose graph has been initialized
+     * @return Status
+     */
+    Status load(const std::shared_ptr<Model>& model);
+
+    /**
+     * @brief load the onnx model file and prepare it to run. if the session options have a model cache directory, the
+     * precompiled entry of the model is loaded instead if it exists, otherwise it is saved after the preparation. a
+     * broken entry is compiled again
+     *
+     * @param model_path the onnx model file path
+     * @return Status
+     */
+    Status load(const std::string& model_path);
+
+    /**
+     * @brief run the model
+     *
+     * @param run_options the run options
+     * @param feeds the graph input tensors, key: the input name
+     * @param fetches output parameter. the requested output tensors, key: the output name
+     * @return Status
+     */
+    Status run(const RunOptions& run_options, const TensorFeeds& feeds, TensorFetches& fetches);
+
+    /**
+     * @brief Get the counters of the executor shape binding cache, the prewarmed shapes are counted as misses
+     *
+     * @return ShapeCacheStats
+     */
+    ShapeCacheStats shape_cache_stats() const;
+
+    /**
+     * @brief Get the peak memory of both execution orders, available after `load`. empty if the model is loaded
+     * from the model cache, the execution order is not scheduled again
+     *
+     * @return const MemoryReport&
+     */
+    const MemoryReport& memory_report() const { return m_memory_report; }
+
+    /**
+     * @brief Get the report of the optimization pipeline, available after `load`. empty if the model is loaded from
+     * the model cache
+     *
+     * @return const optimizer::PassManagerReport&
+     */
+    const optimizer::PassManagerReport& optimization_report() const { return m_optimization_report; }
+
+    /**
+     * @brief Get the nodes in the execution order selected by the session options, available after `load`
+     *
+     * @return const std::vector<Node*>&
+     */
+    const std::vector<Node*>& execution_order() const { return m_execution_order; }
+
+    /**
+     * @brief check if the model is loaded from the model cache by the last `load`
+     *
+     * @return true
+     * @return false
+     */
+    bool loaded_from_cache() const { return m_loaded_from_cache; }
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSession);
+
+    /**
+     * @brief create the executor of the prepared model. the order is scheduled and the memory report is calculated
+     * only if no order is given
+     *
+     * @param model the model whose graph topology has been constructed
+     * @param execution_order the valid precompiled order of the nodes, empty to select the order by the session
+     * options
+     * @return Status
+     */
+    Status create_executor(const std::shared_ptr<Model>& model, std::vector<Node*>&& execution_order);
+
+    /**
+     * @brief load the model from the precompiled cache entry, its graph is optimized already. the entry whose
+     * execution order is not a topological order of the graph is rejected
+     *
+     * @param entry_path the cache entry path
+     * @return Status
+     */
+    Status load_cached(const std::string& entry_path);
+
+    /**
+     * @brief read the onnx model file, its initializers are decoded on `SessionOptions::load_threads` threads
+     *
+     * @param model_path the onnx model file path
+     * @param model output parameter. the loaded model
+     * @return Status
+     */
+    Status read_onnx_file(const std::string& model_path, std::shared_ptr<Model>& model) const;
+
+private:
+    SessionOptions m_options;
+    std::shared_ptr<Model> m_model;
+    std::vector<Node*> m_execution_order;
+    MemoryReport m_memory_report;
+    optimizer::PassManagerReport m_optimization_report;
+    std::unique_ptr<Executor> m_executor;
+    bool m_loaded_from_cache{false};
+};
+
+}    // namespace runtime
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef _H_SIMPLE_AI_RUNTIME_SESSION_OPTIONS_H_
+#define _H_SIMPLE_AI_RUNTIME_SESSION_OPTIONS_H_
+
+#include <string>
+#include <vector>
+
+#include "executor.h"
+#include "optimizer/pass_manager.h"
+#include "scheduler.h"
+
+namespace simple_ai {
+namespace runtime {
+
+/**
+ * @brief The options of an inference session
+ *
+ */
+struct SessionOptions {
+    // the node execution order
+    ExecutionOrder execution_order{ExecutionOrder::DEFAULT};
+
+    // the graph optimization pipeline run on load, see `optimizer::PassManager`
+    std::string optimization_pipeline{optimizer::kBasicPipeline};
+    // the passes which do not run. the passes listed in the environment variable `optimizer::kDisabledPassesEnv`
+    // do not run either
+    std::vector<std::string> disabled_passes;
+
+    // the number of input shapes whose bindings are kept by the executor, see `Executor`
+    size_t shape_cache_capacity{kDefaultShapeCacheCapacity};
+    // the input shapes bound on load, so that their first runs hit the cache. the later ones are kept if there are
+    // more shapes than the cache capacity
+    std::vector<InputShapes> prewarm_input_shapes;
+
+    // the number of threads which decode the initializers of an onnx file on load, the loading thread included. 0
+    // uses the hardware concurrency, 1 decodes them on the loading thread
+    int load_threads{0};
+
+    // the directory of the precompiled models, see `ModelCache`. the sessions which load an onnx file compile it once
+    // and load the cached entry afterwards. empty disables the cache
+    std::string model_cache_dir;
+};
+
+}    // namespace runtime
+}    // namespace simple_ai
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _H_SIMPLE_AI_UTILS_THREAD_POOL_SIMPLE_THREAD_POOL_H_
+#define _H_SIMPLE_AI_UTILS_THREAD_POOL_SIMPLE_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace simple_ai {
+namespace utils {
+namespace thread_pool {
+
+/**
+ * @brief A fixed size thread pool, the jobs are run in the order they are scheduled
+ */
+class SimpleThreadPool final : public IThreadPool {
+public:
+    /**
+     * @brief Constructor, the threads are started at once
+     *
+     * @param num_threads the number of threads, at least one
+     */
+    explicit SimpleThreadPool(int num_threads);
+
+    /**
+     * @brief the jobs which have not started are dropped, the running ones are waited for
+     */
+    ~SimpleThreadPool() override;
+
+    void schedule(std::function<void()> run) override;
+
+    void cancel() override;
+
+    int num_threads() const override { return static_cast<int>(m_threads.size()); }
+
+    int current_thead_index() const override;
+
+private:
+    SIMPLE_AI_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SimpleThreadPool);
+
+    /**
+     * @brief the loop of a pool thread
+     *
+     * @param index the thread index
+     */
+    void run(int index);
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::deque<std::function<void()>> m_jobs;
+    bool m_stopping{false};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condi;
+};
+
+/**
+ * @brief run `func` for each index in [0, count) and wait for all of them. the calling thread takes indices too, so it
+ * never blocks on a pool which is busy, and a nullptr pool runs all the indices on the calling thread. the indices
+ * are taken in an unspecified order, `func` must only write to the outputs of its index
+ *
+ * @param thread_pool the thread pool, nullptr runs on the calling thread
+ * @param count the number of indices
+ * @param func the function of an index
+ */
+void parallel_for(IThreadPool* thread_pool, size_t count, const std::function<void(size_t)>& func);
+
+}    // namespace thread_pool
+}    // namespace utils
+}    // namespace simple_ai
+
+#endif
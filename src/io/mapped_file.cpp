@@ -0,0 +1,91 @@
+#include "io/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+using namespace simple_ai::common;
+
+namespace simple_ai {
+namespace io {
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        munmap(m_data, m_size);
+    }
+}
+
+Status MappedFile::map(const std::string& file_path, std::shared_ptr<MappedFile>& mapped_file) {
+    int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Status(StatusCode::FILE_NOT_FOUND, "Open file failed: " + file_path + ", " + std::strerror(errno));
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(fd);
+        return Status(StatusCode::INVALID_PARAM, "Empty or unreadable file: " + file_path);
+    }
+
+    size_t size = static_cast<size_t>(file_stat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // the mapping keeps a reference to the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::ostringstream oss;
+        oss << "Map file failed: " << file_path << ", size: " << size << ", " << std::strerror(errno);
+        return Status(StatusCode::OUT_OF_MEMORY, oss.str());
+    }
+
+    mapped_file.reset(new MappedFile(static_cast<char*>(data), size, false));
+    return Status::ok();
+}
+
+Status MappedFile::allocate(size_t size, std::shared_ptr<MappedFile>& mapped_file) {
+    if (size == 0) {
+        return Status(StatusCode::INVALID_PARAM, "Map anonymous memory failed, empty size");
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        std::ostringstream oss;
+        oss << "Map anonymous memory failed, size: " << size << ", " << std::strerror(errno);
+        return Status(StatusCode::OUT_OF_MEMORY, oss.str());
+    }
+
+    // only a hint, the small pages are used if the huge pages are disabled
+    madvise(data, size, MADV_HUGEPAGE);
+    mapped_file.reset(new MappedFile(static_cast<char*>(data), size, true));
+    return Status::ok();
+}
+
+void MappedFile::release_pages(const char* data, size_t size) {
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page_size - 1) / page_size * page_size;
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size) / page_size * page_size;
+    if (m_anonymous || data < m_data || data + size > m_data + m_size || begin >= end) {
+        return;
+    }
+
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+}
+
+void MappedFile::prefetch(const char* data, size_t size) {
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = reinterpret_cast<uintptr_t>(data) / page_size * page_size;
+    uintptr_t end = reinterpret_cast<uintptr_t>(data) + size;
+    if (data < m_data || data + size > m_data + m_size || size == 0) {
+        return;
+    }
+
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+}    // namespace io
+}    // namespace simple_ai
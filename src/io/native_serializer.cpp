@@ -0,0 +1,663 @@
+#include "io/native_serializer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include "framework/allocator_manager.h"
+#include "io/mapped_file.h"
+
+using namespace simple_ai::common;
+using namespace simple_ai::ir;
+using namespace simple_ai::framework;
+
+namespace simple_ai {
+namespace io {
+
+namespace {
+
+/**
+ * @brief The header at the begin of a precompiled model file
+ */
+struct NativeModelHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t graph_offset;
+    uint64_t graph_size;
+    uint64_t weights_offset;
+    uint64_t weights_size;
+};
+
+size_t align_up(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+/**
+ * @brief An encoder of the graph section
+ */
+class ByteWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only the trivially copyable values are encoded as is");
+        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put_string(const std::string& str) {
+        put<uint32_t>(static_cast<uint32_t>(str.size()));
+        m_data.append(str);
+    }
+
+    void put_bytes(const void* data, size_t size) {
+        put<uint64_t>(size);
+        m_data.append(static_cast<const char*>(data), size);
+    }
+
+    void put_shape(const TensorShape& shape) {
+        put<int32_t>(static_cast<int32_t>(shape.layout()));
+        put<uint32_t>(static_cast<uint32_t>(shape.dims_num()));
+        for (size_t i = 0; i < shape.dims_num(); ++i) {
+            put<int64_t>(shape[i]);
+            if (shape.is_dynamic(i)) {
+                put_string(shape.symbol(i));
+            }
+        }
+    }
+
+    const std::string& data() const { return m_data; }
+
+private:
+    std::string m_data;
+};
+
+/**
+ * @brief A decoder of the graph section, every read fails once the section is exhausted
+ */
+class ByteReader {
+public:
+    ByteReader(const char* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(m_end - m_pos) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string& str) {
+        uint32_t size = 0;
+        if (!get(size) || static_cast<size_t>(m_end - m_pos) < size) {
+            return false;
+        }
+        str.assign(m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    bool get_bytes(const char*& data, size_t& size) {
+        uint64_t length = 0;
+        if (!get(length) || static_cast<uint64_t>(m_end - m_pos) < length) {
+            return false;
+        }
+        data = m_pos;
+        size = static_cast<size_t>(length);
+        m_pos += size;
+        return true;
+    }
+
+    bool get_shape(TensorShape& shape) {
+        int32_t layout = 0;
+        uint32_t dims_num = 0;
+        if (!get(layout) || !get(dims_num) || layout < 0 || layout > static_cast<int32_t>(DataLayout::ANY)) {
+            return false;
+        }
+
+        shape = TensorShape();
+        for (uint32_t i = 0; i < dims_num; ++i) {
+            int64_t dim = 0;
+            if (!get(dim)) {
+                return false;
+            }
+            if (dim >= 0) {
+                shape.add_dim(dim);
+                continue;
+            }
+
+            std::string symbol;
+            if (!get_string(symbol)) {
+                return false;
+            }
+            shape.add_symbolic_dim(symbol);
+        }
+        shape.set_layout(static_cast<DataLayout>(layout));
+        return true;
+    }
+
+    bool get_data_type(PrimitiveDataType& data_type) {
+        int32_t value = 0;
+        if (!get(value) || value < 0 || value >= static_cast<int32_t>(PrimitiveDataType::UNKNOWN)) {
+            return false;
+        }
+        data_type = static_cast<PrimitiveDataType>(value);
+        return true;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+void put_tensor(const Tensor& tensor, ByteWriter& writer) {
+    size_t size = 0;
+    Tensor::calc_storage_size(tensor.data_type(), tensor.shape(), size);
+    writer.put_string(tensor.name());
+    writer.put<int32_t>(static_cast<int32_t>(tensor.data_type()));
+    writer.put_shape(tensor.shape());
+    writer.put_bytes(tensor.data_raw(), size);
+}
+
+bool get_tensor(ByteReader& reader, std::unique_ptr<Tensor>& tensor) {
+    std::string name;
+    PrimitiveDataType data_type;
+    TensorShape shape;
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t expected_size = 0;
+    if (!reader.get_string(name) || !reader.get_data_type(data_type) || !reader.get_shape(shape) ||
+        !reader.get_bytes(data, size) || !Tensor::calc_storage_size(data_type, shape, expected_size).is_ok() ||
+        size != expected_size) {
+        return false;
+    }
+
+    // the attribute tensors are small, they are copied instead of pointing into the mapping
+    tensor = std::make_unique<Tensor>(name);
+    tensor->init(data_type, shape, AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU));
+    if (size > 0) {
+        std::memcpy(tensor->data_raw(), data, size);
+    }
+    return true;
+}
+
+void put_attribute(const NodeAttribute& attr, ByteWriter& writer) {
+    writer.put_string(attr.name());
+    writer.put<int32_t>(static_cast<int32_t>(attr.type()));
+    switch (attr.type()) {
+        case NodeAttributeType::INT64:
+            writer.put<int64_t>(attr.get_int64());
+            break;
+        case NodeAttributeType::FLOAT:
+            writer.put<float>(attr.get_float());
+            break;
+        case NodeAttributeType::STRING:
+            writer.put_string(attr.get_string());
+            break;
+        case NodeAttributeType::TENSOR:
+            writer.put<uint8_t>(attr.get_tensor() ? 1 : 0);
+            if (attr.get_tensor()) {
+                put_tensor(*attr.get_tensor(), writer);
+            }
+            break;
+        case NodeAttributeType::INT64_ARRAY:
+            writer.put_bytes(attr.get_int64s().data(), attr.get_int64s().size() * sizeof(int64_t));
+            break;
+        case NodeAttributeType::FLOAT_ARRAY:
+            writer.put_bytes(attr.get_floats().data(), attr.get_floats().size() * sizeof(float));
+            break;
+        case NodeAttributeType::STRING_ARRAY:
+            writer.put<uint32_t>(static_cast<uint32_t>(attr.get_strings().size()));
+            for (auto& str : attr.get_strings()) {
+                writer.put_string(str);
+            }
+            break;
+        case NodeAttributeType::TENSOR_ARRAY:
+            writer.put<uint32_t>(static_cast<uint32_t>(attr.get_tensors().size()));
+            for (auto& tensor : attr.get_tensors()) {
+                put_tensor(*tensor, writer);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool get_attribute(ByteReader& reader, std::unique_ptr<NodeAttribute>& attr) {
+    std::string name;
+    int32_t type = 0;
+    if (!reader.get_string(name) || !reader.get(type) || type < 0 ||
+        type > static_cast<int32_t>(NodeAttributeType::INVALID)) {
+        return false;
+    }
+
+    attr = std::make_unique<NodeAttribute>(name, static_cast<NodeAttributeType>(type));
+    switch (static_cast<NodeAttributeType>(type)) {
+        case NodeAttributeType::INT64: {
+            int64_t value = 0;
+            if (!reader.get(value)) {
+                return false;
+            }
+            attr->set_int64(value);
+            return true;
+        }
+        case NodeAttributeType::FLOAT: {
+            float value = 0.0f;
+            if (!reader.get(value)) {
+                return false;
+            }
+            attr->set_float(value);
+            return true;
+        }
+        case NodeAttributeType::STRING: {
+            std::string value;
+            if (!reader.get_string(value)) {
+                return false;
+            }
+            attr->set_string(value);
+            return true;
+        }
+        case NodeAttributeType::TENSOR: {
+            uint8_t has_tensor = 0;
+            std::unique_ptr<Tensor> tensor;
+            if (!reader.get(has_tensor) || (has_tensor && !get_tensor(reader, tensor))) {
+                return false;
+            }
+            attr->set_tensor(std::move(tensor));
+            return true;
+        }
+        case NodeAttributeType::INT64_ARRAY: {
+            const char* data = nullptr;
+            size_t size = 0;
+            if (!reader.get_bytes(data, size) || size % sizeof(int64_t) != 0) {
+                return false;
+            }
+            for (size_t offset = 0; offset < size; offset += sizeof(int64_t)) {
+                int64_t value = 0;
+                std::memcpy(&value, data + offset, sizeof(int64_t));
+                attr->add_int64(value);
+            }
+            return true;
+        }
+        case NodeAttributeType::FLOAT_ARRAY: {
+            const char* data = nullptr;
+            size_t size = 0;
+            if (!reader.get_bytes(data, size) || size % sizeof(float) != 0) {
+                return false;
+            }
+            for (size_t offset = 0; offset < size; offset += sizeof(float)) {
+                float value = 0.0f;
+                std::memcpy(&value, data + offset, sizeof(float));
+                attr->add_float(value);
+            }
+            return true;
+        }
+        case NodeAttributeType::STRING_ARRAY: {
+            uint32_t count = 0;
+            if (!reader.get(count)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string value;
+                if (!reader.get_string(value)) {
+                    return false;
+                }
+                attr->add_string(value);
+            }
+            return true;
+        }
+        case NodeAttributeType::TENSOR_ARRAY: {
+            uint32_t count = 0;
+            if (!reader.get(count)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                std::unique_ptr<Tensor> tensor;
+                if (!get_tensor(reader, tensor)) {
+                    return false;
+                }
+                attr->add_tensor(std::move(tensor));
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+void put_names(const std::vector<NodeArg*>& args, ByteWriter& writer) {
+    writer.put<uint32_t>(static_cast<uint32_t>(args.size()));
+    for (auto* arg : args) {
+        writer.put_string(arg->name());
+    }
+}
+
+bool get_args(ByteReader& reader, const Graph& graph, std::vector<NodeArg*>& args) {
+    uint32_t count = 0;
+    if (!reader.get(count)) {
+        return false;
+    }
+
+    args.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        if (!reader.get_string(name)) {
+            return false;
+        }
+        NodeArg* arg = graph.get_nodearg(name);
+        if (!arg) {
+            return false;
+        }
+        args.emplace_back(arg);
+    }
+    return true;
+}
+
+Status invalid_file(const std::string& file_path, const std::string& reason) {
+    return Status(StatusCode::INVALID_MODEL, "Invalid precompiled model: " + file_path + ", " + reason);
+}
+
+}    // namespace
+
+Status NativeSerializer::save_to_file(const Model& model, const std::vector<Node*>& execution_order,
+                                      const std::string& file_path) {
+    const Graph* graph = model.get_graph();
+    if (!graph || execution_order.size() != graph->get_topological_nodes().size()) {
+        return Status(StatusCode::INVALID_PARAM, "The execution order does not cover the graph nodes");
+    }
+
+    ByteWriter writer;
+    writer.put<int64_t>(model.get_ir_version());
+    writer.put_string(model.get_producer_name());
+    writer.put_string(model.get_producer_version());
+    writer.put_string(model.get_domain());
+    writer.put<int64_t>(model.get_model_version());
+    writer.put_string(model.get_doc_string());
+    std::map<std::string, std::string> metadata(model.get_metadata().begin(), model.get_metadata().end());
+    writer.put<uint32_t>(static_cast<uint32_t>(metadata.size()));
+    for (auto& item : metadata) {
+        writer.put_string(item.first);
+        writer.put_string(item.second);
+    }
+    std::map<std::string, int64_t> domain_version(model.get_domain_version().begin(),
+                                                  model.get_domain_version().end());
+    writer.put<uint32_t>(static_cast<uint32_t>(domain_version.size()));
+    for (auto& item : domain_version) {
+        writer.put_string(item.first);
+        writer.put<int64_t>(item.second);
+    }
+
+    // the node args with their inferred types and shapes, in the id order
+    std::vector<NodeArg*> args;
+    for (size_t id = 0; id < graph->get_nodearg_id_bound(); ++id) {
+        NodeArg* arg = graph->get_nodearg(static_cast<int>(id));
+        if (arg) {
+            args.emplace_back(arg);
+        }
+    }
+    writer.put<uint32_t>(static_cast<uint32_t>(args.size()));
+    for (auto* arg : args) {
+        writer.put_string(arg->name());
+        writer.put<int32_t>(static_cast<int32_t>(arg->data_type()));
+        writer.put_shape(arg->shape());
+    }
+    // the overridable initializers stay graph inputs
+    put_names(graph->get_inputs_include_initializers(), writer);
+    put_names(graph->get_outputs(), writer);
+
+    // the initializers in the name order, so that a model always produces the same file
+    std::vector<std::pair<std::string, const Tensor*>> initializers;
+    for (auto& item : graph->get_initializers()) {
+        initializers.emplace_back(item.first, item.second.get());
+    }
+    std::sort(initializers.begin(), initializers.end());
+    std::vector<size_t> weight_offsets;
+    size_t weights_size = 0;
+    writer.put<uint32_t>(static_cast<uint32_t>(initializers.size()));
+    for (auto& item : initializers) {
+        size_t size = 0;
+        auto ret = Tensor::calc_storage_size(item.second->data_type(), item.second->shape(), size);
+        if (!ret.is_ok()) {
+            return Status(StatusCode::INVALID_PARAM, "The initializer [" + item.first + "] has a dynamic shape");
+        }
+
+        weights_size = align_up(weights_size, size >= kNativePageAlignment ? kNativePageAlignment
+                                                                           : kNativeWeightAlignment);
+        weight_offsets.emplace_back(weights_size);
+        writer.put_string(item.first);
+        writer.put<int32_t>(static_cast<int32_t>(item.second->data_type()));
+        writer.put_shape(item.second->shape());
+        writer.put<uint64_t>(weights_size);
+        writer.put<uint64_t>(size);
+        weights_size += size;
+    }
+
+    // the nodes in the execution order, their ids are their positions
+    writer.put<uint32_t>(static_cast<uint32_t>(execution_order.size()));
+    for (auto* node : execution_order) {
+        writer.put_string(node->name());
+        writer.put_string(node->type());
+        writer.put_string(node->domain());
+        put_names(node->input_args(), writer);
+        put_names(node->output_args(), writer);
+
+        std::map<std::string, const NodeAttribute*> attributes;
+        for (auto& item : node->attributes()) {
+            attributes.emplace(item.first, item.second.get());
+        }
+        writer.put<uint32_t>(static_cast<uint32_t>(attributes.size()));
+        for (auto& item : attributes) {
+            put_attribute(*item.second, writer);
+        }
+    }
+
+    NativeModelHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kNativeModelMagic, sizeof(header.magic));
+    header.version = kNativeModelVersion;
+    header.graph_offset = sizeof(header);
+    header.graph_size = writer.data().size();
+    header.weights_offset = align_up(header.graph_offset + header.graph_size, kNativePageAlignment);
+    header.weights_size = weights_size;
+
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+        return Status(StatusCode::FILE_NOT_FOUND, "Open file failed: " + file_path);
+    }
+
+    const std::string padding(kNativePageAlignment, '\0');
+    size_t written = header.weights_offset;
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(writer.data().data(), writer.data().size());
+    ofs.write(padding.data(), header.weights_offset - header.graph_offset - header.graph_size);
+    for (size_t i = 0; i < initializers.size(); ++i) {
+        ofs.write(padding.data(), header.weights_offset + weight_offsets[i] - written);
+        size_t size = 0;
+        Tensor::calc_storage_size(initializers[i].second->data_type(), initializers[i].second->shape(), size);
+        ofs.write(static_cast<const char*>(initializers[i].second->data_raw()), size);
+        written = header.weights_offset + weight_offsets[i] + size;
+    }
+
+    ofs.close();
+    if (!ofs) {
+        return Status(StatusCode::FAIL, "Write file failed: " + file_path);
+    }
+
+    return Status::ok();
+}
+
+Status NativeSerializer::load_from_file(const std::string& file_path, std::shared_ptr<Model>& model_ptr,
+                                        std::vector<Node*>& execution_order) {
+    std::shared_ptr<MappedFile> mapped_file;
+    auto ret = MappedFile::map(file_path, mapped_file);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    NativeModelHeader header;
+    if (mapped_file->size() < sizeof(header)) {
+        return invalid_file(file_path, "truncated header");
+    }
+    std::memcpy(&header, mapped_file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kNativeModelMagic, sizeof(header.magic)) != 0) {
+        return invalid_file(file_path, "bad magic");
+    }
+    if (header.version != kNativeModelVersion) {
+        std::ostringstream oss;
+        oss << "version " << header.version << " while " << kNativeModelVersion << " is supported";
+        return invalid_file(file_path, oss.str());
+    }
+    const uint64_t file_size = mapped_file->size();
+    if (header.graph_offset > file_size || header.graph_size > file_size - header.graph_offset ||
+        header.weights_offset > file_size || header.weights_size > file_size - header.weights_offset ||
+        header.weights_offset % kNativePageAlignment != 0) {
+        return invalid_file(file_path, "sections out of the file");
+    }
+
+    ByteReader reader(mapped_file->data() + header.graph_offset, header.graph_size);
+    auto model = std::make_shared<Model>();
+    model->hold_buffer(mapped_file);
+    auto graph = std::make_unique<Graph>(*model);
+
+    int64_t ir_version = 0;
+    int64_t model_version = 0;
+    std::string producer_name;
+    std::string producer_version;
+    std::string domain;
+    std::string doc_string;
+    uint32_t count = 0;
+    if (!reader.get(ir_version) || !reader.get_string(producer_name) || !reader.get_string(producer_version) ||
+        !reader.get_string(domain) || !reader.get(model_version) || !reader.get_string(doc_string) ||
+        !reader.get(count)) {
+        return invalid_file(file_path, "truncated model");
+    }
+    std::unordered_map<std::string, std::string> metadata;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string key;
+        std::string value;
+        if (!reader.get_string(key) || !reader.get_string(value)) {
+            return invalid_file(file_path, "truncated metadata");
+        }
+        metadata[key] = value;
+    }
+    std::unordered_map<std::string, int64_t> domain_version;
+    if (!reader.get(count)) {
+        return invalid_file(file_path, "truncated opsets");
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string key;
+        int64_t version = 0;
+        if (!reader.get_string(key) || !reader.get(version)) {
+            return invalid_file(file_path, "truncated opsets");
+        }
+        domain_version[key] = version;
+    }
+    model->set_ir_version(ir_version);
+    model->set_producer_name(producer_name);
+    model->set_producer_version(producer_version);
+    model->set_domain(domain);
+    model->set_model_version(model_version);
+    model->set_doc_string(doc_string);
+    model->set_metadata(metadata);
+    model->set_domain_version(domain_version);
+
+    if (!reader.get(count)) {
+        return invalid_file(file_path, "truncated node args");
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        PrimitiveDataType data_type;
+        TensorShape shape;
+        if (!reader.get_string(name) || !reader.get_data_type(data_type) || !reader.get_shape(shape)) {
+            return invalid_file(file_path, "truncated node args");
+        }
+        graph->get_or_create_nodearg(name, NodeArg(name, data_type, shape));
+    }
+
+    std::vector<NodeArg*> args;
+    if (!get_args(reader, *graph, args)) {
+        return invalid_file(file_path, "invalid graph inputs");
+    }
+    for (auto* arg : args) {
+        graph->add_input_name(arg->name());
+    }
+    if (!get_args(reader, *graph, args)) {
+        return invalid_file(file_path, "invalid graph outputs");
+    }
+    for (auto* arg : args) {
+        graph->add_output_name(arg->name());
+    }
+
+    // the initializers point into the mapped weights section
+    const MemoryInfo memory_info = AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU)->info();
+    char* weights = mapped_file->data() + header.weights_offset;
+    if (!reader.get(count)) {
+        return invalid_file(file_path, "truncated initializers");
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        PrimitiveDataType data_type;
+        TensorShape shape;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        size_t expected_size = 0;
+        if (!reader.get_string(name) || !reader.get_data_type(data_type) || !reader.get_shape(shape) ||
+            !reader.get(offset) || !reader.get(size) ||
+            !Tensor::calc_storage_size(data_type, shape, expected_size).is_ok() || size != expected_size ||
+            offset > header.weights_size || size > header.weights_size - offset ||
+            offset % kNativeWeightAlignment != 0) {
+            return invalid_file(file_path, "invalid initializer " + name);
+        }
+
+        auto tensor = std::make_unique<Tensor>(name);
+        tensor->init(data_type, shape, size > 0 ? weights + offset : nullptr, memory_info);
+        graph->add_initializer(std::move(tensor));
+    }
+
+    if (!reader.get(count)) {
+        return invalid_file(file_path, "truncated nodes");
+    }
+    execution_order.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        std::string type;
+        std::string node_domain;
+        std::vector<NodeArg*> input_args;
+        std::vector<NodeArg*> output_args;
+        uint32_t attr_count = 0;
+        if (!reader.get_string(name) || !reader.get_string(type) || !reader.get_string(node_domain) ||
+            !get_args(reader, *graph, input_args) || !get_args(reader, *graph, output_args) ||
+            !reader.get(attr_count)) {
+            return invalid_file(file_path, "invalid node " + name);
+        }
+
+        std::unordered_map<std::string, std::unique_ptr<NodeAttribute>> attributes;
+        for (uint32_t j = 0; j < attr_count; ++j) {
+            std::unique_ptr<NodeAttribute> attr;
+            if (!get_attribute(reader, attr)) {
+                return invalid_file(file_path, "invalid attribute of node " + name);
+            }
+            attributes.emplace(attr->name(), std::move(attr));
+        }
+
+        auto node = std::make_unique<Node>(static_cast<int>(i), *graph);
+        node->init(name, type, node_domain, "", input_args, output_args, std::move(attributes));
+        execution_order.emplace_back(node.get());
+        graph->add_node(std::move(node));
+    }
+
+    ret = graph->initialize();
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    model->set_graph(std::move(graph));
+    model_ptr = std::move(model);
+    return Status::ok();
+}
+
+}    // namespace io
+}    // namespace simple_ai
@@ -1,12 +1,24 @@
 #include "io/onnx_serializer.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <istream>
+#include <map>
 #include <sstream>
 #include <stack>
+#include <streambuf>
+#include <thread>
 #include <unordered_set>
 
+#include "io/mapped_file.h"
+#include "ir/op_defines.h"
 #include "utils/logger.h"
+#include "utils/thread_pool/simple_thread_pool.h"
 
 using namespace simple_ai::common;
 using namespace simple_ai::utils;
@@ -16,45 +28,724 @@ using namespace simple_ai::framework;
 namespace simple_ai {
 namespace io {
 
-Status OnnxSerializer::load_from_file(const std::string& file_path, std::shared_ptr<Model>& model_ptr) {
-    auto loader = [file_path](onnx::ModelProto& onnx_model) {
+namespace {
+
+// the field numbers in onnx.proto3 on the path from the model to the initializer raw data
+constexpr uint32_t kModelGraphField = 7;
+constexpr uint32_t kGraphInitializerField = 5;
+constexpr uint32_t kTensorRawDataField = 9;
+
+// the protobuf wire types
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+
+// the raw data at least this large is read straight into its own anonymous mapping when the model is streamed, the
+// smaller raw data is read into the proto
+constexpr uint64_t kStreamedRawDataMinSize = 1 << 20;
+// the fields of a streamed message are merged into it once they reach this size, so that the run never grows beyond
+// what protobuf parses at once
+constexpr size_t kStreamedRunMaxSize = 64 << 20;
+// the read buffer of a streamed model file
+constexpr size_t kStreamBufferSize = 1 << 20;
+// the alignment of the initializer raw data in the saved model file
+constexpr uint64_t kRawDataAlignment = 64;
+
+// the blocks of the arena which the proto is parsed into. they grow up to the max size, so a large graph takes a few
+// hundred blocks instead of an allocation per message and string
+constexpr size_t kProtoArenaStartBlockSize = 64 * 1024;
+constexpr size_t kProtoArenaMaxBlockSize = 4 * 1024 * 1024;
+
+// the name of the saved graph, the ir graph has none
+constexpr const char* kSavedGraphName = "main_graph";
+
+/**
+ * @brief A reader of the fields of a serialized protobuf message
+ */
+class WireReader {
+public:
+    WireReader(const char* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+    bool done() const { return m_pos >= m_end; }
+    const char* pos() const { return m_pos; }
+
+    /**
+     * @brief read the next field
+     *
+     * @param field output parameter. the field number
+     * @param wire_type output parameter. the wire type
+     * @param payload output parameter. the payload of a length-delimited field
+     * @param payload_size output parameter. the payload size of a length-delimited field
+     * @return false if the field is malformed or truncated
+     */
+    bool next_field(uint32_t& field, uint32_t& wire_type, const char*& payload, size_t& payload_size) {
+        uint64_t tag = 0;
+        if (!read_varint(tag) || (tag >> 3) == 0 || (tag >> 3) > UINT32_MAX) {
+            return false;
+        }
+        field = static_cast<uint32_t>(tag >> 3);
+        wire_type = static_cast<uint32_t>(tag & 0x7);
+
+        uint64_t value = 0;
+        switch (wire_type) {
+            case kWireTypeVarint:
+                return read_varint(value);
+            case kWireTypeFixed64:
+                return skip(8);
+            case kWireTypeFixed32:
+                return skip(4);
+            case kWireTypeLengthDelimited:
+                if (!read_varint(value) || value > static_cast<uint64_t>(m_end - m_pos)) {
+                    return false;
+                }
+                payload = m_pos;
+                payload_size = static_cast<size_t>(value);
+                m_pos += payload_size;
+                return true;
+            default:
+                // the groups are not used by onnx
+                return false;
+        }
+    }
+
+private:
+    bool read_varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && m_pos < m_end; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*m_pos++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool skip(size_t size) {
+        if (static_cast<size_t>(m_end - m_pos) < size) {
+            return false;
+        }
+        m_pos += size;
+        return true;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+/**
+ * @brief merge the serialized fields of a message in [begin, end) into the message
+ */
+bool merge_fields(const char* begin, const char* end, google::protobuf::MessageLite& message) {
+    if (begin == end) {
+        return true;
+    }
+
+    if (end - begin > INT32_MAX) {
+        return false;
+    }
+
+    google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(begin),
+                                                 static_cast<int>(end - begin));
+    return message.MergePartialFromCodedStream(&input) && input.ConsumedEntireMessage();
+}
+
+/**
+ * @brief merge the serialized message into `message`, except the length-delimited field `special_field`, which is
+ * passed to `on_field` with its payload. the runs of the other fields are merged at once
+ */
+template <typename OnField>
+Status merge_except_field(const char* data, size_t size, google::protobuf::MessageLite& message,
+                          uint32_t special_field, OnField on_field) {
+    WireReader reader(data, size);
+    const char* run_begin = data;
+    while (!reader.done()) {
+        const char* field_begin = reader.pos();
+        uint32_t field = 0;
+        uint32_t wire_type = 0;
+        const char* payload = nullptr;
+        size_t payload_size = 0;
+        if (!reader.next_field(field, wire_type, payload, payload_size)) {
+            return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, malformed " + message.GetTypeName());
+        }
+
+        if (field != special_field || wire_type != kWireTypeLengthDelimited) {
+            continue;
+        }
+
+        if (!merge_fields(run_begin, field_begin, message)) {
+            return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, invalid " + message.GetTypeName());
+        }
+
+        auto status = on_field(payload, payload_size);
+        if (!status.is_ok()) {
+            return status;
+        }
+        run_begin = reader.pos();
+    }
+
+    if (!merge_fields(run_begin, data + size, message)) {
+        return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, invalid " + message.GetTypeName());
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief A reader of the fields of a serialized protobuf message from a stream. the fields which are merged into the
+ * proto are read with their encoding, the payload of a special field is left to its handler
+ */
+class StreamWireReader {
+public:
+    explicit StreamWireReader(std::istream& input) : m_input(input) {}
+
+    uint64_t consumed() const { return m_consumed; }
+
+    /**
+     * @brief read the next field, but the payload of a length-delimited one
+     *
+     * @param field output parameter. the field number
+     * @param wire_type output parameter. the wire type
+     * @param encoded output parameter. the tag, and the value of a scalar field or the payload size of a
+     * length-delimited field are appended as they are encoded
+     * @param payload_size output parameter. the payload size of a length-delimited field, the payload is not read
+     * @return false if the field is malformed or truncated
+     */
+    bool next_field(uint32_t& field, uint32_t& wire_type, std::string& encoded, uint64_t& payload_size) {
+        uint64_t tag = 0;
+        if (!read_varint(tag, encoded) || (tag >> 3) == 0 || (tag >> 3) > UINT32_MAX) {
+            return false;
+        }
+        field = static_cast<uint32_t>(tag >> 3);
+        wire_type = static_cast<uint32_t>(tag & 0x7);
+
+        uint64_t value = 0;
+        payload_size = 0;
+        switch (wire_type) {
+            case kWireTypeVarint:
+                return read_varint(value, encoded);
+            case kWireTypeFixed64:
+                return read_appended(8, encoded);
+            case kWireTypeFixed32:
+                return read_appended(4, encoded);
+            case kWireTypeLengthDelimited:
+                return read_varint(payload_size, encoded);
+            default:
+                // the groups are not used by onnx
+                return false;
+        }
+    }
+
+    /**
+     * @brief read exactly `size` bytes
+     */
+    bool read(char* data, uint64_t size) {
+        m_input.read(data, static_cast<std::streamsize>(size));
+        m_consumed += static_cast<uint64_t>(m_input.gcount());
+        return static_cast<uint64_t>(m_input.gcount()) == size;
+    }
+
+    /**
+     * @brief read `size` bytes to the end of `encoded`
+     */
+    bool read_appended(uint64_t size, std::string& encoded) {
+        const size_t old_size = encoded.size();
+        encoded.resize(old_size + size);
+        return read(encoded.data() + old_size, size);
+    }
+
+private:
+    bool read_varint(uint64_t& value, std::string& encoded) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int ch = m_input.get();
+            if (ch == std::char_traits<char>::eof()) {
+                return false;
+            }
+            ++m_consumed;
+            encoded.push_back(static_cast<char>(ch));
+            value |= static_cast<uint64_t>(ch & 0x7F) << shift;
+            if ((ch & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::istream& m_input;
+    uint64_t m_consumed{0};
+};
+
+/**
+ * @brief merge the next `size` bytes of the stream, a serialized message, into `message`, except the length-delimited
+ * field `special_field`, whose payload is left to `on_field(payload_size)` to read. the other fields are merged by
+ * runs of a bounded size, so the message may be larger than protobuf parses at once
+ */
+template <typename OnField>
+Status stream_merge_except_field(StreamWireReader& reader, uint64_t size, google::protobuf::MessageLite& message,
+                                 uint32_t special_field, OnField on_field) {
+    const uint64_t end = reader.consumed() + size;
+    std::string run;
+    auto merge_run = [&run, &message]() {
+        bool merged = merge_fields(run.data(), run.data() + run.size(), message);
+        run.clear();
+        return merged;
+    };
+
+    while (reader.consumed() < end) {
+        const size_t field_begin = run.size();
+        uint32_t field = 0;
+        uint32_t wire_type = 0;
+        uint64_t payload_size = 0;
+        if (!reader.next_field(field, wire_type, run, payload_size) || payload_size > end - reader.consumed()) {
+            return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, malformed " + message.GetTypeName());
+        }
+
+        if (wire_type == kWireTypeLengthDelimited && field == special_field) {
+            run.resize(field_begin);
+            if (!merge_run()) {
+                return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, invalid " + message.GetTypeName());
+            }
+
+            auto status = on_field(payload_size);
+            if (!status.is_ok()) {
+                return status;
+            }
+            continue;
+        }
+
+        if (payload_size > INT32_MAX || !reader.read_appended(payload_size, run)) {
+            return Status(StatusCode::INVALID_MODEL,
+                          "Parse onnx model failed, truncated or too large field of " + message.GetTypeName());
+        }
+        if (run.size() >= kStreamedRunMaxSize && !merge_run()) {
+            return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, invalid " + message.GetTypeName());
+        }
+    }
+
+    // a scalar field may run over the end
+    if (reader.consumed() != end || !merge_run()) {
+        return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, invalid " + message.GetTypeName());
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief A read-only stream buffer over memory, whose size may exceed what protobuf parses from an array
+ */
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char* data, size_t size) {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+/**
+ * @brief append the base 128 varint encoding of the value
+ */
+void append_varint(uint64_t value, std::string& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief the key and the length of a length delimited field, the payload follows them
+ */
+std::string length_delimited_prefix(uint32_t field, uint64_t size) {
+    std::string prefix;
+    append_varint((field << 3) | kWireTypeLengthDelimited, prefix);
+    append_varint(size, prefix);
+    return prefix;
+}
+
+/**
+ * @brief the graph initializer field of the tensor proto without data, up to the key and the length of its raw data.
+ * the doc string of the proto pads the prefix, so that the raw data following it at `offset + prefix size` is aligned
+ * to kRawDataAlignment
+ */
+std::string aligned_initializer_prefix(onnx::TensorProto& proto_tensor, size_t byte_size, uint64_t offset) {
+    std::string prefix;
+    // an empty doc string is not encoded, a doc string of n characters takes n + 2 bytes until it reaches 128
+    for (size_t padding = 0; padding <= kRawDataAlignment + 2; ++padding) {
+        proto_tensor.set_doc_string(std::string(padding, ' '));
+        std::string header = proto_tensor.SerializeAsString() + length_delimited_prefix(kTensorRawDataField, byte_size);
+        prefix = length_delimited_prefix(kGraphInitializerField, header.size() + byte_size) + header;
+        if ((offset + prefix.size()) % kRawDataAlignment == 0) {
+            break;
+        }
+    }
+    return prefix;
+}
+
+/**
+ * @brief the size of an element of the onnx tensor data type, 0 for the types without a fixed size
+ */
+size_t proto_element_size(int32_t data_type) {
+    switch (data_type) {
+        case onnx::TensorProto_DataType_BOOL:
+        case onnx::TensorProto_DataType_INT8:
+        case onnx::TensorProto_DataType_UINT8:
+            return 1;
+        case onnx::TensorProto_DataType_FLOAT16:
+        case onnx::TensorProto_DataType_BFLOAT16:
+        case onnx::TensorProto_DataType_INT16:
+        case onnx::TensorProto_DataType_UINT16:
+            return 2;
+        case onnx::TensorProto_DataType_FLOAT:
+        case onnx::TensorProto_DataType_INT32:
+        case onnx::TensorProto_DataType_UINT32:
+            return 4;
+        case onnx::TensorProto_DataType_DOUBLE:
+        case onnx::TensorProto_DataType_INT64:
+        case onnx::TensorProto_DataType_UINT64:
+        case onnx::TensorProto_DataType_COMPLEX64:
+            return 8;
+        case onnx::TensorProto_DataType_COMPLEX128:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief parse a non-negative integer of an external data entry
+ */
+bool parse_external_data_size(const std::string& value, size_t& size) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(value.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed > SIZE_MAX) {
+        return false;
+    }
+
+    size = static_cast<size_t>(parsed);
+    return true;
+}
+
+/**
+ * @brief convert the elements of a typed repeated field into the tensor type. the loop has no branches and no
+ * aliasing, so it is vectorized: the narrowing conversions truncate, as the onnx values of the narrower types are
+ * stored in the wider fields
+ */
+template <typename Dst, typename Src>
+void convert_elements(const Src* __restrict src, Dst* __restrict dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<Dst>(src[i]);
+    }
+}
+
+/**
+ * @brief copy or convert the typed repeated field of the proto tensor into the tensor data
+ *
+ * @return bool false if the field is not the one of the data type or its size is not the element number
+ */
+template <typename Src>
+bool copy_typed_field(const google::protobuf::RepeatedField<Src>& field, PrimitiveDataType data_type, size_t count,
+                      void* dst) {
+    if (static_cast<size_t>(field.size()) != count) {
+        return false;
+    }
+
+    switch (data_type) {
+        case PrimitiveDataType::INT8:
+            convert_elements(field.data(), static_cast<int8_t*>(dst), count);
+            return true;
+        case PrimitiveDataType::UINT8:
+            convert_elements(field.data(), static_cast<uint8_t*>(dst), count);
+            return true;
+        case PrimitiveDataType::INT16:
+            convert_elements(field.data(), static_cast<int16_t*>(dst), count);
+            return true;
+        // the float16 values are stored as their bits
+        case PrimitiveDataType::FLOAT16:
+        case PrimitiveDataType::UINT16:
+            convert_elements(field.data(), static_cast<uint16_t*>(dst), count);
+            return true;
+        case PrimitiveDataType::UINT32:
+            convert_elements(field.data(), static_cast<uint32_t*>(dst), count);
+            return true;
+        default:
+            // the field has the element type, the repeated field is contiguous
+            if (size_of_datatype(data_type) != sizeof(Src)) {
+                return false;
+            }
+            memcpy(dst, field.data(), sizeof(Src) * count);
+            return true;
+    }
+}
+
+}    // namespace
+
+Status OnnxSerializer::load_from_file(const std::string& file_path, std::shared_ptr<Model>& model_ptr,
+                                      bool use_mmap, bool prefetch_external_data,
+                                      utils::thread_pool::IThreadPool* thread_pool) {
+    std::string model_dir = std::filesystem::path(file_path).parent_path().string();
+    if (model_dir.empty()) {
+        model_dir = ".";
+    }
+    if (use_mmap) {
         if (!file_exist(file_path)) {
             return Status(StatusCode::FILE_NOT_FOUND, "file not found: " + file_path);
         }
 
-        std::ifstream ifs(file_path, std::ios::in | std::ios::binary);
+        std::shared_ptr<MappedFile> mapped_file;
+        auto status = MappedFile::map(file_path, mapped_file);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        auto loader = [&mapped_file](onnx::ModelProto& onnx_model, RawDataRefs& raw_data_refs) {
+            return parse_onnx_model_zero_copy(mapped_file->data(), mapped_file->size(), mapped_file.get(), onnx_model,
+                                              raw_data_refs);
+        };
+        return load_with_loader(loader, mapped_file, model_dir, prefetch_external_data, thread_pool, model_ptr);
+    }
+
+    auto loader = [file_path](onnx::ModelProto& onnx_model, RawDataRefs& raw_data_refs) {
+        std::error_code error;
+        const uintmax_t file_size = std::filesystem::file_size(file_path, error);
+        if (error) {
+            return Status(StatusCode::FILE_NOT_FOUND, "file not found: " + file_path);
+        }
+
+        std::vector<char> stream_buffer(kStreamBufferSize);
+        std::ifstream ifs;
+        ifs.rdbuf()->pubsetbuf(stream_buffer.data(), static_cast<std::streamsize>(stream_buffer.size()));
+        ifs.open(file_path, std::ios::in | std::ios::binary);
         if (!ifs.is_open()) {
             return Status(StatusCode::FILE_NOT_FOUND, "Open file failed: " + file_path);
         }
 
-        google::protobuf::io::IstreamInputStream input_stream(&ifs);
-        google::protobuf::io::CodedInputStream coded_input(&input_stream);
-        bool parsed = onnx_model.ParseFromCodedStream(&coded_input);
-        ifs.close();
+        return parse_onnx_model_streamed(ifs, file_size, onnx_model, raw_data_refs);
+    };
+
+    return load_with_loader(loader, nullptr, model_dir, prefetch_external_data, thread_pool, model_ptr);
+}
+
+Status OnnxSerializer::load_from_memory(const void* data, size_t data_len, std::shared_ptr<Model>& model_ptr,
+                                        bool borrow_buffer, utils::thread_pool::IThreadPool* thread_pool) {
+    if (data == nullptr || data_len == 0) {
+        return Status(StatusCode::INVALID_PARAM, "Parse onnx model from memory failed, invalid parameters");
+    }
+
+    // the buffer is owned by the caller, the model does not hold it
+    if (borrow_buffer) {
+        auto loader = [data, data_len](onnx::ModelProto& onnx_model, RawDataRefs& raw_data_refs) {
+            return parse_onnx_model_zero_copy(static_cast<const char*>(data), data_len, nullptr, onnx_model,
+                                              raw_data_refs);
+        };
+        return load_with_loader(loader, nullptr, "", false, thread_pool, model_ptr);
+    }
+
+    auto loader = [data, data_len](onnx::ModelProto& onnx_model, RawDataRefs& raw_data_refs) {
+        // protobuf parses at most 2 GB from an array, the larger models are streamed from the memory
+        if (data_len > static_cast<size_t>(INT32_MAX)) {
+            MemoryStreamBuf stream_buf(static_cast<const char*>(data), data_len);
+            std::istream input(&stream_buf);
+            return parse_onnx_model_streamed(input, data_len, onnx_model, raw_data_refs);
+        }
+
+        bool parsed = onnx_model.ParseFromArray(data, static_cast<int>(data_len));
         if (!parsed) {
-            return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed: " + file_path);
+            return Status(StatusCode::INVALID_MODEL, "Parse onnx model from memory failed");
         }
 
         return Status::ok();
     };
 
-    return load_with_loader(loader, model_ptr);
+    return load_with_loader(loader, nullptr, "", false, thread_pool, model_ptr);
 }
 
-Status OnnxSerializer::load_from_memory(const void* data, size_t data_len, std::shared_ptr<Model>& model_ptr) {
-    auto loader = [data, data_len](onnx::ModelProto& onnx_model) {
-        if (data == nullptr || data_len == 0) {
-            return Status(StatusCode::INVALID_PARAM, "Parse onnx model from memory failed, invalid parameters");
+Status OnnxSerializer::save_to_file(const Model& model, const std::string& file_path) {
+    const Graph* graph = model.get_graph();
+    if (!graph) {
+        return Status(StatusCode::INVALID_PARAM, "Save onnx model failed, the model has no graph");
+    }
+
+    onnx::ModelProto onnx_model;
+    onnx_model.set_ir_version(model.get_ir_version());
+    onnx_model.set_producer_name(model.get_producer_name());
+    onnx_model.set_producer_version(model.get_producer_version());
+    onnx_model.set_domain(model.get_domain());
+    onnx_model.set_model_version(model.get_model_version());
+    onnx_model.set_doc_string(model.get_doc_string());
+    // the maps are saved in the key order, so that a model always produces the same file
+    std::map<std::string, std::string> metadata(model.get_metadata().begin(), model.get_metadata().end());
+    for (auto& item : graph->get_initializers()) {
+        DataLayout layout = item.second->shape().layout();
+        if (layout != DataLayout::NCHW) {
+            metadata[kLayoutMetadataPrefix + item.first] = layout_to_string(layout);
         }
-        bool parsed = onnx_model.ParseFromArray(data, static_cast<int>(data_len));
-        if (!parsed) {
-            return Status(StatusCode::INVALID_MODEL, "Parse onnx model from memory failed");
+    }
+    for (auto& item : metadata) {
+        auto* prop = onnx_model.add_metadata_props();
+        prop->set_key(item.first);
+        prop->set_value(item.second);
+    }
+    std::map<std::string, int64_t> domain_version(model.get_domain_version().begin(),
+                                                  model.get_domain_version().end());
+    for (auto* node : graph->get_topological_nodes()) {
+        if (node->domain() == kSimpleAIDomain) {
+            domain_version.emplace(kSimpleAIDomain, kSimpleAIDomainVersion);
+            break;
         }
+    }
+    for (auto& item : domain_version) {
+        auto* opset = onnx_model.add_opset_import();
+        opset->set_domain(item.first);
+        opset->set_version(item.second);
+    }
+
+    onnx::GraphProto onnx_graph;
+    auto ret = graph_to_proto(*graph, onnx_graph);
+    if (!ret.is_ok()) {
+        return ret;
+    }
 
+    // the initializers in the name order. each one is encoded as its proto without data, followed by the key and the
+    // length of its raw data, the raw data itself is written from the tensor buffer
+    std::vector<std::pair<std::string, const Tensor*>> initializers;
+    for (auto& item : graph->get_initializers()) {
+        initializers.emplace_back(item.first, item.second.get());
+    }
+    std::sort(initializers.begin(), initializers.end());
+    std::vector<onnx::TensorProto> proto_tensors(initializers.size());
+    std::vector<size_t> initializer_sizes(initializers.size());
+    for (size_t i = 0; i < initializers.size(); ++i) {
+        ret = tensor_to_proto(*initializers[i].second, false, proto_tensors[i], initializer_sizes[i]);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    std::string graph_bytes;
+    std::string model_bytes;
+    if (!onnx_graph.SerializeToString(&graph_bytes) || !onnx_model.SerializeToString(&model_bytes)) {
+        return Status(StatusCode::FAIL, "Serialize onnx model failed");
+    }
+
+    // the raw data begins at a multiple of kRawDataAlignment in the file, so the mapped weights are used in place on
+    // load. the offsets depend on the length of the graph size, the prefixes are encoded again if it grows. the
+    // alignment is only an optimization, the file is valid either way
+    std::vector<std::string> initializer_prefixes;
+    size_t graph_key_size = length_delimited_prefix(kModelGraphField, graph_bytes.size()).size();
+    uint64_t graph_size = 0;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        uint64_t offset = model_bytes.size() + graph_key_size + graph_bytes.size();
+        initializer_prefixes.clear();
+        for (size_t i = 0; i < proto_tensors.size(); ++i) {
+            initializer_prefixes.emplace_back(
+                aligned_initializer_prefix(proto_tensors[i], initializer_sizes[i], offset));
+            offset += initializer_prefixes.back().size() + initializer_sizes[i];
+        }
+
+        graph_size = offset - model_bytes.size() - graph_key_size;
+        const size_t key_size = length_delimited_prefix(kModelGraphField, graph_size).size();
+        if (key_size == graph_key_size) {
+            break;
+        }
+        graph_key_size = key_size;
+    }
+    model_bytes += length_delimited_prefix(kModelGraphField, graph_size);
+
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+        return Status(StatusCode::FILE_NOT_FOUND, "Open file failed: " + file_path);
+    }
+
+    ofs.write(model_bytes.data(), static_cast<std::streamsize>(model_bytes.size()));
+    ofs.write(graph_bytes.data(), static_cast<std::streamsize>(graph_bytes.size()));
+    for (size_t i = 0; i < initializers.size(); ++i) {
+        ofs.write(initializer_prefixes[i].data(), static_cast<std::streamsize>(initializer_prefixes[i].size()));
+        ofs.write(static_cast<const char*>(initializers[i].second->data_raw()),
+                  static_cast<std::streamsize>(initializer_sizes[i]));
+    }
+
+    ofs.close();
+    if (!ofs) {
+        return Status(StatusCode::FAIL, "Write file failed: " + file_path);
+    }
+
+    return Status::ok();
+}
+
+Status OnnxSerializer::parse_onnx_model_zero_copy(const char* data, size_t size, MappedFile* mapped_file,
+                                                  onnx::ModelProto& onnx_model, RawDataRefs& raw_data_refs) {
+    auto on_tensor = [&raw_data_refs, mapped_file](onnx::TensorProto* tensor, const char* payload,
+                                                   size_t payload_size) {
+        return merge_except_field(payload, payload_size, *tensor, kTensorRawDataField,
+                                  [&raw_data_refs, mapped_file, tensor](const char* raw_data, size_t raw_data_size) {
+                                      raw_data_refs[tensor] = RawDataRef{raw_data, raw_data_size, mapped_file, nullptr};
+                                      return Status::ok();
+                                  });
+    };
+
+    auto on_graph = [&on_tensor](onnx::GraphProto* graph, const char* payload, size_t payload_size) {
+        return merge_except_field(payload, payload_size, *graph, kGraphInitializerField,
+                                  [&on_tensor, graph](const char* tensor_data, size_t tensor_size) {
+                                      return on_tensor(graph->add_initializer(), tensor_data, tensor_size);
+                                  });
+    };
+
+    return merge_except_field(data, size, onnx_model, kModelGraphField,
+                              [&on_graph, &onnx_model](const char* graph_data, size_t graph_size) {
+                                  return on_graph(onnx_model.mutable_graph(), graph_data, graph_size);
+                              });
+}
+
+Status OnnxSerializer::parse_onnx_model_streamed(std::istream& input, uint64_t size, onnx::ModelProto& onnx_model,
+                                                 RawDataRefs& raw_data_refs) {
+    StreamWireReader reader(input);
+    auto on_raw_data = [&reader, &raw_data_refs](onnx::TensorProto* tensor, uint64_t raw_data_size) {
+        if (raw_data_size < kStreamedRawDataMinSize) {
+            std::string* raw_data = tensor->mutable_raw_data();
+            raw_data->clear();
+            if (!reader.read_appended(raw_data_size, *raw_data)) {
+                return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, truncated tensor raw data");
+            }
+            return Status::ok();
+        }
+
+        std::shared_ptr<MappedFile> buffer;
+        auto status = MappedFile::allocate(raw_data_size, buffer);
+        if (!status.is_ok()) {
+            return status;
+        }
+        if (!reader.read(buffer->data(), raw_data_size)) {
+            return Status(StatusCode::INVALID_MODEL, "Parse onnx model failed, truncated tensor raw data");
+        }
+        raw_data_refs[tensor] = RawDataRef{buffer->data(), raw_data_size, nullptr, buffer};
         return Status::ok();
     };
 
-    return load_with_loader(loader, model_ptr);
+    auto on_graph = [&reader, &on_raw_data](onnx::GraphProto* graph, uint64_t graph_size) {
+        return stream_merge_except_field(reader, graph_size, *graph, kGraphInitializerField,
+                                         [&reader, &on_raw_data, graph](uint64_t tensor_size) {
+                                             onnx::TensorProto* tensor = graph->add_initializer();
+                                             return stream_merge_except_field(
+                                                 reader, tensor_size, *tensor, kTensorRawDataField,
+                                                 [&on_raw_data, tensor](uint64_t raw_data_size) {
+                                                     return on_raw_data(tensor, raw_data_size);
+                                                 });
+                                         });
+    };
+
+    return stream_merge_except_field(reader, size, onnx_model, kModelGraphField,
+                                     [&on_graph, &onnx_model](uint64_t graph_size) {
+                                         return on_graph(onnx_model.mutable_graph(), graph_size);
+                                     });
 }
 
 Status OnnxSerializer::validate_onnx_proto(const onnx::ModelProto& model) {
@@ -82,12 +773,21 @@ Status OnnxSerializer::validate_onnx_proto(const onnx::ModelProto& model) {
     return Status::ok();
 }
 
-Status OnnxSerializer::load_with_loader(std::function<Status(onnx::ModelProto&)> loader,
+Status OnnxSerializer::load_with_loader(std::function<Status(onnx::ModelProto&, RawDataRefs&)> loader,
+                                        std::shared_ptr<const void> buffer, const std::string& model_dir,
+                                        bool prefetch_external_data, utils::thread_pool::IThreadPool* thread_pool,
                                         std::shared_ptr<Model>& model_ptr) {
-    onnx::ModelProto onnx_model;
+    // the proto is parsed into an arena, its messages are allocated from a few blocks and freed at once with the
+    // arena, right after the conversion
+    google::protobuf::ArenaOptions arena_options;
+    arena_options.start_block_size = kProtoArenaStartBlockSize;
+    arena_options.max_block_size = kProtoArenaMaxBlockSize;
+    google::protobuf::Arena arena(arena_options);
+    onnx::ModelProto& onnx_model = *google::protobuf::Arena::CreateMessage<onnx::ModelProto>(&arena);
+    RawDataRefs raw_data_refs;
 
     // step 1. load the onnx model
-    Status status = loader(onnx_model);
+    Status status = loader(onnx_model, raw_data_refs);
     if (!status.is_ok()) {
         return status;
     }
@@ -100,7 +800,20 @@ Status OnnxSerializer::load_with_loader(std::function<Status(onnx::ModelProto&)>
 
     // step 3. parse the onnx model
     model_ptr = std::make_shared<Model>();
-    status = parse_onnx_model(onnx_model, model_ptr);
+    if (buffer) {
+        model_ptr->hold_buffer(std::move(buffer));
+    }
+    for (auto& item : raw_data_refs) {
+        if (item.second.owner) {
+            model_ptr->hold_buffer(item.second.owner);
+        }
+    }
+    status = resolve_external_data(onnx_model.graph(), model_dir, prefetch_external_data, *model_ptr, raw_data_refs);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    status = parse_onnx_model(onnx_model, raw_data_refs, thread_pool, model_ptr);
     if (!status.is_ok()) {
         return status;
     }
@@ -108,12 +821,123 @@ Status OnnxSerializer::load_with_loader(std::function<Status(onnx::ModelProto&)>
     return Status::ok();
 }
 
-Status OnnxSerializer::parse_onnx_model(const onnx::ModelProto& onnx_model, std::shared_ptr<Model>& ir_model) {
-    // set metadata props
+Status OnnxSerializer::resolve_external_data(const onnx::GraphProto& onnx_graph, const std::string& model_dir,
+                                             bool prefetch, Model& ir_model, RawDataRefs& raw_data_refs) {
+    std::unordered_map<std::string, std::shared_ptr<MappedFile>> mapped_files;
+    std::vector<std::pair<std::shared_ptr<MappedFile>, RawDataRef>> prefetch_ranges;
+    for (auto& initializer : onnx_graph.initializer()) {
+        if (initializer.data_location() != onnx::TensorProto_DataLocation_EXTERNAL) {
+            continue;
+        }
+
+        std::string location;
+        std::string offset_value = "0";
+        std::string length_value;
+        for (auto& entry : initializer.external_data()) {
+            if (entry.key() == "location") {
+                location = entry.value();
+            } else if (entry.key() == "offset") {
+                offset_value = entry.value();
+            } else if (entry.key() == "length") {
+                length_value = entry.value();
+            }
+        }
+
+        std::ostringstream oss;
+        oss << "Initializer [" << initializer.name() << "] external data";
+        if (model_dir.empty()) {
+            oss << " is relative to the model file, load the model from its file";
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
+        // the location is relative to the model directory and must stay in it
+        std::filesystem::path relative_path(location);
+        bool escapes = location.empty() || relative_path.is_absolute();
+        for (auto& part : relative_path) {
+            escapes = escapes || part == "..";
+        }
+        if (escapes) {
+            oss << " has an invalid location: " << location;
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
+        auto it_file = mapped_files.find(location);
+        if (it_file == mapped_files.end()) {
+            std::string file_path = (std::filesystem::path(model_dir) / relative_path).string();
+            std::shared_ptr<MappedFile> mapped_file;
+            auto status = MappedFile::map(file_path, mapped_file);
+            if (!status.is_ok()) {
+                oss << " can not be mapped, " << status.message();
+                return Status(status.code(), oss.str());
+            }
+
+            ir_model.hold_buffer(mapped_file);
+            it_file = mapped_files.emplace(location, std::move(mapped_file)).first;
+        }
+
+        // without the length, the data is as long as the tensor, or runs to the end of the file
+        MappedFile* mapped_file = it_file->second.get();
+        size_t offset = 0;
+        size_t length = 0;
+        int64_t element_num = 1;
+        for (auto dim : initializer.dims()) {
+            element_num *= dim;
+        }
+        bool valid = parse_external_data_size(offset_value, offset) && offset <= mapped_file->size();
+        if (valid && length_value.empty()) {
+            size_t element_size = proto_element_size(initializer.data_type());
+            length = element_size > 0 && element_num >= 0 ? element_size * static_cast<size_t>(element_num)
+                                                          : mapped_file->size() - offset;
+        } else if (valid) {
+            valid = parse_external_data_size(length_value, length);
+        }
+        if (!valid || length > mapped_file->size() - offset) {
+            oss << " is out of the file: " << location << ", offset: " << offset_value << ", length: " << length_value
+                << ", file size: " << mapped_file->size();
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
+        RawDataRef ref{mapped_file->data() + offset, length, mapped_file, nullptr};
+        raw_data_refs[&initializer] = ref;
+        if (prefetch) {
+            prefetch_ranges.emplace_back(it_file->second, ref);
+        }
+    }
+
+    // the read ahead overlaps with the parsing of the graph. the thread holds the mappings it reads, so it may outlive
+    // the model
+    if (!prefetch_ranges.empty()) {
+        std::thread([ranges = std::move(prefetch_ranges)]() {
+            for (auto& range : ranges) {
+                range.first->prefetch(range.second.data, range.second.size);
+            }
+        }).detach();
+    }
+
+    return Status::ok();
+}
+
+Status OnnxSerializer::parse_onnx_model(const onnx::ModelProto& onnx_model, const RawDataRefs& raw_data_refs,
+                                        utils::thread_pool::IThreadPool* thread_pool,
+                                        std::shared_ptr<Model>& ir_model) {
+    // set metadata props. the layouts of the initializers are not model metadata, they are restored on the graph
+    std::unordered_map<std::string, DataLayout> initializer_layouts;
     {
+        const std::string layout_prefix = kLayoutMetadataPrefix;
         std::unordered_map<std::string, std::string> meta_map;
         for (auto& prop : onnx_model.metadata_props()) {
-            meta_map[prop.key()] = prop.value();
+            if (prop.key().compare(0, layout_prefix.size(), layout_prefix) != 0) {
+                meta_map[prop.key()] = prop.value();
+                continue;
+            }
+
+            DataLayout layout = DataLayout::NCHW;
+            if (!string_to_layout(prop.value(), layout)) {
+                std::ostringstream oss;
+                oss << "Parse onnx model failed, invalid layout: " << prop.value() << " of " << prop.key();
+                return Status(StatusCode::INVALID_MODEL, oss.str());
+            }
+            initializer_layouts[prop.key().substr(layout_prefix.size())] = layout;
         }
 
         ir_model->set_metadata(meta_map);
@@ -150,19 +974,34 @@ Status OnnxSerializer::parse_onnx_model(const onnx::ModelProto& onnx_model, std:
     ir_model->set_doc_string(onnx_model.doc_string());
 
     auto ir_graph = std::make_unique<Graph>(*(ir_model.get()));
-    Status status = parse_onnx_graph(onnx_model.graph(), ir_graph);
+    Status status = parse_onnx_graph(onnx_model.graph(), raw_data_refs, thread_pool, ir_graph);
     if (!status.is_ok()) {
         return status;
     }
 
+    for (auto& item : initializer_layouts) {
+        Tensor* tensor = ir_graph->get_initializer(item.first);
+        NodeArg* arg = ir_graph->get_nodearg(item.first);
+        if (!tensor || !arg) {
+            std::ostringstream oss;
+            oss << "Parse onnx model failed, the layout is set on the unknown initializer: " << item.first;
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
+        tensor->shape().set_layout(item.second);
+        TensorShape shape = arg->shape();
+        shape.set_layout(item.second);
+        arg->set_shape(shape);
+    }
+
     ir_model->set_graph(std::move(ir_graph));
 
     return Status::ok();
 }
 
-Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std::unique_ptr<Graph>& ir_graph) {
-    std::unordered_map<std::string, NodeArg> name_to_nodearg_map;
-
+Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, const RawDataRefs& raw_data_refs,
+                                        utils::thread_pool::IThreadPool* thread_pool,
+                                        std::unique_ptr<Graph>& ir_graph) {
     // Step 1. Process "Constant" nodes. Retrieve "TensorProto" attributes in the "Constant" node as a Tensor.
     for (auto& proto_node : onnx_graph.node()) {
         if (proto_node.op_type() != "Constant") {
@@ -195,9 +1034,7 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
                 }
 
                 TensorShape shape = shapeproto_to_tensorshape(tensor_type.shape());
-                NodeArg arg(input.name(), dt, shape);
-                name_to_nodearg_map.emplace(input.name(), arg);
-                ir_graph->get_or_create_nodearg(input.name(), arg);
+                ir_graph->get_or_create_nodearg(input.name(), NodeArg(input.name(), dt, shape));
                 ir_graph->add_input_name(input.name());
             } else {
                 LOG_WARNING("Graph input [%s] has no type or has an unsupported type", input.name().c_str());
@@ -207,22 +1044,31 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
         }
     }
 
-    // Step 3. copy tensor proto to tensor ir map
+    // Step 3. copy tensor proto to tensor ir map. the initializers are decoded in parallel, each into its own slot,
+    // and added to the graph in the proto order
     IAllocator* allocator = AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU);
-    for (auto& initializer : onnx_graph.initializer()) {
-        std::unique_ptr<Tensor> tensor;
-        auto ret = retrieve_tensor_data(initializer, tensor, allocator, initializer.name());
-        if (!ret.is_ok()) {
-            LOG_WARNING("Parsing initializer[%s] fails", initializer.name().c_str());
-            return ret;
+    const size_t num_initializers = static_cast<size_t>(onnx_graph.initializer_size());
+    std::vector<std::unique_ptr<Tensor>> tensors(num_initializers);
+    std::vector<Status> statuses(num_initializers);
+    utils::thread_pool::parallel_for(thread_pool, num_initializers, [&](size_t i) {
+        const auto& initializer = onnx_graph.initializer(static_cast<int>(i));
+        auto it_ref = raw_data_refs.find(&initializer);
+        statuses[i] = retrieve_tensor_data(initializer, tensors[i], allocator, initializer.name(),
+                                           it_ref == raw_data_refs.end() ? nullptr : &it_ref->second);
+    });
+
+    for (size_t i = 0; i < num_initializers; ++i) {
+        if (!statuses[i].is_ok()) {
+            LOG_WARNING("Parsing initializer[%s] fails", onnx_graph.initializer(static_cast<int>(i)).name().c_str());
+            return statuses[i];
         }
 
+        auto& tensor = tensors[i];
         LOG_INFO("Initializer name: %s", tensor->name().c_str());
         NodeArg* tensor_arg = ir_graph->get_nodearg(tensor->name());
         if (tensor_arg == nullptr) {
-            NodeArg arg(tensor->name(), tensor->data_type(), tensor->shape());
-            name_to_nodearg_map.emplace(tensor->name(), arg);
-            ir_graph->get_or_create_nodearg(tensor->name(), arg);
+            ir_graph->get_or_create_nodearg(tensor->name(),
+                                            NodeArg(tensor->name(), tensor->data_type(), tensor->shape()));
         } else {
             LOG_WARNING("Initializer [%s] appears in graph inputs and will not be treated as constant value",
                         tensor->name().c_str());
@@ -249,9 +1095,7 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
                 }
 
                 TensorShape shape = shapeproto_to_tensorshape(tensor_type.shape());
-                NodeArg arg(output.name(), dt, shape);
-                name_to_nodearg_map.emplace(output.name(), arg);
-                ir_graph->get_or_create_nodearg(output.name(), arg);
+                ir_graph->get_or_create_nodearg(output.name(), NodeArg(output.name(), dt, shape));
                 ir_graph->add_output_name(output.name());
             } else {
                 LOG_WARNING("Graph output [%s] has not type or unsupported type", output.name().c_str());
@@ -261,7 +1105,8 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
         }
     }
 
-    // Step 4. Process the ValueInfoProto name, type, shape information of the graph.
+    // Step 4. Process the ValueInfoProto name, type, shape information of the graph. the args are created in the graph
+    // directly, the ones which are not used by any node are released when the topology is constructed
     for (auto& val_info : onnx_graph.value_info()) {
         if (!val_info.name().empty()) {
             const onnx::TypeProto& type = val_info.type();
@@ -274,8 +1119,7 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
                 }
 
                 TensorShape shape = shapeproto_to_tensorshape(tensor_type.shape());
-                NodeArg arg(val_info.name(), dt, shape);
-                name_to_nodearg_map.emplace(val_info.name(), arg);
+                ir_graph->get_or_create_nodearg(val_info.name(), NodeArg(val_info.name(), dt, shape));
             }
         } else {
             LOG_WARNING("Graph value_info name is empty");
@@ -291,7 +1135,7 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
         }
         ++node_id;
         std::unique_ptr<Node> ir_node;
-        auto ret = parse_onnx_node(proto_node, ir_node, node_id, ir_graph.get(), name_to_nodearg_map);
+        auto ret = parse_onnx_node(proto_node, ir_node, node_id, ir_graph.get());
         if (!ret.is_ok()) {
             return ret;
         }
@@ -305,35 +1149,19 @@ Status OnnxSerializer::parse_onnx_graph(const onnx::GraphProto& onnx_graph, std:
 }
 
 Status OnnxSerializer::parse_onnx_node(const onnx::NodeProto& onnx_node, std::unique_ptr<Node>& ir_node, int node_id,
-                                       Graph* graph, const std::unordered_map<std::string, NodeArg>& nodearg_map) {
-    auto create_node_args = [&](const std::vector<std::string>& names) {
+                                       Graph* graph) {
+    auto create_node_args = [graph](const google::protobuf::RepeatedPtrField<std::string>& names) {
         std::vector<NodeArg*> results;
+        results.reserve(names.size());
         for (auto& name : names) {
-            auto it = nodearg_map.find(name);
-            if (it != nodearg_map.end()) {
-                auto ret = graph->get_or_create_nodearg(name, it->second);
-                results.emplace_back(ret);
-            } else {
-                auto ret = graph->get_or_create_nodearg(name, NodeArg(name));
-                results.emplace_back(ret);
-            }
+            NodeArg* arg = graph->get_nodearg(name);
+            results.emplace_back(arg ? arg : graph->get_or_create_nodearg(name, NodeArg(name)));
         }
         return results;
     };
 
-    std::vector<std::string> inputs_name;
-    std::vector<std::string> outputs_name;
-
-    for (auto& name : onnx_node.input()) {
-        inputs_name.emplace_back(name);
-    }
-
-    for (auto& name : onnx_node.output()) {
-        outputs_name.emplace_back(name);
-    }
-
-    auto node_input_args = create_node_args(inputs_name);
-    auto node_output_args = create_node_args(outputs_name);
+    auto node_input_args = create_node_args(onnx_node.input());
+    auto node_output_args = create_node_args(onnx_node.output());
     auto name = onnx_node.name();
     auto type = onnx_node.op_type();
     auto doc_str = onnx_node.doc_string();
@@ -358,56 +1186,100 @@ Status OnnxSerializer::parse_onnx_node(const onnx::NodeProto& onnx_node, std::un
 }
 
 Status OnnxSerializer::retrieve_tensor_data(const onnx::TensorProto& proto_tensor, std::unique_ptr<Tensor>& ir_tensor,
-                                            IAllocator* allocator, const std::string& name) {
-    switch (proto_tensor.data_type()) {
-        case onnx::TensorProto_DataType::TensorProto_DataType_FLOAT: {
-            auto tensor = std::make_unique<Tensor>(name);
+                                            IAllocator* allocator, const std::string& name,
+                                            const RawDataRef* raw_data_ref) {
+    if (!raw_data_ref && proto_tensor.data_location() == onnx::TensorProto_DataLocation_EXTERNAL) {
+        std::ostringstream oss;
+        oss << "Tensor [" << name << "] is stored in an external data file, which is supported for the initializers of "
+            << "a model loaded from its file only";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
 
-            TensorShape tensor_shape;
-            // add dims to the tensor
-            int dim_size = proto_tensor.dims_size();
-            for (int i = 0; i < dim_size; ++i) {
-                int64_t dim = proto_tensor.dims(i);
-                tensor_shape.add_dim(dim);
-            }
+    const PrimitiveDataType data_type =
+        tensor_datatype_to_primitive(static_cast<onnx::TensorProto_DataType>(proto_tensor.data_type()));
+    if (data_type == PrimitiveDataType::UNKNOWN) {
+        std::ostringstream oss;
+        oss << "not support data type " << proto_tensor.data_type() << " for proto tensor [" << name << "]";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
 
-            // initialize the ir tensor
-            auto status = tensor->init(PrimitiveDataType::FLOAT32, tensor_shape, allocator);
-            if (!status.is_ok()) {
-                std::ostringstream oss;
-                oss << "init tensor failed, tensor proto: " << proto_tensor.name();
-                return Status(status.code(), oss.str());
-            }
+    auto tensor = std::make_unique<Tensor>(name);
+    TensorShape tensor_shape;
+    // add dims to the tensor
+    int dim_size = proto_tensor.dims_size();
+    for (int i = 0; i < dim_size; ++i) {
+        int64_t dim = proto_tensor.dims(i);
+        tensor_shape.add_dim(dim);
+    }
+    if (tensor_shape.element_num() < 0) {
+        return Status(StatusCode::INVALID_MODEL, "Invalid tensor dims of proto tensor: " + name);
+    }
+    const size_t element_size = size_of_datatype(data_type);
+    // the tensor without dims is a scalar
+    const size_t element_num = tensor_shape.dims_num() == 0 ? 1 : static_cast<size_t>(tensor_shape.element_num());
+    const size_t byte_size = element_size * element_num;
+
+    // the raw data left in the loaded buffer is used in place, unless it is misaligned for the data type
+    if (raw_data_ref) {
+        if (raw_data_ref->size != byte_size) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid tensor raw data length with its dims");
+        }
 
-            if (proto_tensor.raw_data().length() > 0) {
-                if (proto_tensor.raw_data().length() == sizeof(float) * tensor->shape().element_num()) {
-                    const float* tensor_data = reinterpret_cast<const float*>(proto_tensor.raw_data().data());
-                    float* ir_data = tensor->data_as<float>();
-                    memmove(ir_data, tensor_data, sizeof(float) * tensor->shape().element_num());
-                } else {
-                    return Status(StatusCode::INVALID_MODEL, "Invalid tensor raw data length with its dims");
-                }
-            } else {
-                if (proto_tensor.float_data_size() == tensor->shape().element_num()) {
-                    float* ir_data = tensor->data_as<float>();
-                    for (int i = 0; i < proto_tensor.float_data_size(); ++i) {
-                        ir_data[i] = proto_tensor.float_data(i);
-                    }
-                } else {
-                    return Status(StatusCode::INVALID_MODEL, "Invalid tensor float data length with its dims");
-                }
+        if (reinterpret_cast<uintptr_t>(raw_data_ref->data) % element_size == 0) {
+            tensor->init(data_type, tensor_shape, const_cast<char*>(raw_data_ref->data), allocator->info());
+        } else {
+            tensor->init(data_type, tensor_shape, allocator);
+            memcpy(tensor->data_raw(), raw_data_ref->data, raw_data_ref->size);
+            if (raw_data_ref->mapped_file) {
+                raw_data_ref->mapped_file->release_pages(raw_data_ref->data, raw_data_ref->size);
             }
-
-            ir_tensor = std::move(tensor);
-            return Status::ok();
         }
 
-        default: {
-            std::ostringstream oss;
-            oss << "not support data type for proto tensor";
-            return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+        ir_tensor = std::move(tensor);
+        return Status::ok();
+    }
+
+    // initialize the ir tensor
+    auto status = tensor->init(data_type, tensor_shape, allocator);
+    if (!status.is_ok()) {
+        std::ostringstream oss;
+        oss << "init tensor failed, tensor proto: " << proto_tensor.name();
+        return Status(status.code(), oss.str());
+    }
+
+    if (proto_tensor.raw_data().length() > 0) {
+        if (proto_tensor.raw_data().length() != byte_size) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid tensor raw data length with its dims");
         }
+        memmove(tensor->data_raw(), proto_tensor.raw_data().data(), byte_size);
+        ir_tensor = std::move(tensor);
+        return Status::ok();
     }
+
+    // the typed field of the data type, see the TensorProto of onnx
+    bool copied = false;
+    switch (data_type) {
+        case PrimitiveDataType::FLOAT32:
+            copied = copy_typed_field(proto_tensor.float_data(), data_type, element_num, tensor->data_raw());
+            break;
+        case PrimitiveDataType::INT64:
+            copied = copy_typed_field(proto_tensor.int64_data(), data_type, element_num, tensor->data_raw());
+            break;
+        case PrimitiveDataType::UINT32:
+        case PrimitiveDataType::UINT64:
+            copied = copy_typed_field(proto_tensor.uint64_data(), data_type, element_num, tensor->data_raw());
+            break;
+        default:
+            copied = copy_typed_field(proto_tensor.int32_data(), data_type, element_num, tensor->data_raw());
+            break;
+    }
+    if (!copied) {
+        std::ostringstream oss;
+        oss << "Invalid tensor typed data length with its dims, tensor proto: " << name;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    ir_tensor = std::move(tensor);
     return Status::ok();
 }
 
@@ -534,6 +1406,8 @@ PrimitiveDataType OnnxSerializer::tensor_datatype_to_primitive(const onnx::Tenso
 
     if (data_type == onnx::TensorProto_DataType::TensorProto_DataType_FLOAT) {
         dt = PrimitiveDataType::FLOAT32;
+    } else if (data_type == onnx::TensorProto_DataType::TensorProto_DataType_FLOAT16) {
+        dt = PrimitiveDataType::FLOAT16;
     } else if (data_type == onnx::TensorProto_DataType::TensorProto_DataType_INT8) {
         dt = PrimitiveDataType::INT8;
     } else if (data_type == onnx::TensorProto_DataType::TensorProto_DataType_UINT8) {
@@ -561,8 +1435,10 @@ TensorShape OnnxSerializer::shapeproto_to_tensorshape(const onnx::TensorShapePro
         if (dim.value_case() == onnx::TensorShapeProto_Dimension::ValueCase::kDimValue) {
             int64_t dim_val = dim.dim_value();
             shape.add_dim(dim_val);
+        } else if (dim.value_case() == onnx::TensorShapeProto_Dimension::ValueCase::kDimParam) {
+            shape.add_symbolic_dim(dim.dim_param());
         } else {
-            shape.add_dim(-1);
+            shape.add_dim(kDynamicDim);
         }
     }
 
@@ -676,5 +1552,207 @@ Status OnnxSerializer::parse_onnx_attribute(const onnx::AttributeProto& proto_at
     return Status::ok();
 }
 
+Status OnnxSerializer::graph_to_proto(const Graph& graph, onnx::GraphProto& onnx_graph) {
+    const auto& nodes = graph.get_topological_nodes();
+    if (nodes.size() != graph.get_nodes().size()) {
+        return Status(StatusCode::INVALID_PARAM, "Save onnx graph failed, the graph topology is not constructed");
+    }
+
+    auto set_value_info = [](const NodeArg* arg, onnx::ValueInfoProto* value_info) {
+        const auto data_type = primitive_to_tensor_datatype(arg->data_type());
+        if (data_type == onnx::TensorProto_DataType_UNDEFINED) {
+            return Status(StatusCode::INVALID_PARAM, "unsupported data type of node arg: " + arg->name());
+        }
+
+        value_info->set_name(arg->name());
+        auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(data_type);
+        tensorshape_to_shapeproto(arg->shape(), *tensor_type->mutable_shape());
+        return Status::ok();
+    };
+
+    onnx_graph.set_name(kSavedGraphName);
+    // the overridable initializers stay graph inputs, so they are not folded as constants on load
+    for (auto* arg : graph.get_inputs_include_initializers()) {
+        auto ret = set_value_info(arg, onnx_graph.add_input());
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+    for (auto* arg : graph.get_outputs()) {
+        auto ret = set_value_info(arg, onnx_graph.add_output());
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    for (auto* node : nodes) {
+        auto* proto_node = onnx_graph.add_node();
+        proto_node->set_name(node->name());
+        proto_node->set_op_type(node->type());
+        proto_node->set_domain(node->domain());
+        for (auto* arg : node->input_args()) {
+            proto_node->add_input(arg->name());
+        }
+        for (auto* arg : node->output_args()) {
+            proto_node->add_output(arg->name());
+        }
+
+        std::map<std::string, const NodeAttribute*> attributes;
+        for (auto& item : node->attributes()) {
+            attributes.emplace(item.first, item.second.get());
+        }
+        for (auto& item : attributes) {
+            auto ret = attribute_to_proto(*item.second, *proto_node->add_attribute());
+            if (!ret.is_ok()) {
+                return ret;
+            }
+        }
+
+        // the inferred types and shapes of the intermediate args. the args which are not typed yet are left to the
+        // shape inference on load, like the args in the other layouts
+        for (auto* arg : node->output_args()) {
+            if (arg->name().empty() || graph.is_graph_output(arg) || arg->data_type() == PrimitiveDataType::UNKNOWN ||
+                arg->shape().layout() != DataLayout::NCHW) {
+                continue;
+            }
+
+            auto ret = set_value_info(arg, onnx_graph.add_value_info());
+            if (!ret.is_ok()) {
+                return ret;
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+Status OnnxSerializer::attribute_to_proto(const NodeAttribute& node_attr, onnx::AttributeProto& proto_attr) {
+    proto_attr.set_name(node_attr.name());
+    size_t byte_size = 0;
+    switch (node_attr.type()) {
+        case NodeAttributeType::FLOAT:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_FLOAT);
+            proto_attr.set_f(node_attr.get_float());
+            break;
+
+        case NodeAttributeType::INT64:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_INT);
+            proto_attr.set_i(node_attr.get_int64());
+            break;
+
+        case NodeAttributeType::STRING:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_STRING);
+            proto_attr.set_s(node_attr.get_string());
+            break;
+
+        case NodeAttributeType::TENSOR: {
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_TENSOR);
+            auto ret = tensor_to_proto(*node_attr.get_tensor(), true, *proto_attr.mutable_t(), byte_size);
+            if (!ret.is_ok()) {
+                return ret;
+            }
+            break;
+        }
+
+        case NodeAttributeType::FLOAT_ARRAY:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_FLOATS);
+            proto_attr.mutable_floats()->Add(node_attr.get_floats().begin(), node_attr.get_floats().end());
+            break;
+
+        case NodeAttributeType::INT64_ARRAY:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_INTS);
+            proto_attr.mutable_ints()->Add(node_attr.get_int64s().begin(), node_attr.get_int64s().end());
+            break;
+
+        case NodeAttributeType::STRING_ARRAY:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_STRINGS);
+            for (auto& item : node_attr.get_strings()) {
+                proto_attr.add_strings(item);
+            }
+            break;
+
+        case NodeAttributeType::TENSOR_ARRAY:
+            proto_attr.set_type(onnx::AttributeProto_AttributeType::AttributeProto_AttributeType_TENSORS);
+            for (auto& tensor : node_attr.get_tensors()) {
+                auto ret = tensor_to_proto(*tensor, true, *proto_attr.add_tensors(), byte_size);
+                if (!ret.is_ok()) {
+                    return ret;
+                }
+            }
+            break;
+
+        default: {
+            std::ostringstream oss;
+            oss << "not supported attribute: " << node_attr.name();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+    }
+
+    return Status::ok();
+}
+
+Status OnnxSerializer::tensor_to_proto(const Tensor& tensor, bool with_data, onnx::TensorProto& proto_tensor,
+                                       size_t& byte_size) {
+    const auto data_type = primitive_to_tensor_datatype(tensor.data_type());
+    if (data_type == onnx::TensorProto_DataType_UNDEFINED) {
+        return Status(StatusCode::INVALID_PARAM, "unsupported data type of tensor: " + tensor.name());
+    }
+
+    auto ret = Tensor::calc_storage_size(tensor.data_type(), tensor.shape(), byte_size);
+    if (!ret.is_ok()) {
+        return Status(StatusCode::INVALID_PARAM, "The tensor [" + tensor.name() + "] has a dynamic shape");
+    }
+
+    proto_tensor.set_name(tensor.name());
+    proto_tensor.set_data_type(data_type);
+    for (auto dim : tensor.shape().dims()) {
+        proto_tensor.add_dims(dim);
+    }
+    if (with_data) {
+        proto_tensor.set_raw_data(tensor.data_raw(), byte_size);
+    }
+
+    return Status::ok();
+}
+
+onnx::TensorProto_DataType OnnxSerializer::primitive_to_tensor_datatype(PrimitiveDataType data_type) {
+    switch (data_type) {
+        case PrimitiveDataType::FLOAT32:
+            return onnx::TensorProto_DataType::TensorProto_DataType_FLOAT;
+        case PrimitiveDataType::FLOAT16:
+            return onnx::TensorProto_DataType::TensorProto_DataType_FLOAT16;
+        case PrimitiveDataType::INT8:
+            return onnx::TensorProto_DataType::TensorProto_DataType_INT8;
+        case PrimitiveDataType::UINT8:
+            return onnx::TensorProto_DataType::TensorProto_DataType_UINT8;
+        case PrimitiveDataType::INT16:
+            return onnx::TensorProto_DataType::TensorProto_DataType_INT16;
+        case PrimitiveDataType::UINT16:
+            return onnx::TensorProto_DataType::TensorProto_DataType_UINT16;
+        case PrimitiveDataType::INT32:
+            return onnx::TensorProto_DataType::TensorProto_DataType_INT32;
+        case PrimitiveDataType::UINT32:
+            return onnx::TensorProto_DataType::TensorProto_DataType_UINT32;
+        case PrimitiveDataType::INT64:
+            return onnx::TensorProto_DataType::TensorProto_DataType_INT64;
+        case PrimitiveDataType::UINT64:
+            return onnx::TensorProto_DataType::TensorProto_DataType_UINT64;
+        default:
+            return onnx::TensorProto_DataType::TensorProto_DataType_UNDEFINED;
+    }
+}
+
+void OnnxSerializer::tensorshape_to_shapeproto(const TensorShape& shape, onnx::TensorShapeProto& shape_proto) {
+    for (size_t i = 0; i < shape.dims().size(); ++i) {
+        auto* dim = shape_proto.add_dim();
+        if (!shape.is_dynamic(i)) {
+            dim->set_dim_value(shape.dims()[i]);
+        } else if (!shape.symbol(i).empty()) {
+            dim->set_dim_param(shape.symbol(i));
+        }
+    }
+}
+
 }    // namespace io
 }    // namespace simple_ai
\ No newline at end of file
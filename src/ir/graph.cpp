@@ -3,8 +3,6 @@
 #include <algorithm>
 #include <fstream>
 #include <sstream>
-#include <stack>
-#include <unordered_set>
 
 #include "ir/model.h"
 #include "ir/node_arg.h"
@@ -37,29 +35,115 @@ void Graph::add_initializer(std::unique_ptr<Tensor>&& tensor) {
 
 bool Graph::has_initializer(const std::string& name) { return m_initializer_map.find(name) != m_initializer_map.end(); }
 
+Tensor* Graph::get_initializer(const std::string& name) const {
+    auto it = m_initializer_map.find(name);
+    if (it != m_initializer_map.end()) {
+        return it->second.get();
+    }
+
+    return nullptr;
+}
+
 NodeArg* Graph::get_or_create_nodearg(const std::string& name, const NodeArg& node_arg) {
-    auto insert_result = m_nodearg_map.emplace(name, nullptr);
-    if (insert_result.second) {
-        insert_result.first->second = std::make_unique<NodeArg>(node_arg);
+    const int id = m_nodearg_names.intern(name);
+    if (static_cast<size_t>(id) >= m_nodeargs.size()) {
+        m_nodeargs.resize(static_cast<size_t>(id) + 1);
     }
-    return insert_result.first->second.get();
+
+    auto& arg = m_nodeargs[id];
+    if (!arg) {
+        arg = std::make_unique<NodeArg>(node_arg);
+        arg->m_id = id;
+    }
+    return arg.get();
 }
 
-NodeArg* Graph::get_nodearg(const std::string& name) {
-    auto it = m_nodearg_map.find(name);
-    if (it != m_nodearg_map.end()) {
-        return it->second.get();
+NodeArg* Graph::get_nodearg(const std::string& name) const { return get_nodearg(m_nodearg_names.find(name)); }
+
+NodeArg* Graph::get_nodearg(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= m_nodeargs.size()) {
+        return nullptr;
     }
 
-    return nullptr;
+    return m_nodeargs[id].get();
 }
 
-void Graph::add_node(std::unique_ptr<Node>&& node) { m_nodes.emplace_back(std::move(node)); }
+size_t Graph::get_nodearg_id_bound() const { return m_nodearg_names.size(); }
 
-const std::vector<Node*>& Graph::get_topological_nodes() const { return m_topological_nodes; }
+void Graph::add_node(std::unique_ptr<Node>&& node) {
+    const int id = node->id();
+    if (id >= 0) {
+        if (static_cast<size_t>(id) >= m_node_index.size()) {
+            m_node_index.resize(static_cast<size_t>(id) + 1, nullptr);
+        }
+        m_node_index[id] = node.get();
+    }
+    m_nodes.emplace_back(std::move(node));
+}
+
+const std::vector<Node*>& Graph::get_topological_nodes() const { return m_view.nodes(); }
+
+const GraphView& Graph::get_view() const { return m_view; }
+
+const std::unordered_map<std::string, std::unique_ptr<Tensor>>& Graph::get_initializers() const {
+    return m_initializer_map;
+}
 
 const std::vector<std::unique_ptr<Node>>& Graph::get_nodes() const { return m_nodes; }
 
+Node* Graph::get_node(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= m_node_index.size()) {
+        return nullptr;
+    }
+
+    return m_node_index[id];
+}
+
+Node* Graph::get_producer_node(const std::string& arg_name) const {
+    return get_producer_node(get_nodearg(arg_name));
+}
+
+Node* Graph::get_producer_node(const NodeArg* arg) const {
+    if (arg == nullptr) {
+        return nullptr;
+    }
+
+    // look up by id, the node may have been erased since the view was built
+    const int producer = m_view.producer(arg->id());
+    return producer < 0 ? nullptr : get_node(m_view.node_id(producer));
+}
+
+const std::vector<NodeArg*>& Graph::get_inputs() const { return m_inputs_exclude_initializer; }
+
+const std::vector<NodeArg*>& Graph::get_inputs_include_initializers() const { return m_inputs_include_initializer; }
+
+const std::vector<NodeArg*>& Graph::get_outputs() const { return m_outputs; }
+
+bool Graph::is_graph_input(const NodeArg* arg) const {
+    return std::find(m_inputs_include_initializer.cbegin(), m_inputs_include_initializer.cend(), arg) !=
+           m_inputs_include_initializer.cend();
+}
+
+bool Graph::is_graph_output(const NodeArg* arg) const {
+    return std::find(m_outputs.cbegin(), m_outputs.cend(), arg) != m_outputs.cend();
+}
+
+Status Graph::erase_node(int id) {
+    Node* node = get_node(id);
+    auto it_node = node == nullptr ? m_nodes.end()
+                                   : std::find_if(m_nodes.begin(), m_nodes.end(),
+                                                  [node](const auto& item) { return item.get() == node; });
+    if (it_node == m_nodes.end()) {
+        std::ostringstream oss;
+        oss << "node not found, nod id: " << id;
+        return Status(StatusCode::FAIL, oss.str());
+    }
+
+    m_node_index[id] = nullptr;
+    m_nodes.erase(it_node);
+    return Status::ok();
+}
+
 Status Graph::initialize() {
     m_inputs_include_initializer.clear();
     m_inputs_exclude_initializer.clear();
@@ -190,21 +274,35 @@ Status Graph::init_inputs_initializers_outputs() {
 }
 
 Status Graph::check_inputs_initializers_names() {
-    std::unordered_set<std::string_view>& inputs_and_initializers = m_topology_context.inputs_and_initializers;
+    // intern the initializer names first, so that the flags below cover every id
+    std::vector<int> initializer_ids;
+    initializer_ids.reserve(m_initializer_map.size());
+    for (auto& item : m_initializer_map) {
+        initializer_ids.emplace_back(m_nodearg_names.intern(item.first));
+    }
+
+    std::vector<bool>& inputs_and_initializers = m_topology_context.inputs_and_initializers;
+    inputs_and_initializers.assign(get_nodearg_id_bound(), false);
 
     // check the input (excluding the initializers) names
     for (auto& item : m_inputs_exclude_initializer) {
-        auto ret = inputs_and_initializers.insert(item->name());
-        if (!ret.second) {
+        if (get_nodearg(item->id()) != item) {
+            std::ostringstream oss;
+            oss << "Input [" << item->name() << "] is not a node arg of the graph";
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
+        if (inputs_and_initializers[item->id()]) {
             std::ostringstream oss;
             oss << "Duplicate input name: " << item->name();
             return Status(StatusCode::INVALID_MODEL, oss.str());
         }
+        inputs_and_initializers[item->id()] = true;
     }
 
     // check the initializer names
-    for (auto& item : m_initializer_map) {
-        inputs_and_initializers.insert(item.first);
+    for (int id : initializer_ids) {
+        inputs_and_initializers[id] = true;
     }
 
     return Status::ok();
@@ -215,10 +313,18 @@ Status Graph::check_no_duplicate_names() {
     auto& output_args = m_topology_context.output_args;
     auto& node_name_to_id = m_topology_context.node_name_to_id;
 
-    output_args.clear();
+    output_args.assign(get_nodearg_id_bound(), nullptr);
     node_name_to_id.clear();
+    node_name_to_id.reserve(m_nodes.size());
 
     for (auto& item : m_nodes) {
+        // the node id indexes the node, it should be unique
+        if (get_node(item->id()) != item.get()) {
+            std::ostringstream oss;
+            oss << "Node id is not unique or not registered: " << item->id();
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
         // check node name shoule be unique
         auto& node_name = item->name();
         if (!node_name.empty() && node_name_to_id.find(node_name) != node_name_to_id.end()) {
@@ -229,24 +335,34 @@ Status Graph::check_no_duplicate_names() {
 
         node_name_to_id[node_name] = item->id();
 
+        // the node args are looked up by id, they should be owned by this graph
+        for (const auto* args : {&item->input_args(), &item->output_args()}) {
+            for (const NodeArg* arg : *args) {
+                if (get_nodearg(arg->id()) != arg) {
+                    std::ostringstream oss;
+                    oss << "Node: " << item->type() << "[" << node_name << "], arg [" << arg->name()
+                        << "] is not a node arg of the graph";
+                    return Status(StatusCode::INVALID_MODEL, oss.str());
+                }
+            }
+        }
+
         // node output's name should be unique
-        int output_index = -1;
         for (auto& output : item->output_args()) {
-            ++output_index;
             auto& output_name = output->name();
             if (!output_name.empty()) {
-                if (inputs_and_initializers.count(output_name)) {
+                if (inputs_and_initializers[output->id()]) {
                     std::ostringstream oss;
                     oss << "Node output name is same to some input/initializer: " << output_name;
                     return Status(StatusCode::INVALID_MODEL, oss.str());
                 }
 
-                auto ret = output_args.insert({output_name, {item.get(), output_index}});
-                if (!ret.second) {
+                if (output_args[output->id()] != nullptr) {
                     std::ostringstream oss;
                     oss << "Node output name is not unique: " << output_name;
                     return Status(StatusCode::INVALID_MODEL, oss.str());
                 }
+                output_args[output->id()] = item.get();
             }
         }
     }
@@ -260,30 +376,19 @@ Status Graph::build_nodes_connections() {
     for (auto& node : m_nodes) {
         const auto& inputs = node->input_args();
         if (!inputs.empty()) {
-            int input_arg_index = -1;
             for (auto& input_arg : inputs) {
-                ++input_arg_index;
-
                 const auto& input_name = input_arg->name();
                 if (input_name.empty()) {
                     continue;
                 }
 
-                auto it_output_arg = m_topology_context.output_args.find(input_name);
-                if (it_output_arg != m_topology_context.output_args.end()) {
-                    // the input to this node is an output from the previous node.
-                    // build connections between this node and the node producing the output
-                    auto& output_node = it_output_arg->second.first;
-                    add_edge(output_node->id(), node->id(), it_output_arg->second.second, input_arg_index);
-                } else {
-                    // the input to this node should be a graph input or initializer
-                    if (m_topology_context.inputs_and_initializers.find(input_name) ==
-                        m_topology_context.inputs_and_initializers.end()) {
-                        std::ostringstream oss;
-                        oss << "Invalid mode. Node input [" << input_name
-                            << " is not a graph input, initializer, or output of a previous node";
-                        return Status(StatusCode::INVALID_MODEL, oss.str());
-                    }
+                // the input to this node should be an output from a node, a graph input or an initializer
+                if (m_topology_context.output_args[input_arg->id()] == nullptr &&
+                    !m_topology_context.inputs_and_initializers[input_arg->id()]) {
+                    std::ostringstream oss;
+                    oss << "Invalid mode. Node input [" << input_name
+                        << " is not a graph input, initializer, or output of a previous node";
+                    return Status(StatusCode::INVALID_MODEL, oss.str());
                 }
             }
         } else if (node->output_args().empty()) {
@@ -292,259 +397,77 @@ Status Graph::build_nodes_connections() {
         }
     }
 
-    // the node has no inputs and outputs. remove it.
+    // the node has no inputs and outputs, nothing connects to it. remove it.
     for (auto& id : unused_nodes_id) {
-        auto status = remove_node(id);
+        auto status = erase_node(id);
         if (!status.is_ok()) {
             return status;
         }
     }
 
-    auto ret = init_node_arg_to_connected_nodes();
-    if (!ret.is_ok()) {
-        return ret;
-    }
-
-    return Status::ok();
-}
-
-Status Graph::remove_node(int id) {
-    auto it_node = std::find_if(m_nodes.begin(), m_nodes.end(), [id](const auto& node) { return node->id() == id; });
-    if (it_node == m_nodes.end()) {
-        return Status::ok();
-    }
-
-    // ensure the node has no outputs
-    if ((*it_node)->output_edges().size() != 0) {
-        std::ostringstream oss;
-        oss << "Remove node fail. the node has " << (*it_node)->output_edges().size() << " output edges";
-        return Status(StatusCode::FAIL, oss.str());
-    }
-
-    // remove the input edges of this node
-    auto& input_edges = (*it_node)->input_edges();
-    for (auto& input_edge : input_edges) {
-        remove_edge(input_edge.other_node().id(), id, input_edge.src_arg_index(), input_edge.dst_arg_index());
-    }
-
-    // erase the node
-    m_nodes.erase(it_node);
-
-    return Status::ok();
-}
-
-Status Graph::add_edge(int src_node_id, int dest_node_id, int src_arg_index, int dst_arg_index) {
-    // find source node
-    auto it_node_src = std::find_if(m_nodes.begin(), m_nodes.end(),
-                                    [src_node_id](const auto& node) { return node->id() == src_node_id; });
-    if (it_node_src == m_nodes.end()) {
-        std::ostringstream oss;
-        oss << "node not found, nod id: " << src_node_id;
-        return Status(StatusCode::FAIL, oss.str());
-    }
-
-    // find destination node
-    auto it_node_dst = std::find_if(m_nodes.begin(), m_nodes.end(),
-                                    [dest_node_id](const auto& node) { return node->id() == dest_node_id; });
-    if (it_node_dst == m_nodes.end()) {
-        std::ostringstream oss;
-        oss << "node not found, nod id: " << dest_node_id;
-        return Status(StatusCode::FAIL, oss.str());
-    }
-
-    // check the arg index
-    if (src_arg_index < 0 || dst_arg_index < 0) {
-        return Status(StatusCode::FAIL, "invalid arg index");
-    }
-
-    NodeArg* src_arg = nullptr;
-    NodeArg* dst_arg = nullptr;
-    if (static_cast<size_t>(src_arg_index) < (*it_node_src)->output_args().size()) {
-        src_arg = (*it_node_src)->output_args()[src_arg_index];
-    } else {
-        return Status(StatusCode::FAIL, "invalid source arg index");
-    }
-
-    if (static_cast<size_t>(dst_arg_index) < (*it_node_dst)->input_args().size()) {
-        dst_arg = (*it_node_dst)->input_args()[dst_arg_index];
-    } else {
-        return Status(StatusCode::FAIL, "invalid destination arg index");
-    }
-
-    if (src_arg != dst_arg) {
-        if (*src_arg != *dst_arg) {
-            return Status(StatusCode::FAIL, "Argument type mismatch");
-        }
-    }
-
-    (*it_node_src)->add_output_edge(Edge(*(it_node_dst->get()), src_arg_index, dst_arg_index));
-    (*it_node_dst)->add_input_edge(Edge(*(it_node_src->get()), src_arg_index, dst_arg_index));
-
-    return Status::ok();
-}
-
-Status Graph::remove_edge(int src_node_id, int dest_node_id, int src_arg_index, int dst_arg_index) {
-    // find source node
-    auto it_node_src = std::find_if(m_nodes.begin(), m_nodes.end(),
-                                    [src_node_id](const auto& node) { return node->id() == src_node_id; });
-    if (it_node_src == m_nodes.end()) {
-        std::ostringstream oss;
-        oss << "node not found, nod id: " << src_node_id;
-        return Status(StatusCode::FAIL, oss.str());
-    }
-
-    // find destination node
-    auto it_node_dst = std::find_if(m_nodes.begin(), m_nodes.end(),
-                                    [dest_node_id](const auto& node) { return node->id() == dest_node_id; });
-    if (it_node_dst == m_nodes.end()) {
-        std::ostringstream oss;
-        oss << "node not found, nod id: " << dest_node_id;
-        return Status(StatusCode::FAIL, oss.str());
-    }
-
-    // check the arg index
-    if (src_arg_index < 0 || dst_arg_index < 0) {
-        return Status(StatusCode::FAIL, "invalid arg index");
-    }
-
-    NodeArg* src_arg = nullptr;
-    NodeArg* dst_arg = nullptr;
-    if (static_cast<size_t>(src_arg_index) < (*it_node_src)->output_args().size()) {
-        src_arg = (*it_node_src)->output_args()[src_arg_index];
-    } else {
-        return Status(StatusCode::FAIL, "invalid source arg index");
-    }
-
-    if (static_cast<size_t>(dst_arg_index) < (*it_node_dst)->input_args().size()) {
-        dst_arg = (*it_node_dst)->input_args()[dst_arg_index];
-    } else {
-        return Status(StatusCode::FAIL, "invalid destination arg index");
-    }
-
-    if (src_arg != dst_arg) {
-        return Status(StatusCode::FAIL, "Argument mismatch when removing edge");
-    }
-
-    (*it_node_dst)->remove_input_edge(Edge((*(*it_node_src).get()), src_arg_index, dst_arg_index));
-    (*it_node_src)->remove_output_edge(Edge((*(*it_node_dst).get()), src_arg_index, dst_arg_index));
-
-    return Status::ok();
-}
-
-Status Graph::init_node_arg_to_connected_nodes() {
-    m_node_arg_to_producer_node.clear();
-    m_node_arg_to_consumer_nodes.clear();
-
-    for (auto& node : m_nodes) {
-        for (auto& input : node->input_args()) {
-            m_node_arg_to_consumer_nodes[input->name()].insert(node->id());
-        }
-
-        for (auto& output : node->output_args()) {
-            m_node_arg_to_producer_node.insert({output->name(), node->id()});
-        }
-    }
-
     return Status::ok();
 }
 
 Status Graph::topological_sort() {
-    m_topological_nodes.clear();
-
-    std::unordered_set<int> downstream_nodes;    // downstream nodes id of the current node
-    std::unordered_set<int> nodes_visited;       // the nodes id visited
-    std::unordered_set<int> nodes_added;         // the nodes id added
-    std::stack<int> nodes_stack;                 // the nodes id stack for depth-first search
-
-    // add the graph input to topological nodes list
-    std::for_each(m_nodes.cbegin(), m_nodes.cend(), [&](const auto& node) {
-        auto& input_edges = node->input_edges();
-        if (input_edges.size() == 0) {
-            m_topological_nodes.emplace_back(node.get());
-            nodes_visited.insert(node->id());
-            nodes_added.insert(node->id());
-        }
-    });
-
-    // find all the leaf nods
-    for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it) {
-        if ((*it)->output_edges().empty()) {
-            nodes_stack.push((*it)->id());
+    // the connections in the graph order
+    GraphView graph_order_view;
+    std::vector<Node*> nodes;
+    nodes.reserve(m_nodes.size());
+    std::for_each(m_nodes.cbegin(), m_nodes.cend(), [&nodes](const auto& node) { nodes.emplace_back(node.get()); });
+    graph_order_view.build(*this, std::move(nodes));
+
+    // Kahn's algorithm over the view. the in-degree of a node is the number of its input edges, every output edge of
+    // a sorted node releases one of them. the sorted nodes double as the FIFO queue
+    const int node_num = static_cast<int>(graph_order_view.node_num());
+    std::vector<size_t> in_degrees(node_num);
+    std::vector<int> sorted_nodes;
+    sorted_nodes.reserve(node_num);
+    for (int i = 0; i < node_num; ++i) {
+        in_degrees[i] = graph_order_view.input_edges(i).size();
+        if (in_degrees[i] == 0) {
+            sorted_nodes.emplace_back(i);
         }
     }
 
-    while (!nodes_stack.empty()) {
-        auto& current_node = nodes_stack.top();
-        nodes_stack.pop();
-
-        auto current_node_ptr = std::find_if(m_nodes.cbegin(), m_nodes.cend(), [current_node](const auto& item) {
-            if (item->id() == current_node) {
-                return true;
-            } else {
-                return false;
-            }
-        });
-
-        if (current_node_ptr == m_nodes.cend()) {
-            continue;
-        }
-
-        if (nodes_added.find(current_node) != nodes_added.end()) {
-            continue;
-        }
-
-        if (nodes_visited.find(current_node) != nodes_visited.end()) {
-            m_topological_nodes.emplace_back(current_node_ptr->get());
-            nodes_added.insert(current_node);
-            downstream_nodes.erase(current_node);
-            continue;
-        }
-
-        nodes_visited.insert(current_node);
-        downstream_nodes.insert(current_node);
-
-        nodes_stack.push(current_node);
-
-        for (auto it_input = (*current_node_ptr)->input_edges().cbegin();
-             it_input != (*current_node_ptr)->input_edges().cend(); ++it_input) {
-            auto other_node_id = it_input->other_node().id();
-            if (downstream_nodes.find(other_node_id) != downstream_nodes.end()) {
-                return Status(StatusCode::INVALID_MODEL, "The graph is not a DAG");
-            }
-
-            if (nodes_visited.find(other_node_id) == nodes_visited.end()) {
-                nodes_stack.push(other_node_id);
+    for (size_t head = 0; head < sorted_nodes.size(); ++head) {
+        for (const auto& output_edge : graph_order_view.output_edges(sorted_nodes[head])) {
+            if (--in_degrees[output_edge.node] == 0) {
+                sorted_nodes.emplace_back(output_edge.node);
             }
         }
     }
 
-    if (m_topological_nodes.size() != m_nodes.size()) {
-        return Status(StatusCode::INVALID_MODEL, "the graph is not a DAG");
+    // the nodes on a cycle never reach in-degree zero
+    if (sorted_nodes.size() != m_nodes.size()) {
+        m_view.clear();
+        return Status(StatusCode::INVALID_MODEL, "The graph is not a DAG");
     }
 
+    std::vector<Node*> topological_nodes(node_num);
+    std::transform(sorted_nodes.cbegin(), sorted_nodes.cend(), topological_nodes.begin(),
+                   [&graph_order_view](int i) { return graph_order_view.node(i); });
+    m_view.build(*this, std::move(topological_nodes));
+
     return Status::ok();
 }
 
 Status Graph::clean_unused_initializers_args() {
-    std::unordered_set<const NodeArg*> used_node_args;
+    // whether the node arg is used, indexed by the node arg id
+    std::vector<bool> used_node_args(get_nodearg_id_bound(), false);
+    auto mark_used = [&used_node_args](const NodeArg* item) { used_node_args[item->id()] = true; };
 
     // the graph inputs(exclude initializers) must be in used node args set
-    std::for_each(m_inputs_exclude_initializer.cbegin(), m_inputs_exclude_initializer.cend(),
-                  [&used_node_args](const NodeArg* item) { used_node_args.insert(item); });
+    std::for_each(m_inputs_exclude_initializer.cbegin(), m_inputs_exclude_initializer.cend(), mark_used);
 
     // the grapn overridable initializers must be in used node args set
-    std::for_each(m_overridable_initializers.cbegin(), m_overridable_initializers.cend(),
-                  [&used_node_args](const NodeArg* item) { used_node_args.insert(item); });
+    std::for_each(m_overridable_initializers.cbegin(), m_overridable_initializers.cend(), mark_used);
 
     // the graph outputs must be in used node args set
-    std::for_each(m_outputs.cbegin(), m_outputs.cend(),
-                  [&used_node_args](const NodeArg* item) { used_node_args.insert(item); });
+    std::for_each(m_outputs.cbegin(), m_outputs.cend(), mark_used);
 
     // the nodes inputs must be in used node args set
     for (const auto& node : m_nodes) {
-        for (const auto& input_arg : node->input_args()) {
-            used_node_args.insert(input_arg);
-        }
+        std::for_each(node->input_args().cbegin(), node->input_args().cend(), mark_used);
     }
 
     std::vector<std::string> erase_initializers;
@@ -557,7 +480,7 @@ Status Graph::clean_unused_initializers_args() {
             return Status(StatusCode::FAIL, oss.str());
         }
 
-        if (used_node_args.find(tmp_node_arg) == used_node_args.cend()) {
+        if (!used_node_args[tmp_node_arg->id()]) {
             erase_initializers.emplace_back(init_name);
         }
     }
@@ -574,19 +497,13 @@ Status Graph::clean_unused_initializers_args() {
 
     // the nodes outputs
     for (const auto& node : m_nodes) {
-        for (const auto& output_arg : node->output_args()) {
-            used_node_args.insert(output_arg);
-        }
+        std::for_each(node->output_args().cbegin(), node->output_args().cend(), mark_used);
     }
 
-    for (auto it = m_nodearg_map.begin(); it != m_nodearg_map.end();) {
-        const auto* current_node_arg = it->second.get();
-        const auto& node_arg_name = it->first;
-
-        if (!node_arg_name.empty() && used_node_args.find(current_node_arg) == used_node_args.cend()) {
-            it = m_nodearg_map.erase(it);
-        } else {
-            ++it;
+    for (size_t id = 0; id < m_nodeargs.size(); ++id) {
+        auto& node_arg = m_nodeargs[id];
+        if (node_arg && !node_arg->name().empty() && !used_node_args[id]) {
+            node_arg.reset();
         }
     }
 
@@ -594,15 +511,9 @@ Status Graph::clean_unused_initializers_args() {
 }
 
 Status Graph::infer_shape() {
-    for (auto& node : m_topological_nodes) {
-        IShapeInfer* infer = NodeShapeManager::instance()->get_shape_infer(node->type());
-        if(!infer){
-            std::ostringstream oss;
-            oss << "Infer object for node: " << node->type() << "[" << node->name() << "]" << " not found";
-            return Status(StatusCode::FAIL, oss.str());
-        }
-        auto ret = node->infer_shape(infer);
-        if(!ret.is_ok()){
+    for (auto& node : m_view.nodes()) {
+        auto ret = infer_node_shape(node);
+        if (!ret.is_ok()) {
             return ret;
         }
     }
@@ -610,5 +521,32 @@ Status Graph::infer_shape() {
     return Status::ok();
 }
 
+Status Graph::infer_node_shape(Node* node) {
+    IShapeInfer* infer = NodeShapeManager::instance()->get_shape_infer(node->type());
+    if(!infer){
+        std::ostringstream oss;
+        oss << "Infer object for node: " << node->type() << "[" << node->name() << "]" << " not found";
+        return Status(StatusCode::FAIL, oss.str());
+    }
+    auto ret = node->infer_shape(infer);
+    if(!ret.is_ok()){
+        return ret;
+    }
+
+    // the supported operators produce outputs of the same data type as their first typed input
+    auto it_typed = std::find_if(node->input_args().cbegin(), node->input_args().cend(), [](const NodeArg* arg) {
+        return arg->data_type() != PrimitiveDataType::UNKNOWN;
+    });
+    if (it_typed != node->input_args().cend()) {
+        for (auto* output : node->output_args()) {
+            if (output->data_type() == PrimitiveDataType::UNKNOWN) {
+                output->set_data_type((*it_typed)->data_type());
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
 }    // namespace ir
 }    // namespace simple_ai
\ No newline at end of file
@@ -0,0 +1,538 @@
+#include "ir/graph_transaction.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+using namespace simple_ai::common;
+
+namespace simple_ai {
+namespace ir {
+
+GraphTransaction::GraphTransaction(Graph& graph) : m_graph(graph) {}
+
+GraphTransaction::~GraphTransaction() { rollback(); }
+
+int GraphTransaction::next_node_id() const { return static_cast<int>(m_graph.m_node_index.size()); }
+
+Node* GraphTransaction::add_node(std::unique_ptr<Node>&& node) {
+    Node* added = node.get();
+    m_graph.add_node(std::move(node));
+
+    m_changes.emplace_back();
+    m_changes.back().type = Change::Type::ADD_NODE;
+    m_changes.back().node = added;
+    touch(added);
+    return added;
+}
+
+Status GraphTransaction::erase_node(int id) {
+    if (m_graph.get_node(id) == nullptr || !m_erased_nodes.insert(id).second) {
+        std::ostringstream oss;
+        oss << "node not found, node id: " << id;
+        return Status(StatusCode::FAIL, oss.str());
+    }
+
+    return Status::ok();
+}
+
+bool GraphTransaction::is_erased(int id) const { return m_erased_nodes.count(id) != 0; }
+
+void GraphTransaction::add_input_arg(Node* node, NodeArg* arg) {
+    m_changes.emplace_back();
+    m_changes.back().type = Change::Type::ADD_INPUT;
+    m_changes.back().node = node;
+    m_changes.back().index = node->input_args().size();
+    node->add_input_arg(arg);
+    touch(node);
+}
+
+void GraphTransaction::replace_input_arg(Node* node, size_t index, NodeArg* arg) {
+    if (index >= node->input_args().size()) {
+        return;
+    }
+
+    m_changes.emplace_back();
+    m_changes.back().type = Change::Type::REPLACE_INPUT;
+    m_changes.back().node = node;
+    m_changes.back().index = index;
+    m_changes.back().arg = node->input_args()[index];
+    node->replace_input_arg(index, arg);
+    touch(node);
+}
+
+void GraphTransaction::replace_output_arg(Node* node, size_t index, NodeArg* arg) {
+    if (index >= node->output_args().size()) {
+        return;
+    }
+
+    m_changes.emplace_back();
+    m_changes.back().type = Change::Type::REPLACE_OUTPUT;
+    m_changes.back().node = node;
+    m_changes.back().index = index;
+    m_changes.back().arg = node->output_args()[index];
+    node->replace_output_arg(index, arg);
+    touch(node);
+}
+
+void GraphTransaction::set_op_type(Node* node, const std::string& type, const std::string& domain) {
+    m_changes.emplace_back();
+    m_changes.back().type = Change::Type::SET_OP_TYPE;
+    m_changes.back().node = node;
+    m_changes.back().name = node->type();
+    m_changes.back().domain = node->domain();
+    node->set_op_type(type, domain);
+    touch(node);
+}
+
+void GraphTransaction::set_attribute(Node* node, std::unique_ptr<NodeAttribute>&& attr) {
+    m_changes.emplace_back();
+    m_changes.back().type = Change::Type::SET_ATTRIBUTE;
+    m_changes.back().node = node;
+    m_changes.back().name = attr->name();
+    m_changes.back().attribute = node->release_attribute(attr->name());
+    node->set_attribute(std::move(attr));
+    touch(node);
+}
+
+bool GraphTransaction::empty() const { return m_changes.empty() && m_erased_nodes.empty(); }
+
+void GraphTransaction::touch(Node* node) { m_changed_nodes.emplace_back(node->id()); }
+
+Status GraphTransaction::commit() {
+    if (empty()) {
+        return Status::ok();
+    }
+
+    const GraphView& old_view = m_graph.m_view;
+    const size_t node_id_bound = m_graph.m_node_index.size();
+    std::vector<bool> erased(node_id_bound, false);
+    std::vector<bool> changed(node_id_bound, false);
+    for (int id : m_erased_nodes) {
+        erased[id] = true;
+    }
+
+    // the distinct changed nodes which are not erased, and the added nodes
+    std::vector<int> changed_nodes;
+    std::vector<Node*> added_nodes;
+    for (int id : m_changed_nodes) {
+        if (changed[id]) {
+            continue;
+        }
+
+        changed[id] = true;
+        if (old_view.index_of(id) < 0) {
+            added_nodes.emplace_back(m_graph.get_node(id));
+        }
+        if (!erased[id]) {
+            changed_nodes.emplace_back(id);
+        }
+    }
+
+    if (old_view.node_num() + added_nodes.size() != m_graph.m_nodes.size()) {
+        rollback();
+        return Status(StatusCode::FAIL, "The graph view is out of date, construct the topology before rewriting");
+    }
+
+    // Step 1. keep the topological order: drop the erased nodes, and insert every added node right after the last
+    // producer of its inputs in the previous order
+    std::unordered_map<int, int> added_output_anchors;
+    std::vector<std::pair<int, Node*>> anchored_nodes;
+    for (Node* node : added_nodes) {
+        int anchor = -1;
+        for (const NodeArg* input : node->input_args()) {
+            auto it = added_output_anchors.find(input->id());
+            anchor = std::max(anchor, it != added_output_anchors.end() ? it->second : old_view.producer(input->id()));
+        }
+        for (const NodeArg* output : node->output_args()) {
+            added_output_anchors[output->id()] = anchor;
+        }
+        anchored_nodes.emplace_back(anchor, node);
+    }
+    std::stable_sort(anchored_nodes.begin(), anchored_nodes.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    std::vector<Node*> nodes;
+    std::vector<int> previous_indices;
+    nodes.reserve(m_graph.m_nodes.size());
+    previous_indices.reserve(m_graph.m_nodes.size());
+    auto it_anchored = anchored_nodes.cbegin();
+    for (int i = -1; i < static_cast<int>(old_view.node_num()); ++i) {
+        if (i >= 0 && !erased[old_view.node_id(i)]) {
+            nodes.emplace_back(old_view.node(i));
+            previous_indices.emplace_back(i);
+        }
+        for (; it_anchored != anchored_nodes.cend() && it_anchored->first == i; ++it_anchored) {
+            if (!erased[it_anchored->second->id()]) {
+                nodes.emplace_back(it_anchored->second);
+                previous_indices.emplace_back(-1);
+            }
+        }
+    }
+
+    std::vector<bool> changed_indices(nodes.size(), false);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        changed_indices[i] = previous_indices[i] < 0 || changed[old_view.node_id(previous_indices[i])];
+    }
+
+    GraphView view;
+    view.rebuild(m_graph, old_view, nodes, previous_indices, changed_indices);
+
+    // Step 2. validate the changed nodes and the args which lost their producer
+    auto ret = validate(view, changed_nodes, changed, erased);
+    if (!ret.is_ok()) {
+        rollback();
+        return ret;
+    }
+
+    // Step 3. repair the order around the edges of the changed nodes which go backward
+    std::vector<int> order;
+    ret = repair_order(view, changed_nodes, order);
+    if (!ret.is_ok()) {
+        rollback();
+        return ret;
+    }
+
+    if (!order.empty()) {
+        std::vector<Node*> sorted_nodes(order.size());
+        std::transform(order.cbegin(), order.cend(), sorted_nodes.begin(), [&view](int i) { return view.node(i); });
+        GraphView sorted_view;
+        sorted_view.rebuild(m_graph, view, std::move(sorted_nodes), order, std::vector<bool>(order.size(), false));
+        view = std::move(sorted_view);
+    }
+
+    // Step 4. infer the shapes from the changed nodes
+    std::vector<ArgState> replaced_states;
+    ret = infer_shape(view, changed_nodes, replaced_states);
+    if (!ret.is_ok()) {
+        for (auto it = replaced_states.rbegin(); it != replaced_states.rend(); ++it) {
+            it->arg->set_shape(it->shape);
+            it->arg->set_data_type(it->data_type);
+        }
+        rollback();
+        return ret;
+    }
+
+    // Step 5. erase the nodes, and release the args which lost all their consumers and their producer
+    std::vector<NodeArg*> released_candidates;
+    for (const auto& change : m_changes) {
+        if (change.type == Change::Type::REPLACE_INPUT || change.type == Change::Type::REPLACE_OUTPUT) {
+            released_candidates.emplace_back(change.arg);
+        }
+    }
+    for (int id : m_erased_nodes) {
+        const Node* node = m_graph.get_node(id);
+        for (const auto* args : {&node->input_args(), &node->output_args()}) {
+            released_candidates.insert(released_candidates.end(), args->cbegin(), args->cend());
+        }
+    }
+    std::sort(released_candidates.begin(), released_candidates.end());
+    released_candidates.erase(std::unique(released_candidates.begin(), released_candidates.end()),
+                              released_candidates.end());
+
+    if (!m_erased_nodes.empty()) {
+        auto& graph_nodes = m_graph.m_nodes;
+        graph_nodes.erase(std::remove_if(graph_nodes.begin(), graph_nodes.end(),
+                                         [&erased](const auto& node) { return erased[node->id()]; }),
+                          graph_nodes.end());
+        for (int id : m_erased_nodes) {
+            m_graph.m_node_index[id] = nullptr;
+        }
+    }
+    m_graph.m_view = std::move(view);
+
+    const GraphView& new_view = m_graph.m_view;
+    for (NodeArg* arg : released_candidates) {
+        if (arg->name().empty() || new_view.producer(arg->id()) >= 0 || !new_view.consumers(arg->id()).empty() ||
+            m_graph.is_graph_input(arg) || m_graph.is_graph_output(arg)) {
+            continue;
+        }
+
+        m_graph.m_initializer_map.erase(arg->name());
+        m_graph.m_nodeargs[arg->id()].reset();
+    }
+
+    m_changes.clear();
+    m_changed_nodes.clear();
+    m_erased_nodes.clear();
+    return Status::ok();
+}
+
+Status GraphTransaction::validate(const GraphView& view, const std::vector<int>& changed_nodes,
+                                  const std::vector<bool>& changed, const std::vector<bool>& erased) const {
+    const GraphView& old_view = m_graph.m_view;
+    auto is_input_or_initializer = [this](const NodeArg* arg) {
+        return m_graph.is_graph_input(arg) || m_graph.get_initializer(arg->name()) != nullptr;
+    };
+
+    for (int id : changed_nodes) {
+        const int index = view.index_of(id);
+        const Node* node = view.node(index);
+
+        // the node args are looked up by id, they should be owned by this graph
+        for (const auto* args : {&node->input_args(), &node->output_args()}) {
+            for (const NodeArg* arg : *args) {
+                if (m_graph.get_nodearg(arg->id()) != arg) {
+                    std::ostringstream oss;
+                    oss << "Node: " << node->type() << "[" << node->name() << "], arg [" << arg->name()
+                        << "] is not a node arg of the graph";
+                    return Status(StatusCode::INVALID_MODEL, oss.str());
+                }
+            }
+        }
+
+        for (const NodeArg* output : node->output_args()) {
+            if (output->name().empty()) {
+                continue;
+            }
+
+            if (is_input_or_initializer(output)) {
+                std::ostringstream oss;
+                oss << "Node output name is same to some input/initializer: " << output->name();
+                return Status(StatusCode::INVALID_MODEL, oss.str());
+            }
+
+            // another node produces the arg: a later one in the view, or an unchanged one which produced it before
+            const int old_producer = old_view.producer(output->id());
+            const int old_producer_id = old_producer < 0 ? -1 : old_view.node_id(old_producer);
+            if (view.producer(output->id()) != index ||
+                (old_producer_id >= 0 && old_producer_id != id && !erased[old_producer_id] &&
+                 !changed[old_producer_id])) {
+                std::ostringstream oss;
+                oss << "Node output name is not unique: " << output->name();
+                return Status(StatusCode::INVALID_MODEL, oss.str());
+            }
+        }
+
+        // the input to this node should be an output from a node, a graph input or an initializer
+        for (const NodeArg* input : node->input_args()) {
+            if (!input->name().empty() && view.producer(input->id()) < 0 && !is_input_or_initializer(input)) {
+                std::ostringstream oss;
+                oss << "Invalid mode. Node input [" << input->name()
+                    << " is not a graph input, initializer, or output of a previous node";
+                return Status(StatusCode::INVALID_MODEL, oss.str());
+            }
+        }
+    }
+
+    // the args which lost their producer should not be used any more
+    std::vector<const NodeArg*> orphan_args;
+    for (const auto& change : m_changes) {
+        if (change.type == Change::Type::REPLACE_OUTPUT) {
+            orphan_args.emplace_back(change.arg);
+        }
+    }
+    for (int id : m_erased_nodes) {
+        const auto& outputs = m_graph.get_node(id)->output_args();
+        orphan_args.insert(orphan_args.end(), outputs.cbegin(), outputs.cend());
+    }
+
+    for (const NodeArg* arg : orphan_args) {
+        if (arg->name().empty() || view.producer(arg->id()) >= 0 || is_input_or_initializer(arg)) {
+            continue;
+        }
+
+        if (!view.consumers(arg->id()).empty() || m_graph.is_graph_output(arg)) {
+            std::ostringstream oss;
+            oss << "Invalid model. Node arg [" << arg->name() << "] is used, but its producer is removed";
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+    }
+
+    return Status::ok();
+}
+
+Status GraphTransaction::repair_order(const GraphView& view, const std::vector<int>& changed_nodes,
+                                      std::vector<int>& order) const {
+    // the unchanged edges keep their direction, only the edges of the changed nodes may go backward. every backward
+    // edge u -> v is repaired by Pearce-Kelly: within the positions [v, u], the nodes reaching u are moved before
+    // the nodes reachable from v, keeping their relative order. both searches stay inside [v, u], so they never
+    // follow another backward edge which is not repaired yet
+    const int node_num = static_cast<int>(view.node_num());
+    std::vector<int> positions;
+    std::vector<char> visited;
+    std::vector<int> forward;
+    std::vector<int> backward;
+    std::vector<int> stack;
+
+    auto reorder = [&](int u, int v) {
+        if (positions.empty()) {
+            positions.resize(node_num);
+            order.resize(node_num);
+            for (int i = 0; i < node_num; ++i) {
+                positions[i] = i;
+                order[i] = i;
+            }
+            visited.assign(node_num, 0);
+        }
+
+        if (u == v) {
+            return false;
+        }
+        const int lower = positions[v];
+        const int upper = positions[u];
+
+        // the nodes reachable from v, which are not after u
+        forward.clear();
+        stack.assign(1, v);
+        visited[v] = 1;
+        while (!stack.empty()) {
+            const int node = stack.back();
+            stack.pop_back();
+            forward.emplace_back(node);
+            for (const auto& edge : view.output_edges(node)) {
+                if (edge.node == u) {
+                    return false;
+                }
+                if (!visited[edge.node] && positions[edge.node] > lower && positions[edge.node] < upper) {
+                    visited[edge.node] = 1;
+                    stack.emplace_back(edge.node);
+                }
+            }
+        }
+
+        // the nodes reaching u, which are not before v
+        backward.clear();
+        stack.assign(1, u);
+        visited[u] = 1;
+        while (!stack.empty()) {
+            const int node = stack.back();
+            stack.pop_back();
+            backward.emplace_back(node);
+            for (const auto& edge : view.input_edges(node)) {
+                if (!visited[edge.node] && positions[edge.node] > lower && positions[edge.node] < upper) {
+                    visited[edge.node] = 1;
+                    stack.emplace_back(edge.node);
+                }
+            }
+        }
+
+        auto by_position = [&positions](int lhs, int rhs) { return positions[lhs] < positions[rhs]; };
+        std::sort(forward.begin(), forward.end(), by_position);
+        std::sort(backward.begin(), backward.end(), by_position);
+
+        std::vector<int> slots;
+        slots.reserve(forward.size() + backward.size());
+        for (const auto* region : {&forward, &backward}) {
+            for (int node : *region) {
+                slots.emplace_back(positions[node]);
+                visited[node] = 0;
+            }
+        }
+        std::sort(slots.begin(), slots.end());
+
+        auto it_slot = slots.cbegin();
+        for (const auto* region : {&backward, &forward}) {
+            for (int node : *region) {
+                positions[node] = *it_slot++;
+                order[positions[node]] = node;
+            }
+        }
+        return true;
+    };
+
+    // the view index is the position until the first repair
+    auto position = [&positions](int node) { return positions.empty() ? node : positions[node]; };
+    for (int id : changed_nodes) {
+        const int index = view.index_of(id);
+        for (const auto& edge : view.input_edges(index)) {
+            if (position(edge.node) >= position(index) && !reorder(edge.node, index)) {
+                return Status(StatusCode::INVALID_MODEL, "The graph is not a DAG");
+            }
+        }
+        for (const auto& edge : view.output_edges(index)) {
+            if (position(index) >= position(edge.node) && !reorder(index, edge.node)) {
+                return Status(StatusCode::INVALID_MODEL, "The graph is not a DAG");
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+Status GraphTransaction::infer_shape(const GraphView& view, const std::vector<int>& changed_nodes,
+                                     std::vector<ArgState>& replaced_states) const {
+    // the nodes are visited in topological order, a node is inferred if it is changed or one of its inputs changed
+    const int node_num = static_cast<int>(view.node_num());
+    std::vector<bool> dirty(node_num, false);
+    int first = node_num;
+    for (int id : changed_nodes) {
+        const int index = view.index_of(id);
+        dirty[index] = true;
+        first = std::min(first, index);
+    }
+
+    for (int i = first; i < node_num; ++i) {
+        if (!dirty[i]) {
+            continue;
+        }
+
+        Node* node = view.node(i);
+        const size_t begin = replaced_states.size();
+        for (NodeArg* output : node->output_args()) {
+            replaced_states.push_back({output, output->data_type(), output->shape()});
+        }
+
+        auto ret = m_graph.infer_node_shape(node);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+
+        for (size_t k = begin; k < replaced_states.size(); ++k) {
+            const auto& state = replaced_states[k];
+            if (state.arg->shape() == state.shape && state.arg->data_type() == state.data_type) {
+                continue;
+            }
+
+            for (int consumer : view.consumers(state.arg->id())) {
+                dirty[consumer] = true;
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+void GraphTransaction::rollback() {
+    for (auto it = m_changes.rbegin(); it != m_changes.rend(); ++it) {
+        Node* node = it->node;
+        switch (it->type) {
+            case Change::Type::ADD_NODE:
+                m_graph.erase_node(node->id());
+                break;
+            case Change::Type::ADD_INPUT:
+                node->remove_input_arg(it->index);
+                break;
+            case Change::Type::REPLACE_INPUT:
+                node->replace_input_arg(it->index, it->arg);
+                break;
+            case Change::Type::REPLACE_OUTPUT:
+                node->replace_output_arg(it->index, it->arg);
+                break;
+            case Change::Type::SET_OP_TYPE:
+                node->set_op_type(it->name, it->domain);
+                break;
+            case Change::Type::SET_ATTRIBUTE:
+                node->release_attribute(it->name);
+                if (it->attribute) {
+                    node->set_attribute(std::move(it->attribute));
+                }
+                break;
+            default:
+                break;
+        }
+
+        // the restored attributes were decoded successfully before the transaction
+        if (it->type == Change::Type::SET_OP_TYPE || it->type == Change::Type::SET_ATTRIBUTE) {
+            (void)node->decode_params();
+        }
+    }
+
+    m_changes.clear();
+    m_changed_nodes.clear();
+    m_erased_nodes.clear();
+}
+
+}    // namespace ir
+}    // namespace simple_ai
@@ -0,0 +1,291 @@
+#include "ir/graph_view.h"
+
+#include <algorithm>
+
+#include "ir/graph.h"
+#include "ir/node.h"
+
+namespace simple_ai {
+namespace ir {
+
+void GraphView::build(const Graph& graph, std::vector<Node*> nodes) {
+    m_nodes = std::move(nodes);
+    const int node_num = static_cast<int>(m_nodes.size());
+    const size_t arg_num = graph.get_nodearg_id_bound();
+
+    int max_node_id = -1;
+    m_node_ids.resize(node_num);
+    for (int i = 0; i < node_num; ++i) {
+        m_node_ids[i] = m_nodes[i]->id();
+        max_node_id = std::max(max_node_id, m_node_ids[i]);
+    }
+    m_node_index.assign(static_cast<size_t>(max_node_id + 1), -1);
+    for (int i = 0; i < node_num; ++i) {
+        m_node_index[m_node_ids[i]] = i;
+    }
+
+    // the producer node and the arg index in its outputs
+    std::vector<int> producer_slots(arg_num, -1);
+    m_arg_producers.assign(arg_num, -1);
+    for (int i = 0; i < node_num; ++i) {
+        const auto& outputs = m_nodes[i]->output_args();
+        for (size_t j = 0; j < outputs.size(); ++j) {
+            if (!outputs[j]->name().empty()) {
+                m_arg_producers[outputs[j]->id()] = i;
+                producer_slots[outputs[j]->id()] = static_cast<int>(j);
+            }
+        }
+    }
+
+    // the input edges, while counting the output edges and the consumers
+    std::vector<int> last_consumers(arg_num, -1);
+    m_input_offsets.assign(node_num + 1, 0);
+    m_output_offsets.assign(node_num + 1, 0);
+    m_arg_consumer_offsets.assign(arg_num + 1, 0);
+    m_input_edges.clear();
+    for (int i = 0; i < node_num; ++i) {
+        const auto& inputs = m_nodes[i]->input_args();
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            if (inputs[j]->name().empty()) {
+                continue;
+            }
+
+            const int arg_id = inputs[j]->id();
+            if (last_consumers[arg_id] != i) {
+                last_consumers[arg_id] = i;
+                ++m_arg_consumer_offsets[arg_id + 1];
+            }
+
+            const int producer = m_arg_producers[arg_id];
+            if (producer >= 0) {
+                m_input_edges.push_back({producer, producer_slots[arg_id], static_cast<int>(j)});
+                ++m_output_offsets[producer + 1];
+            }
+        }
+        m_input_offsets[i + 1] = m_input_edges.size();
+    }
+
+    for (int i = 0; i < node_num; ++i) {
+        m_output_offsets[i + 1] += m_output_offsets[i];
+    }
+    for (size_t i = 0; i < arg_num; ++i) {
+        m_arg_consumer_offsets[i + 1] += m_arg_consumer_offsets[i];
+    }
+
+    // scatter the output edges and the consumers, in ascending order of the consumer nodes
+    std::vector<size_t> cursors(m_output_offsets.begin(), m_output_offsets.end() - 1);
+    m_output_edges.resize(m_input_edges.size());
+    for (int i = 0; i < node_num; ++i) {
+        for (const auto& edge : input_edges(i)) {
+            m_output_edges[cursors[edge.node]++] = {i, edge.src_arg_index, edge.dst_arg_index};
+        }
+    }
+
+    cursors.assign(m_arg_consumer_offsets.begin(), m_arg_consumer_offsets.end() - 1);
+    last_consumers.assign(arg_num, -1);
+    m_arg_consumers.resize(m_arg_consumer_offsets.back());
+    for (int i = 0; i < node_num; ++i) {
+        for (const auto* input : m_nodes[i]->input_args()) {
+            if (!input->name().empty() && last_consumers[input->id()] != i) {
+                last_consumers[input->id()] = i;
+                m_arg_consumers[cursors[input->id()]++] = i;
+            }
+        }
+    }
+}
+
+void GraphView::rebuild(const Graph& graph, const GraphView& previous, std::vector<Node*> nodes,
+                        const std::vector<int>& previous_indices, const std::vector<bool>& changed) {
+    m_nodes = std::move(nodes);
+    const int node_num = static_cast<int>(m_nodes.size());
+    const size_t arg_num = graph.get_nodearg_id_bound();
+    const size_t previous_arg_num = previous.m_arg_producers.size();
+
+    // the index of the unchanged nodes in this view, indexed by their previous index. -1 for the other nodes
+    std::vector<int> kept_indices(previous.node_num(), -1);
+    bool keep_order = true;
+    int last_kept = -1;
+    int max_node_id = -1;
+    m_node_ids.resize(node_num);
+    for (int i = 0; i < node_num; ++i) {
+        const int previous_index = previous_indices[i];
+        m_node_ids[i] = previous_index >= 0 ? previous.m_node_ids[previous_index] : m_nodes[i]->id();
+        max_node_id = std::max(max_node_id, m_node_ids[i]);
+        if (previous_index >= 0 && !changed[i]) {
+            kept_indices[previous_index] = i;
+            keep_order = keep_order && previous_index > last_kept;
+            last_kept = previous_index;
+        }
+    }
+    m_node_index.assign(static_cast<size_t>(max_node_id + 1), -1);
+    for (int i = 0; i < node_num; ++i) {
+        m_node_index[m_node_ids[i]] = i;
+    }
+
+    // the producers: the unchanged ones are moved, the outputs of the changed nodes are read
+    m_arg_producers.assign(arg_num, -1);
+    for (size_t arg_id = 0; arg_id < previous_arg_num; ++arg_id) {
+        const int producer = previous.m_arg_producers[arg_id];
+        if (producer >= 0) {
+            m_arg_producers[arg_id] = kept_indices[producer];
+        }
+    }
+
+    std::vector<int> changed_nodes;
+    for (int i = 0; i < node_num; ++i) {
+        if (!changed[i]) {
+            continue;
+        }
+
+        changed_nodes.emplace_back(i);
+        for (const NodeArg* output : m_nodes[i]->output_args()) {
+            if (!output->name().empty()) {
+                m_arg_producers[output->id()] = i;
+            }
+        }
+    }
+
+    // the input edges: the edges between unchanged nodes are moved, the others are looked up by the arg
+    auto add_input_edge = [this](const NodeArg* arg, int dst_arg_index) {
+        const int producer = m_arg_producers[arg->id()];
+        if (producer >= 0) {
+            const auto& outputs = m_nodes[producer]->output_args();
+            const auto src_arg_index = std::find(outputs.cbegin(), outputs.cend(), arg) - outputs.cbegin();
+            m_input_edges.push_back({producer, static_cast<int>(src_arg_index), dst_arg_index});
+            ++m_output_offsets[producer + 1];
+        }
+    };
+
+    m_input_offsets.assign(node_num + 1, 0);
+    m_output_offsets.assign(node_num + 1, 0);
+    m_input_edges.clear();
+    m_input_edges.reserve(previous.m_input_edges.size());
+    for (int i = 0; i < node_num; ++i) {
+        if (changed[i]) {
+            const auto& inputs = m_nodes[i]->input_args();
+            for (size_t j = 0; j < inputs.size(); ++j) {
+                if (!inputs[j]->name().empty()) {
+                    add_input_edge(inputs[j], static_cast<int>(j));
+                }
+            }
+        } else {
+            for (const auto& edge : previous.input_edges(previous_indices[i])) {
+                const int producer = kept_indices[edge.node];
+                if (producer >= 0) {
+                    m_input_edges.push_back({producer, edge.src_arg_index, edge.dst_arg_index});
+                    ++m_output_offsets[producer + 1];
+                } else {
+                    add_input_edge(m_nodes[i]->input_args()[edge.dst_arg_index], edge.dst_arg_index);
+                }
+            }
+        }
+        m_input_offsets[i + 1] = m_input_edges.size();
+    }
+
+    for (int i = 0; i < node_num; ++i) {
+        m_output_offsets[i + 1] += m_output_offsets[i];
+    }
+
+    std::vector<size_t> cursors(m_output_offsets.begin(), m_output_offsets.end() - 1);
+    m_output_edges.resize(m_input_edges.size());
+    for (int i = 0; i < node_num; ++i) {
+        for (const auto& edge : input_edges(i)) {
+            m_output_edges[cursors[edge.node]++] = {i, edge.src_arg_index, edge.dst_arg_index};
+        }
+    }
+
+    // the consumers: the unchanged ones are moved, the distinct inputs of the changed nodes are read
+    auto for_each_changed_input = [this, &changed_nodes](auto&& func) {
+        for (int i : changed_nodes) {
+            const auto& inputs = m_nodes[i]->input_args();
+            for (auto it = inputs.cbegin(); it != inputs.cend(); ++it) {
+                if (!(*it)->name().empty() && std::find(inputs.cbegin(), it, *it) == it) {
+                    func((*it)->id(), i);
+                }
+            }
+        }
+    };
+
+    m_arg_consumer_offsets.assign(arg_num + 1, 0);
+    for (size_t arg_id = 0; arg_id < previous_arg_num; ++arg_id) {
+        for (int consumer : previous.consumers(static_cast<int>(arg_id))) {
+            if (kept_indices[consumer] >= 0) {
+                ++m_arg_consumer_offsets[arg_id + 1];
+            }
+        }
+    }
+    for_each_changed_input([this](int arg_id, int) { ++m_arg_consumer_offsets[arg_id + 1]; });
+    for (size_t i = 0; i < arg_num; ++i) {
+        m_arg_consumer_offsets[i + 1] += m_arg_consumer_offsets[i];
+    }
+
+    cursors.assign(m_arg_consumer_offsets.begin(), m_arg_consumer_offsets.end() - 1);
+    m_arg_consumers.resize(m_arg_consumer_offsets.back());
+    for (size_t arg_id = 0; arg_id < previous_arg_num; ++arg_id) {
+        for (int consumer : previous.consumers(static_cast<int>(arg_id))) {
+            if (kept_indices[consumer] >= 0) {
+                m_arg_consumers[cursors[arg_id]++] = kept_indices[consumer];
+            }
+        }
+    }
+
+    std::vector<int> unsorted_args;
+    for_each_changed_input([this, &cursors, &unsorted_args](int arg_id, int consumer) {
+        m_arg_consumers[cursors[arg_id]++] = consumer;
+        unsorted_args.emplace_back(arg_id);
+    });
+
+    // keep the consumers in ascending order
+    auto sort_consumers = [this](size_t arg_id) {
+        std::sort(m_arg_consumers.begin() + m_arg_consumer_offsets[arg_id],
+                  m_arg_consumers.begin() + m_arg_consumer_offsets[arg_id + 1]);
+    };
+    if (keep_order) {
+        std::for_each(unsorted_args.cbegin(), unsorted_args.cend(), sort_consumers);
+    } else {
+        for (size_t arg_id = 0; arg_id < arg_num; ++arg_id) {
+            sort_consumers(arg_id);
+        }
+    }
+}
+
+void GraphView::clear() {
+    m_nodes.clear();
+    m_node_ids.clear();
+    m_node_index.clear();
+    m_input_offsets.clear();
+    m_input_edges.clear();
+    m_output_offsets.clear();
+    m_output_edges.clear();
+    m_arg_producers.clear();
+    m_arg_consumer_offsets.clear();
+    m_arg_consumers.clear();
+}
+
+int GraphView::index_of(int node_id) const {
+    if (node_id < 0 || static_cast<size_t>(node_id) >= m_node_index.size()) {
+        return -1;
+    }
+
+    return m_node_index[node_id];
+}
+
+int GraphView::producer(int arg_id) const {
+    if (arg_id < 0 || static_cast<size_t>(arg_id) >= m_arg_producers.size()) {
+        return -1;
+    }
+
+    return m_arg_producers[arg_id];
+}
+
+ArrayRange<int> GraphView::consumers(int arg_id) const {
+    if (arg_id < 0 || static_cast<size_t>(arg_id) + 1 >= m_arg_consumer_offsets.size()) {
+        return {nullptr, nullptr};
+    }
+
+    return {m_arg_consumers.data() + m_arg_consumer_offsets[arg_id],
+            m_arg_consumers.data() + m_arg_consumer_offsets[arg_id + 1]};
+}
+
+}    // namespace ir
+}    // namespace simple_ai
@@ -43,5 +43,7 @@ void Model::set_domain_version(const std::unordered_map<std::string, int64_t>& d
     m_domain_version = dom_ver_map;
 }
 
+void Model::hold_buffer(std::shared_ptr<const void> buffer) { m_buffers.emplace_back(std::move(buffer)); }
+
 }    // namespace ir
 }    // namespace simple_ai
\ No newline at end of file
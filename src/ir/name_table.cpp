@@ -0,0 +1,28 @@
+#include "ir/name_table.h"
+
+namespace simple_ai {
+namespace ir {
+
+int NameTable::intern(std::string_view name) {
+    auto it = m_ids.find(name);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+
+    const int id = static_cast<int>(m_names.size());
+    m_names.emplace_back(name);
+    m_ids.emplace(m_names.back(), id);
+    return id;
+}
+
+int NameTable::find(std::string_view name) const {
+    auto it = m_ids.find(name);
+    if (it == m_ids.end()) {
+        return kInvalidNameId;
+    }
+
+    return it->second;
+}
+
+}    // namespace ir
+}    // namespace simple_ai
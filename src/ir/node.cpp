@@ -6,16 +6,6 @@ using namespace simple_ai::common;
 namespace simple_ai {
 namespace ir {
 
-bool EdgeCompare::operator()(const Edge& lhs, const Edge& rhs) const {
-    if (lhs.other_node().id() == rhs.other_node().id()) {
-        if (lhs.src_arg_index() == rhs.src_arg_index()) {
-            return lhs.dst_arg_index() < rhs.dst_arg_index();
-        }
-        return lhs.src_arg_index() < rhs.src_arg_index();
-    }
-    return lhs.other_node().id() < rhs.other_node().id();
-}
-
 Node::Node(int id, const Graph& graph) : m_id(id), m_graph(graph) {}
 
 void Node::init(const std::string& name, const std::string& type, const std::string& domain,
@@ -35,20 +25,56 @@ const std::vector<NodeArg*>& Node::input_args() const { return m_input_args; }
 
 const std::vector<NodeArg*>& Node::output_args() const { return m_output_args; }
 
-const EdgeSet& Node::input_edges() const { return m_input_edges; }
+void Node::set_op_type(const std::string& type, const std::string& domain) {
+    m_type = type;
+    m_domain = domain;
+}
+
+void Node::add_input_arg(NodeArg* arg) { m_input_args.emplace_back(arg); }
+
+void Node::replace_input_arg(size_t index, NodeArg* arg) {
+    if (index < m_input_args.size()) {
+        m_input_args[index] = arg;
+    }
+}
+
+void Node::remove_input_arg(size_t index) {
+    if (index < m_input_args.size()) {
+        m_input_args.erase(m_input_args.begin() + index);
+    }
+}
+
+void Node::replace_output_arg(size_t index, NodeArg* arg) {
+    if (index < m_output_args.size()) {
+        m_output_args[index] = arg;
+    }
+}
 
-const EdgeSet& Node::output_edges() const { return m_output_edges; }
+void Node::set_attribute(std::unique_ptr<NodeAttribute>&& attr) {
+    const std::string name = attr->name();
+    m_attributes[name] = std::move(attr);
+}
 
-void Node::add_input_edge(const Edge& edge) { m_input_edges.insert(edge); }
+std::unique_ptr<NodeAttribute> Node::release_attribute(const std::string& name) {
+    auto it = m_attributes.find(name);
+    if (it == m_attributes.end()) {
+        return nullptr;
+    }
 
-void Node::add_output_edge(const Edge& edge) { m_output_edges.insert(edge); }
+    auto attr = std::move(it->second);
+    m_attributes.erase(it);
+    return attr;
+}
 
-void Node::remove_input_edge(const Edge& edge) { m_input_edges.erase(edge); }
+Status Node::decode_params() { return decode_op_params(m_type, m_name, m_attributes, m_params); }
 
-void Node::remove_output_edge(const Edge& edge) { m_output_edges.erase(edge); }
+Status Node::infer_shape(IShapeInfer* infer) {
+    auto ret = decode_params();
+    if (!ret.is_ok()) {
+        return ret;
+    }
 
-Status Node::infer_shape(IShapeInfer* infer){
-    return infer->infer(m_name, m_input_args, m_attributes, m_output_args);
+    return infer->infer(m_name, m_input_args, m_params, m_output_args);
 }
 
 }    // namespace ir
@@ -1,5 +1,73 @@
 #include "ir/node_attribute.h"
 
 namespace simple_ai {
-namespace ir {}
-}    // namespace simple_ai
\ No newline at end of file
+namespace ir {
+
+namespace {
+
+/**
+ * @brief get the value of the type T, or the zero value if the variant holds another type
+ */
+template <typename T, typename Variant>
+const T& get_or_empty(const Variant& value) {
+    static const T empty{};
+    const T* ptr = std::get_if<T>(&value);
+    return ptr ? *ptr : empty;
+}
+
+}    // namespace
+
+NodeAttribute::NodeAttribute(const std::string& name, const NodeAttributeType& type) : m_name(name) {
+    switch (type) {
+        case NodeAttributeType::INT64:
+            m_value.emplace<int64_t>(0);
+            break;
+        case NodeAttributeType::FLOAT:
+            m_value.emplace<float>(0.0f);
+            break;
+        case NodeAttributeType::STRING:
+            m_value.emplace<std::string>();
+            break;
+        case NodeAttributeType::TENSOR:
+            m_value.emplace<std::unique_ptr<Tensor>>();
+            break;
+        case NodeAttributeType::INT64_ARRAY:
+            m_value.emplace<std::vector<int64_t>>();
+            break;
+        case NodeAttributeType::FLOAT_ARRAY:
+            m_value.emplace<std::vector<float>>();
+            break;
+        case NodeAttributeType::STRING_ARRAY:
+            m_value.emplace<std::vector<std::string>>();
+            break;
+        case NodeAttributeType::TENSOR_ARRAY:
+            m_value.emplace<std::vector<std::unique_ptr<Tensor>>>();
+            break;
+        default:
+            m_value.emplace<std::monostate>();
+            break;
+    }
+}
+
+float NodeAttribute::get_float() const { return get_or_empty<float>(m_value); }
+
+int64_t NodeAttribute::get_int64() const { return get_or_empty<int64_t>(m_value); }
+
+const std::string& NodeAttribute::get_string() const { return get_or_empty<std::string>(m_value); }
+
+Tensor* NodeAttribute::get_tensor() const { return get_or_empty<std::unique_ptr<Tensor>>(m_value).get(); }
+
+const std::vector<float>& NodeAttribute::get_floats() const { return get_or_empty<std::vector<float>>(m_value); }
+
+const std::vector<int64_t>& NodeAttribute::get_int64s() const { return get_or_empty<std::vector<int64_t>>(m_value); }
+
+const std::vector<std::string>& NodeAttribute::get_strings() const {
+    return get_or_empty<std::vector<std::string>>(m_value);
+}
+
+const std::vector<std::unique_ptr<Tensor>>& NodeAttribute::get_tensors() const {
+    return get_or_empty<std::vector<std::unique_ptr<Tensor>>>(m_value);
+}
+
+}    // namespace ir
+}    // namespace simple_ai
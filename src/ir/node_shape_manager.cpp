@@ -3,10 +3,13 @@
 #include "ir/node_shapes/add_shape.h"
 #include "ir/node_shapes/conv_shape.h"
 #include "ir/node_shapes/flatten_shape.h"
+#include "ir/node_shapes/fused_conv_shape.h"
+#include "ir/node_shapes/fused_gemm_shape.h"
 #include "ir/node_shapes/gemm_shape.h"
 #include "ir/node_shapes/global_avg_pool_shape.h"
 #include "ir/node_shapes/max_pool_shape.h"
 #include "ir/node_shapes/relu_shape.h"
+#include "ir/node_shapes/reorder_shape.h"
 
 namespace simple_ai {
 namespace ir {
@@ -34,12 +37,15 @@ void NodeShapeManager::register_all_infer() {
     register_node_infer<GlobalAveragePoolShapeInfer>();
     register_node_infer<FlattenShapeInfer>();
     register_node_infer<AddShapeInfer>();
+    register_node_infer<FusedConvShapeInfer>();
+    register_node_infer<FusedGemmShapeInfer>();
+    register_node_infer<ReorderShapeInfer>();
 }
 
 IShapeInfer* NodeShapeManager::get_shape_infer(const std::string& node_type) {
     auto iter = m_node_infer_map.find(node_type);
     if (iter != m_node_infer_map.end()) {
-        iter->second.get();
+        return iter->second.get();
     }
 
     return nullptr;
@@ -8,15 +8,45 @@
 namespace simple_ai {
 namespace ir {
 
+namespace {
+
+/**
+ * @brief broadcast the dim `index2` of shape2 into the dim `index1` of shape1, the result is written to the same dim
+ * of the output. a dynamic dim broadcast with a static dim other than 1 must be equal to it, two dynamic dims keep
+ * the symbol only if they have the same one
+ *
+ * @return false if the static dims can not be broadcast
+ */
+bool broadcast_dim(const TensorShape& shape1, size_t index1, const TensorShape& shape2, size_t index2,
+                   TensorShape& out_shape) {
+    auto d1 = shape1[index1];
+    auto d2 = shape2[index2];
+    if (!shape1.is_dynamic(index1) && !shape2.is_dynamic(index2)) {
+        if (d1 != 1 && d2 != 1 && d1 != d2) {
+            return false;
+        }
+        out_shape.set_dim(index1, std::max<int64_t>(d1, d2));
+    } else if (shape1.is_dynamic(index1) && shape2.is_dynamic(index2)) {
+        out_shape.set_symbol(index1, shape1.symbol(index1) == shape2.symbol(index2) ? shape1.symbol(index1) : "");
+    } else if (shape1.is_dynamic(index1)) {
+        out_shape.copy_dim(index1, d2 == 1 ? shape1 : shape2, d2 == 1 ? index1 : index2);
+    } else {
+        out_shape.copy_dim(index1, d1 == 1 ? shape2 : shape1, d1 == 1 ? index2 : index1);
+    }
+
+    return true;
+}
+
+}    // namespace
+
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#Add
 // https://github.com/onnx/onnx/blob/main/docs/Broadcasting.md
 
 std::string AddShapeInfer::node_type() const { return "Add"; }
 
 Status AddShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                            const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
-                            std::vector<NodeArg*>& outputs) {
-    (void)attributes;
+                            const OpParams& params, std::vector<NodeArg*>& outputs) {
+    (void)params;
 
     if (inputs.size() != 2 || outputs.size() != 1) {
         std::ostringstream oss;
@@ -28,46 +58,32 @@ Status AddShapeInfer::infer(const std::string& node_name, const std::vector<Node
     const auto& shape1 = inputs[0]->shape();
     const auto& shape2 = inputs[1]->shape();
 
-    TensorShape out_shape;
-
-    if (shape1.dims_num() >= shape2.dims_num()) {
-        std::vector<int64_t> out_dims(shape1.dims());
-
-        auto start1 = shape1.dims_num() - shape2.dims_num();
-        for (int i = 0; i < static_cast<int>(shape2.dims_num()); ++i) {
-            auto d1 = shape1[start1 + i];
-            auto d2 = shape2[i];
-            if (d1 == 1 || d2 == 1 || d1 == d2) {
-                out_dims[start1 + i] = std::max<int64_t>(d1, d2);
-            } else {
-                std::ostringstream oss;
-                oss << "Node: Add[" << node_name << "], input1 shape: " << shape1.to_string()
-                    << " input2 shape: " << shape2.to_string();
-                return Status(StatusCode::INVALID_PARAM, oss.str());
-            }
-        }
+    // the broadcasting follows the logical dims. in a non-default layout, it is only valid when both inputs have the
+    // same shape or one of them is a scalar
+    DataLayout layout = shape1.layout() != DataLayout::NCHW ? shape1.layout() : shape2.layout();
+    if (layout != DataLayout::NCHW && !shape1.is_compatible(shape2) && !shape1.is_scalar() && !shape2.is_scalar()) {
+        std::ostringstream oss;
+        oss << "Node: Add[" << node_name << "], input1 shape: " << shape1.to_string()
+            << " input2 shape: " << shape2.to_string() << " can not be broadcast in a non-default layout";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
 
-        out_shape.set_dims(out_dims);
-    } else {
-        std::vector<int64_t> out_dims(shape2.dims());
-
-        auto start2 = shape2.dims_num() - shape1.dims_num();
-        for (int i = 0; i < static_cast<int>(shape1.dims_num()); ++i) {
-            auto d2 = shape2[start2 + i];
-            auto d1 = shape1[i];
-            if (d1 == 1 || d2 == 1 || d1 == d2) {
-                out_dims[start2 + i] = std::max<int64_t>(d1, d2);
-            } else {
-                std::ostringstream oss;
-                oss << "Node: Add[" << node_name << "], input1 shape: " << shape1.to_string()
-                    << " input2 shape: " << shape2.to_string();
-                return Status(StatusCode::INVALID_PARAM, oss.str());
-            }
+    // the output has the rank of the longer input, the dims are aligned from the tail
+    const TensorShape& longer = shape1.dims_num() >= shape2.dims_num() ? shape1 : shape2;
+    const TensorShape& shorter = shape1.dims_num() >= shape2.dims_num() ? shape2 : shape1;
+    TensorShape out_shape = longer;
+
+    auto start = longer.dims_num() - shorter.dims_num();
+    for (size_t i = 0; i < shorter.dims_num(); ++i) {
+        if (!broadcast_dim(longer, start + i, shorter, i, out_shape)) {
+            std::ostringstream oss;
+            oss << "Node: Add[" << node_name << "], input1 shape: " << shape1.to_string()
+                << " input2 shape: " << shape2.to_string();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
         }
-
-        out_shape.set_dims(out_dims);
     }
 
+    out_shape.set_layout(layout);
     outputs[0]->set_shape(out_shape);
 
     return Status::ok();
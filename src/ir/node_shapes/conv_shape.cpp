@@ -1,7 +1,6 @@
 #include "ir/node_shapes/conv_shape.h"
 
 #include "ir/node.h"
-#include "ir/node_utils.h"
 
 namespace simple_ai {
 namespace ir {
@@ -11,8 +10,7 @@ namespace ir {
 std::string ConvShapeInfer::node_type() const { return "Conv"; }
 
 Status ConvShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                             const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
-                             std::vector<NodeArg*>& outputs) {
+                             const OpParams& params, std::vector<NodeArg*>& outputs) {
     if (inputs.size() < 2 || outputs.size() != 1) {
         std::ostringstream oss;
         oss << "Node: Conv[" << node_name << "], invalid input size: " << inputs.size()
@@ -20,21 +18,27 @@ Status ConvShapeInfer::infer(const std::string& node_name, const std::vector<Nod
         return Status(StatusCode::INVALID_PARAM, oss.str());
     }
 
-    std::string auto_pad = utils::get_attr_or_default<std::string>("auto_pad", "NOTSET", attributes);
-    std::vector<int64_t> dilations = utils::get_attrs_or_default<int64_t>("dilations", {}, attributes);
-    int64_t group = utils::get_attr_or_default<int64_t>("group", 1, attributes);
-    std::vector<int64_t> kernel_shape = utils::get_attrs_or_default<int64_t>("kernel_shape", {}, attributes);
-    std::vector<int64_t> pads = utils::get_attrs_or_default<int64_t>("pads", {}, attributes);
-    std::vector<int64_t> strides = utils::get_attrs_or_default<int64_t>("strides", {}, attributes);
+    const ConvParams* conv = nullptr;
+    auto ret = get_op_params("Conv", node_name, params, conv);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    int64_t group = conv->group;
+    std::vector<int64_t> dilations = conv->dilations.to_vector();
+    std::vector<int64_t> kernel_shape = conv->kernel_shape.to_vector();
+    std::vector<int64_t> pads = conv->pads.to_vector();
+    std::vector<int64_t> strides = conv->strides.to_vector();
 
-    if (auto_pad != "NOTSET") {
+    if (conv->auto_pad != AutoPad::NOTSET) {
         std::ostringstream oss;
-        oss << "Node: Conv[" << node_name << "], auto_pad attribute is not supported now. auto_pad value: " << auto_pad;
+        oss << "Node: Conv[" << node_name << "], auto_pad attribute is not supported now. auto_pad value: "
+            << auto_pad_to_string(conv->auto_pad);
 
         return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
     }
 
-    if (group <= 1) {
+    if (group != 1) {
         std::ostringstream oss;
         oss << "Node: Conv[" << node_name << "], group convolution is not supported now. group attribute: " << group;
 
@@ -66,8 +70,7 @@ Status ConvShapeInfer::infer(const std::string& node_name, const std::vector<Nod
     size_t kernel_size = kernel_shape.size();
     // the kernel shape is empty. get its info from the weigths
     if (kernel_size == 0) {
-        kernel_shape = weight_shape.dims();
-        kernel_shape.erase(kernel_shape.begin(), kernel_shape.begin() + 2);
+        kernel_shape.assign(weight_shape.dims().begin() + 2, weight_shape.dims().end());
         kernel_size = kernel_shape.size();
     }
 
@@ -119,10 +122,17 @@ Status ConvShapeInfer::infer(const std::string& node_name, const std::vector<Nod
     }
 
     TensorShape out_shape;
-    out_shape.add_dim(input_shape[0]);     // batch
-    out_shape.add_dim(kernel_shape[0]);    // output channel
+    out_shape.set_layout(input_shape.layout());
+    out_shape.add_dim(input_shape, 0);     // batch
+    out_shape.add_dim(weight_shape, 0);    // output channel
 
     for (size_t i = 0; i < kernel_size; ++i) {
+        // a dynamic spatial dim is derived from the bound input shape at run time
+        if (input_shape.is_dynamic(i + 2)) {
+            out_shape.add_dim(kDynamicDim);
+            continue;
+        }
+
         int64_t dim =
             (input_shape[i + 2] + pads[i] + pads[i + pads.size() / 2] - dilations[i] * (kernel_shape[i] - 1) - 1) /
                 strides[i] +
@@ -1,18 +1,45 @@
 #include "ir/node_shapes/flatten_shape.h"
 
 #include "ir/node.h"
-#include "ir/node_utils.h"
 
 namespace simple_ai {
 namespace ir {
 
-// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Flatten
+namespace {
+
+/**
+ * @brief append the product of the dims in [begin, end) to the output shape. the product is dynamic if any of the
+ * dims is dynamic, it keeps the symbol only if the other dims are all 1
+ */
+void add_flattened_dim(const TensorShape& shape, int64_t begin, int64_t end, TensorShape& output_shape) {
+    int64_t dim = 1;
+    int64_t dynamic_index = -1;
+    int dynamic_num = 0;
+    for (int64_t i = begin; i < end; ++i) {
+        if (shape.is_dynamic(i)) {
+            dynamic_index = i;
+            ++dynamic_num;
+        } else {
+            dim *= shape[i];
+        }
+    }
 
+    if (dynamic_num == 0) {
+        output_shape.add_dim(dim);
+    } else if (dynamic_num == 1 && dim == 1) {
+        output_shape.add_dim(shape, dynamic_index);
+    } else {
+        output_shape.add_dim(kDynamicDim);
+    }
+}
+
+}    // namespace
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Flatten
 std::string FlattenShapeInfer::node_type() const { return "Flatten"; }
 
 Status FlattenShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-             const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
-             std::vector<NodeArg*>& outputs) {
+             const OpParams& params, std::vector<NodeArg*>& outputs) {
     if (inputs.size() != 1 || outputs.size() != 1) {
         std::ostringstream oss;
         oss << "Node: Flatten[" << node_name << "], Invalid input size: " << inputs.size()
@@ -20,12 +47,26 @@ Status FlattenShapeInfer::infer(const std::string& node_name, const std::vector<
         return Status(StatusCode::INVALID_PARAM, oss.str());
     }
 
-    int64_t axis = utils::get_attr_or_default<int64_t>("axis", 1, attributes);
+    const FlattenParams* flatten = nullptr;
+    auto ret = get_op_params("Flatten", node_name, params, flatten);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    int64_t axis = flatten->axis;
     int64_t axis_tmp = axis;
 
     const auto& input_shape = inputs[0]->shape();
     int64_t rank = static_cast<int64_t>(input_shape.dims_num());
 
+    // the elements are flattened in the logical order, which is the memory order only in the default layout
+    if (input_shape.layout() != DataLayout::NCHW) {
+        std::ostringstream oss;
+        oss << "Node: Flatten[" << node_name << "], unsupported input layout: "
+            << layout_to_string(input_shape.layout());
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
     // The value for axis must be in the range [-r, r], where r is the rank of the input tensor
     if (axis < 0) {
         axis += rank;
@@ -37,19 +78,9 @@ Status FlattenShapeInfer::infer(const std::string& node_name, const std::vector<
         return Status(StatusCode::INVALID_PARAM, oss.str());
     }
 
-    int64_t dim1 = 1;
-    int64_t dim2 = 1;
-    for (int i = 0; i < axis; ++i) {
-        dim1 *= input_shape[i];
-    }
-
-    for (int i = axis; i < rank; ++i) {
-        dim2 *= input_shape[i];
-    }
-
     TensorShape output_shape;
-    output_shape.add_dim(dim1);
-    output_shape.add_dim(dim2);
+    add_flattened_dim(input_shape, 0, axis, output_shape);
+    add_flattened_dim(input_shape, axis, rank, output_shape);
 
     outputs[0]->set_shape(output_shape);
 
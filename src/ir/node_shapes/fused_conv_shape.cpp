@@ -0,0 +1,51 @@
+#include "ir/node_shapes/fused_conv_shape.h"
+
+#include <sstream>
+
+#include "ir/node.h"
+#include "ir/node_shapes/conv_shape.h"
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace ir {
+
+std::string FusedConvShapeInfer::node_type() const { return kFusedConvOpType; }
+
+Status FusedConvShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
+                                  const OpParams& params, std::vector<NodeArg*>& outputs) {
+    if (inputs.size() < 2 || inputs.size() > 4 || outputs.size() != 1) {
+        std::ostringstream oss;
+        oss << "Node: FusedConv[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    // the conv part. the bias is an optional input with empty name
+    std::vector<NodeArg*> conv_inputs(inputs.begin(), inputs.begin() + 2);
+    if (inputs.size() > 2 && !inputs[2]->name().empty()) {
+        conv_inputs.emplace_back(inputs[2]);
+    }
+
+    ConvShapeInfer conv_infer;
+    auto ret = conv_infer.infer(node_name, conv_inputs, params, outputs);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    // the residual must have the same shape as the output, no broadcasting in the epilogue. the dynamic dims are
+    // checked again when the shapes are bound at run time
+    if (inputs.size() == 4 && !inputs[3]->name().empty()) {
+        const auto& residual_shape = inputs[3]->shape();
+        if (!residual_shape.is_compatible(outputs[0]->shape())) {
+            std::ostringstream oss;
+            oss << "Node: FusedConv[" << node_name << "], residual shape: " << residual_shape.to_string()
+                << " mismatch output shape: " << outputs[0]->shape().to_string();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace ir
+}    // namespace simple_ai
@@ -1,7 +1,6 @@
 #include "ir/node_shapes/gemm_shape.h"
 
 #include "ir/node.h"
-#include "ir/node_utils.h"
 
 namespace simple_ai {
 namespace ir {
@@ -11,8 +10,7 @@ namespace ir {
 std::string GemmShapeInfer::node_type() const { return "Gemm"; }
 
 Status GemmShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                             const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
-                             std::vector<NodeArg*>& outputs) {
+                             const OpParams& params, std::vector<NodeArg*>& outputs) {
     if (inputs.size() < 2 || outputs.size() != 1) {
         std::ostringstream oss;
         oss << "Node: Gemm[" << node_name << "], invalid input size: " << inputs.size()
@@ -32,8 +30,14 @@ Status GemmShapeInfer::infer(const std::string& node_name, const std::vector<Nod
         return Status(StatusCode::INVALID_PARAM, oss.str());
     }
 
-    int64_t transA = utils::get_attr_or_default<int64_t>("transA", 0, attributes);
-    int64_t transB = utils::get_attr_or_default<int64_t>("transB", 0, attributes);
+    const GemmParams* gemm = nullptr;
+    auto ret = get_op_params("Gemm", node_name, params, gemm);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    bool transA = gemm->trans_a;
+    bool transB = gemm->trans_b;
 
     int64_t m_a = 0;
     int64_t k_a = 0;
@@ -56,7 +60,8 @@ Status GemmShapeInfer::infer(const std::string& node_name, const std::vector<Nod
         n_b = mat_B_shape[1];
     }
 
-    if (k_a != k_b) {
+    // the dynamic dims are checked when the shapes are bound at run time
+    if (k_a >= 0 && k_b >= 0 && k_a != k_b) {
         std::ostringstream oss;
         oss << "Node: Gemm[" << node_name << "], mismatch for A dim1 and B dim0";
         return Status(StatusCode::INVALID_PARAM, oss.str());
@@ -66,9 +71,12 @@ Status GemmShapeInfer::infer(const std::string& node_name, const std::vector<Nod
     if (inputs.size() == 3) {
         const auto& mat_C_shape = inputs[2]->shape();
         size_t c_dim_num = mat_C_shape.dims_num();
-        bool valid_c_shape = (c_dim_num == 2 && (mat_C_shape[0] == m_a || mat_C_shape[0] == 1) &&
-                              (mat_C_shape[1] == n_b || mat_C_shape[1] == 1)) ||
-                             (c_dim_num == 1 && (mat_C_shape[0] == 1 || mat_C_shape[0] == n_b));
+        auto broadcastable = [](int64_t dim, int64_t target) {
+            return dim == target || dim == 1 || dim < 0 || target < 0;
+        };
+        bool valid_c_shape =
+            (c_dim_num == 2 && broadcastable(mat_C_shape[0], m_a) && broadcastable(mat_C_shape[1], n_b)) ||
+            (c_dim_num == 1 && broadcastable(mat_C_shape[0], n_b));
         if (!valid_c_shape) {
             std::ostringstream oss;
             oss << "Node: Gemm[" << node_name << "], invalid matrix C dimensions";
@@ -77,8 +85,8 @@ Status GemmShapeInfer::infer(const std::string& node_name, const std::vector<Nod
     }
 
     TensorShape out_shape;
-    out_shape.add_dim(m_a);
-    out_shape.add_dim(n_b);
+    out_shape.add_dim(mat_A_shape, transA ? 1 : 0);
+    out_shape.add_dim(mat_B_shape, transB ? 0 : 1);
 
     outputs[0]->set_shape(out_shape);
 
@@ -8,10 +8,9 @@ namespace ir {
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#GlobalAveragePool
 std::string GlobalAveragePoolShapeInfer::node_type() const { return "GlobalAveragePool"; }
 
-Status GlobalAveragePoolShapeInfer::infer(
-    const std::string& node_name, const std::vector<NodeArg*>& inputs,
-    const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes, std::vector<NodeArg*>& outputs) {
-    (void)attributes;
+Status GlobalAveragePoolShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
+                                          const OpParams& params, std::vector<NodeArg*>& outputs) {
+    (void)params;
 
     if (inputs.size() != 1 || outputs.size() != 1) {
         std::ostringstream oss;
@@ -35,8 +34,9 @@ Status GlobalAveragePoolShapeInfer::infer(
     // The first two dimensions of output shape are the same as the input (N x C), while the other dimensions are
     // all 1.
     TensorShape output_shape;
-    output_shape.add_dim(input_shape[0]);
-    output_shape.add_dim(input_shape[1]);
+    output_shape.set_layout(input_shape.layout());
+    output_shape.add_dim(input_shape, 0);
+    output_shape.add_dim(input_shape, 1);
     for (int i = 2; i < dim_num; ++i) {
         output_shape.add_dim(1);
     }
@@ -4,7 +4,6 @@
 #include <unordered_set>
 
 #include "ir/node.h"
-#include "ir/node_utils.h"
 
 namespace simple_ai {
 namespace ir {
@@ -13,8 +12,7 @@ namespace ir {
 std::string MaxPoolShapeInfer::node_type() const { return "MaxPool"; }
 
 Status MaxPoolShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                                const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
-                                std::vector<NodeArg*>& outputs) {
+                                const OpParams& params, std::vector<NodeArg*>& outputs) {
     if (inputs.size() != 1 || outputs.size() != 1) {
         std::ostringstream oss;
         oss << "Node: MaxPool[" << node_name << "], not implemented or invalid input size: " << inputs.size()
@@ -22,13 +20,18 @@ Status MaxPoolShapeInfer::infer(const std::string& node_name, const std::vector<
         return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
     }
 
-    std::string auto_pad = utils::get_attr_or_default<std::string>("auto_pad", "NOTSET", attributes);
-    int64_t ceil_mode = utils::get_attr_or_default<int64_t>("ceil_mode", 0, attributes);
-    std::vector<int64_t> dilations = utils::get_attrs_or_default<int64_t>("dilations", {}, attributes);
-    std::vector<int64_t> kernel_shape = utils::get_attrs_or_default<int64_t>("kernel_shape", {}, attributes);
-    std::vector<int64_t> pads = utils::get_attrs_or_default<int64_t>("pads", {}, attributes);
-    int64_t storage_order = utils::get_attr_or_default<int64_t>("storage_order", 0, attributes);
-    std::vector<int64_t> strides = utils::get_attrs_or_default<int64_t>("strides", {}, attributes);
+    const PoolParams* pool = nullptr;
+    auto ret = get_op_params("MaxPool", node_name, params, pool);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    int64_t ceil_mode = pool->ceil_mode;
+    std::vector<int64_t> dilations = pool->dilations.to_vector();
+    const DimVector& kernel_shape = pool->kernel_shape;
+    std::vector<int64_t> pads = pool->pads.to_vector();
+    int64_t storage_order = pool->storage_order;
+    std::vector<int64_t> strides = pool->strides.to_vector();
 
     // for image case are (N x C x H x W), where N is the batch size, C is the number of channels, and H and W are
     // the height and the width of the data.
@@ -46,10 +49,11 @@ Status MaxPoolShapeInfer::infer(const std::string& node_name, const std::vector<
 
     // check the node's attributes
     // auto_pad is a DEPRECATED attribute, skip it
-    if (auto_pad != "NOTSET") {
+    if (pool->auto_pad != AutoPad::NOTSET) {
         std::ostringstream oss;
         oss << "Node: MaxPool[" << node_name
-            << "], auto_pad is a DEPRECATED attribute, not supported now. auto_pad value: " << auto_pad;
+            << "], auto_pad is a DEPRECATED attribute, not supported now. auto_pad value: "
+            << auto_pad_to_string(pool->auto_pad);
 
         return Status(StatusCode::INVALID_PARAM, oss.str());
     }
@@ -97,27 +101,36 @@ Status MaxPoolShapeInfer::infer(const std::string& node_name, const std::vector<
         }
     }
 
+    // the pooling keeps the memory layout of the input
     TensorShape output_shape;
+    output_shape.set_layout(input_shape.layout());
     output_shape.set_dims_num(dim_num);
 
     // now, compute the output shape
     for (size_t i = 0; i < dim_num - kernel_size; ++i) {
-        output_shape[i] = input_shape[i];
+        output_shape.copy_dim(i, input_shape, i);
     }
 
     int j = 0;
     for (size_t i = dim_num - kernel_size; i < dim_num; ++i) {
+        // a dynamic spatial dim is derived from the bound input shape at run time
+        if (input_shape.is_dynamic(i)) {
+            output_shape.set_dim(i, kDynamicDim);
+            ++j;
+            continue;
+        }
+
         int64_t dim = 0;
         int64_t tmp1 = input_shape[i] + pads[j] + pads[j + pads.size() / 2] - dilations[j] * (kernel_shape[j] - 1) - 1;
-        int64_t tmp2 = tmp1 / strides[i];
+        int64_t tmp2 = tmp1 / strides[j];
         if (ceil_mode) {
-            dim = (tmp2 * strides[i] == tmp1) ? (tmp2 + 1) : (tmp2 + 2);
+            dim = (tmp2 * strides[j] == tmp1) ? (tmp2 + 1) : (tmp2 + 2);
         } else {
             // floor
             dim = tmp2 + 1;
         }
 
-        output_shape[i] = dim;
+        output_shape.set_dim(i, dim);
         ++j;
     }
 
@@ -9,9 +9,8 @@ namespace ir {
 std::string ReluShapeInfer::node_type() const { return "Relu"; }
 
 Status ReluShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
-                             const std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>& attributes,
-                             std::vector<NodeArg*>& outputs) {
-    (void)attributes;
+                             const OpParams& params, std::vector<NodeArg*>& outputs) {
+    (void)params;
 
     if (inputs.size() != 1 || outputs.size() != 1) {
         std::ostringstream oss;
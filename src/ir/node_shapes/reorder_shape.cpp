@@ -0,0 +1,54 @@
+#include "ir/node_shapes/reorder_shape.h"
+
+#include <sstream>
+
+#include "ir/node.h"
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace ir {
+
+std::string ReorderShapeInfer::node_type() const { return kReorderOpType; }
+
+Status ReorderShapeInfer::infer(const std::string& node_name, const std::vector<NodeArg*>& inputs,
+                                const OpParams& params, std::vector<NodeArg*>& outputs) {
+    if (inputs.size() != 1 || outputs.size() != 1) {
+        std::ostringstream oss;
+        oss << "Node: Reorder[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const ReorderParams* reorder = nullptr;
+    auto ret = get_op_params(kReorderOpType, node_name, params, reorder);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    DataLayout src_layout = reorder->src_layout;
+    DataLayout dst_layout = reorder->dst_layout;
+
+    const auto& input_shape = inputs[0]->shape();
+    // the packed Conv weights are never reordered, they are created by the layout pass
+    if (input_shape.layout() != src_layout || input_shape.dims_num() != 4 || src_layout == DataLayout::HWIO ||
+        dst_layout == DataLayout::HWIO) {
+        std::ostringstream oss;
+        oss << "Node: Reorder[" << node_name << "], invalid input shape: " << input_shape.to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if ((src_layout == DataLayout::NCHWc || dst_layout == DataLayout::NCHWc) && input_shape[1] % kNCHWcBlockSize != 0) {
+        std::ostringstream oss;
+        oss << "Node: Reorder[" << node_name << "], the channels: " << input_shape[1]
+            << " are not a multiple of the NCHWc block size";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    TensorShape output_shape = input_shape;
+    output_shape.set_layout(dst_layout);
+    outputs[0]->set_shape(output_shape);
+    return Status::ok();
+}
+
+}    // namespace ir
+}    // namespace simple_ai
@@ -0,0 +1,180 @@
+#include "ir/op_params.h"
+
+#include <sstream>
+#include <vector>
+
+#include "ir/node_utils.h"
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace ir {
+
+namespace {
+
+using AttributeMap = std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>;
+
+/**
+ * @brief copy an int array attribute, the dims are left empty if the attribute is absent
+ */
+void decode_ints(const std::string& name, const AttributeMap& attributes, DimVector& dims) {
+    auto iter = attributes.find(name);
+    if (iter != attributes.end() && iter->second->type() == NodeAttributeType::INT64_ARRAY) {
+        const auto& values = iter->second->get_int64s();
+        dims.assign(values.data(), values.size());
+    }
+}
+
+Status decode_auto_pad(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                       AutoPad& auto_pad) {
+    std::string value = utils::get_attr_or_default<std::string>("auto_pad", "NOTSET", attributes);
+    for (auto candidate : {AutoPad::NOTSET, AutoPad::SAME_UPPER, AutoPad::SAME_LOWER, AutoPad::VALID}) {
+        if (value == auto_pad_to_string(candidate)) {
+            auto_pad = candidate;
+            return Status::ok();
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "Node: " << op_type << "[" << node_name << "], invalid auto_pad: " << value;
+    return Status(StatusCode::INVALID_PARAM, oss.str());
+}
+
+Status decode_activation(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                         FusedActivation& activation) {
+    std::string value = utils::get_attr_or_default<std::string>(kActivationAttrName, "", attributes);
+    if (value.empty()) {
+        activation = FusedActivation::NONE;
+    } else if (value == kReluActivation) {
+        activation = FusedActivation::RELU;
+    } else {
+        std::ostringstream oss;
+        oss << "Node: " << op_type << "[" << node_name << "], unsupported activation: " << value;
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    return Status::ok();
+}
+
+Status decode_conv(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                   OpParams& params) {
+    ConvParams conv;
+    auto ret = decode_auto_pad(op_type, node_name, attributes, conv.auto_pad);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    if (op_type == kFusedConvOpType) {
+        ret = decode_activation(op_type, node_name, attributes, conv.activation);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    conv.group = utils::get_attr_or_default<int64_t>("group", 1, attributes);
+    decode_ints("kernel_shape", attributes, conv.kernel_shape);
+    decode_ints("dilations", attributes, conv.dilations);
+    decode_ints("pads", attributes, conv.pads);
+    decode_ints("strides", attributes, conv.strides);
+
+    params = std::move(conv);
+    return Status::ok();
+}
+
+Status decode_pool(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                   OpParams& params) {
+    PoolParams pool;
+    auto ret = decode_auto_pad(op_type, node_name, attributes, pool.auto_pad);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    pool.ceil_mode = utils::get_attr_or_default<int64_t>("ceil_mode", 0, attributes);
+    pool.storage_order = utils::get_attr_or_default<int64_t>("storage_order", 0, attributes);
+    decode_ints("kernel_shape", attributes, pool.kernel_shape);
+    decode_ints("dilations", attributes, pool.dilations);
+    decode_ints("pads", attributes, pool.pads);
+    decode_ints("strides", attributes, pool.strides);
+
+    params = std::move(pool);
+    return Status::ok();
+}
+
+Status decode_gemm(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                   OpParams& params) {
+    GemmParams gemm;
+    if (op_type == kFusedGemmOpType) {
+        auto ret = decode_activation(op_type, node_name, attributes, gemm.activation);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    gemm.alpha = utils::get_attr_or_default<float>("alpha", 1.0f, attributes);
+    gemm.beta = utils::get_attr_or_default<float>("beta", 1.0f, attributes);
+    gemm.trans_a = utils::get_attr_or_default<int64_t>("transA", 0, attributes) != 0;
+    gemm.trans_b = utils::get_attr_or_default<int64_t>("transB", 0, attributes) != 0;
+
+    params = gemm;
+    return Status::ok();
+}
+
+Status decode_reorder(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                      OpParams& params) {
+    ReorderParams reorder;
+    std::string src = utils::get_attr_or_default<std::string>(kSrcLayoutAttrName, "", attributes);
+    std::string dst = utils::get_attr_or_default<std::string>(kDstLayoutAttrName, "", attributes);
+    if (!string_to_layout(src, reorder.src_layout) || !string_to_layout(dst, reorder.dst_layout)) {
+        std::ostringstream oss;
+        oss << "Node: " << op_type << "[" << node_name << "], invalid src_layout: " << src << " or dst_layout: " << dst;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    params = reorder;
+    return Status::ok();
+}
+
+}    // namespace
+
+const char* auto_pad_to_string(AutoPad auto_pad) {
+    switch (auto_pad) {
+        case AutoPad::SAME_UPPER:
+            return "SAME_UPPER";
+        case AutoPad::SAME_LOWER:
+            return "SAME_LOWER";
+        case AutoPad::VALID:
+            return "VALID";
+        default:
+            return "NOTSET";
+    }
+}
+
+Status decode_op_params(const std::string& op_type, const std::string& node_name, const AttributeMap& attributes,
+                        OpParams& params) {
+    if (op_type == "Conv" || op_type == kFusedConvOpType) {
+        return decode_conv(op_type, node_name, attributes, params);
+    }
+
+    if (op_type == "MaxPool") {
+        return decode_pool(op_type, node_name, attributes, params);
+    }
+
+    if (op_type == "Gemm" || op_type == kFusedGemmOpType) {
+        return decode_gemm(op_type, node_name, attributes, params);
+    }
+
+    if (op_type == "Flatten") {
+        params = FlattenParams{utils::get_attr_or_default<int64_t>("axis", 1, attributes)};
+        return Status::ok();
+    }
+
+    if (op_type == kReorderOpType) {
+        return decode_reorder(op_type, node_name, attributes, params);
+    }
+
+    // the operator has no attributes, or they are not read by the shape inference and the kernels
+    params = std::monostate();
+    return Status::ok();
+}
+
+}    // namespace ir
+}    // namespace simple_ai
@@ -47,7 +47,8 @@ void Tensor::release_buffer() {
 }
 
 Status Tensor::calc_storage_size(PrimitiveDataType data_type, const TensorShape& shape, size_t& size) {
-    int64_t shape_size = shape.element_num();
+    // a tensor without dims is a scalar of one element
+    int64_t shape_size = shape.dims_num() == 0 ? 1 : shape.element_num();
     if (shape_size < 0) {
         return Status(StatusCode::FAIL, "invalid tensor shape");
     }
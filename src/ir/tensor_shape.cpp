@@ -6,23 +6,222 @@
 namespace simple_ai {
 namespace ir {
 
+const char* layout_to_string(DataLayout layout) {
+    switch (layout) {
+        case DataLayout::NCHW:
+            return "NCHW";
+        case DataLayout::NHWC:
+            return "NHWC";
+        case DataLayout::NCHWc:
+            return "NCHWc";
+        case DataLayout::HWIO:
+            return "HWIO";
+        default:
+            return "ANY";
+    }
+}
+
+bool string_to_layout(const std::string& str, DataLayout& layout) {
+    for (auto candidate : {DataLayout::NCHW, DataLayout::NHWC, DataLayout::NCHWc, DataLayout::HWIO}) {
+        if (str == layout_to_string(candidate)) {
+            layout = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+DimVector::~DimVector() {
+    if (!is_inline()) {
+        delete[] m_data;
+    }
+}
+
+DimVector::DimVector(const DimVector& rhs) { assign(rhs.m_data, rhs.m_size); }
+
+DimVector::DimVector(DimVector&& rhs) noexcept { *this = std::move(rhs); }
+
+DimVector& DimVector::operator=(const DimVector& rhs) {
+    if (this != &rhs) {
+        assign(rhs.m_data, rhs.m_size);
+    }
+    return *this;
+}
+
+DimVector& DimVector::operator=(DimVector&& rhs) noexcept {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if (rhs.is_inline()) {
+        assign(rhs.m_data, rhs.m_size);
+    } else {
+        // take the heap buffer of rhs, which falls back to the inline storage
+        if (!is_inline()) {
+            delete[] m_data;
+        }
+        m_data = rhs.m_data;
+        m_capacity = rhs.m_capacity;
+        m_size = rhs.m_size;
+        rhs.m_data = rhs.m_inline;
+        rhs.m_capacity = kInlineDimNum;
+    }
+    rhs.m_size = 0;
+    return *this;
+}
+
+bool DimVector::operator==(const DimVector& rhs) const {
+    return std::equal(begin(), end(), rhs.begin(), rhs.end());
+}
+
+void DimVector::push_back(int64_t dim) {
+    if (m_size == m_capacity) {
+        reserve(m_capacity * 2);
+    }
+    m_data[m_size++] = dim;
+}
+
+void DimVector::resize(size_t num) {
+    reserve(num);
+    if (num > m_size) {
+        std::fill(m_data + m_size, m_data + num, 0);
+    }
+    m_size = num;
+}
+
+void DimVector::assign(const int64_t* dims, size_t num) {
+    reserve(num);
+    std::copy(dims, dims + num, m_data);
+    m_size = num;
+}
+
+void DimVector::reserve(size_t capacity) {
+    if (capacity <= m_capacity) {
+        return;
+    }
+
+    int64_t* data = new int64_t[capacity];
+    std::copy(m_data, m_data + m_size, data);
+    if (!is_inline()) {
+        delete[] m_data;
+    }
+    m_data = data;
+    m_capacity = capacity;
+}
+
 bool TensorShape::operator==(const TensorShape& rhs) const {
-    return std::equal(m_dims.begin(), m_dims.end(), rhs.m_dims.begin(), rhs.m_dims.end());
+    if (m_layout != rhs.m_layout || m_dims != rhs.m_dims) {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_dims.size(); ++i) {
+        if (m_dims[i] < 0 && symbol(i) != rhs.symbol(i)) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool TensorShape::operator!=(const TensorShape& rhs) const { return !(*this == rhs); }
 
-int64_t TensorShape::element_num() const {
-    int64_t result = 0;
+bool TensorShape::is_compatible(const TensorShape& rhs) const {
+    if (m_layout != rhs.m_layout || m_dims.size() != rhs.m_dims.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_dims.size(); ++i) {
+        if (m_dims[i] >= 0 && rhs.m_dims[i] >= 0) {
+            if (m_dims[i] != rhs.m_dims[i]) {
+                return false;
+            }
+        } else if (m_dims[i] < 0 && rhs.m_dims[i] < 0 && !symbol(i).empty() && !rhs.symbol(i).empty() &&
+                   symbol(i) != rhs.symbol(i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TensorShape::set_dim(size_t index, int64_t dim) {
+    m_dims[index] = dim;
+    update_element_num();
+}
+
+void TensorShape::set_dims_num(size_t num) {
+    m_dims.resize(num);
+    if (!m_symbols.empty()) {
+        m_symbols.resize(num);
+    }
+    update_element_num();
+}
+
+void TensorShape::add_dim(int64_t dim) {
+    m_dims.push_back(dim);
+    if (!m_symbols.empty()) {
+        m_symbols.emplace_back();
+    }
+    update_element_num();
+}
+
+void TensorShape::set_dims(const std::vector<int64_t>& dims) {
+    m_dims.assign(dims.data(), dims.size());
+    m_symbols.clear();
+    update_element_num();
+}
+
+void TensorShape::add_symbolic_dim(const std::string& symbol) {
+    add_dim(kDynamicDim);
+    set_symbol(m_dims.size() - 1, symbol);
+}
+
+void TensorShape::add_dim(const TensorShape& shape, size_t index) {
+    add_dim(shape[index]);
+    if (shape.is_dynamic(index)) {
+        set_symbol(m_dims.size() - 1, shape.symbol(index));
+    }
+}
+
+void TensorShape::copy_dim(size_t index, const TensorShape& shape, size_t src_index) {
+    if (shape.is_dynamic(src_index)) {
+        set_symbol(index, shape.symbol(src_index));
+    } else {
+        set_dim(index, shape[src_index]);
+    }
+}
+
+const std::string& TensorShape::symbol(size_t index) const {
+    static const std::string empty;
+    return index < m_symbols.size() && m_dims[index] < 0 ? m_symbols[index] : empty;
+}
+
+void TensorShape::set_symbol(size_t index, const std::string& symbol) {
+    m_dims[index] = kDynamicDim;
+    m_element_num = kDynamicDim;
+    if (symbol.empty() && m_symbols.empty()) {
+        return;
+    }
+
+    m_symbols.resize(m_dims.size());
+    m_symbols[index] = symbol;
+}
+
+void TensorShape::update_element_num() {
+    if (std::any_of(m_dims.cbegin(), m_dims.cend(), [](int64_t dim) { return dim < 0; })) {
+        m_element_num = kDynamicDim;
+        return;
+    }
+
+    m_element_num = 0;
     if (m_dims.size() > 0) {
-        result = m_dims[0];
+        m_element_num = m_dims[0];
     }
 
     for (size_t i = 1; i < m_dims.size(); ++i) {
-        result *= m_dims[i];
+        m_element_num *= m_dims[i];
     }
-
-    return result;
 }
 
 bool TensorShape::is_scalar() const {
@@ -35,16 +234,24 @@ std::string TensorShape::to_string() const {
 
     oss << "{";
     bool first = true;
-    for (auto dim : m_dims) {
+    for (size_t i = 0; i < m_dims.size(); ++i) {
         if (!first) {
             oss << ",";
         }
 
-        oss << dim;
+        if (symbol(i).empty()) {
+            oss << m_dims[i];
+        } else {
+            oss << symbol(i);
+        }
         first = false;
     }
     oss << "}";
 
+    if (m_layout != DataLayout::NCHW) {
+        oss << layout_to_string(m_layout);
+    }
+
     return oss.str();
 }
 
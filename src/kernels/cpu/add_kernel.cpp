@@ -0,0 +1,130 @@
+#include "kernels/cpu/add_kernel.h"
+
+#include <sstream>
+
+namespace simple_ai {
+namespace kernels {
+
+namespace {
+
+/**
+ * @brief get the strides of the input aligned to the output dimensions. the stride of a broadcast dimension is 0
+ */
+std::vector<int64_t> broadcast_strides(const ir::TensorShape& in_shape, const ir::TensorShape& out_shape) {
+    const size_t out_rank = out_shape.dims_num();
+    const size_t in_rank = in_shape.dims_num();
+    std::vector<int64_t> strides(out_rank, 0);
+
+    int64_t stride = 1;
+    for (size_t i = 0; i < in_rank; ++i) {
+        size_t in_index = in_rank - 1 - i;
+        size_t out_index = out_rank - 1 - i;
+        strides[out_index] = in_shape[in_index] == 1 ? 0 : stride;
+        stride *= in_shape[in_index];
+    }
+
+    return strides;
+}
+
+/**
+ * @brief check that each dim of the input is 1 or equal to the aligned output dim, so the strides stay in the input
+ */
+bool is_broadcastable(const ir::TensorShape& in_shape, const ir::TensorShape& out_shape) {
+    const size_t out_rank = out_shape.dims_num();
+    const size_t in_rank = in_shape.dims_num();
+    if (in_rank > out_rank) {
+        return false;
+    }
+
+    for (size_t i = 0; i < in_rank; ++i) {
+        int64_t in_dim = in_shape[in_rank - 1 - i];
+        if (in_dim != 1 && in_dim != out_shape[out_rank - 1 - i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}    // namespace
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Add
+// https://github.com/onnx/onnx/blob/main/docs/Broadcasting.md
+std::string AddKernel::node_type() const { return "Add"; }
+
+DataLayout AddKernel::preferred_layout() const { return DataLayout::ANY; }
+
+bool AddKernel::supports_layout(DataLayout layout) const { return layout != DataLayout::ANY; }
+
+Status AddKernel::compute(const std::string& node_name, const OpParams& params,
+                          const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    (void)params;
+
+    if (inputs.size() != 2 || outputs.size() != 1 || !inputs[0] || !inputs[1]) {
+        std::ostringstream oss;
+        oss << "Node: Add[" << node_name << "], Invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (inputs[0]->data_type() != PrimitiveDataType::FLOAT32 || inputs[1]->data_type() != PrimitiveDataType::FLOAT32) {
+        std::ostringstream oss;
+        oss << "Node: Add[" << node_name << "], only float32 is supported now";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    const auto& shape_a = inputs[0]->shape();
+    const auto& shape_b = inputs[1]->shape();
+    const auto& out_shape = outputs[0]->shape();
+
+    const float* a = inputs[0]->data_as<float>();
+    const float* b = inputs[1]->data_as<float>();
+    float* y = outputs[0]->data_as<float>();
+    const int64_t len = out_shape.element_num();
+
+    // fast path, no broadcasting
+    if (shape_a == out_shape && shape_b == out_shape) {
+        for (int64_t i = 0; i < len; ++i) {
+            y[i] = a[i] + b[i];
+        }
+        return Status::ok();
+    }
+
+    // the broadcasting below walks the logical dims, which is the memory order only in the default layout
+    bool layout_invalid = out_shape.layout() != DataLayout::NCHW && !shape_a.is_scalar() && !shape_b.is_scalar();
+    if (layout_invalid || !is_broadcastable(shape_a, out_shape) || !is_broadcastable(shape_b, out_shape)) {
+        std::ostringstream oss;
+        oss << "Node: Add[" << node_name << "], input1 shape: " << shape_a.to_string()
+            << " input2 shape: " << shape_b.to_string() << " output shape: " << out_shape.to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const size_t rank = out_shape.dims_num();
+    std::vector<int64_t> strides_a = broadcast_strides(shape_a, out_shape);
+    std::vector<int64_t> strides_b = broadcast_strides(shape_b, out_shape);
+    std::vector<int64_t> index(rank, 0);
+
+    int64_t offset_a = 0;
+    int64_t offset_b = 0;
+    for (int64_t i = 0; i < len; ++i) {
+        y[i] = a[offset_a] + b[offset_b];
+
+        // move to the next output element, the innermost dimension first
+        for (size_t d = rank; d-- > 0;) {
+            ++index[d];
+            offset_a += strides_a[d];
+            offset_b += strides_b[d];
+            if (index[d] < out_shape[d]) {
+                break;
+            }
+
+            offset_a -= strides_a[d] * index[d];
+            offset_b -= strides_b[d] * index[d];
+            index[d] = 0;
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace kernels
+}    // namespace simple_ai
@@ -0,0 +1,336 @@
+#include "kernels/cpu/conv_kernel.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace kernels {
+
+namespace {
+
+// the number of output elements along the width computed at a time
+constexpr int64_t kTileWidth = 16;
+
+struct Conv2DParams {
+    int64_t batch;
+    int64_t in_channels;
+    int64_t in_height;
+    int64_t in_width;
+    int64_t out_channels;
+    int64_t kernel_height;
+    int64_t kernel_width;
+    int64_t out_height;
+    int64_t out_width;
+    int64_t stride_h;
+    int64_t stride_w;
+    int64_t pad_top;
+    int64_t pad_left;
+    int64_t dilation_h;
+    int64_t dilation_w;
+};
+
+Status get_conv2d_params(const std::string& node_name, const ir::ConvParams& conv, const Tensor* x, const Tensor* w,
+                         const Tensor* y, Conv2DParams& params) {
+    const auto& x_shape = x->shape();
+    const auto& w_shape = w->shape();
+    const auto& y_shape = y->shape();
+
+    if (x_shape.dims_num() != 4 || w_shape.dims_num() != 4 || y_shape.dims_num() != 4) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], only 2D convolution is supported now";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    if (x->data_type() != PrimitiveDataType::FLOAT32 || w->data_type() != PrimitiveDataType::FLOAT32) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], only float32 convolution is supported now";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    if (conv.group != 1 || x_shape[1] != w_shape[1]) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], group convolution is not supported now";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    // the absent attributes are empty, which means no dilation, no padding and unit strides
+    if ((!conv.dilations.empty() && conv.dilations.size() != 2) || (!conv.pads.empty() && conv.pads.size() != 4) ||
+        (!conv.strides.empty() && conv.strides.size() != 2)) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], invalid dilations, pads or strides";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (x_shape.layout() != y_shape.layout() ||
+        (x_shape.layout() != DataLayout::NCHW && x_shape.layout() != DataLayout::NHWC)) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], unsupported input layout: " << x_shape.to_string()
+            << " or output layout: " << y_shape.to_string();
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    params.batch = x_shape[0];
+    params.in_channels = x_shape[1];
+    params.in_height = x_shape[2];
+    params.in_width = x_shape[3];
+    params.out_channels = w_shape[0];
+    params.kernel_height = w_shape[2];
+    params.kernel_width = w_shape[3];
+    params.out_height = y_shape[2];
+    params.out_width = y_shape[3];
+    params.stride_h = conv.strides.empty() ? 1 : conv.strides[0];
+    params.stride_w = conv.strides.empty() ? 1 : conv.strides[1];
+    params.pad_top = conv.pads.empty() ? 0 : conv.pads[0];
+    params.pad_left = conv.pads.empty() ? 0 : conv.pads[1];
+    params.dilation_h = conv.dilations.empty() ? 1 : conv.dilations[0];
+    params.dilation_w = conv.dilations.empty() ? 1 : conv.dilations[1];
+
+    if (y_shape[0] != params.batch || y_shape[1] != params.out_channels) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], invalid output shape: " << y_shape.to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief direct convolution. the output is computed in tiles along the width, and the epilogue (bias, residual,
+ * relu) is applied to the tile before it is stored, so the output is written to memory only once.
+ */
+void conv2d_nchw(const Conv2DParams& p, const float* x, const float* w, const float* bias, const float* residual,
+                 bool relu, float* y) {
+    const int64_t out_plane = p.out_height * p.out_width;
+    float acc[kTileWidth];
+
+    for (int64_t n = 0; n < p.batch; ++n) {
+        for (int64_t m = 0; m < p.out_channels; ++m) {
+            const float init = bias ? bias[m] : 0.0f;
+            const int64_t out_offset = (n * p.out_channels + m) * out_plane;
+
+            for (int64_t oh = 0; oh < p.out_height; ++oh) {
+                for (int64_t ow0 = 0; ow0 < p.out_width; ow0 += kTileWidth) {
+                    const int64_t count = std::min(kTileWidth, p.out_width - ow0);
+                    std::fill(acc, acc + count, init);
+
+                    for (int64_t c = 0; c < p.in_channels; ++c) {
+                        for (int64_t kh = 0; kh < p.kernel_height; ++kh) {
+                            const int64_t ih = oh * p.stride_h - p.pad_top + kh * p.dilation_h;
+                            if (ih < 0 || ih >= p.in_height) {
+                                continue;
+                            }
+
+                            const float* x_row = x + ((n * p.in_channels + c) * p.in_height + ih) * p.in_width;
+                            const float* w_row = w + ((m * p.in_channels + c) * p.kernel_height + kh) * p.kernel_width;
+                            for (int64_t kw = 0; kw < p.kernel_width; ++kw) {
+                                const float weight = w_row[kw];
+                                const int64_t iw_base = ow0 * p.stride_w - p.pad_left + kw * p.dilation_w;
+                                for (int64_t t = 0; t < count; ++t) {
+                                    const int64_t iw = iw_base + t * p.stride_w;
+                                    if (iw >= 0 && iw < p.in_width) {
+                                        acc[t] += weight * x_row[iw];
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // epilogue
+                    const int64_t tile_offset = out_offset + oh * p.out_width + ow0;
+                    if (residual) {
+                        const float* res = residual + tile_offset;
+                        for (int64_t t = 0; t < count; ++t) {
+                            acc[t] += res[t];
+                        }
+                    }
+
+                    if (relu) {
+                        for (int64_t t = 0; t < count; ++t) {
+                            acc[t] = std::max(acc[t], 0.0f);
+                        }
+                    }
+
+                    std::copy(acc, acc + count, y + tile_offset);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief direct convolution in NHWC layout. the weights are packed as [kH, kW, C, M] (DataLayout::HWIO) so the
+ * innermost loop runs over the contiguous output channels of one output pixel, which is kept in a small accumulator
+ * until the epilogue is applied.
+ */
+void conv2d_nhwc(const Conv2DParams& p, const float* x, const float* packed_w, const float* bias,
+                 const float* residual, bool relu, float* y) {
+    const int64_t channels = p.in_channels;
+    const int64_t filters = p.out_channels;
+
+    std::vector<float> acc(filters);
+    for (int64_t n = 0; n < p.batch; ++n) {
+        for (int64_t oh = 0; oh < p.out_height; ++oh) {
+            for (int64_t ow = 0; ow < p.out_width; ++ow) {
+                if (bias) {
+                    std::copy(bias, bias + filters, acc.begin());
+                } else {
+                    std::fill(acc.begin(), acc.end(), 0.0f);
+                }
+
+                for (int64_t kh = 0; kh < p.kernel_height; ++kh) {
+                    const int64_t ih = oh * p.stride_h - p.pad_top + kh * p.dilation_h;
+                    if (ih < 0 || ih >= p.in_height) {
+                        continue;
+                    }
+
+                    for (int64_t kw = 0; kw < p.kernel_width; ++kw) {
+                        const int64_t iw = ow * p.stride_w - p.pad_left + kw * p.dilation_w;
+                        if (iw < 0 || iw >= p.in_width) {
+                            continue;
+                        }
+
+                        const float* x_pixel = x + ((n * p.in_height + ih) * p.in_width + iw) * channels;
+                        const float* w_tap = packed_w + (kh * p.kernel_width + kw) * channels * filters;
+                        for (int64_t c = 0; c < channels; ++c) {
+                            const float value = x_pixel[c];
+                            const float* w_row = w_tap + c * filters;
+                            for (int64_t m = 0; m < filters; ++m) {
+                                acc[m] += value * w_row[m];
+                            }
+                        }
+                    }
+                }
+
+                // epilogue
+                const int64_t pixel_offset = ((n * p.out_height + oh) * p.out_width + ow) * filters;
+                if (residual) {
+                    const float* res = residual + pixel_offset;
+                    for (int64_t m = 0; m < filters; ++m) {
+                        acc[m] += res[m];
+                    }
+                }
+
+                if (relu) {
+                    for (int64_t m = 0; m < filters; ++m) {
+                        acc[m] = std::max(acc[m], 0.0f);
+                    }
+                }
+
+                std::copy(acc.begin(), acc.end(), y + pixel_offset);
+            }
+        }
+    }
+}
+
+Status compute_conv(const std::string& node_name, const OpParams& op_params, const Tensor* x, const Tensor* w,
+                    const Tensor* b, const Tensor* z, Tensor* y) {
+    const ir::ConvParams* conv = nullptr;
+    auto ret = ir::get_op_params("Conv", node_name, op_params, conv);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    Conv2DParams params;
+    ret = get_conv2d_params(node_name, *conv, x, w, y, params);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    if (b && b->shape().element_num() != params.out_channels) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], invalid bias shape: " << b->shape().to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (z && z->shape() != y->shape()) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], invalid residual shape: " << z->shape().to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const bool packed = w->shape().layout() == DataLayout::HWIO;
+    const bool nhwc = x->shape().layout() == DataLayout::NHWC;
+    if (packed && !nhwc) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], the packed weights are only supported by the NHWC input, input shape: "
+            << x->shape().to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const float* weights = w->data_as<float>();
+    // the weights which were not packed by the layout pass, e.g. a graph input, are packed on every call
+    std::vector<float> packed_w;
+    if (nhwc && !packed) {
+        packed_w.resize(w->shape().element_num());
+        pack_conv_weights_hwio(weights, params.out_channels, params.in_channels,
+                               params.kernel_height * params.kernel_width, packed_w.data());
+        weights = packed_w.data();
+    }
+
+    auto conv2d = nhwc ? conv2d_nhwc : conv2d_nchw;
+    conv2d(params, x->data_as<float>(), weights, b ? b->data_as<float>() : nullptr, z ? z->data_as<float>() : nullptr,
+           conv->activation == ir::FusedActivation::RELU, y->data_as<float>());
+    return Status::ok();
+}
+
+}    // namespace
+
+void pack_conv_weights_hwio(const float* w, int64_t filters, int64_t channels, int64_t kernel_plane, float* packed) {
+    for (int64_t m = 0; m < filters; ++m) {
+        for (int64_t c = 0; c < channels; ++c) {
+            for (int64_t k = 0; k < kernel_plane; ++k) {
+                packed[(k * channels + c) * filters + m] = w[(m * channels + c) * kernel_plane + k];
+            }
+        }
+    }
+}
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Conv
+std::string ConvKernel::node_type() const { return "Conv"; }
+
+DataLayout ConvKernel::preferred_layout() const { return DataLayout::NHWC; }
+
+bool ConvKernel::supports_layout(DataLayout layout) const {
+    return layout == DataLayout::NCHW || layout == DataLayout::NHWC;
+}
+
+Status ConvKernel::compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    if (inputs.size() < 2 || inputs.size() > 3 || outputs.size() != 1 || !inputs[0] || !inputs[1]) {
+        std::ostringstream oss;
+        oss << "Node: Conv[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const Tensor* bias = inputs.size() == 3 ? inputs[2] : nullptr;
+    return compute_conv(node_name, params, inputs[0], inputs[1], bias, nullptr, outputs[0]);
+}
+
+std::string FusedConvKernel::node_type() const { return ir::kFusedConvOpType; }
+
+DataLayout FusedConvKernel::preferred_layout() const { return DataLayout::NHWC; }
+
+bool FusedConvKernel::supports_layout(DataLayout layout) const {
+    return layout == DataLayout::NCHW || layout == DataLayout::NHWC;
+}
+
+Status FusedConvKernel::compute(const std::string& node_name, const OpParams& params,
+                                const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    if (inputs.size() < 2 || inputs.size() > 4 || outputs.size() != 1 || !inputs[0] || !inputs[1]) {
+        std::ostringstream oss;
+        oss << "Node: FusedConv[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const Tensor* bias = inputs.size() > 2 ? inputs[2] : nullptr;
+    const Tensor* residual = inputs.size() > 3 ? inputs[3] : nullptr;
+    return compute_conv(node_name, params, inputs[0], inputs[1], bias, residual, outputs[0]);
+}
+
+}    // namespace kernels
+}    // namespace simple_ai
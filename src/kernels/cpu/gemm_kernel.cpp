@@ -0,0 +1,185 @@
+#include "kernels/cpu/gemm_kernel.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace kernels {
+
+namespace {
+
+// the register tile of the micro kernel
+constexpr int64_t kTileRows = 4;
+constexpr int64_t kTileCols = 16;
+
+struct GemmParams {
+    int64_t m;
+    int64_t n;
+    int64_t k;
+    // the strides of A and B along their logical (row, column) after the transposition
+    int64_t a_row_stride;
+    int64_t a_col_stride;
+    int64_t b_row_stride;
+    int64_t b_col_stride;
+    // the strides of the broadcast C, 0 for a broadcast dimension
+    int64_t c_row_stride;
+    int64_t c_col_stride;
+    float alpha;
+    float beta;
+};
+
+/**
+ * @brief compute a kTileRows x kTileCols tile of the output in registers, then store it with the epilogue
+ */
+void gemm_micro_kernel(const GemmParams& p, const float* a, const float* b, const float* c, const float* residual,
+                       bool relu, float* y, int64_t row0, int64_t col0, int64_t rows, int64_t cols) {
+    float acc[kTileRows][kTileCols] = {};
+
+    for (int64_t kk = 0; kk < p.k; ++kk) {
+        const float* b_row = b + kk * p.b_row_stride + col0 * p.b_col_stride;
+        for (int64_t r = 0; r < rows; ++r) {
+            const float a_val = a[(row0 + r) * p.a_row_stride + kk * p.a_col_stride];
+            for (int64_t t = 0; t < cols; ++t) {
+                acc[r][t] += a_val * b_row[t * p.b_col_stride];
+            }
+        }
+    }
+
+    // store phase
+    for (int64_t r = 0; r < rows; ++r) {
+        const int64_t row = row0 + r;
+        float* y_row = y + row * p.n + col0;
+        for (int64_t t = 0; t < cols; ++t) {
+            float val = p.alpha * acc[r][t];
+            if (c) {
+                val += p.beta * c[row * p.c_row_stride + (col0 + t) * p.c_col_stride];
+            }
+            if (residual) {
+                val += residual[row * p.n + col0 + t];
+            }
+            if (relu) {
+                val = std::max(val, 0.0f);
+            }
+            y_row[t] = val;
+        }
+    }
+}
+
+Status compute_gemm(const std::string& node_name, const OpParams& op_params, const Tensor* a, const Tensor* b,
+                    const Tensor* c, const Tensor* z, Tensor* y) {
+    const ir::GemmParams* gemm = nullptr;
+    auto ret = ir::get_op_params("Gemm", node_name, op_params, gemm);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    const auto& a_shape = a->shape();
+    const auto& b_shape = b->shape();
+    const auto& y_shape = y->shape();
+
+    if (a_shape.dims_num() != 2 || b_shape.dims_num() != 2 || y_shape.dims_num() != 2) {
+        std::ostringstream oss;
+        oss << "Node: Gemm[" << node_name << "], invalid dims of inputs or output";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (a->data_type() != PrimitiveDataType::FLOAT32 || b->data_type() != PrimitiveDataType::FLOAT32) {
+        std::ostringstream oss;
+        oss << "Node: Gemm[" << node_name << "], only float32 is supported now";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    const bool trans_a = gemm->trans_a;
+    const bool trans_b = gemm->trans_b;
+    const bool relu = gemm->activation == ir::FusedActivation::RELU;
+
+    GemmParams p;
+    p.alpha = gemm->alpha;
+    p.beta = gemm->beta;
+    p.m = trans_a ? a_shape[1] : a_shape[0];
+    p.k = trans_a ? a_shape[0] : a_shape[1];
+    p.n = trans_b ? b_shape[0] : b_shape[1];
+    p.a_row_stride = trans_a ? 1 : a_shape[1];
+    p.a_col_stride = trans_a ? a_shape[1] : 1;
+    p.b_row_stride = trans_b ? 1 : b_shape[1];
+    p.b_col_stride = trans_b ? b_shape[1] : 1;
+    p.c_row_stride = 0;
+    p.c_col_stride = 0;
+
+    if ((trans_b ? b_shape[1] : b_shape[0]) != p.k || y_shape[0] != p.m || y_shape[1] != p.n) {
+        std::ostringstream oss;
+        oss << "Node: Gemm[" << node_name << "], mismatch dims of inputs and output";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (c) {
+        const auto& c_shape = c->shape();
+        if (c_shape.dims_num() == 2) {
+            p.c_row_stride = c_shape[0] == 1 ? 0 : c_shape[1];
+            p.c_col_stride = c_shape[1] == 1 ? 0 : 1;
+        } else if (c_shape.dims_num() == 1) {
+            p.c_col_stride = c_shape[0] == 1 ? 0 : 1;
+        }
+    }
+
+    if (z && z->shape() != y_shape) {
+        std::ostringstream oss;
+        oss << "Node: Gemm[" << node_name << "], invalid residual shape: " << z->shape().to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const float* a_data = a->data_as<float>();
+    const float* b_data = b->data_as<float>();
+    const float* c_data = c ? c->data_as<float>() : nullptr;
+    const float* z_data = z ? z->data_as<float>() : nullptr;
+    float* y_data = y->data_as<float>();
+
+    for (int64_t row0 = 0; row0 < p.m; row0 += kTileRows) {
+        const int64_t rows = std::min(kTileRows, p.m - row0);
+        for (int64_t col0 = 0; col0 < p.n; col0 += kTileCols) {
+            const int64_t cols = std::min(kTileCols, p.n - col0);
+            gemm_micro_kernel(p, a_data, b_data, c_data, z_data, relu, y_data, row0, col0, rows, cols);
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
+std::string GemmKernel::node_type() const { return "Gemm"; }
+
+Status GemmKernel::compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    if (inputs.size() < 2 || inputs.size() > 3 || outputs.size() != 1 || !inputs[0] || !inputs[1]) {
+        std::ostringstream oss;
+        oss << "Node: Gemm[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const Tensor* c = inputs.size() == 3 ? inputs[2] : nullptr;
+    return compute_gemm(node_name, params, inputs[0], inputs[1], c, nullptr, outputs[0]);
+}
+
+std::string FusedGemmKernel::node_type() const { return ir::kFusedGemmOpType; }
+
+Status FusedGemmKernel::compute(const std::string& node_name, const OpParams& params,
+                                const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    if (inputs.size() < 2 || inputs.size() > 4 || outputs.size() != 1 || !inputs[0] || !inputs[1]) {
+        std::ostringstream oss;
+        oss << "Node: FusedGemm[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const Tensor* c = inputs.size() > 2 ? inputs[2] : nullptr;
+    const Tensor* residual = inputs.size() > 3 ? inputs[3] : nullptr;
+    return compute_gemm(node_name, params, inputs[0], inputs[1], c, residual, outputs[0]);
+}
+
+}    // namespace kernels
+}    // namespace simple_ai
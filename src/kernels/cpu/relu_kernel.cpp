@@ -0,0 +1,51 @@
+#include "kernels/cpu/relu_kernel.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace simple_ai {
+namespace kernels {
+
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Relu
+std::string ReluKernel::node_type() const { return "Relu"; }
+
+DataLayout ReluKernel::preferred_layout() const { return DataLayout::ANY; }
+
+bool ReluKernel::supports_layout(DataLayout layout) const { return layout != DataLayout::ANY; }
+
+Status ReluKernel::compute(const std::string& node_name, const OpParams& params,
+                           const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    (void)params;
+
+    if (inputs.size() != 1 || outputs.size() != 1 || !inputs[0]) {
+        std::ostringstream oss;
+        oss << "Node: Relu[" << node_name << "], Invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (inputs[0]->data_type() != PrimitiveDataType::FLOAT32) {
+        std::ostringstream oss;
+        oss << "Node: Relu[" << node_name << "], only float32 is supported now";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    const int64_t len = inputs[0]->shape().element_num();
+    if (outputs[0]->shape().element_num() != len) {
+        std::ostringstream oss;
+        oss << "Node: Relu[" << node_name << "], input shape: " << inputs[0]->shape().to_string()
+            << " mismatch output shape: " << outputs[0]->shape().to_string();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const float* x = inputs[0]->data_as<float>();
+    float* y = outputs[0]->data_as<float>();
+    for (int64_t i = 0; i < len; ++i) {
+        y[i] = std::max(x[i], 0.0f);
+    }
+
+    return Status::ok();
+}
+
+}    // namespace kernels
+}    // namespace simple_ai
@@ -0,0 +1,106 @@
+#include "kernels/cpu/reorder_kernel.h"
+
+#include <sstream>
+
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace kernels {
+
+namespace {
+
+/**
+ * @brief the strides of the logical dims (n, c, h, w) in memory. the NCHWc channel is split into the block index
+ * and the lane, so it is handled by `channel_offset`
+ */
+struct LayoutStrides {
+    int64_t n;
+    int64_t c;
+    int64_t h;
+    int64_t w;
+    // the stride of c / kNCHWcBlockSize, only used by NCHWc
+    int64_t block;
+};
+
+LayoutStrides layout_strides(DataLayout layout, int64_t channels, int64_t height, int64_t width) {
+    switch (layout) {
+        case DataLayout::NHWC:
+            return {height * width * channels, 1, width * channels, channels, 0};
+        case DataLayout::NCHWc:
+            return {channels * height * width, 1, width * ir::kNCHWcBlockSize, ir::kNCHWcBlockSize,
+                    height * width * ir::kNCHWcBlockSize};
+        default:
+            return {channels * height * width, height * width, width, 1, 0};
+    }
+}
+
+int64_t channel_offset(DataLayout layout, const LayoutStrides& strides, int64_t c) {
+    if (layout == DataLayout::NCHWc) {
+        return (c / ir::kNCHWcBlockSize) * strides.block + c % ir::kNCHWcBlockSize;
+    }
+    return c * strides.c;
+}
+
+}    // namespace
+
+std::string ReorderKernel::node_type() const { return ir::kReorderOpType; }
+
+DataLayout ReorderKernel::preferred_layout() const { return DataLayout::ANY; }
+
+bool ReorderKernel::supports_layout(DataLayout layout) const { return layout != DataLayout::ANY; }
+
+Status ReorderKernel::compute(const std::string& node_name, const OpParams& params,
+                              const std::vector<const Tensor*>& inputs, std::vector<Tensor*>& outputs) {
+    (void)params;
+
+    if (inputs.size() != 1 || outputs.size() != 1 || !inputs[0]) {
+        std::ostringstream oss;
+        oss << "Node: Reorder[" << node_name << "], invalid input size: " << inputs.size()
+            << " or output size: " << outputs.size();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const auto& x_shape = inputs[0]->shape();
+    const auto& y_shape = outputs[0]->shape();
+    if (x_shape.dims() != y_shape.dims() || x_shape.dims_num() != 4 ||
+        inputs[0]->data_type() != PrimitiveDataType::FLOAT32) {
+        std::ostringstream oss;
+        oss << "Node: Reorder[" << node_name << "], only 4-D float32 tensors are supported, input shape: "
+            << x_shape.to_string() << " output shape: " << y_shape.to_string();
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    const int64_t batch = x_shape[0];
+    const int64_t channels = x_shape[1];
+    const int64_t height = x_shape[2];
+    const int64_t width = x_shape[3];
+    bool blocked = x_shape.layout() == DataLayout::NCHWc || y_shape.layout() == DataLayout::NCHWc;
+    if (blocked && channels % ir::kNCHWcBlockSize != 0) {
+        std::ostringstream oss;
+        oss << "Node: Reorder[" << node_name << "], the channels: " << channels
+            << " are not a multiple of the NCHWc block size";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    const float* x = inputs[0]->data_as<float>();
+    float* y = outputs[0]->data_as<float>();
+    const LayoutStrides xs = layout_strides(x_shape.layout(), channels, height, width);
+    const LayoutStrides ys = layout_strides(y_shape.layout(), channels, height, width);
+
+    for (int64_t n = 0; n < batch; ++n) {
+        for (int64_t c = 0; c < channels; ++c) {
+            const float* x_plane = x + n * xs.n + channel_offset(x_shape.layout(), xs, c);
+            float* y_plane = y + n * ys.n + channel_offset(y_shape.layout(), ys, c);
+            for (int64_t h = 0; h < height; ++h) {
+                for (int64_t w = 0; w < width; ++w) {
+                    y_plane[h * ys.h + w * ys.w] = x_plane[h * xs.h + w * xs.w];
+                }
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace kernels
+}    // namespace simple_ai
@@ -0,0 +1,49 @@
+#include "kernels/kernel_manager.h"
+
+#include "kernels/cpu/add_kernel.h"
+#include "kernels/cpu/conv_kernel.h"
+#include "kernels/cpu/gemm_kernel.h"
+#include "kernels/cpu/relu_kernel.h"
+#include "kernels/cpu/reorder_kernel.h"
+
+namespace simple_ai {
+namespace kernels {
+
+KernelManager* KernelManager::instance() {
+    static KernelManager instance;
+    return &instance;
+}
+
+template <typename T>
+void KernelManager::register_kernel() {
+    auto kernel = std::make_unique<T>();
+
+    auto ret = m_kernel_map.emplace(kernel->node_type(), nullptr);
+    if (ret.second) {
+        ret.first->second = std::move(kernel);
+    }
+}
+
+void KernelManager::register_all_kernels() {
+    std::call_once(m_init_flag, [this]() {
+        register_kernel<ConvKernel>();
+        register_kernel<FusedConvKernel>();
+        register_kernel<GemmKernel>();
+        register_kernel<FusedGemmKernel>();
+        register_kernel<ReluKernel>();
+        register_kernel<AddKernel>();
+        register_kernel<ReorderKernel>();
+    });
+}
+
+IKernel* KernelManager::get_kernel(const std::string& node_type) {
+    auto iter = m_kernel_map.find(node_type);
+    if (iter != m_kernel_map.end()) {
+        return iter->second.get();
+    }
+
+    return nullptr;
+}
+
+}    // namespace kernels
+}    // namespace simple_ai
@@ -0,0 +1,229 @@
+#include "optimizer/common_subexpression_elimination.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ir/graph_transaction.h"
+#include "optimizer/pass_utils.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::Node;
+using ir::NodeArg;
+using ir::NodeAttribute;
+using ir::NodeAttributeType;
+using ir::Tensor;
+using ir::TensorShape;
+
+namespace {
+
+template <typename T>
+void append_bytes(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void append_string(std::string& key, const std::string& str) {
+    append_bytes(key, str.size());
+    key.append(str);
+}
+
+/**
+ * @brief serialize the attribute into the key. tensor attributes are compared by identity
+ */
+void append_attribute(std::string& key, const NodeAttribute& attr) {
+    append_string(key, attr.name());
+    append_bytes(key, static_cast<int>(attr.type()));
+    switch (attr.type()) {
+        case NodeAttributeType::INT64:
+            append_bytes(key, attr.get_int64());
+            break;
+        case NodeAttributeType::FLOAT:
+            append_bytes(key, attr.get_float());
+            break;
+        case NodeAttributeType::STRING:
+            append_string(key, attr.get_string());
+            break;
+        case NodeAttributeType::TENSOR:
+            append_bytes(key, attr.get_tensor());
+            break;
+        case NodeAttributeType::INT64_ARRAY:
+            append_bytes(key, attr.get_int64s().size());
+            key.append(reinterpret_cast<const char*>(attr.get_int64s().data()),
+                       attr.get_int64s().size() * sizeof(int64_t));
+            break;
+        case NodeAttributeType::FLOAT_ARRAY:
+            append_bytes(key, attr.get_floats().size());
+            key.append(reinterpret_cast<const char*>(attr.get_floats().data()),
+                       attr.get_floats().size() * sizeof(float));
+            break;
+        case NodeAttributeType::STRING_ARRAY:
+            append_bytes(key, attr.get_strings().size());
+            for (const auto& str : attr.get_strings()) {
+                append_string(key, str);
+            }
+            break;
+        case NodeAttributeType::TENSOR_ARRAY:
+            append_bytes(key, attr.get_tensors().size());
+            for (const auto& tensor : attr.get_tensors()) {
+                append_bytes(key, tensor.get());
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief the node key: (domain, type, sorted attributes, input args)
+ */
+std::string node_key(const Node* node) {
+    std::string key;
+    append_string(key, node->domain());
+    append_string(key, node->type());
+
+    std::map<std::string, const NodeAttribute*> sorted_attributes;
+    for (const auto& item : node->attributes()) {
+        sorted_attributes.emplace(item.first, item.second.get());
+    }
+    append_bytes(key, sorted_attributes.size());
+    for (const auto& item : sorted_attributes) {
+        append_attribute(key, *item.second);
+    }
+
+    append_bytes(key, node->input_args().size());
+    for (const auto* arg : node->input_args()) {
+        append_string(key, arg->name());
+    }
+    return key;
+}
+
+uint64_t content_hash(const void* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t storage_size(PrimitiveDataType data_type, const TensorShape& shape) {
+    const auto& dims = shape.dims();
+    if (std::any_of(dims.cbegin(), dims.cend(), [](int64_t dim) { return dim < 0; })) {
+        return 0;
+    }
+
+    size_t size = 0;
+    return Tensor::calc_storage_size(data_type, shape, size).is_ok() ? size : 0;
+}
+
+}    // namespace
+
+std::string CommonSubexpressionEliminationPass::name() const { return "CommonSubexpressionElimination"; }
+
+Status CommonSubexpressionEliminationPass::apply(Graph& graph, bool& modified) {
+    modified = false;
+    m_stats = CseStats();
+
+    // the duplicated args and the args which replace them
+    std::unordered_map<const NodeArg*, NodeArg*> replacements;
+
+    // initializers: bucket by (data type, dims, content hash), and confirm with a byte comparison
+    std::vector<std::string> initializer_names;
+    for (const auto& item : graph.get_initializers()) {
+        initializer_names.emplace_back(item.first);
+    }
+    std::sort(initializer_names.begin(), initializer_names.end());
+
+    std::unordered_map<std::string, std::vector<std::pair<const Tensor*, NodeArg*>>> initializer_buckets;
+    for (const auto& name : initializer_names) {
+        NodeArg* arg = graph.get_nodearg(name);
+        if (!arg || graph.is_graph_input(arg) || graph.is_graph_output(arg)) {
+            continue;
+        }
+
+        const Tensor* tensor = graph.get_initializer(name);
+        size_t size = 0;
+        if (!Tensor::calc_storage_size(tensor->data_type(), tensor->shape(), size).is_ok()) {
+            continue;
+        }
+
+        std::string key;
+        append_bytes(key, static_cast<int>(tensor->data_type()));
+        for (int64_t dim : tensor->shape().dims()) {
+            append_bytes(key, dim);
+        }
+        append_bytes(key, content_hash(tensor->data_raw(), size));
+
+        auto& bucket = initializer_buckets[key];
+        auto it = std::find_if(bucket.cbegin(), bucket.cend(), [tensor, size](const auto& item) {
+            return std::memcmp(item.first->data_raw(), tensor->data_raw(), size) == 0;
+        });
+        if (it == bucket.cend()) {
+            bucket.emplace_back(tensor, arg);
+            continue;
+        }
+
+        replacements[arg] = it->second;
+        ++m_stats.removed_initializers;
+        m_stats.saved_bytes += size;
+    }
+
+    // nodes: in topological order, so the inputs of a node have already been replaced when its key is computed
+    std::unordered_map<std::string, Node*> canonical_nodes;
+    ir::GraphTransaction transaction(graph);
+    for (Node* node : graph.get_topological_nodes()) {
+        const auto& inputs = node->input_args();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto it = replacements.find(inputs[i]);
+            if (it != replacements.end()) {
+                transaction.replace_input_arg(node, i, it->second);
+            }
+        }
+
+        // nodes without inputs may be sources such as random generators
+        if (inputs.empty()) {
+            continue;
+        }
+
+        const auto& outputs = node->output_args();
+        auto result = canonical_nodes.emplace(node_key(node), node);
+        if (result.second) {
+            continue;
+        }
+
+        const Node* canonical = result.first->second;
+        bool has_graph_output = std::any_of(outputs.cbegin(), outputs.cend(),
+                                            [&graph](const NodeArg* arg) { return graph.is_graph_output(arg); });
+        if (has_graph_output || canonical->output_args().size() != outputs.size()) {
+            continue;
+        }
+
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            replacements[outputs[i]] = canonical->output_args()[i];
+            m_stats.saved_bytes += storage_size(outputs[i]->data_type(), outputs[i]->shape());
+        }
+        m_stats.saved_flops += utils::estimate_flops(node);
+        ++m_stats.removed_nodes;
+        auto ret = transaction.erase_node(node->id());
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    if (transaction.empty()) {
+        return Status::ok();
+    }
+
+    // the commit also releases the replaced initializers
+    modified = true;
+    return transaction.commit();
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
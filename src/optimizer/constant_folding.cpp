@@ -0,0 +1,117 @@
+#include "optimizer/constant_folding.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "framework/allocator_manager.h"
+#include "kernels/kernel_manager.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::Node;
+using ir::NodeArg;
+using ir::Tensor;
+
+namespace {
+
+bool is_constant(const Graph& graph, const NodeArg* arg) {
+    return graph.get_initializer(arg->name()) != nullptr && !graph.is_graph_input(arg);
+}
+
+bool is_foldable(const Graph& graph, const Node* node) {
+    const auto& inputs = node->input_args();
+    if (inputs.empty() || node->output_args().empty()) {
+        return false;
+    }
+
+    bool all_constant = std::all_of(inputs.cbegin(), inputs.cend(), [&graph](const NodeArg* arg) {
+        return arg->name().empty() || is_constant(graph, arg);
+    });
+    if (!all_constant) {
+        return false;
+    }
+
+    // the output shapes must be static
+    return std::all_of(node->output_args().cbegin(), node->output_args().cend(), [](const NodeArg* arg) {
+        const auto& dims = arg->shape().dims();
+        return !arg->name().empty() && std::all_of(dims.cbegin(), dims.cend(), [](int64_t dim) { return dim >= 0; });
+    });
+}
+
+}    // namespace
+
+std::string ConstantFoldingPass::name() const { return "ConstantFolding"; }
+
+Status ConstantFoldingPass::apply(Graph& graph, bool& modified) {
+    modified = false;
+
+    IAllocator* allocator = AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU);
+    std::vector<int> folded_nodes;
+    const std::vector<Node*> nodes = graph.get_topological_nodes();
+
+    for (Node* node : nodes) {
+        if (!is_foldable(graph, node)) {
+            continue;
+        }
+
+        kernels::IKernel* kernel = kernels::KernelManager::instance()->get_kernel(node->type());
+        if (!kernel) {
+            continue;
+        }
+
+        std::vector<const Tensor*> inputs;
+        PrimitiveDataType data_type = PrimitiveDataType::UNKNOWN;
+        for (auto* arg : node->input_args()) {
+            const Tensor* tensor = arg->name().empty() ? nullptr : graph.get_initializer(arg->name());
+            if (tensor && data_type == PrimitiveDataType::UNKNOWN) {
+                data_type = tensor->data_type();
+            }
+            inputs.emplace_back(tensor);
+        }
+
+        std::vector<std::unique_ptr<Tensor>> results;
+        std::vector<Tensor*> outputs;
+        for (auto* arg : node->output_args()) {
+            auto tensor = std::make_unique<Tensor>(arg->name());
+            auto dt = arg->data_type() != PrimitiveDataType::UNKNOWN ? arg->data_type() : data_type;
+            auto ret = tensor->init(dt, arg->shape(), allocator);
+            if (!ret.is_ok()) {
+                return ret;
+            }
+            outputs.emplace_back(tensor.get());
+            results.emplace_back(std::move(tensor));
+        }
+
+        // the kernel may not support the data type or attributes, keep the node in that case
+        auto ret = kernel->compute(node->name(), node->params(), inputs, outputs);
+        if (!ret.is_ok()) {
+            continue;
+        }
+
+        // the outputs become initializers, their node args are kept
+        for (auto& tensor : results) {
+            graph.add_initializer(std::move(tensor));
+        }
+        folded_nodes.emplace_back(node->id());
+    }
+
+    for (int id : folded_nodes) {
+        auto ret = graph.erase_node(id);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    if (folded_nodes.empty()) {
+        return Status::ok();
+    }
+
+    // rebuild the topology, which also cleans up the initializers consumed only by the folded nodes
+    modified = true;
+    return graph.construct_topology();
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
@@ -0,0 +1,141 @@
+#include "optimizer/conv_epilogue_fusion.h"
+
+#include <vector>
+
+#include "ir/graph_transaction.h"
+#include "ir/op_defines.h"
+#include "optimizer/pass_utils.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::Node;
+using ir::NodeArg;
+using ir::TensorShape;
+
+namespace {
+
+/**
+ * @brief check if the shape broadcasts only along the channel of the NCHW output, i.e. [C,1,1] or [1,C,1,1]
+ */
+bool is_per_channel_shape(const TensorShape& shape, const TensorShape& out_shape) {
+    size_t rank = shape.dims_num();
+    if (rank < 3 || rank > out_shape.dims_num()) {
+        return false;
+    }
+
+    size_t start = out_shape.dims_num() - rank;
+    for (size_t i = 0; i < rank; ++i) {
+        int64_t expected = (start + i == 1) ? out_shape[1] : 1;
+        if (shape[i] != expected) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}    // namespace
+
+std::string ConvEpilogueFusionPass::name() const { return "ConvEpilogueFusion"; }
+
+Status ConvEpilogueFusionPass::apply(Graph& graph, bool& modified) {
+    modified = false;
+
+    ir::GraphTransaction transaction(graph);
+    const std::vector<Node*> nodes = graph.get_topological_nodes();
+
+    for (Node* conv : nodes) {
+        if (conv->type() != "Conv" || conv->output_args().size() != 1) {
+            continue;
+        }
+
+        NodeArg* conv_output = conv->output_args()[0];
+        const TensorShape& out_shape = conv_output->shape();
+        if (out_shape.dims_num() != 4) {
+            continue;
+        }
+
+        bool has_bias = conv->input_args().size() > 2 && !conv->input_args()[2]->name().empty();
+        NodeArg* bias = nullptr;
+        NodeArg* residual = nullptr;
+        bool relu = false;
+        std::vector<Node*> absorbed_nodes;
+
+        Node* tail = conv;
+        Node* consumer = utils::single_consumer(transaction, tail);
+
+        // Conv -> Add(per-channel initializer)
+        if (consumer && consumer->type() == "Add" && !has_bias) {
+            NodeArg* other = utils::other_input(consumer, tail->output_args()[0]);
+            const auto* tensor = other ? graph.get_initializer(other->name()) : nullptr;
+            if (tensor && tensor->data_type() == PrimitiveDataType::FLOAT32 &&
+                is_per_channel_shape(tensor->shape(), out_shape)) {
+                bias = other;
+                absorbed_nodes.emplace_back(consumer);
+                tail = consumer;
+                consumer = utils::single_consumer(transaction, tail);
+            }
+        }
+
+        // Conv -> Add(residual)
+        if (consumer && consumer->type() == "Add") {
+            NodeArg* other = utils::other_input(consumer, tail->output_args()[0]);
+            if (other && other != tail->output_args()[0] && other->shape() == out_shape &&
+                consumer->output_args()[0]->shape() == out_shape) {
+                residual = other;
+                absorbed_nodes.emplace_back(consumer);
+                tail = consumer;
+                consumer = utils::single_consumer(transaction, tail);
+            }
+        }
+
+        // Conv -> Relu
+        if (consumer && consumer->type() == "Relu") {
+            relu = true;
+            absorbed_nodes.emplace_back(consumer);
+            tail = consumer;
+        }
+
+        if (absorbed_nodes.empty()) {
+            continue;
+        }
+
+        // rewrite the Conv to FusedConv, which produces the output of the last absorbed node
+        transaction.set_op_type(conv, ir::kFusedConvOpType, ir::kSimpleAIDomain);
+        if (bias) {
+            transaction.add_input_arg(conv, bias);
+        }
+
+        if (residual) {
+            if (conv->input_args().size() == 2) {
+                // the absent optional bias
+                transaction.add_input_arg(conv, graph.get_or_create_nodearg("", NodeArg("")));
+            }
+            transaction.add_input_arg(conv, residual);
+        }
+
+        if (relu) {
+            utils::set_string_attr(transaction, conv, ir::kActivationAttrName, ir::kReluActivation);
+        }
+
+        transaction.replace_output_arg(conv, 0, tail->output_args()[0]);
+
+        for (auto* node : absorbed_nodes) {
+            auto ret = transaction.erase_node(node->id());
+            if (!ret.is_ok()) {
+                return ret;
+            }
+        }
+    }
+
+    if (transaction.empty()) {
+        return Status::ok();
+    }
+
+    modified = true;
+    return transaction.commit();
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
@@ -0,0 +1,58 @@
+#include "optimizer/dead_node_elimination.h"
+
+#include <vector>
+
+#include "ir/graph_transaction.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+std::string DeadNodeEliminationPass::name() const { return "DeadNodeElimination"; }
+
+Status DeadNodeEliminationPass::apply(Graph& graph, bool& modified) {
+    modified = false;
+
+    // walk backward over the view from the producers of the graph outputs
+    const ir::GraphView& view = graph.get_view();
+    std::vector<bool> live_nodes(view.node_num(), false);
+    std::vector<int> nodes_stack;
+    for (const auto* output : graph.get_outputs()) {
+        const int producer = view.producer(output->id());
+        if (producer >= 0 && !live_nodes[producer]) {
+            live_nodes[producer] = true;
+            nodes_stack.emplace_back(producer);
+        }
+    }
+
+    while (!nodes_stack.empty()) {
+        const int node = nodes_stack.back();
+        nodes_stack.pop_back();
+
+        for (const auto& edge : view.input_edges(node)) {
+            if (!live_nodes[edge.node]) {
+                live_nodes[edge.node] = true;
+                nodes_stack.emplace_back(edge.node);
+            }
+        }
+    }
+
+    ir::GraphTransaction transaction(graph);
+    for (int i = 0; i < static_cast<int>(view.node_num()); ++i) {
+        if (!live_nodes[i]) {
+            auto ret = transaction.erase_node(view.node_id(i));
+            if (!ret.is_ok()) {
+                return ret;
+            }
+        }
+    }
+
+    if (transaction.empty()) {
+        return Status::ok();
+    }
+
+    modified = true;
+    return transaction.commit();
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
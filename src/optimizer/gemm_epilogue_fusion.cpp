@@ -0,0 +1,140 @@
+#include "optimizer/gemm_epilogue_fusion.h"
+
+#include <vector>
+
+#include "ir/graph_transaction.h"
+#include "ir/op_defines.h"
+#include "optimizer/pass_utils.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::Node;
+using ir::NodeArg;
+using ir::TensorShape;
+
+namespace {
+
+/**
+ * @brief check if the shape is unidirectional broadcastable to the [M, N] output, as the Gemm matrix C
+ */
+bool is_gemm_bias_shape(const TensorShape& shape, const TensorShape& out_shape) {
+    if (out_shape.dims_num() != 2) {
+        return false;
+    }
+
+    if (shape.dims_num() == 2) {
+        return (shape[0] == out_shape[0] || shape[0] == 1) && (shape[1] == out_shape[1] || shape[1] == 1);
+    } else if (shape.dims_num() == 1) {
+        return shape[0] == out_shape[1] || shape[0] == 1;
+    }
+
+    return false;
+}
+
+}    // namespace
+
+std::string GemmEpilogueFusionPass::name() const { return "GemmEpilogueFusion"; }
+
+Status GemmEpilogueFusionPass::apply(Graph& graph, bool& modified) {
+    modified = false;
+
+    ir::GraphTransaction transaction(graph);
+    const std::vector<Node*> nodes = graph.get_topological_nodes();
+
+    for (Node* gemm : nodes) {
+        if (gemm->type() != "Gemm" || gemm->output_args().size() != 1) {
+            continue;
+        }
+
+        const TensorShape& out_shape = gemm->output_args()[0]->shape();
+        if (out_shape.dims_num() != 2) {
+            continue;
+        }
+
+        bool has_c = gemm->input_args().size() > 2 && !gemm->input_args()[2]->name().empty();
+        NodeArg* matrix_c = nullptr;
+        NodeArg* residual = nullptr;
+        bool relu = false;
+        std::vector<Node*> absorbed_nodes;
+
+        Node* tail = gemm;
+        Node* consumer = utils::single_consumer(transaction, tail);
+
+        // Gemm -> Add(initializer) as the matrix C
+        if (consumer && consumer->type() == "Add" && !has_c) {
+            NodeArg* other = utils::other_input(consumer, tail->output_args()[0]);
+            const auto* tensor = other ? graph.get_initializer(other->name()) : nullptr;
+            if (tensor && tensor->data_type() == PrimitiveDataType::FLOAT32 &&
+                is_gemm_bias_shape(tensor->shape(), out_shape) &&
+                consumer->output_args()[0]->shape() == out_shape) {
+                matrix_c = other;
+                absorbed_nodes.emplace_back(consumer);
+                tail = consumer;
+                consumer = utils::single_consumer(transaction, tail);
+            }
+        }
+
+        // Gemm -> Add(residual)
+        if (consumer && consumer->type() == "Add") {
+            NodeArg* other = utils::other_input(consumer, tail->output_args()[0]);
+            if (other && other != tail->output_args()[0] && other->shape() == out_shape &&
+                consumer->output_args()[0]->shape() == out_shape) {
+                residual = other;
+                absorbed_nodes.emplace_back(consumer);
+                tail = consumer;
+                consumer = utils::single_consumer(transaction, tail);
+            }
+        }
+
+        // Gemm -> Relu
+        if (consumer && consumer->type() == "Relu") {
+            relu = true;
+            absorbed_nodes.emplace_back(consumer);
+            tail = consumer;
+        }
+
+        if (absorbed_nodes.empty()) {
+            continue;
+        }
+
+        // rewrite the Gemm to FusedGemm, which produces the output of the last absorbed node
+        transaction.set_op_type(gemm, ir::kFusedGemmOpType, ir::kSimpleAIDomain);
+        if (matrix_c) {
+            transaction.add_input_arg(gemm, matrix_c);
+            // the Add contributes C without scaling
+            utils::set_float_attr(transaction, gemm, "beta", 1.0f);
+        }
+
+        if (residual) {
+            if (gemm->input_args().size() == 2) {
+                // the absent optional matrix C
+                transaction.add_input_arg(gemm, graph.get_or_create_nodearg("", NodeArg("")));
+            }
+            transaction.add_input_arg(gemm, residual);
+        }
+
+        if (relu) {
+            utils::set_string_attr(transaction, gemm, ir::kActivationAttrName, ir::kReluActivation);
+        }
+
+        transaction.replace_output_arg(gemm, 0, tail->output_args()[0]);
+
+        for (auto* node : absorbed_nodes) {
+            auto ret = transaction.erase_node(node->id());
+            if (!ret.is_ok()) {
+                return ret;
+            }
+        }
+    }
+
+    if (transaction.empty()) {
+        return Status::ok();
+    }
+
+    modified = true;
+    return transaction.commit();
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
@@ -0,0 +1,356 @@
+#include "optimizer/layout_transformation.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/allocator_manager.h"
+#include "ir/node_utils.h"
+#include "ir/op_defines.h"
+#include "kernels/cpu/conv_kernel.h"
+#include "kernels/kernel_manager.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::DataLayout;
+using ir::Node;
+using ir::NodeArg;
+using ir::NodeAttribute;
+using ir::NodeAttributeType;
+using ir::Tensor;
+
+namespace {
+
+bool is_activation(const NodeArg* arg) { return !arg->name().empty() && arg->shape().dims_num() == 4; }
+
+bool is_conv(const Node* node) { return node->type() == "Conv" || node->type() == ir::kFusedConvOpType; }
+
+/**
+ * @brief the indices of the inputs which are activations. the weights and the bias of Conv keep their layout
+ */
+std::vector<size_t> activation_inputs(const Node* node) {
+    std::vector<size_t> indices;
+    const auto& inputs = node->input_args();
+    bool conv = is_conv(node);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if ((!conv || i == 0 || i == 3) && is_activation(inputs[i])) {
+            indices.emplace_back(i);
+        }
+    }
+    return indices;
+}
+
+DataLayout get_layout_attr(const Node* node, const std::string& name) {
+    DataLayout layout = DataLayout::NCHW;
+    ir::string_to_layout(ir::utils::get_attr_or_default<std::string>(name, "", node->attributes()), layout);
+    return layout;
+}
+
+class LayoutContext {
+public:
+    explicit LayoutContext(Graph& graph) : m_graph(graph) {
+        for (const auto& node : graph.get_nodes()) {
+            m_next_node_id = std::max(m_next_node_id, node->id() + 1);
+        }
+    }
+
+    DataLayout layout_of(const NodeArg* arg) const {
+        auto it = m_layouts.find(arg);
+        return it != m_layouts.end() ? it->second : arg->shape().layout();
+    }
+
+    void set_layout(const NodeArg* arg, DataLayout layout) { m_layouts[arg] = layout; }
+
+    /**
+     * @brief get the version of the arg in the layout, insert a Reorder node if it does not exist yet
+     */
+    NodeArg* convert(NodeArg* arg, DataLayout layout) {
+        if (layout_of(arg) == layout) {
+            return arg;
+        }
+
+        auto key = std::make_pair(static_cast<const NodeArg*>(arg), layout);
+        auto it = m_converted.find(key);
+        if (it != m_converted.end()) {
+            return it->second;
+        }
+
+        NodeArg* converted = create_arg(arg, layout);
+        add_reorder(arg, converted, layout_of(arg), layout);
+        return converted;
+    }
+
+    /**
+     * @brief the graph output must stay in NCHW. the producer writes a new arg in the layout, which is reordered
+     * into the graph output
+     */
+    NodeArg* redirect_graph_output(Node* producer, size_t index, DataLayout layout) {
+        NodeArg* output = producer->output_args()[index];
+        NodeArg* produced = create_arg(output, layout);
+        producer->replace_output_arg(index, produced);
+        add_reorder(produced, output, layout, DataLayout::NCHW);
+        m_converted[std::make_pair(static_cast<const NodeArg*>(output), layout)] = produced;
+        return produced;
+    }
+
+    /**
+     * @brief get the weights of an NHWC Conv packed in DataLayout::HWIO, a new initializer is created the first time.
+     * the weights which are not a float 4-D NCHW initializer, e.g. a graph input, are packed by the kernel instead
+     */
+    Status pack_conv_weight(NodeArg* weight, NodeArg*& packed) {
+        packed = weight;
+        const Tensor* tensor = m_graph.get_initializer(weight->name());
+        if (!tensor || m_graph.is_graph_input(weight) || tensor->data_type() != PrimitiveDataType::FLOAT32 ||
+            tensor->shape().dims_num() != 4 || tensor->shape().layout() != DataLayout::NCHW) {
+            return Status::ok();
+        }
+
+        auto key = std::make_pair(static_cast<const NodeArg*>(weight), DataLayout::HWIO);
+        auto it = m_converted.find(key);
+        if (it != m_converted.end()) {
+            packed = it->second;
+            return Status::ok();
+        }
+
+        NodeArg* created = create_arg(weight, DataLayout::HWIO);
+        IAllocator* allocator = AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU);
+        auto packed_tensor = std::make_unique<Tensor>(created->name());
+        auto ret = packed_tensor->init(PrimitiveDataType::FLOAT32, created->shape(), allocator);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+
+        const auto& dims = tensor->shape();
+        kernels::pack_conv_weights_hwio(tensor->data_as<float>(), dims[0], dims[1], dims[2] * dims[3],
+                                        packed_tensor->data_as<float>());
+        m_graph.add_initializer(std::move(packed_tensor));
+
+        m_converted[key] = created;
+        m_modified = true;
+        packed = created;
+        return Status::ok();
+    }
+
+    bool modified() const { return m_modified; }
+
+private:
+    NodeArg* create_arg(const NodeArg* arg, DataLayout layout) {
+        std::string base = arg->name() + "/" + ir::layout_to_string(layout);
+        std::string name = base;
+        for (int i = 1; m_graph.get_nodearg(name); ++i) {
+            name = base + "_" + std::to_string(i);
+        }
+
+        ir::TensorShape shape = arg->shape();
+        shape.set_layout(layout);
+        NodeArg* created = m_graph.get_or_create_nodearg(name, NodeArg(name, arg->data_type(), shape));
+        set_layout(created, layout);
+        return created;
+    }
+
+    void add_reorder(NodeArg* input, NodeArg* output, DataLayout src, DataLayout dst) {
+        std::unordered_map<std::string, std::unique_ptr<NodeAttribute>> attributes;
+        auto src_attr = std::make_unique<NodeAttribute>(ir::kSrcLayoutAttrName, NodeAttributeType::STRING);
+        src_attr->set_string(ir::layout_to_string(src));
+        attributes.emplace(ir::kSrcLayoutAttrName, std::move(src_attr));
+        auto dst_attr = std::make_unique<NodeAttribute>(ir::kDstLayoutAttrName, NodeAttributeType::STRING);
+        dst_attr->set_string(ir::layout_to_string(dst));
+        attributes.emplace(ir::kDstLayoutAttrName, std::move(dst_attr));
+
+        auto node = std::make_unique<Node>(m_next_node_id++, m_graph);
+        node->init(output->name(), ir::kReorderOpType, ir::kSimpleAIDomain, "", {input}, {output},
+                   std::move(attributes));
+        m_graph.add_node(std::move(node));
+
+        m_converted[std::make_pair(static_cast<const NodeArg*>(input), dst)] = output;
+        set_layout(output, dst);
+        m_modified = true;
+    }
+
+private:
+    Graph& m_graph;
+    int m_next_node_id{0};
+    bool m_modified{false};
+
+    // the predicted layouts of the args, the shapes are updated by the shape inference when the topology is rebuilt
+    std::unordered_map<const NodeArg*, DataLayout> m_layouts;
+    // the arg versions in the other layouts. key: (arg, layout)
+    std::map<std::pair<const NodeArg*, DataLayout>, NodeArg*> m_converted;
+};
+
+/**
+ * @brief decide the layout of the node from its kernel and the layouts of its activation inputs
+ */
+DataLayout decide_layout(const LayoutContext& context, const Node* node, const std::vector<size_t>& activations) {
+    kernels::IKernel* kernel = kernels::KernelManager::instance()->get_kernel(node->type());
+    if (!kernel || activations.empty()) {
+        return DataLayout::NCHW;
+    }
+
+    const auto& inputs = node->input_args();
+    DataLayout preferred = kernel->preferred_layout();
+    if (preferred == DataLayout::ANY) {
+        // follow the first activation in a non-default layout, the element-wise kernels need the same dims
+        preferred = DataLayout::NCHW;
+        for (size_t i : activations) {
+            if (context.layout_of(inputs[i]) != DataLayout::NCHW) {
+                preferred = context.layout_of(inputs[i]);
+                break;
+            }
+        }
+
+        const auto& dims = inputs[activations[0]]->shape().dims();
+        bool same_dims = std::all_of(activations.cbegin(), activations.cend(),
+                                     [&inputs, &dims](size_t i) { return inputs[i]->shape().dims() == dims; });
+        bool has_broadcast = std::any_of(inputs.cbegin(), inputs.cend(), [](const NodeArg* arg) {
+            return !arg->name().empty() && !is_activation(arg) && !arg->shape().is_scalar();
+        });
+        if (!same_dims || has_broadcast) {
+            return DataLayout::NCHW;
+        }
+    } else if (preferred == DataLayout::NCHWc && inputs[activations[0]]->shape()[1] % ir::kNCHWcBlockSize != 0) {
+        return DataLayout::NCHW;
+    }
+
+    return kernel->supports_layout(preferred) ? preferred : DataLayout::NCHW;
+}
+
+/**
+ * @brief make the consumers of the second Reorder of an inverse pair read the input of the first one. the
+ * Reorder nodes left without consumers are removed
+ */
+Status cancel_inverse_reorders(Graph& graph, bool& modified) {
+    std::vector<int> erased_nodes;
+    for (Node* node : graph.get_topological_nodes()) {
+        if (node->type() != ir::kReorderOpType) {
+            continue;
+        }
+
+        NodeArg* output = node->output_args()[0];
+        Node* producer = graph.get_producer_node(node->input_args()[0]->name());
+        bool is_inverse = producer && producer->type() == ir::kReorderOpType &&
+                          get_layout_attr(producer, ir::kSrcLayoutAttrName) ==
+                              get_layout_attr(node, ir::kDstLayoutAttrName) &&
+                          get_layout_attr(producer, ir::kDstLayoutAttrName) ==
+                              get_layout_attr(node, ir::kSrcLayoutAttrName);
+        if (!is_inverse || graph.is_graph_output(output)) {
+            continue;
+        }
+
+        NodeArg* source = producer->input_args()[0];
+        for (int consumer_index : graph.get_view().consumers(output->id())) {
+            Node* consumer = graph.get_view().node(consumer_index);
+            const auto& inputs = consumer->input_args();
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                if (inputs[i] == output) {
+                    consumer->replace_input_arg(i, source);
+                }
+            }
+        }
+        erased_nodes.emplace_back(node->id());
+    }
+
+    for (int id : erased_nodes) {
+        auto ret = graph.erase_node(id);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    if (erased_nodes.empty()) {
+        return Status::ok();
+    }
+
+    modified = true;
+    auto ret = graph.construct_topology();
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    // the first Reorder of a pair may have no consumers now
+    erased_nodes.clear();
+    for (Node* node : graph.get_topological_nodes()) {
+        if (node->type() == ir::kReorderOpType && graph.get_view().consumers(node->output_args()[0]->id()).empty() &&
+            !graph.is_graph_output(node->output_args()[0])) {
+            erased_nodes.emplace_back(node->id());
+        }
+    }
+
+    for (int id : erased_nodes) {
+        ret = graph.erase_node(id);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    return erased_nodes.empty() ? Status::ok() : graph.construct_topology();
+}
+
+}    // namespace
+
+std::string LayoutTransformationPass::name() const { return "LayoutTransformation"; }
+
+Status LayoutTransformationPass::apply(Graph& graph, bool& modified) {
+    modified = false;
+
+    LayoutContext context(graph);
+    const std::vector<Node*> nodes = graph.get_topological_nodes();
+    for (Node* node : nodes) {
+        if (node->type() == ir::kReorderOpType) {
+            context.set_layout(node->output_args()[0], get_layout_attr(node, ir::kDstLayoutAttrName));
+            continue;
+        }
+
+        std::vector<size_t> activations = activation_inputs(node);
+        DataLayout layout = decide_layout(context, node, activations);
+
+        // every input which is not an activation of the region must be in NCHW, except the weights of an NHWC
+        // Conv which are packed once here instead of on every run
+        const auto& inputs = node->input_args();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (i == 1 && is_conv(node) && layout == DataLayout::NHWC) {
+                NodeArg* packed = nullptr;
+                auto ret = context.pack_conv_weight(inputs[i], packed);
+                if (!ret.is_ok()) {
+                    return ret;
+                }
+                node->replace_input_arg(i, packed);
+                continue;
+            }
+
+            bool in_region = std::find(activations.cbegin(), activations.cend(), i) != activations.cend();
+            DataLayout required = in_region ? layout : DataLayout::NCHW;
+            if (!inputs[i]->name().empty() && context.layout_of(inputs[i]) != required) {
+                node->replace_input_arg(i, context.convert(inputs[i], required));
+            }
+        }
+
+        const auto& outputs = node->output_args();
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            DataLayout output_layout = outputs[i]->shape().dims_num() == 4 ? layout : DataLayout::NCHW;
+            if (output_layout != DataLayout::NCHW && graph.is_graph_output(outputs[i])) {
+                context.redirect_graph_output(node, i, output_layout);
+            } else {
+                context.set_layout(outputs[i], output_layout);
+            }
+        }
+    }
+
+    if (context.modified()) {
+        modified = true;
+        auto ret = graph.construct_topology();
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    bool cancelled = false;
+    auto ret = cancel_inverse_reorders(graph, cancelled);
+    modified = modified || cancelled;
+    return ret;
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
@@ -0,0 +1,220 @@
+#include "optimizer/pass_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+
+#include "optimizer/common_subexpression_elimination.h"
+#include "optimizer/constant_folding.h"
+#include "optimizer/conv_epilogue_fusion.h"
+#include "optimizer/dead_node_elimination.h"
+#include "optimizer/gemm_epilogue_fusion.h"
+#include "optimizer/layout_transformation.h"
+
+namespace simple_ai {
+namespace optimizer {
+
+using ir::NodeArg;
+using ir::Tensor;
+
+namespace {
+
+size_t arg_bytes(const NodeArg* arg) {
+    const auto& dims = arg->shape().dims();
+    if (std::any_of(dims.cbegin(), dims.cend(), [](int64_t dim) { return dim < 0; })) {
+        return 0;
+    }
+
+    size_t size = 0;
+    return Tensor::calc_storage_size(arg->data_type(), arg->shape(), size).is_ok() ? size : 0;
+}
+
+/**
+ * @brief the bytes of the initializers and the node outputs
+ */
+int64_t graph_bytes(const Graph& graph) {
+    size_t bytes = 0;
+    for (const auto& item : graph.get_initializers()) {
+        size_t size = 0;
+        if (Tensor::calc_storage_size(item.second->data_type(), item.second->shape(), size).is_ok()) {
+            bytes += size;
+        }
+    }
+
+    for (const auto* node : graph.get_topological_nodes()) {
+        for (const auto* arg : node->output_args()) {
+            bytes += arg->name().empty() ? 0 : arg_bytes(arg);
+        }
+    }
+    return static_cast<int64_t>(bytes);
+}
+
+std::unordered_set<int> node_ids(const Graph& graph) {
+    std::unordered_set<int> ids;
+    for (const auto& node : graph.get_nodes()) {
+        ids.insert(node->id());
+    }
+    return ids;
+}
+
+}    // namespace
+
+std::string PassManagerReport::to_string() const {
+    std::ostringstream oss;
+    oss << "pipeline: " << pipeline << ", iterations: " << iterations << (converged ? "" : " (not converged)")
+        << ", time: " << total_time_ms << " ms";
+    for (const auto& stats : passes) {
+        oss << "\n  " << stats.name << ": runs " << stats.runs << ", modified " << stats.modified_runs << ", time "
+            << stats.time_ms << " ms, nodes -" << stats.nodes_removed << " +" << stats.nodes_added << ", bytes saved "
+            << stats.bytes_saved;
+    }
+    return oss.str();
+}
+
+PassManager::PassManager() {
+    register_pass(std::make_unique<ConstantFoldingPass>());
+    register_pass(std::make_unique<CommonSubexpressionEliminationPass>());
+    register_pass(std::make_unique<DeadNodeEliminationPass>());
+    register_pass(std::make_unique<ConvEpilogueFusionPass>());
+    register_pass(std::make_unique<GemmEpilogueFusionPass>());
+    register_pass(std::make_unique<LayoutTransformationPass>());
+
+    std::vector<std::string> basic{"ConstantFolding", "CommonSubexpressionElimination", "DeadNodeElimination"};
+    std::vector<std::string> extended = basic;
+    extended.insert(extended.end(), {"ConvEpilogueFusion", "GemmEpilogueFusion"});
+    std::vector<std::string> all = extended;
+    all.emplace_back("LayoutTransformation");
+
+    m_pipelines[kNonePipeline] = {};
+    m_pipelines[kBasicPipeline] = basic;
+    m_pipelines[kExtendedPipeline] = extended;
+    m_pipelines[kAllPipeline] = all;
+}
+
+Status PassManager::register_pass(std::unique_ptr<IGraphPass>&& pass) {
+    std::string name = pass->name();
+    auto ret = m_passes.emplace(name, nullptr);
+    if (!ret.second) {
+        return Status(StatusCode::INVALID_PARAM, "Pass: [" + name + "] has been registered");
+    }
+
+    ret.first->second = std::move(pass);
+    return Status::ok();
+}
+
+Status PassManager::add_pipeline(const std::string& name, const std::vector<std::string>& pass_names) {
+    for (const auto& pass_name : pass_names) {
+        if (!m_passes.count(pass_name)) {
+            return Status(StatusCode::INVALID_PARAM, "Pass: [" + pass_name + "] is not registered");
+        }
+    }
+
+    m_pipelines[name] = pass_names;
+    return Status::ok();
+}
+
+void PassManager::set_pass_enabled(const std::string& name, bool enabled) {
+    if (name == "*") {
+        m_all_disabled = !enabled;
+        if (enabled) {
+            m_disabled_passes.clear();
+        }
+    } else if (enabled) {
+        m_disabled_passes.erase(name);
+    } else {
+        m_disabled_passes.insert(name);
+    }
+}
+
+void PassManager::disable_passes_from_env() {
+    const char* value = std::getenv(kDisabledPassesEnv);
+    if (!value) {
+        return;
+    }
+
+    std::istringstream iss(value);
+    std::string name;
+    while (std::getline(iss, name, ',')) {
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (!name.empty()) {
+            set_pass_enabled(name, false);
+        }
+    }
+}
+
+bool PassManager::is_pass_enabled(const std::string& name) const {
+    return !m_all_disabled && !m_disabled_passes.count(name);
+}
+
+void PassManager::set_max_iterations(size_t max_iterations) { m_max_iterations = std::max<size_t>(1, max_iterations); }
+
+Status PassManager::run(const std::string& pipeline, Graph& graph) {
+    m_report = PassManagerReport();
+    m_report.pipeline = pipeline;
+
+    auto it = m_pipelines.find(pipeline);
+    if (it == m_pipelines.end()) {
+        return Status(StatusCode::INVALID_PARAM, "Pipeline: [" + pipeline + "] does not exist");
+    }
+
+    std::vector<IGraphPass*> passes;
+    for (const auto& name : it->second) {
+        if (is_pass_enabled(name)) {
+            passes.emplace_back(m_passes[name].get());
+            PassStats stats;
+            stats.name = name;
+            m_report.passes.emplace_back(std::move(stats));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (m_report.iterations < m_max_iterations) {
+        ++m_report.iterations;
+
+        bool any_modified = false;
+        for (size_t i = 0; i < passes.size(); ++i) {
+            auto& stats = m_report.passes[i];
+            std::unordered_set<int> ids_before = node_ids(graph);
+            int64_t bytes_before = graph_bytes(graph);
+
+            bool modified = false;
+            auto pass_start = std::chrono::steady_clock::now();
+            auto ret = passes[i]->apply(graph, modified);
+            auto pass_end = std::chrono::steady_clock::now();
+            if (!ret.is_ok()) {
+                return ret;
+            }
+
+            ++stats.runs;
+            stats.time_ms += std::chrono::duration<double, std::milli>(pass_end - pass_start).count();
+            if (!modified) {
+                continue;
+            }
+
+            any_modified = true;
+            ++stats.modified_runs;
+            std::unordered_set<int> ids_after = node_ids(graph);
+            for (int id : ids_before) {
+                stats.nodes_removed += ids_after.count(id) ? 0 : 1;
+            }
+            for (int id : ids_after) {
+                stats.nodes_added += ids_before.count(id) ? 0 : 1;
+            }
+            stats.bytes_saved += bytes_before - graph_bytes(graph);
+        }
+
+        if (!any_modified) {
+            m_report.converged = true;
+            break;
+        }
+    }
+
+    m_report.total_time_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return Status::ok();
+}
+
+}    // namespace optimizer
+}    // namespace simple_ai
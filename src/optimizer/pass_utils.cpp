@@ -0,0 +1,101 @@
+#include "optimizer/pass_utils.h"
+
+#include <algorithm>
+
+#include "ir/op_defines.h"
+
+namespace simple_ai {
+namespace optimizer {
+namespace utils {
+
+using ir::Node;
+using ir::NodeArg;
+using ir::NodeAttribute;
+using ir::NodeAttributeType;
+
+Node* single_consumer(const ir::GraphTransaction& transaction, const Node* node) {
+    const ir::Graph& graph = transaction.graph();
+    if (node->output_args().size() != 1 || graph.is_graph_output(node->output_args()[0])) {
+        return nullptr;
+    }
+
+    const ir::GraphView& view = graph.get_view();
+    const int index = view.index_of(node->id());
+    if (index < 0 || view.output_edges(index).size() != 1) {
+        return nullptr;
+    }
+
+    int consumer_id = view.node_id(view.output_edges(index)[0].node);
+    if (transaction.is_erased(consumer_id)) {
+        return nullptr;
+    }
+
+    return graph.get_node(consumer_id);
+}
+
+NodeArg* other_input(const Node* node, const NodeArg* input) {
+    const auto& inputs = node->input_args();
+    if (inputs.size() != 2) {
+        return nullptr;
+    }
+
+    return inputs[0] == input ? inputs[1] : inputs[0];
+}
+
+void set_string_attr(ir::GraphTransaction& transaction, Node* node, const std::string& name,
+                     const std::string& value) {
+    auto attr = std::make_unique<NodeAttribute>(name, NodeAttributeType::STRING);
+    attr->set_string(value);
+    transaction.set_attribute(node, std::move(attr));
+}
+
+void set_float_attr(ir::GraphTransaction& transaction, Node* node, const std::string& name, float value) {
+    auto attr = std::make_unique<NodeAttribute>(name, NodeAttributeType::FLOAT);
+    attr->set_float(value);
+    transaction.set_attribute(node, std::move(attr));
+}
+
+int64_t estimate_flops(const Node* node) {
+    if (node->output_args().empty()) {
+        return 0;
+    }
+
+    const auto& output_dims = node->output_args()[0]->shape().dims();
+    if (std::any_of(output_dims.cbegin(), output_dims.cend(), [](int64_t dim) { return dim < 0; })) {
+        return 0;
+    }
+    int64_t output_num = node->output_args()[0]->shape().element_num();
+
+    const auto& type = node->type();
+    const auto& inputs = node->input_args();
+    if ((type == "Conv" || type == ir::kFusedConvOpType) && inputs.size() >= 2) {
+        // weight: [M, C/group, kH, kW], every output element reduces over C/group * kH * kW
+        const auto& weight_dims = inputs[1]->shape().dims();
+        int64_t reduce_num = 1;
+        for (size_t i = 1; i < weight_dims.size(); ++i) {
+            reduce_num *= weight_dims[i];
+        }
+        return reduce_num > 0 ? 2 * output_num * reduce_num : 0;
+    }
+
+    if ((type == "Gemm" || type == ir::kFusedGemmOpType || type == "MatMul") && inputs.size() >= 2) {
+        const auto& a_dims = inputs[0]->shape().dims();
+        if (a_dims.size() < 2) {
+            return 0;
+        }
+
+        bool trans_a = false;
+        auto it = node->attributes().find("transA");
+        if (type != "MatMul" && it != node->attributes().end()) {
+            trans_a = it->second->get_int64() != 0;
+        }
+        int64_t k = trans_a ? a_dims[a_dims.size() - 2] : a_dims.back();
+        return k > 0 ? 2 * output_num * k : 0;
+    }
+
+    return output_num;
+}
+
+}    // namespace utils
+}    // namespace optimizer
+}    // namespace simple_ai
@@ -0,0 +1,476 @@
+#include "runtime/executor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "framework/allocator_manager.h"
+#include "ir/node_shape_manager.h"
+#include "kernels/kernel_manager.h"
+
+namespace simple_ai {
+namespace runtime {
+
+using framework::AllocatorManager;
+using framework::IAllocator;
+
+namespace {
+
+Status copy_tensor(const Tensor* src, const std::string& name, IAllocator* allocator, std::unique_ptr<Tensor>& dst) {
+    dst = std::make_unique<Tensor>(name);
+    auto ret = dst->init(src->data_type(), src->shape(), allocator);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    size_t size = 0;
+    ret = Tensor::calc_storage_size(src->data_type(), src->shape(), size);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+    std::memcpy(dst->data_raw(), src->data_raw(), size);
+    return Status::ok();
+}
+
+}    // namespace
+
+Executor::Executor(const Graph& graph) : Executor(graph, graph.get_topological_nodes()) {}
+
+Executor::Executor(const Graph& graph, const std::vector<Node*>& execution_order, size_t shape_cache_capacity)
+    : m_graph(graph), m_execution_order(execution_order), m_shape_cache_capacity(shape_cache_capacity) {
+    kernels::KernelManager::instance()->register_all_kernels();
+
+    const auto& inputs = m_graph.get_inputs();
+    m_dynamic_shapes = std::any_of(inputs.cbegin(), inputs.cend(),
+                                   [](const NodeArg* input) { return !input->shape().is_static(); });
+}
+
+Status Executor::get_execution_nodes(const std::vector<std::string>& output_names, const std::vector<Node*>*& nodes) {
+    const ExecutionPlan* plan = nullptr;
+    auto ret = get_execution_plan(output_names, plan);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    nodes = &plan->nodes;
+    return Status::ok();
+}
+
+Status Executor::get_execution_plan(const std::vector<std::string>& output_names, const ExecutionPlan*& plan) {
+    std::vector<std::string> key = output_names;
+    if (key.empty()) {
+        for (const auto* output : m_graph.get_outputs()) {
+            key.emplace_back(output->name());
+        }
+    }
+    std::sort(key.begin(), key.end());
+    key.erase(std::unique(key.begin(), key.end()), key.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_execution_plan_cache.find(key);
+    if (it == m_execution_plan_cache.end()) {
+        ExecutionPlan execution_plan;
+        auto ret = create_execution_plan(key, execution_plan);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+        it = m_execution_plan_cache.emplace(std::move(key), std::move(execution_plan)).first;
+    }
+
+    plan = &it->second;
+    return Status::ok();
+}
+
+Status Executor::create_execution_plan(const std::vector<std::string>& output_names, ExecutionPlan& plan) const {
+    const ir::GraphView& view = m_graph.get_view();
+    std::vector<bool> needed_nodes(view.node_num(), false);
+    std::vector<int> nodes_stack;
+    for (const auto& name : output_names) {
+        const auto& outputs = m_graph.get_outputs();
+        auto it_output = std::find_if(outputs.cbegin(), outputs.cend(),
+                                      [&name](const NodeArg* output) { return output->name() == name; });
+        if (it_output == outputs.cend()) {
+            std::ostringstream oss;
+            oss << "Output: [" << name << "] is not a graph output";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        const int producer = view.producer((*it_output)->id());
+        if (producer >= 0 && !needed_nodes[producer]) {
+            needed_nodes[producer] = true;
+            nodes_stack.emplace_back(producer);
+        }
+    }
+
+    while (!nodes_stack.empty()) {
+        const int node = nodes_stack.back();
+        nodes_stack.pop_back();
+
+        for (const auto& edge : view.input_edges(node)) {
+            if (!needed_nodes[edge.node]) {
+                needed_nodes[edge.node] = true;
+                nodes_stack.emplace_back(edge.node);
+            }
+        }
+    }
+
+    plan.nodes.clear();
+    for (Node* node : m_execution_order) {
+        if (needed_nodes[view.index_of(node->id())]) {
+            plan.nodes.emplace_back(node);
+        }
+    }
+
+    plan.kernels.clear();
+    for (const Node* node : plan.nodes) {
+        kernels::IKernel* kernel = kernels::KernelManager::instance()->get_kernel(node->type());
+        if (!kernel) {
+            std::ostringstream oss;
+            oss << "Node: " << node->type() << "[" << node->name() << "], no kernel for the node type";
+            return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+        }
+        plan.kernels.emplace_back(kernel);
+    }
+
+    // free every node output after its last consumer in the plan, except the fetched outputs. the steps are indexed
+    // by the node arg id, -1 for the args not produced in the plan
+    std::vector<int> last_use(m_graph.get_nodearg_id_bound(), -1);
+    for (size_t i = 0; i < plan.nodes.size(); ++i) {
+        for (const auto* arg : plan.nodes[i]->output_args()) {
+            last_use[arg->id()] = static_cast<int>(i);
+        }
+        for (const auto* arg : plan.nodes[i]->input_args()) {
+            if (last_use[arg->id()] >= 0) {
+                last_use[arg->id()] = static_cast<int>(i);
+            }
+        }
+    }
+
+    plan.release_names.assign(plan.nodes.size(), {});
+    for (size_t id = 0; id < last_use.size(); ++id) {
+        const NodeArg* arg = m_graph.get_nodearg(static_cast<int>(id));
+        if (last_use[id] >= 0 && !arg->name().empty() &&
+            !std::binary_search(output_names.cbegin(), output_names.cend(), arg->name())) {
+            plan.release_names[last_use[id]].emplace_back(arg->name());
+        }
+    }
+
+    return Status::ok();
+}
+
+Status Executor::prepare_shapes(const InputShapes& input_shapes) {
+    if (!m_dynamic_shapes) {
+        return Status::ok();
+    }
+
+    std::vector<ir::TensorShape> shapes;
+    std::vector<const ir::TensorShape*> shape_ptrs;
+    const auto& inputs = m_graph.get_inputs();
+    shapes.reserve(inputs.size());
+    for (const auto* input : inputs) {
+        auto it = input_shapes.find(input->name());
+        shapes.emplace_back(input->shape());
+        if (it != input_shapes.end()) {
+            shapes.back().set_dims(it->second);
+        }
+        shape_ptrs.emplace_back(&shapes.back());
+    }
+
+    std::shared_ptr<const ShapeBinding> binding;
+    return bind_shapes(shape_ptrs, binding);
+}
+
+ShapeCacheStats Executor::shape_cache_stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_shape_cache_stats;
+}
+
+std::shared_ptr<const Executor::ShapeBinding> Executor::find_shape_binding(
+    const std::vector<const ir::TensorShape*>& input_shapes) {
+    // the cache is small, the bindings are compared one by one
+    for (auto it = m_shape_bindings.begin(); it != m_shape_bindings.end(); ++it) {
+        const auto& cached_shapes = (*it)->input_shapes;
+        bool same_shapes = true;
+        for (size_t i = 0; same_shapes && i < cached_shapes.size(); ++i) {
+            same_shapes = cached_shapes[i].dims() == input_shapes[i]->dims();
+        }
+
+        if (same_shapes) {
+            m_shape_bindings.splice(m_shape_bindings.begin(), m_shape_bindings, it);
+            return m_shape_bindings.front();
+        }
+    }
+
+    return nullptr;
+}
+
+Status Executor::bind_shapes(const std::vector<const ir::TensorShape*>& input_shapes,
+                             std::shared_ptr<const ShapeBinding>& binding) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        binding = find_shape_binding(input_shapes);
+        if (binding) {
+            ++m_shape_cache_stats.hits;
+            return Status::ok();
+        }
+    }
+
+    // infer the shapes out of the lock, the concurrent runs of the cached shapes are not blocked
+    std::vector<ir::TensorShape> shapes;
+    shapes.reserve(input_shapes.size());
+    for (const auto* shape : input_shapes) {
+        shapes.emplace_back(*shape);
+    }
+    auto new_binding = std::make_shared<ShapeBinding>();
+    auto ret = create_shape_binding(shapes, *new_binding);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_shape_cache_stats.misses;
+    // another run may have bound the same shapes in the meantime
+    binding = find_shape_binding(input_shapes);
+    if (binding) {
+        return Status::ok();
+    }
+
+    binding = new_binding;
+    if (m_shape_cache_capacity == 0) {
+        return Status::ok();
+    }
+
+    m_shape_bindings.emplace_front(std::move(new_binding));
+    if (m_shape_bindings.size() > m_shape_cache_capacity) {
+        m_shape_bindings.pop_back();
+        ++m_shape_cache_stats.evictions;
+    }
+    return Status::ok();
+}
+
+Status Executor::create_shape_binding(const std::vector<ir::TensorShape>& input_shapes, ShapeBinding& binding) const {
+    binding.args.reserve(m_graph.get_nodearg_id_bound());
+    for (size_t id = 0; id < m_graph.get_nodearg_id_bound(); ++id) {
+        const NodeArg* arg = m_graph.get_nodearg(static_cast<int>(id));
+        binding.args.emplace_back(arg ? *arg : NodeArg(""));
+    }
+
+    // bind the input shapes, the static dims must match and a symbol has the same value in all the inputs
+    std::unordered_map<std::string, int64_t> symbols;
+    const auto& inputs = m_graph.get_inputs();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const ir::TensorShape& declared = inputs[i]->shape();
+        ir::TensorShape shape = input_shapes[i];
+        shape.set_layout(declared.layout());
+
+        bool matched = shape.dims_num() == declared.dims_num();
+        for (size_t j = 0; matched && j < declared.dims_num(); ++j) {
+            if (!declared.is_dynamic(j)) {
+                matched = shape[j] == declared[j];
+            } else if (!declared.symbol(j).empty() && !shape.is_dynamic(j)) {
+                matched = symbols.emplace(declared.symbol(j), shape[j]).first->second == shape[j];
+            }
+        }
+        if (!matched) {
+            std::ostringstream oss;
+            oss << "Input: [" << inputs[i]->name() << "], shape: " << shape.to_string()
+                << " mismatch the declared shape: " << declared.to_string();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        binding.args[inputs[i]->id()].set_shape(shape);
+    }
+    binding.input_shapes = input_shapes;
+
+    // re-derive the node output shapes in one pass over the topological order
+    std::vector<NodeArg*> node_inputs;
+    std::vector<NodeArg*> node_outputs;
+    for (const Node* node : m_execution_order) {
+        ir::IShapeInfer* infer = ir::NodeShapeManager::instance()->get_shape_infer(node->type());
+        if (!infer) {
+            std::ostringstream oss;
+            oss << "Infer object for node: " << node->type() << "[" << node->name() << "] not found";
+            return Status(StatusCode::FAIL, oss.str());
+        }
+
+        node_inputs.clear();
+        for (const auto* arg : node->input_args()) {
+            node_inputs.emplace_back(&binding.args[arg->id()]);
+        }
+        node_outputs.clear();
+        for (const auto* arg : node->output_args()) {
+            node_outputs.emplace_back(&binding.args[arg->id()]);
+        }
+
+        auto ret = infer->infer(node->name(), node_inputs, node->params(), node_outputs);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    return Status::ok();
+}
+
+Status Executor::check_feeds(const TensorFeeds& feeds) const {
+    for (const auto& item : feeds) {
+        const NodeArg* arg = m_graph.get_nodearg(item.first);
+        const Tensor* initializer = m_graph.get_initializer(item.first);
+        // the other names are never read by the kernels
+        if (!initializer && (!arg || !m_graph.is_graph_input(arg))) {
+            continue;
+        }
+
+        const Tensor* tensor = item.second;
+        if (!tensor || !tensor->shape().is_static()) {
+            std::ostringstream oss;
+            oss << "Input: [" << item.first << "] is null or has dynamic dims";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        PrimitiveDataType data_type = initializer ? initializer->data_type() : arg->data_type();
+        if (data_type != PrimitiveDataType::UNKNOWN && tensor->data_type() != data_type) {
+            std::ostringstream oss;
+            oss << "Input: [" << item.first << "], data type: " << static_cast<int>(tensor->data_type())
+                << " mismatch the declared data type: " << static_cast<int>(data_type);
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        const ir::TensorShape& declared = initializer ? initializer->shape() : arg->shape();
+        if (!initializer && !declared.is_static()) {
+            continue;
+        }
+        const ir::TensorShape& shape = tensor->shape();
+        bool matched = shape.dims_num() == declared.dims_num();
+        for (size_t i = 0; matched && i < declared.dims_num(); ++i) {
+            matched = shape[i] == declared[i];
+        }
+        if (!matched) {
+            std::ostringstream oss;
+            oss << "Input: [" << item.first << "], shape: " << shape.to_string()
+                << " mismatch the declared shape: " << declared.to_string();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+    }
+
+    return Status::ok();
+}
+
+Status Executor::run(const RunOptions& run_options, const TensorFeeds& feeds, TensorFetches& fetches) {
+    const ExecutionPlan* plan = nullptr;
+    auto ret = get_execution_plan(run_options.output_names, plan);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    ret = check_feeds(feeds);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    std::shared_ptr<const ShapeBinding> binding;
+    if (m_dynamic_shapes) {
+        // the graph inputs which are not fed keep their declared shapes
+        const auto& inputs = m_graph.get_inputs();
+        std::vector<const ir::TensorShape*> input_shapes;
+        input_shapes.reserve(inputs.size());
+        for (const auto* input : inputs) {
+            auto it = feeds.find(input->name());
+            input_shapes.emplace_back(it != feeds.end() ? &it->second->shape() : &input->shape());
+        }
+
+        ret = bind_shapes(input_shapes, binding);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    IAllocator* allocator = AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU);
+    auto find_tensor = [this, &feeds](const std::string& name) -> const Tensor* {
+        auto it = feeds.find(name);
+        if (it != feeds.end()) {
+            return it->second;
+        }
+        return m_graph.get_initializer(name);
+    };
+
+    // the node outputs computed in this run
+    TensorFetches values;
+    for (size_t step = 0; step < plan->nodes.size(); ++step) {
+        Node* node = plan->nodes[step];
+        std::vector<const Tensor*> inputs;
+        for (auto* arg : node->input_args()) {
+            if (arg->name().empty()) {
+                inputs.emplace_back(nullptr);
+                continue;
+            }
+
+            auto it = values.find(arg->name());
+            const Tensor* tensor = it != values.end() ? it->second.get() : find_tensor(arg->name());
+            if (!tensor) {
+                std::ostringstream oss;
+                oss << "Node: " << node->type() << "[" << node->name() << "], input: [" << arg->name()
+                    << "] is not fed";
+                return Status(StatusCode::INVALID_PARAM, oss.str());
+            }
+            inputs.emplace_back(tensor);
+        }
+
+        std::vector<Tensor*> outputs;
+        for (auto* arg : node->output_args()) {
+            auto tensor = std::make_unique<Tensor>(arg->name());
+            auto data_type = arg->data_type() != PrimitiveDataType::UNKNOWN ? arg->data_type()
+                                                                             : PrimitiveDataType::FLOAT32;
+            const ir::TensorShape& shape = binding ? binding->args[arg->id()].shape() : arg->shape();
+            ret = tensor->init(data_type, shape, allocator);
+            if (!ret.is_ok()) {
+                return ret;
+            }
+            outputs.emplace_back(tensor.get());
+            values[arg->name()] = std::move(tensor);
+        }
+
+        ret = plan->kernels[step]->compute(node->name(), node->params(), inputs, outputs);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+
+        for (const auto& name : plan->release_names[step]) {
+            values.erase(name);
+        }
+    }
+
+    std::vector<std::string> output_names = run_options.output_names;
+    if (output_names.empty()) {
+        for (const auto* output : m_graph.get_outputs()) {
+            output_names.emplace_back(output->name());
+        }
+    }
+    // a repeated name is fetched once, its value is moved out of the run
+    std::sort(output_names.begin(), output_names.end());
+    output_names.erase(std::unique(output_names.begin(), output_names.end()), output_names.end());
+
+    for (const auto& name : output_names) {
+        auto it = values.find(name);
+        if (it != values.end()) {
+            fetches[name] = std::move(it->second);
+            continue;
+        }
+
+        // the output is a graph input or an initializer
+        const Tensor* tensor = find_tensor(name);
+        if (!tensor) {
+            std::ostringstream oss;
+            oss << "Output: [" << name << "] is not fed";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+        ret = copy_tensor(tensor, name, allocator, fetches[name]);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace runtime
+}    // namespace simple_ai
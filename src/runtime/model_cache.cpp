@@ -0,0 +1,203 @@
+#include "runtime/model_cache.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "io/native_serializer.h"
+
+namespace simple_ai {
+namespace runtime {
+
+namespace {
+
+constexpr uint64_t kHashPrime = 0x100000001b3ULL;
+constexpr uint64_t kHashOffset = 0xcbf29ce484222325ULL;
+// the file is hashed in 4 independent lanes of 8-byte words, so the multiplications do not wait for each other
+constexpr size_t kHashLanes = 4;
+constexpr size_t kHashBlockSize = kHashLanes * sizeof(uint64_t);
+// the chunk read at a time, a multiple of the block size
+constexpr size_t kHashChunkSize = 1 << 20;
+
+uint64_t mix_word(uint64_t hash, uint64_t word) {
+    hash = (hash ^ word) * kHashPrime;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief FNV-1a over 8-byte words, with a shift to fold the high bits back. it is only a cache key, not a checksum
+ * against tampering
+ */
+uint64_t hash_bytes(const char* data, size_t size, uint64_t seed) {
+    uint64_t hash = seed ^ (kHashOffset + size);
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + pos, sizeof(uint64_t));
+        hash = mix_word(hash, word);
+    }
+    for (; pos < size; ++pos) {
+        hash = (hash ^ static_cast<unsigned char>(data[pos])) * kHashPrime;
+    }
+    return hash;
+}
+
+}    // namespace
+
+Status ModelCache::get_entry_path(const std::string& model_path, const SessionOptions& options,
+                                  std::string& entry_path) const {
+    uint64_t model_hash = 0;
+    auto ret = get_model_hash(model_path, model_hash);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    // everything which changes the compiled graph. the shape cache options only change the executor
+    std::vector<std::string> disabled_passes = options.disabled_passes;
+    std::sort(disabled_passes.begin(), disabled_passes.end());
+    const char* env_disabled_passes = std::getenv(optimizer::kDisabledPassesEnv);
+    std::ostringstream key;
+    key << "version=" << io::kNativeModelVersion << ";isa=" << cpu_isa()
+        << ";pipeline=" << options.optimization_pipeline << ";order=" << static_cast<int>(options.execution_order)
+        << ";disabled=";
+    for (auto& name : disabled_passes) {
+        key << name << ",";
+    }
+    key << ";env_disabled=" << (env_disabled_passes ? env_disabled_passes : "");
+    const std::string key_str = key.str();
+
+    std::ostringstream file_name;
+    file_name << std::filesystem::path(model_path).stem().string() << "." << std::hex << std::setw(16)
+              << std::setfill('0') << hash_bytes(key_str.data(), key_str.size(), model_hash) << ".saim";
+    entry_path = (std::filesystem::path(m_cache_dir) / file_name.str()).string();
+    return Status::ok();
+}
+
+Status ModelCache::get_model_hash(const std::string& model_path, uint64_t& hash) const {
+    std::error_code error;
+    const std::filesystem::path path = std::filesystem::absolute(model_path, error);
+    const uintmax_t size = std::filesystem::file_size(path, error);
+    if (error) {
+        return Status(StatusCode::FILE_NOT_FOUND, "file not found: " + model_path);
+    }
+    const int64_t mtime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+    // the stamp of the model file: its size, its modification time and its content hash
+    const std::string path_str = path.string();
+    std::ostringstream stamp_name;
+    stamp_name << path.stem().string() << "." << std::hex << std::setw(16) << std::setfill('0')
+               << hash_bytes(path_str.data(), path_str.size(), 0) << ".stamp";
+    const std::filesystem::path stamp_path = std::filesystem::path(m_cache_dir) / stamp_name.str();
+    {
+        std::ifstream ifs(stamp_path);
+        uintmax_t stamp_size = 0;
+        int64_t stamp_mtime = 0;
+        if (ifs >> stamp_size >> stamp_mtime >> hash && stamp_size == size && stamp_mtime == mtime) {
+            return Status::ok();
+        }
+    }
+
+    auto ret = hash_file(path_str, hash);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    // the stamp only saves the hashing, the entry is found without it
+    std::filesystem::create_directories(m_cache_dir, error);
+    std::ofstream ofs(stamp_path, std::ios::out | std::ios::trunc);
+    ofs << size << " " << mtime << " " << hash;
+    return Status::ok();
+}
+
+Status ModelCache::save(const std::string& entry_path, const ir::Model& model,
+                        const std::vector<ir::Node*>& execution_order) const {
+    std::error_code error;
+    std::filesystem::create_directories(m_cache_dir, error);
+    if (error) {
+        return Status(StatusCode::FAIL, "Create the model cache directory failed: " + m_cache_dir);
+    }
+
+    const std::string temp_path = entry_path + ".tmp" + std::to_string(getpid());
+    auto ret = io::NativeSerializer::save_to_file(model, execution_order, temp_path);
+    if (ret.is_ok()) {
+        std::filesystem::rename(temp_path, entry_path, error);
+        if (error) {
+            ret = Status(StatusCode::FAIL, "Rename the model cache entry failed: " + entry_path);
+        }
+    }
+    if (!ret.is_ok()) {
+        std::filesystem::remove(temp_path, error);
+    }
+
+    return ret;
+}
+
+std::string ModelCache::cpu_isa() {
+    std::string isa;
+#if defined(__x86_64__) || defined(__i386__)
+    isa = "x86";
+    __builtin_cpu_init();
+    // __builtin_cpu_supports only takes the literals
+    isa += __builtin_cpu_supports("sse4.2") ? "+sse4.2" : "";
+    isa += __builtin_cpu_supports("avx") ? "+avx" : "";
+    isa += __builtin_cpu_supports("avx2") ? "+avx2" : "";
+    isa += __builtin_cpu_supports("fma") ? "+fma" : "";
+    isa += __builtin_cpu_supports("avx512f") ? "+avx512f" : "";
+#elif defined(__aarch64__)
+    isa = "aarch64";
+#else
+    isa = "generic";
+#endif
+    return isa;
+}
+
+Status ModelCache::hash_file(const std::string& file_path, uint64_t& hash) {
+    std::ifstream ifs(file_path, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        return Status(StatusCode::FILE_NOT_FOUND, "Open file failed: " + file_path);
+    }
+
+    uint64_t lanes[kHashLanes];
+    for (size_t i = 0; i < kHashLanes; ++i) {
+        lanes[i] = kHashOffset + i;
+    }
+    std::vector<char> chunk(kHashChunkSize);
+    size_t total_size = 0;
+    size_t tail_size = 0;
+    while (ifs) {
+        ifs.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        size_t size = static_cast<size_t>(ifs.gcount());
+        total_size += size;
+        size_t pos = 0;
+        for (; pos + kHashBlockSize <= size; pos += kHashBlockSize) {
+            uint64_t words[kHashLanes];
+            std::memcpy(words, chunk.data() + pos, kHashBlockSize);
+            for (size_t i = 0; i < kHashLanes; ++i) {
+                lanes[i] = mix_word(lanes[i], words[i]);
+            }
+        }
+        // only the last chunk has a partial block
+        tail_size = size - pos;
+        if (tail_size > 0) {
+            std::memmove(chunk.data(), chunk.data() + pos, tail_size);
+        }
+    }
+    if (ifs.bad()) {
+        return Status(StatusCode::FAIL, "Read file failed: " + file_path);
+    }
+
+    hash = hash_bytes(chunk.data(), tail_size, total_size);
+    for (size_t i = 0; i < kHashLanes; ++i) {
+        hash = mix_word(hash, lanes[i]);
+    }
+    return Status::ok();
+}
+
+}    // namespace runtime
+}    // namespace simple_ai
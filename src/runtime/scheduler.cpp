@@ -0,0 +1,332 @@
+#include "runtime/scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+
+namespace simple_ai {
+namespace runtime {
+
+using ir::Graph;
+using ir::Node;
+using ir::NodeArg;
+using ir::Tensor;
+
+namespace {
+
+// the graphs with at most this number of nodes are scheduled by an exact search over the subsets of nodes
+constexpr size_t kExactScheduleMaxNodes = 16;
+
+/**
+ * @brief the node outputs and their consumers, the nodes are indexed by their position in the default order
+ */
+struct LivenessInfo {
+    struct ArgInfo {
+        size_t bytes{0};
+        bool is_graph_output{false};
+        std::vector<size_t> consumers;
+    };
+
+    std::vector<ArgInfo> args;
+    // the indices of the args produced and consumed by the nodes
+    std::vector<std::vector<size_t>> node_outputs;
+    std::vector<std::vector<size_t>> node_inputs;
+    // the indices of the producer nodes
+    std::vector<std::vector<size_t>> node_producers;
+};
+
+size_t arg_bytes(const NodeArg* arg) {
+    const auto& dims = arg->shape().dims();
+    if (std::any_of(dims.cbegin(), dims.cend(), [](int64_t dim) { return dim < 0; })) {
+        return 0;
+    }
+
+    size_t size = 0;
+    return Tensor::calc_storage_size(arg->data_type(), arg->shape(), size).is_ok() ? size : 0;
+}
+
+LivenessInfo build_liveness(const Graph& graph) {
+    const ir::GraphView& view = graph.get_view();
+    const size_t node_num = view.node_num();
+
+    LivenessInfo info;
+    info.node_outputs.resize(node_num);
+    info.node_inputs.resize(node_num);
+    info.node_producers.resize(node_num);
+
+    // the arg index, indexed by the node arg id
+    std::vector<int> arg_indices(graph.get_nodearg_id_bound(), -1);
+    for (size_t i = 0; i < node_num; ++i) {
+        for (const auto* arg : view.node(static_cast<int>(i))->output_args()) {
+            if (arg->name().empty()) {
+                continue;
+            }
+
+            LivenessInfo::ArgInfo arg_info;
+            arg_info.bytes = arg_bytes(arg);
+            arg_info.is_graph_output = graph.is_graph_output(arg);
+            const auto consumers = view.consumers(arg->id());
+            arg_info.consumers.assign(consumers.begin(), consumers.end());
+            arg_indices[arg->id()] = static_cast<int>(info.args.size());
+            info.node_outputs[i].emplace_back(info.args.size());
+            info.args.emplace_back(std::move(arg_info));
+        }
+    }
+
+    for (size_t i = 0; i < node_num; ++i) {
+        auto& inputs = info.node_inputs[i];
+        auto& node_producers = info.node_producers[i];
+        for (const auto& edge : view.input_edges(static_cast<int>(i))) {
+            const NodeArg* arg = view.node(static_cast<int>(i))->input_args()[edge.dst_arg_index];
+            const size_t arg_index = static_cast<size_t>(arg_indices[arg->id()]);
+            if (std::find(inputs.cbegin(), inputs.cend(), arg_index) == inputs.cend()) {
+                inputs.emplace_back(arg_index);
+            }
+
+            const size_t producer = static_cast<size_t>(edge.node);
+            if (std::find(node_producers.cbegin(), node_producers.cend(), producer) == node_producers.cend()) {
+                node_producers.emplace_back(producer);
+            }
+        }
+    }
+
+    return info;
+}
+
+/**
+ * @brief simulate the order, which is given as node indices
+ */
+size_t simulate_peak(const LivenessInfo& info, const std::vector<size_t>& order) {
+    std::vector<size_t> remaining(info.args.size());
+    for (size_t i = 0; i < info.args.size(); ++i) {
+        remaining[i] = info.args[i].consumers.size();
+    }
+
+    size_t live = 0;
+    size_t peak = 0;
+    for (size_t node : order) {
+        for (size_t arg : info.node_outputs[node]) {
+            live += info.args[arg].bytes;
+        }
+        peak = std::max(peak, live);
+
+        for (size_t arg : info.node_inputs[node]) {
+            if (--remaining[arg] == 0 && !info.args[arg].is_graph_output) {
+                live -= info.args[arg].bytes;
+            }
+        }
+
+        for (size_t arg : info.node_outputs[node]) {
+            if (info.args[arg].consumers.empty() && !info.args[arg].is_graph_output) {
+                live -= info.args[arg].bytes;
+            }
+        }
+    }
+
+    return peak;
+}
+
+/**
+ * @brief greedy: among the ready nodes, run the one which frees the most bytes net of what it allocates. the ties
+ * are broken by the default order
+ */
+std::vector<size_t> greedy_order(const LivenessInfo& info) {
+    const size_t node_num = info.node_outputs.size();
+    std::vector<size_t> pending_producers(node_num);
+    std::vector<std::vector<size_t>> successors(node_num);
+    for (size_t i = 0; i < node_num; ++i) {
+        pending_producers[i] = info.node_producers[i].size();
+        for (size_t producer : info.node_producers[i]) {
+            successors[producer].emplace_back(i);
+        }
+    }
+
+    std::vector<size_t> remaining(info.args.size());
+    for (size_t i = 0; i < info.args.size(); ++i) {
+        remaining[i] = info.args[i].consumers.size();
+    }
+
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < node_num; ++i) {
+        if (pending_producers[i] == 0) {
+            ready.emplace_back(i);
+        }
+    }
+
+    std::vector<size_t> order;
+    order.reserve(node_num);
+    while (!ready.empty()) {
+        size_t best = 0;
+        int64_t best_delta = std::numeric_limits<int64_t>::max();
+        for (size_t r = 0; r < ready.size(); ++r) {
+            size_t node = ready[r];
+            int64_t delta = 0;
+            for (size_t arg : info.node_outputs[node]) {
+                if (info.args[arg].consumers.size() > 0 || info.args[arg].is_graph_output) {
+                    delta += static_cast<int64_t>(info.args[arg].bytes);
+                }
+            }
+            for (size_t arg : info.node_inputs[node]) {
+                if (remaining[arg] == 1 && !info.args[arg].is_graph_output) {
+                    delta -= static_cast<int64_t>(info.args[arg].bytes);
+                }
+            }
+
+            if (delta < best_delta || (delta == best_delta && node < ready[best])) {
+                best = r;
+                best_delta = delta;
+            }
+        }
+
+        size_t node = ready[best];
+        ready.erase(ready.begin() + best);
+        order.emplace_back(node);
+
+        for (size_t arg : info.node_inputs[node]) {
+            --remaining[arg];
+        }
+        for (size_t successor : successors[node]) {
+            if (--pending_producers[successor] == 0) {
+                ready.emplace_back(successor);
+            }
+        }
+    }
+
+    return order;
+}
+
+/**
+ * @brief exact: the minimal peak to run each subset of nodes first, computed by dynamic programming over subsets
+ */
+std::vector<size_t> exact_order(const LivenessInfo& info) {
+    const size_t node_num = info.node_outputs.size();
+    const size_t state_num = size_t(1) << node_num;
+
+    std::vector<uint32_t> producer_masks(node_num, 0);
+    for (size_t i = 0; i < node_num; ++i) {
+        for (size_t producer : info.node_producers[i]) {
+            producer_masks[i] |= uint32_t(1) << producer;
+        }
+    }
+
+    std::vector<size_t> output_bytes(node_num, 0);
+    for (size_t i = 0; i < node_num; ++i) {
+        for (size_t arg : info.node_outputs[i]) {
+            output_bytes[i] += info.args[arg].bytes;
+        }
+    }
+
+    // the bytes still live after the nodes in the state have run
+    auto live_bytes = [&info](uint32_t state) {
+        size_t live = 0;
+        for (size_t node = 0; node < info.node_outputs.size(); ++node) {
+            if (!(state & (uint32_t(1) << node))) {
+                continue;
+            }
+
+            for (size_t arg : info.node_outputs[node]) {
+                const auto& consumers = info.args[arg].consumers;
+                bool used_later = std::any_of(consumers.cbegin(), consumers.cend(),
+                                              [state](size_t c) { return !(state & (uint32_t(1) << c)); });
+                if (used_later || info.args[arg].is_graph_output) {
+                    live += info.args[arg].bytes;
+                }
+            }
+        }
+        return live;
+    };
+
+    const size_t unreachable = std::numeric_limits<size_t>::max();
+    std::vector<size_t> best_peak(state_num, unreachable);
+    std::vector<uint8_t> last_node(state_num, 0);
+    best_peak[0] = 0;
+
+    // a subset is always visited after all of its subsets, since they are numerically smaller
+    for (uint32_t state = 0; state < state_num; ++state) {
+        if (best_peak[state] == unreachable) {
+            continue;
+        }
+
+        size_t live = live_bytes(state);
+        for (size_t node = 0; node < node_num; ++node) {
+            uint32_t bit = uint32_t(1) << node;
+            if ((state & bit) || (producer_masks[node] & ~state)) {
+                continue;
+            }
+
+            size_t peak = std::max(best_peak[state], live + output_bytes[node]);
+            if (peak < best_peak[state | bit]) {
+                best_peak[state | bit] = peak;
+                last_node[state | bit] = static_cast<uint8_t>(node);
+            }
+        }
+    }
+
+    std::vector<size_t> order(node_num);
+    uint32_t state = static_cast<uint32_t>(state_num - 1);
+    for (size_t i = node_num; i-- > 0;) {
+        order[i] = last_node[state];
+        state &= ~(uint32_t(1) << order[i]);
+    }
+    return order;
+}
+
+}    // namespace
+
+Status get_execution_order(const Graph& graph, ExecutionOrder order, std::vector<Node*>& nodes) {
+    const auto& topological_nodes = graph.get_topological_nodes();
+    if (order == ExecutionOrder::DEFAULT) {
+        nodes = topological_nodes;
+        return Status::ok();
+    }
+
+    LivenessInfo info = build_liveness(graph);
+    std::vector<size_t> best = greedy_order(info);
+    if (best.size() != topological_nodes.size()) {
+        return Status(StatusCode::INVALID_PARAM, "The graph is not a DAG");
+    }
+
+    if (topological_nodes.size() <= kExactScheduleMaxNodes) {
+        std::vector<size_t> exact = exact_order(info);
+        if (simulate_peak(info, exact) < simulate_peak(info, best)) {
+            best = std::move(exact);
+        }
+    }
+
+    // keep the default order if it is already as good
+    std::vector<size_t> default_order(topological_nodes.size());
+    for (size_t i = 0; i < default_order.size(); ++i) {
+        default_order[i] = i;
+    }
+    if (simulate_peak(info, default_order) <= simulate_peak(info, best)) {
+        best = std::move(default_order);
+    }
+
+    nodes.clear();
+    for (size_t i : best) {
+        nodes.emplace_back(topological_nodes[i]);
+    }
+    return Status::ok();
+}
+
+Status calc_peak_memory(const Graph& graph, const std::vector<Node*>& nodes, size_t& peak_bytes) {
+    const ir::GraphView& view = graph.get_view();
+    std::vector<size_t> order;
+    order.reserve(nodes.size());
+    for (const Node* node : nodes) {
+        const int index = view.index_of(node->id());
+        if (index < 0 || view.node(index) != node) {
+            std::ostringstream oss;
+            oss << "Node: " << node->type() << "[" << node->name() << "] is not in the graph";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+        order.emplace_back(static_cast<size_t>(index));
+    }
+
+    peak_bytes = simulate_peak(build_liveness(graph), order);
+    return Status::ok();
+}
+
+}    // namespace runtime
+}    // namespace simple_ai
@@ -0,0 +1,231 @@
+#include "runtime/session.h"
+
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "io/native_serializer.h"
+#include "io/onnx_serializer.h"
+#include "ir/node_shape_manager.h"
+#include "kernels/kernel_manager.h"
+#include "runtime/model_cache.h"
+#include "utils/logger.h"
+#include "utils/thread_pool/simple_thread_pool.h"
+
+using namespace simple_ai::utils;
+
+namespace simple_ai {
+namespace runtime {
+
+namespace {
+
+/**
+ * @brief check that the loaded order runs every node of the graph once, after the producers of its inputs
+ */
+Status check_execution_order(const Graph& graph, const std::vector<Node*>& execution_order) {
+    const auto& nodes = graph.get_topological_nodes();
+    std::unordered_map<const Node*, size_t> positions;
+    for (auto* node : nodes) {
+        positions.emplace(node, nodes.size());
+    }
+
+    if (execution_order.size() != nodes.size()) {
+        std::ostringstream oss;
+        oss << "The execution order has " << execution_order.size() << " nodes, the graph has " << nodes.size();
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    for (size_t i = 0; i < execution_order.size(); ++i) {
+        auto it = positions.find(execution_order[i]);
+        if (it == positions.end() || it->second != nodes.size()) {
+            return Status(StatusCode::INVALID_MODEL, "The execution order is not a permutation of the graph nodes");
+        }
+        it->second = i;
+    }
+
+    for (size_t i = 0; i < execution_order.size(); ++i) {
+        for (auto* arg : execution_order[i]->input_args()) {
+            Node* producer = arg->name().empty() ? nullptr : graph.get_producer_node(arg);
+            if (producer && positions.at(producer) > i) {
+                std::ostringstream oss;
+                oss << "The execution order runs the node: " << execution_order[i]->name()
+                    << " before the producer of its input: " << arg->name();
+                return Status(StatusCode::INVALID_MODEL, oss.str());
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace
+
+InferenceSession::InferenceSession(const SessionOptions& options) : m_options(options) {}
+
+Status InferenceSession::load(const std::shared_ptr<Model>& model) {
+    if (!model || !model->get_graph()) {
+        return Status(StatusCode::INVALID_PARAM, "The model has no graph");
+    }
+
+    ir::NodeShapeManager::instance()->register_all_infer();
+    kernels::KernelManager::instance()->register_all_kernels();
+    m_loaded_from_cache = false;
+    Graph& graph = *model->get_graph();
+    auto ret = graph.construct_topology();
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    optimizer::PassManager pass_manager;
+    pass_manager.disable_passes_from_env();
+    for (const auto& name : m_options.disabled_passes) {
+        pass_manager.set_pass_enabled(name, false);
+    }
+    ret = pass_manager.run(m_options.optimization_pipeline, graph);
+    m_optimization_report = pass_manager.report();
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    return create_executor(model, {});
+}
+
+Status InferenceSession::load(const std::string& model_path) {
+    if (m_options.model_cache_dir.empty()) {
+        std::shared_ptr<Model> model;
+        auto ret = read_onnx_file(model_path, model);
+        return ret.is_ok() ? load(model) : ret;
+    }
+
+    ModelCache cache(m_options.model_cache_dir);
+    std::string entry_path;
+    auto ret = cache.get_entry_path(model_path, m_options, entry_path);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    if (std::filesystem::exists(entry_path)) {
+        ret = load_cached(entry_path);
+        if (ret.is_ok()) {
+            return ret;
+        }
+        LOG_WARNING("Load the model cache entry %s failed, compile the model again: %s", entry_path.c_str(),
+                    ret.to_string().c_str());
+    }
+
+    std::shared_ptr<Model> model;
+    ret = read_onnx_file(model_path, model);
+    if (ret.is_ok()) {
+        ret = load(model);
+    }
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    // the session runs without the cache entry
+    auto save_ret = cache.save(entry_path, *m_model, m_execution_order);
+    if (!save_ret.is_ok()) {
+        LOG_WARNING("Save the model cache entry %s failed: %s", entry_path.c_str(), save_ret.to_string().c_str());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::read_onnx_file(const std::string& model_path, std::shared_ptr<Model>& model) const {
+    int num_threads = m_options.load_threads;
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    // the loading thread decodes too, the pool has the other threads
+    std::unique_ptr<utils::thread_pool::SimpleThreadPool> thread_pool;
+    if (num_threads > 1) {
+        thread_pool = std::make_unique<utils::thread_pool::SimpleThreadPool>(num_threads - 1);
+    }
+
+    return io::OnnxSerializer::load_from_file(model_path, model, true, true, thread_pool.get());
+}
+
+Status InferenceSession::load_cached(const std::string& entry_path) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    kernels::KernelManager::instance()->register_all_kernels();
+
+    std::shared_ptr<Model> model;
+    std::vector<Node*> execution_order;
+    auto ret = io::NativeSerializer::load_from_file(entry_path, model, execution_order);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    ret = model->get_graph()->construct_topology();
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    // the order is trusted by the executor, a stale or broken entry is compiled again
+    ret = check_execution_order(*model->get_graph(), execution_order);
+    if (!ret.is_ok()) {
+        return ret;
+    }
+
+    m_optimization_report = optimizer::PassManagerReport();
+    ret = create_executor(model, std::move(execution_order));
+    m_loaded_from_cache = ret.is_ok();
+    return ret;
+}
+
+Status InferenceSession::create_executor(const std::shared_ptr<Model>& model, std::vector<Node*>&& execution_order) {
+    Graph& graph = *model->get_graph();
+    m_memory_report = MemoryReport();
+    if (!execution_order.empty()) {
+        // the order is precompiled, neither the scheduler nor the memory report runs
+        m_execution_order = std::move(execution_order);
+    } else {
+        std::vector<Node*> memory_efficient_order;
+        auto ret = get_execution_order(graph, ExecutionOrder::MEMORY_EFFICIENT, memory_efficient_order);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+
+        ret = calc_peak_memory(graph, graph.get_topological_nodes(), m_memory_report.default_peak_bytes);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+        ret = calc_peak_memory(graph, memory_efficient_order, m_memory_report.memory_efficient_peak_bytes);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+
+        if (m_options.execution_order == ExecutionOrder::MEMORY_EFFICIENT) {
+            m_execution_order = std::move(memory_efficient_order);
+        } else {
+            m_execution_order = graph.get_topological_nodes();
+        }
+    }
+
+    m_model = model;
+    m_executor = std::make_unique<Executor>(graph, m_execution_order, m_options.shape_cache_capacity);
+    for (const auto& input_shapes : m_options.prewarm_input_shapes) {
+        auto ret = m_executor->prepare_shapes(input_shapes);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    return Status::ok();
+}
+
+ShapeCacheStats InferenceSession::shape_cache_stats() const {
+    return m_executor ? m_executor->shape_cache_stats() : ShapeCacheStats();
+}
+
+Status InferenceSession::run(const RunOptions& run_options, const TensorFeeds& feeds, TensorFetches& fetches) {
+    if (!m_executor) {
+        return Status(StatusCode::FAIL, "The session has not loaded a model");
+    }
+
+    return m_executor->run(run_options, feeds, fetches);
+}
+
+}    // namespace runtime
+}    // namespace simple_ai
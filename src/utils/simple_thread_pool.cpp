@@ -0,0 +1,112 @@
+#include "utils/thread_pool/simple_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace simple_ai {
+namespace utils {
+namespace thread_pool {
+
+namespace {
+// the index of the current thread in its pool, -1 out of the pools
+thread_local int t_thread_index = -1;
+// the pool which the current thread belongs to
+thread_local const IThreadPool* t_thread_pool = nullptr;
+}    // namespace
+
+SimpleThreadPool::SimpleThreadPool(int num_threads) {
+    num_threads = std::max(num_threads, 1);
+    m_threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        m_threads.emplace_back(&SimpleThreadPool::run, this, i);
+    }
+}
+
+SimpleThreadPool::~SimpleThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_condi.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void SimpleThreadPool::schedule(std::function<void()> run) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobs.emplace_back(std::move(run));
+    }
+    m_condi.notify_one();
+}
+
+void SimpleThreadPool::cancel() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs.clear();
+}
+
+int SimpleThreadPool::current_thead_index() const { return t_thread_pool == this ? t_thread_index : -1; }
+
+void SimpleThreadPool::run(int index) {
+    t_thread_index = index;
+    t_thread_pool = this;
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condi.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void parallel_for(IThreadPool* thread_pool, size_t count, const std::function<void(size_t)>& func) {
+    if (thread_pool == nullptr || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    // the state is shared with the helpers. a helper which starts after all the indices are taken returns without
+    // touching `func`, so only the completion of the indices is waited for, not the helpers. the pool may be busy or
+    // cancel the helpers, the calling thread takes the indices left then
+    struct State {
+        std::atomic<size_t> next{0};
+        size_t done{0};
+        std::mutex mutex;
+        std::condition_variable condi;
+    };
+    auto state = std::make_shared<State>();
+    auto take_indices = [state, count, &func]() {
+        for (size_t i = state->next.fetch_add(1); i < count; i = state->next.fetch_add(1)) {
+            func(i);
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (++state->done == count) {
+                state->condi.notify_one();
+            }
+        }
+    };
+
+    const size_t num_helpers = std::min(static_cast<size_t>(thread_pool->num_threads()), count - 1);
+    for (size_t i = 0; i < num_helpers; ++i) {
+        thread_pool->schedule(take_indices);
+    }
+    take_indices();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condi.wait(lock, [&state, count] { return state->done == count; });
+}
+
+}    // namespace thread_pool
+}    // namespace utils
+}    // namespace simple_ai
@@ -1,12 +1,22 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "io/native_serializer.h"
 #include "io/onnx_serializer.h"
+#include "ir/graph_transaction.h"
 #include "ir/model.h"
+#include "ir/name_table.h"
 #include "ir/node_shape_manager.h"
+#include "ir/op_defines.h"
+#include "ir/op_params.h"
 #include "utils/logger.h"
+#include "utils/thread_pool/simple_thread_pool.h"
 #include "utils/utils.h"
 
 using namespace simple_ai;
@@ -81,4 +91,1195 @@ TEST(IOTest, IRTest) {
 
     std::this_thread::sleep_for(std::chrono::milliseconds(300));
     release_logger();
-}
\ No newline at end of file
+}
+
+namespace {
+
+/**
+ * @brief A serialized onnx model computing Y = X + W, the initializer W is stored as raw data
+ */
+std::string build_add_model(const std::string& graph_name, const std::vector<float>& weight) {
+    onnx::ModelProto model;
+    model.set_ir_version(7);
+    model.add_opset_import()->set_version(13);
+
+    auto* graph = model.mutable_graph();
+    graph->set_name(graph_name);
+    for (auto* value_info : {graph->add_input(), graph->add_output()}) {
+        value_info->set_name(value_info == &graph->input(0) ? "X" : "Y");
+        auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+        tensor_type->mutable_shape()->add_dim()->set_dim_value(static_cast<int64_t>(weight.size()));
+    }
+
+    auto* initializer = graph->add_initializer();
+    initializer->set_name("W");
+    initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+    initializer->add_dims(static_cast<int64_t>(weight.size()));
+    initializer->set_raw_data(weight.data(), weight.size() * sizeof(float));
+
+    auto* node = graph->add_node();
+    node->set_op_type("Add");
+    node->add_input("X");
+    node->add_input("W");
+    node->add_output("Y");
+
+    return model.SerializeAsString();
+}
+
+/**
+ * @brief Move the raw data of the initializer of `build_add_model` to an external data file
+ */
+std::string build_external_add_model(const std::vector<float>& weight, const std::string& location, size_t offset,
+                                     bool with_length) {
+    onnx::ModelProto model;
+    model.ParseFromString(build_add_model("g", weight));
+    auto* initializer = model.mutable_graph()->mutable_initializer(0);
+    initializer->clear_raw_data();
+    initializer->set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+    auto add_entry = [initializer](const std::string& key, const std::string& value) {
+        auto* entry = initializer->add_external_data();
+        entry->set_key(key);
+        entry->set_value(value);
+    };
+    add_entry("location", location);
+    add_entry("offset", std::to_string(offset));
+    if (with_length) {
+        add_entry("length", std::to_string(weight.size() * sizeof(float)));
+    }
+
+    return model.SerializeAsString();
+}
+
+/**
+ * @brief Add a node reading and writing the named args, the args are created on first use
+ */
+void add_test_node(ir::Graph& graph, int id, const std::string& type, const std::vector<std::string>& inputs,
+                   const std::string& output) {
+    std::vector<ir::NodeArg*> input_args;
+    for (auto& name : inputs) {
+        input_args.emplace_back(graph.get_or_create_nodearg(name, ir::NodeArg(name)));
+    }
+    auto node = std::make_unique<ir::Node>(id, graph);
+    node->init(type + std::to_string(id), type, "", "", input_args,
+               {graph.get_or_create_nodearg(output, ir::NodeArg(output))}, {});
+    graph.add_node(std::move(node));
+}
+
+std::shared_ptr<ir::Model> make_test_model() {
+    auto model = std::make_shared<ir::Model>();
+    model->set_graph(std::make_unique<ir::Graph>(*model));
+
+    ir::TensorShape shape;
+    shape.set_dims({2, 4});
+    model->get_graph()->get_or_create_nodearg("X", ir::NodeArg("X", PrimitiveDataType::FLOAT32, shape));
+    model->get_graph()->add_input_name("X");
+    return model;
+}
+
+}    // namespace
+
+TEST(IRTest, TopologicalSort) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    // the nodes are added consumers first
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    add_test_node(*graph, 0, "Add", {"b", "c"}, "Y");
+    add_test_node(*graph, 1, "Relu", {"a"}, "c");
+    add_test_node(*graph, 2, "Relu", {"a"}, "b");
+    add_test_node(*graph, 3, "Relu", {"X"}, "a");
+    graph->add_output_name("Y");
+    ASSERT_TRUE(graph->initialize().is_ok());
+
+    auto status = graph->construct_topology();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    const auto& nodes = graph->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 4);
+    auto position = [&nodes](int id) {
+        return std::find_if(nodes.begin(), nodes.end(), [id](const ir::Node* node) { return node->id() == id; }) -
+               nodes.begin();
+    };
+    EXPECT_EQ(position(3), 0);
+    EXPECT_LT(position(1), position(0));
+    EXPECT_LT(position(2), position(0));
+    EXPECT_EQ(graph->get_node(2)->name(), "Relu2");
+    EXPECT_EQ(graph->get_node(4), nullptr);
+
+    // the erased node leaves the index, the topology is constructed again
+    add_test_node(*graph, 4, "Relu", {"a"}, "unused");
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+    ASSERT_TRUE(graph->erase_node(4).is_ok());
+    EXPECT_EQ(graph->get_node(4), nullptr);
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+    EXPECT_EQ(graph->get_topological_nodes().size(), 4);
+}
+
+TEST(IRTest, TopologicalSortRejectsInvalidGraphs) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    // a -> b -> a
+    auto cyclic_model = make_test_model();
+    auto cyclic = cyclic_model->get_graph();
+    add_test_node(*cyclic, 0, "Add", {"X", "b"}, "a");
+    add_test_node(*cyclic, 1, "Relu", {"a"}, "b");
+    cyclic->add_output_name("b");
+    ASSERT_TRUE(cyclic->initialize().is_ok());
+    EXPECT_EQ(cyclic->construct_topology().code(), StatusCode::INVALID_MODEL);
+
+    // two nodes share an id
+    auto duplicate_model = make_test_model();
+    auto duplicate = duplicate_model->get_graph();
+    add_test_node(*duplicate, 0, "Relu", {"X"}, "a");
+    add_test_node(*duplicate, 0, "Relu", {"a"}, "b");
+    duplicate->add_output_name("b");
+    ASSERT_TRUE(duplicate->initialize().is_ok());
+    EXPECT_EQ(duplicate->construct_topology().code(), StatusCode::INVALID_MODEL);
+}
+
+TEST(IRTest, NameTable) {
+    ir::NameTable table;
+    EXPECT_EQ(table.find("a"), ir::kInvalidNameId);
+    EXPECT_EQ(table.intern("a"), 0);
+    EXPECT_EQ(table.intern("b"), 1);
+    EXPECT_EQ(table.intern(std::string("a")), 0);
+    EXPECT_EQ(table.find("b"), 1);
+    EXPECT_EQ(table.name(1), "b");
+    EXPECT_EQ(table.size(), 2);
+
+    // the interned names stay valid when the table grows
+    const std::string& first = table.name(0);
+    for (int i = 0; i < 1000; ++i) {
+        table.intern("name" + std::to_string(i));
+    }
+    EXPECT_EQ(first, "a");
+    EXPECT_EQ(table.find("name999"), 1001);
+}
+
+TEST(IRTest, NodeArgIds) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    add_test_node(*graph, 0, "Relu", {"X"}, "a");
+    add_test_node(*graph, 1, "Relu", {"a"}, "Y");
+    graph->add_output_name("Y");
+    graph->get_or_create_nodearg("unused", ir::NodeArg("unused"));
+    ASSERT_TRUE(graph->initialize().is_ok());
+
+    ir::NodeArg* a = graph->get_nodearg("a");
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(graph->get_nodearg(a->id()), a);
+    EXPECT_LT(static_cast<size_t>(a->id()), graph->get_nodearg_id_bound());
+    EXPECT_EQ(ir::NodeArg("a").id(), ir::kInvalidNameId);
+
+    auto status = graph->construct_topology();
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(graph->get_producer_node(a), graph->get_node(0));
+    EXPECT_EQ(graph->get_producer_node("Y"), graph->get_node(1));
+    EXPECT_EQ(graph->get_producer_node("X"), nullptr);
+
+    // the unused arg is released, its id comes back with the name
+    const size_t bound = graph->get_nodearg_id_bound();
+    EXPECT_EQ(graph->get_nodearg("unused"), nullptr);
+    ir::NodeArg* unused = graph->get_or_create_nodearg("unused", ir::NodeArg("unused"));
+    EXPECT_EQ(graph->get_nodearg_id_bound(), bound);
+    EXPECT_LT(static_cast<size_t>(unused->id()), bound);
+
+    // a node arg which is not owned by the graph is rejected
+    ir::NodeArg foreign("a");
+    auto node = std::make_unique<ir::Node>(2, *graph);
+    node->init("Relu2", "Relu", "", "", {&foreign}, {graph->get_or_create_nodearg("b", ir::NodeArg("b"))}, {});
+    graph->add_node(std::move(node));
+    EXPECT_EQ(graph->construct_topology().code(), StatusCode::INVALID_MODEL);
+}
+
+TEST(IRTest, GraphView) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    // X -> a, a -> b, Add(a, b) -> c, Add(c, c) -> Y
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    add_test_node(*graph, 0, "Add", {"c", "c"}, "Y");
+    add_test_node(*graph, 1, "Add", {"a", "b"}, "c");
+    add_test_node(*graph, 2, "Relu", {"a"}, "b");
+    add_test_node(*graph, 3, "Relu", {"X"}, "a");
+    graph->add_output_name("Y");
+    ASSERT_TRUE(graph->initialize().is_ok());
+    auto status = graph->construct_topology();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    const ir::GraphView& view = graph->get_view();
+    ASSERT_EQ(view.node_num(), 4);
+    EXPECT_EQ(view.nodes(), graph->get_topological_nodes());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(view.index_of(view.node_id(i)), i);
+        EXPECT_EQ(view.node(i)->id(), view.node_id(i));
+    }
+    EXPECT_EQ(view.index_of(7), -1);
+
+    const int relu_a = view.index_of(3);
+    const int relu_b = view.index_of(2);
+    const int add_c = view.index_of(1);
+    const int add_y = view.index_of(0);
+    EXPECT_TRUE(view.input_edges(relu_a).empty());
+    EXPECT_EQ(view.output_edges(relu_a).size(), 2);
+
+    // the input edges follow the node inputs
+    auto inputs = view.input_edges(add_c);
+    ASSERT_EQ(inputs.size(), 2);
+    EXPECT_EQ(inputs[0].node, relu_a);
+    EXPECT_EQ(inputs[0].dst_arg_index, 0);
+    EXPECT_EQ(inputs[1].node, relu_b);
+    EXPECT_EQ(inputs[1].dst_arg_index, 1);
+
+    // one edge per input slot, one consumer per node
+    EXPECT_EQ(view.input_edges(add_y).size(), 2);
+    EXPECT_EQ(view.output_edges(add_c).size(), 2);
+    const int c = graph->get_nodearg("c")->id();
+    EXPECT_EQ(view.producer(c), add_c);
+    ASSERT_EQ(view.consumers(c).size(), 1);
+    EXPECT_EQ(view.consumers(c)[0], add_y);
+
+    const int a = graph->get_nodearg("a")->id();
+    ASSERT_EQ(view.consumers(a).size(), 2);
+    EXPECT_LT(view.consumers(a)[0], view.consumers(a)[1]);
+    EXPECT_EQ(view.producer(graph->get_nodearg("X")->id()), -1);
+    EXPECT_TRUE(view.consumers(graph->get_nodearg("Y")->id()).empty());
+    EXPECT_EQ(view.producer(12345), -1);
+}
+
+TEST(IRTest, GraphTransaction) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    // X -> a -> b -> Y
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    add_test_node(*graph, 0, "Relu", {"X"}, "a");
+    add_test_node(*graph, 1, "Relu", {"a"}, "b");
+    add_test_node(*graph, 2, "Relu", {"b"}, "Y");
+    graph->add_output_name("Y");
+    ASSERT_TRUE(graph->initialize().is_ok());
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+
+    ir::Node* relu_a = graph->get_node(0);
+    ir::Node* relu_y = graph->get_node(2);
+    ir::NodeArg* a = graph->get_nodearg("a");
+
+    // bypass the middle node, the arg it produced is released
+    {
+        ir::GraphTransaction transaction(*graph);
+        transaction.replace_input_arg(relu_y, 0, a);
+        ASSERT_TRUE(transaction.erase_node(1).is_ok());
+        EXPECT_FALSE(transaction.erase_node(1).is_ok());
+        auto status = transaction.commit();
+        ASSERT_TRUE(status.is_ok()) << status;
+    }
+    ASSERT_EQ(graph->get_nodes().size(), 2);
+    EXPECT_EQ(graph->get_node(1), nullptr);
+    EXPECT_EQ(graph->get_nodearg("b"), nullptr);
+    EXPECT_EQ(graph->get_view().node_num(), 2);
+    EXPECT_EQ(graph->get_producer_node("Y"), relu_y);
+
+    // the changes are rolled back if not committed
+    {
+        ir::GraphTransaction transaction(*graph);
+        transaction.replace_input_arg(relu_y, 0, graph->get_nodearg("X"));
+        transaction.set_op_type(relu_y, "Abs", "");
+        ASSERT_FALSE(transaction.empty());
+    }
+    EXPECT_EQ(relu_y->input_args()[0], a);
+    EXPECT_EQ(relu_y->type(), "Relu");
+
+    // an arg which is still consumed loses its producer
+    {
+        ir::GraphTransaction transaction(*graph);
+        ASSERT_TRUE(transaction.erase_node(0).is_ok());
+        EXPECT_EQ(transaction.commit().code(), StatusCode::INVALID_MODEL);
+    }
+    EXPECT_EQ(graph->get_nodes().size(), 2);
+    EXPECT_EQ(graph->get_node(0), relu_a);
+
+    // a cycle
+    {
+        ir::GraphTransaction transaction(*graph);
+        transaction.replace_input_arg(relu_a, 0, graph->get_nodearg("Y"));
+        EXPECT_EQ(transaction.commit().code(), StatusCode::INVALID_MODEL);
+    }
+    EXPECT_EQ(relu_a->input_args()[0]->name(), "X");
+
+    // a duplicated output
+    {
+        ir::GraphTransaction transaction(*graph);
+        auto node = std::make_unique<ir::Node>(transaction.next_node_id(), *graph);
+        node->init("dup", "Relu", "", "", {graph->get_nodearg("X")}, {a}, {});
+        transaction.add_node(std::move(node));
+        EXPECT_EQ(transaction.commit().code(), StatusCode::INVALID_MODEL);
+    }
+    EXPECT_EQ(graph->get_nodes().size(), 2);
+
+    // an added node consumed by an earlier node is sorted before it, its output shape is inferred
+    int id = -1;
+    {
+        ir::GraphTransaction transaction(*graph);
+        id = transaction.next_node_id();
+        EXPECT_EQ(graph->get_node(id), nullptr);
+        auto node = std::make_unique<ir::Node>(id, *graph);
+        ir::NodeArg* d = graph->get_or_create_nodearg("d", ir::NodeArg("d"));
+        node->init("d", "Relu", "", "", {graph->get_nodearg("X")}, {d}, {});
+        transaction.add_node(std::move(node));
+        transaction.replace_input_arg(relu_a, 0, graph->get_nodearg("d"));
+        auto status = transaction.commit();
+        ASSERT_TRUE(status.is_ok()) << status;
+    }
+    const auto& nodes = graph->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 3);
+    EXPECT_EQ(nodes[0]->id(), id);
+    EXPECT_EQ(nodes[1], relu_a);
+    EXPECT_EQ(nodes[2], relu_y);
+    EXPECT_EQ(graph->get_nodearg("d")->shape(), graph->get_nodearg("X")->shape());
+    EXPECT_EQ(graph->get_nodearg("d")->data_type(), PrimitiveDataType::FLOAT32);
+}
+
+TEST(IRTest, GraphTransactionRepairsOrder) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    // X -> a -> Y, a -> c
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    add_test_node(*graph, 0, "Relu", {"X"}, "a");
+    add_test_node(*graph, 1, "Relu", {"a"}, "Y");
+    add_test_node(*graph, 2, "Relu", {"a"}, "c");
+    graph->add_output_name("Y");
+    ASSERT_TRUE(graph->initialize().is_ok());
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+    ASSERT_EQ(graph->get_view().index_of(1), 1);
+    ASSERT_EQ(graph->get_view().index_of(2), 2);
+
+    // the node 1 consumes c which is produced after it
+    {
+        ir::GraphTransaction transaction(*graph);
+        transaction.replace_input_arg(graph->get_node(1), 0, graph->get_nodearg("c"));
+        auto status = transaction.commit();
+        ASSERT_TRUE(status.is_ok()) << status;
+    }
+
+    const ir::GraphView& view = graph->get_view();
+    ASSERT_EQ(view.node_num(), 3);
+    EXPECT_EQ(view.node_id(0), 0);
+    EXPECT_EQ(view.node_id(1), 2);
+    EXPECT_EQ(view.node_id(2), 1);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(view.index_of(view.node_id(i)), i);
+        for (const auto& edge : view.input_edges(i)) {
+            EXPECT_LT(edge.node, i);
+        }
+    }
+
+    const int a = graph->get_nodearg("a")->id();
+    const int c = graph->get_nodearg("c")->id();
+    ASSERT_EQ(view.consumers(a).size(), 1);
+    EXPECT_EQ(view.consumers(a)[0], 1);
+    ASSERT_EQ(view.consumers(c).size(), 1);
+    EXPECT_EQ(view.consumers(c)[0], 2);
+    EXPECT_EQ(view.producer(c), 1);
+    ASSERT_EQ(view.output_edges(1).size(), 1);
+    EXPECT_EQ(view.output_edges(1)[0].node, 2);
+
+    // X -> b, X -> p -> p2 -> u, X -> v -> a. one transaction adds the backward edges u -> V and a -> B, the
+    // repair of the first one must not follow the second one
+    auto chain_model = make_test_model();
+    auto chain = chain_model->get_graph();
+    add_test_node(*chain, 0, "Relu", {"X"}, "b");
+    add_test_node(*chain, 1, "Relu", {"X"}, "p");
+    add_test_node(*chain, 2, "Relu", {"X"}, "v");
+    add_test_node(*chain, 3, "Relu", {"p"}, "p2");
+    add_test_node(*chain, 4, "Relu", {"v"}, "a");
+    add_test_node(*chain, 5, "Relu", {"p2"}, "u");
+    for (const std::string output : {"b", "a", "u"}) {
+        chain->add_output_name(output);
+    }
+    ASSERT_TRUE(chain->initialize().is_ok());
+    ASSERT_TRUE(chain->construct_topology().is_ok());
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_EQ(chain->get_view().node_id(i), i);
+    }
+
+    {
+        ir::GraphTransaction transaction(*chain);
+        transaction.replace_input_arg(chain->get_node(2), 0, chain->get_nodearg("u"));
+        transaction.replace_input_arg(chain->get_node(0), 0, chain->get_nodearg("a"));
+        auto status = transaction.commit();
+        ASSERT_TRUE(status.is_ok()) << status;
+    }
+
+    const ir::GraphView& chain_view = chain->get_view();
+    ASSERT_EQ(chain_view.node_num(), 6);
+    for (int i = 0; i < 6; ++i) {
+        for (const auto& edge : chain_view.input_edges(i)) {
+            EXPECT_LT(edge.node, i);
+        }
+    }
+    EXPECT_EQ(chain->get_topological_nodes().back()->id(), 0);
+}
+
+TEST(IRTest, SymbolicShapes) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+
+    ir::TensorShape shape;
+    shape.add_symbolic_dim("N");
+    shape.add_dim(4);
+    EXPECT_TRUE(shape.is_dynamic(0));
+    EXPECT_FALSE(shape.is_static());
+    EXPECT_EQ(shape.symbol(0), "N");
+    EXPECT_EQ(shape.symbol(1), "");
+    EXPECT_EQ(shape.element_num(), ir::kDynamicDim);
+    EXPECT_EQ(shape.to_string(), "{N,4}");
+
+    ir::TensorShape other = shape;
+    other.set_symbol(0, "M");
+    EXPECT_NE(shape, other);
+    EXPECT_FALSE(shape.is_compatible(other));
+    other.set_symbol(0, "");
+    EXPECT_TRUE(shape.is_compatible(other));
+    other.set_dim(0, 2);
+    EXPECT_EQ(other.symbol(0), "");
+    EXPECT_TRUE(other.is_static());
+
+    // the batch symbol is passed through, the dims of different symbols are merged into an anonymous dim
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    graph->get_nodearg("X")->set_shape(shape);
+    ir::TensorShape z_shape;
+    z_shape.add_symbolic_dim("M");
+    z_shape.add_dim(1);
+    graph->get_or_create_nodearg("Z", ir::NodeArg("Z", PrimitiveDataType::FLOAT32, z_shape));
+    graph->add_input_name("Z");
+    add_test_node(*graph, 0, "Relu", {"X"}, "a");
+    add_test_node(*graph, 1, "Add", {"a", "X"}, "b");
+    add_test_node(*graph, 2, "Flatten", {"b"}, "c");
+    add_test_node(*graph, 3, "Add", {"c", "Z"}, "Y");
+    graph->add_output_name("Y");
+    ASSERT_TRUE(graph->initialize().is_ok());
+    auto status = graph->construct_topology();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    EXPECT_EQ(graph->get_nodearg("b")->shape(), shape);
+    EXPECT_EQ(graph->get_nodearg("c")->shape(), shape);
+    const auto& y_shape = graph->get_nodearg("Y")->shape();
+    ASSERT_EQ(y_shape.dims_num(), 2);
+    EXPECT_TRUE(y_shape.is_dynamic(0));
+    EXPECT_EQ(y_shape.symbol(0), "");
+    EXPECT_EQ(y_shape[1], 4);
+}
+
+TEST(IRTest, TensorShapeInlineDims) {
+    ir::TensorShape shape;
+    shape.set_dims({2, 3, 4});
+    EXPECT_EQ(shape.element_num(), 24);
+    shape.set_dim(1, 5);
+    EXPECT_EQ(shape.element_num(), 40);
+    shape.set_dim(1, ir::kDynamicDim);
+    EXPECT_EQ(shape.element_num(), ir::kDynamicDim);
+    shape.set_dims_num(0);
+    EXPECT_EQ(shape.element_num(), 0);
+
+    // more dims than the inline storage fall back to the heap
+    ir::TensorShape large;
+    std::vector<int64_t> dims;
+    for (int64_t i = 1; i <= 12; ++i) {
+        large.add_dim(i % 3 + 1);
+        dims.emplace_back(i % 3 + 1);
+    }
+    EXPECT_EQ(large.dims().to_vector(), dims);
+    EXPECT_EQ(large.element_num(), 1296);
+
+    ir::TensorShape copied = large;
+    EXPECT_EQ(copied, large);
+    ir::TensorShape moved = std::move(copied);
+    EXPECT_EQ(moved, large);
+    EXPECT_NE(moved.dims().data(), large.dims().data());
+
+    // the inline shape is assigned over the heap one
+    moved = shape;
+    EXPECT_EQ(moved.dims_num(), 0);
+    moved.set_dims({7, 7});
+    EXPECT_EQ(moved.element_num(), 49);
+    large = moved;
+    EXPECT_EQ(large, moved);
+}
+
+TEST(IRTest, OpParams) {
+    // the attribute holds only the value of its type
+    ir::NodeAttribute attr("pads", ir::NodeAttributeType::INT64_ARRAY);
+    EXPECT_EQ(attr.type(), ir::NodeAttributeType::INT64_ARRAY);
+    EXPECT_TRUE(attr.get_int64s().empty());
+    attr.add_int64(1);
+    attr.add_int64(2);
+    EXPECT_EQ(attr.get_int64s(), std::vector<int64_t>({1, 2}));
+    EXPECT_TRUE(attr.get_floats().empty());
+    EXPECT_EQ(attr.get_tensor(), nullptr);
+    attr.set_string("SAME_UPPER");
+    EXPECT_EQ(attr.type(), ir::NodeAttributeType::STRING);
+    EXPECT_EQ(attr.get_string(), "SAME_UPPER");
+    EXPECT_TRUE(attr.get_int64s().empty());
+
+    std::unordered_map<std::string, std::unique_ptr<ir::NodeAttribute>> attributes;
+    auto strides = std::make_unique<ir::NodeAttribute>("strides", ir::NodeAttributeType::INT64_ARRAY);
+    strides->add_int64(2);
+    strides->add_int64(2);
+    attributes.emplace("strides", std::move(strides));
+
+    ir::OpParams params;
+    ASSERT_TRUE(ir::decode_op_params("Conv", "conv", attributes, params).is_ok());
+    const auto* conv = std::get_if<ir::ConvParams>(&params);
+    ASSERT_NE(conv, nullptr);
+    EXPECT_EQ(conv->strides.to_vector(), std::vector<int64_t>({2, 2}));
+    EXPECT_TRUE(conv->pads.empty());
+    EXPECT_EQ(conv->group, 1);
+    EXPECT_EQ(conv->auto_pad, ir::AutoPad::NOTSET);
+
+    auto activation = std::make_unique<ir::NodeAttribute>(ir::kActivationAttrName, ir::NodeAttributeType::STRING);
+    activation->set_string("Tanh");
+    attributes.emplace(ir::kActivationAttrName, std::move(activation));
+    EXPECT_EQ(ir::decode_op_params(ir::kFusedGemmOpType, "gemm", attributes, params).code(),
+              StatusCode::NOT_IMPLEMENTED);
+    EXPECT_EQ(ir::decode_op_params(ir::kReorderOpType, "reorder", attributes, params).code(),
+              StatusCode::INVALID_PARAM);
+    ASSERT_TRUE(ir::decode_op_params("Relu", "relu", attributes, params).is_ok());
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(params));
+
+    // the params follow the attributes through the transactions
+    ir::NodeShapeManager::instance()->register_all_infer();
+    auto model = make_test_model();
+    auto graph = model->get_graph();
+    add_test_node(*graph, 0, "Flatten", {"X"}, "Y");
+    graph->add_output_name("Y");
+    ASSERT_TRUE(graph->initialize().is_ok());
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+
+    ir::Node* flatten = graph->get_node(0);
+    ASSERT_TRUE(std::holds_alternative<ir::FlattenParams>(flatten->params()));
+    EXPECT_EQ(std::get<ir::FlattenParams>(flatten->params()).axis, 1);
+
+    auto make_axis = [](int64_t value) {
+        auto axis = std::make_unique<ir::NodeAttribute>("axis", ir::NodeAttributeType::INT64);
+        axis->set_int64(value);
+        return axis;
+    };
+    {
+        ir::GraphTransaction transaction(*graph);
+        transaction.set_attribute(flatten, make_axis(0));
+        auto status = transaction.commit();
+        ASSERT_TRUE(status.is_ok()) << status;
+    }
+    EXPECT_EQ(std::get<ir::FlattenParams>(flatten->params()).axis, 0);
+    EXPECT_EQ(graph->get_nodearg("Y")->shape().dims().to_vector(), std::vector<int64_t>({1, 8}));
+
+    {
+        ir::GraphTransaction transaction(*graph);
+        transaction.set_attribute(flatten, make_axis(5));
+        EXPECT_EQ(transaction.commit().code(), StatusCode::INVALID_PARAM);
+    }
+    EXPECT_EQ(std::get<ir::FlattenParams>(flatten->params()).axis, 0);
+}
+
+TEST(IOTest, MappedLoad) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    const std::vector<float> weight{1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+    const std::string file_path = testing::TempDir() + "mapped_load.onnx";
+
+    // the graph name, which is serialized before the initializers, shifts the offset of the raw data in the file
+    // through all the alignments of float
+    int in_place = 0;
+    for (size_t padding = 0; padding < sizeof(float); ++padding) {
+        {
+            std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+            ofs << build_add_model(std::string(padding + 1, 'g'), weight);
+        }
+
+        for (bool use_mmap : {true, false}) {
+            std::shared_ptr<ir::Model> model;
+            auto status = io::OnnxSerializer::load_from_file(file_path, model, use_mmap);
+            ASSERT_TRUE(status.is_ok()) << status;
+            ASSERT_TRUE(model->get_graph()->construct_topology().is_ok());
+
+            ir::Tensor* tensor = model->get_graph()->get_initializer("W");
+            ASSERT_NE(tensor, nullptr);
+            EXPECT_EQ(tensor->shape().element_num(), static_cast<int64_t>(weight.size()));
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(tensor->data_raw()) % alignof(float), 0u);
+            for (size_t i = 0; i < weight.size(); ++i) {
+                EXPECT_FLOAT_EQ(tensor->data_as<float>()[i], weight[i]);
+            }
+
+            // only the aligned raw data of the mapped file is used in place
+            if (!use_mmap) {
+                EXPECT_TRUE(tensor->owns_buffer());
+            } else if (!tensor->owns_buffer()) {
+                ++in_place;
+            }
+        }
+    }
+    EXPECT_EQ(in_place, 1);
+
+    // a truncated model is rejected
+    const std::string data = build_add_model("g", weight);
+    {
+        std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofs << data.substr(0, data.size() - 3);
+    }
+    std::shared_ptr<ir::Model> model;
+    EXPECT_EQ(io::OnnxSerializer::load_from_file(file_path, model).code(), StatusCode::INVALID_MODEL);
+    std::remove(file_path.c_str());
+}
+
+TEST(IOTest, ExternalData) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    const std::vector<float> weight{1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+    const std::string model_path = testing::TempDir() + "external_data.onnx";
+    const std::string data_path = testing::TempDir() + "external_data.bin";
+    auto write_file = [](const std::string& file_path, const std::string& data) {
+        std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofs << data;
+    };
+
+    // the weight is stored at the page aligned file begin and after 2 bytes
+    std::string weight_data(reinterpret_cast<const char*>(weight.data()), weight.size() * sizeof(float));
+    write_file(data_path, weight_data + "xx" + weight_data);
+    for (size_t offset : {size_t(0), weight_data.size() + 2}) {
+        write_file(model_path, build_external_add_model(weight, "external_data.bin", offset, offset == 0));
+        for (bool use_mmap : {true, false}) {
+            std::shared_ptr<ir::Model> model;
+            auto status = io::OnnxSerializer::load_from_file(model_path, model, use_mmap, use_mmap);
+            ASSERT_TRUE(status.is_ok()) << status;
+
+            // the aligned data is used in place from the mapped data file
+            ir::Tensor* tensor = model->get_graph()->get_initializer("W");
+            ASSERT_NE(tensor, nullptr);
+            EXPECT_EQ(tensor->owns_buffer(), offset != 0);
+            for (size_t i = 0; i < weight.size(); ++i) {
+                EXPECT_FLOAT_EQ(tensor->data_as<float>()[i], weight[i]);
+            }
+        }
+    }
+
+    // the data file must be in the model directory, and hold the whole data
+    std::shared_ptr<ir::Model> model;
+    write_file(model_path, build_external_add_model(weight, "../external_data.bin", 0, true));
+    EXPECT_EQ(io::OnnxSerializer::load_from_file(model_path, model).code(), StatusCode::INVALID_MODEL);
+    write_file(model_path, build_external_add_model(weight, "external_data.bin", weight_data.size() * 2, true));
+    EXPECT_EQ(io::OnnxSerializer::load_from_file(model_path, model).code(), StatusCode::INVALID_MODEL);
+    write_file(model_path, build_external_add_model(weight, "missing.bin", 0, true));
+    EXPECT_EQ(io::OnnxSerializer::load_from_file(model_path, model).code(), StatusCode::FILE_NOT_FOUND);
+
+    // the location is relative to the model file
+    const std::string data = build_external_add_model(weight, "external_data.bin", 0, true);
+    EXPECT_EQ(io::OnnxSerializer::load_from_memory(data.data(), data.size(), model).code(),
+              StatusCode::INVALID_MODEL);
+    std::remove(model_path.c_str());
+    std::remove(data_path.c_str());
+}
+
+TEST(IOTest, NativeFormat) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    const std::vector<float> weight(2048, 0.5f);
+    const std::string onnx_path = testing::TempDir() + "native_format.onnx";
+    const std::string native_path = testing::TempDir() + "native_format.saim";
+    {
+        std::ofstream ofs(onnx_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofs << build_add_model("g", weight);
+    }
+
+    std::shared_ptr<ir::Model> model;
+    auto status = io::OnnxSerializer::load_from_file(onnx_path, model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ir::Graph* graph = model->get_graph();
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+    auto* attr = new ir::NodeAttribute("axes", ir::NodeAttributeType::INT64_ARRAY);
+    attr->add_int64(3);
+    graph->get_node(0)->set_attribute(std::unique_ptr<ir::NodeAttribute>(attr));
+    // the weight can be overridden by a feed
+    graph->add_input_name("W");
+    ASSERT_TRUE(graph->initialize().is_ok());
+    ASSERT_TRUE(graph->construct_topology().is_ok());
+    ASSERT_TRUE(graph->is_graph_input(graph->get_nodearg("W")));
+    ASSERT_TRUE(io::NativeSerializer::save_to_file(*model, graph->get_topological_nodes(), native_path).is_ok());
+
+    // the graph is restored with its shapes, the weights point into the page aligned weights section
+    std::shared_ptr<ir::Model> loaded;
+    std::vector<ir::Node*> execution_order;
+    status = io::NativeSerializer::load_from_file(native_path, loaded, execution_order);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ir::Graph* loaded_graph = loaded->get_graph();
+    ASSERT_TRUE(loaded_graph->construct_topology().is_ok());
+    EXPECT_EQ(loaded->get_ir_version(), model->get_ir_version());
+    EXPECT_EQ(loaded->get_domain_version(), model->get_domain_version());
+    ASSERT_EQ(execution_order.size(), 1u);
+    EXPECT_EQ(execution_order[0]->type(), "Add");
+    EXPECT_EQ(execution_order[0]->attributes().at("axes")->get_int64s(), std::vector<int64_t>({3}));
+    EXPECT_EQ(loaded_graph->get_nodearg("Y")->shape(), graph->get_nodearg("Y")->shape());
+    ASSERT_EQ(loaded_graph->get_inputs().size(), 1u);
+    EXPECT_EQ(loaded_graph->get_inputs()[0]->name(), "X");
+    EXPECT_TRUE(loaded_graph->is_graph_input(loaded_graph->get_nodearg("W")));
+
+    ir::Tensor* tensor = loaded_graph->get_initializer("W");
+    ASSERT_NE(tensor, nullptr);
+    EXPECT_FALSE(tensor->owns_buffer());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(tensor->data_raw()) % io::kNativePageAlignment, 0u);
+    EXPECT_EQ(tensor->shape().element_num(), static_cast<int64_t>(weight.size()));
+    EXPECT_FLOAT_EQ(tensor->data_as<float>()[weight.size() - 1], 0.5f);
+
+    // the other versions and the truncated files are rejected
+    std::string data;
+    {
+        std::ifstream ifs(native_path, std::ios::in | std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    std::string other_version = data;
+    other_version[sizeof(io::kNativeModelMagic)] += 1;
+    for (const std::string& broken : {other_version, data.substr(0, data.size() / 2), data.substr(0, 100)}) {
+        {
+            std::ofstream ofs(native_path, std::ios::out | std::ios::binary | std::ios::trunc);
+            ofs << broken;
+        }
+        EXPECT_EQ(io::NativeSerializer::load_from_file(native_path, loaded, execution_order).code(),
+                  StatusCode::INVALID_MODEL);
+    }
+    std::remove(onnx_path.c_str());
+    std::remove(native_path.c_str());
+}
+
+TEST(IOTest, ParallelInitializers) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    onnx::ModelProto onnx_model;
+    ASSERT_TRUE(onnx_model.ParseFromString(build_add_model("g", {1.0f, 2.0f})));
+
+    // the odd initializers are stored as raw data and the even ones as float data, the last one duplicates "extra.3"
+    constexpr int kExtras = 32;
+    auto* graph = onnx_model.mutable_graph();
+    for (int i = 0; i <= kExtras; ++i) {
+        auto* initializer = graph->add_initializer();
+        initializer->set_name("extra." + std::to_string(i == kExtras ? 3 : i));
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        initializer->add_dims(i + 1);
+        std::vector<float> data(i + 1);
+        for (int j = 0; j <= i; ++j) {
+            data[j] = 0.25f * (i * 100 + j);
+        }
+        if (i % 2 == 1) {
+            initializer->set_raw_data(data.data(), data.size() * sizeof(float));
+        } else {
+            for (float value : data) {
+                initializer->add_float_data(value);
+            }
+        }
+    }
+
+    const std::string data = onnx_model.SerializeAsString();
+    std::shared_ptr<ir::Model> serial_model;
+    auto status = io::OnnxSerializer::load_from_memory(data.data(), data.size(), serial_model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ir::Tensor* duplicate = serial_model->get_graph()->get_initializer("extra.3");
+    ASSERT_NE(duplicate, nullptr);
+    EXPECT_EQ(duplicate->shape().element_num(), kExtras + 1);
+
+    thread_pool::SimpleThreadPool thread_pool(3);
+    for (int repeat = 0; repeat < 4; ++repeat) {
+        std::shared_ptr<ir::Model> model;
+        // the odd repeats borrow the buffer
+        const bool borrow_buffer = repeat % 2 == 1;
+        status = io::OnnxSerializer::load_from_memory(data.data(), data.size(), model, borrow_buffer, &thread_pool);
+        ASSERT_TRUE(status.is_ok()) << status;
+        for (int i = 0; i < kExtras; ++i) {
+            const std::string name = "extra." + std::to_string(i);
+            ir::Tensor* expected = serial_model->get_graph()->get_initializer(name);
+            ir::Tensor* tensor = model->get_graph()->get_initializer(name);
+            ASSERT_NE(tensor, nullptr) << name;
+            ASSERT_EQ(tensor->shape().element_num(), expected->shape().element_num()) << name;
+            EXPECT_EQ(std::memcmp(tensor->data_raw(), expected->data_raw(),
+                                  sizeof(float) * static_cast<size_t>(tensor->shape().element_num())),
+                      0)
+                << name;
+        }
+    }
+
+    // the error of the first broken initializer in the proto order is returned
+    graph->mutable_initializer(21)->add_float_data(0.0f);
+    graph->mutable_initializer(10)->mutable_raw_data()->append("x");
+    const std::string broken_data = onnx_model.SerializeAsString();
+    std::shared_ptr<ir::Model> model;
+    status = io::OnnxSerializer::load_from_memory(broken_data.data(), broken_data.size(), model, false, &thread_pool);
+    EXPECT_EQ(status.code(), StatusCode::INVALID_MODEL);
+    EXPECT_NE(status.message().find("raw data"), std::string::npos) << status;
+}
+
+TEST(IOTest, TensorDataTypes) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    onnx::ModelProto onnx_model;
+    ASSERT_TRUE(onnx_model.ParseFromString(build_add_model("g", {1.0f, 2.0f})));
+    auto* graph = onnx_model.mutable_graph();
+    auto add_initializer = [graph](const std::string& name, onnx::TensorProto_DataType data_type) {
+        auto* initializer = graph->add_initializer();
+        initializer->set_name(name);
+        initializer->set_data_type(data_type);
+        initializer->add_dims(4);
+        return initializer;
+    };
+
+    // the narrower types are stored in int32_data, uint32 in uint64_data and float16 as its bits
+    auto* int8 = add_initializer("int8", onnx::TensorProto_DataType_INT8);
+    auto* uint8 = add_initializer("uint8", onnx::TensorProto_DataType_UINT8);
+    auto* int16 = add_initializer("int16", onnx::TensorProto_DataType_INT16);
+    auto* uint16 = add_initializer("uint16", onnx::TensorProto_DataType_UINT16);
+    auto* float16 = add_initializer("float16", onnx::TensorProto_DataType_FLOAT16);
+    auto* int32 = add_initializer("int32", onnx::TensorProto_DataType_INT32);
+    auto* int64 = add_initializer("int64", onnx::TensorProto_DataType_INT64);
+    auto* uint32 = add_initializer("uint32", onnx::TensorProto_DataType_UINT32);
+    auto* uint64 = add_initializer("uint64", onnx::TensorProto_DataType_UINT64);
+    for (int32_t value : {-128, 127, 5, -1}) {
+        int8->add_int32_data(value);
+        uint8->add_int32_data(value & 0xff);
+        int16->add_int32_data(value * 200);
+        uint16->add_int32_data((value * 200) & 0xffff);
+        float16->add_int32_data(0x3c00 + value);
+        int32->add_int32_data(value * 100000);
+        int64->add_int64_data(value * 10000000000LL);
+        uint32->add_uint64_data(0xffff0000u + value);
+        uint64->add_uint64_data(0xffff000000000000ULL + value);
+    }
+    // the int64 shape constant as raw data
+    const std::vector<int64_t> shape{1, -1, 3, 4};
+    add_initializer("shape", onnx::TensorProto_DataType_INT64)->set_raw_data(shape.data(),
+                                                                             shape.size() * sizeof(int64_t));
+
+    const std::string data = onnx_model.SerializeAsString();
+    std::shared_ptr<ir::Model> model;
+    auto status = io::OnnxSerializer::load_from_memory(data.data(), data.size(), model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ir::Graph* ir_graph = model->get_graph();
+    auto expect_values = [ir_graph](const std::string& name, PrimitiveDataType data_type, auto expected) {
+        using T = typename decltype(expected)::value_type;
+        ir::Tensor* tensor = ir_graph->get_initializer(name);
+        ASSERT_NE(tensor, nullptr) << name;
+        EXPECT_EQ(tensor->data_type(), data_type) << name;
+        ASSERT_EQ(tensor->shape().element_num(), static_cast<int64_t>(expected.size())) << name;
+        EXPECT_EQ(std::vector<T>(tensor->data_as<T>(), tensor->data_as<T>() + expected.size()), expected) << name;
+    };
+    expect_values("int8", PrimitiveDataType::INT8, std::vector<int8_t>{-128, 127, 5, -1});
+    expect_values("uint8", PrimitiveDataType::UINT8, std::vector<uint8_t>{128, 127, 5, 255});
+    expect_values("int16", PrimitiveDataType::INT16, std::vector<int16_t>{-25600, 25400, 1000, -200});
+    expect_values("uint16", PrimitiveDataType::UINT16, std::vector<uint16_t>{39936, 25400, 1000, 65336});
+    expect_values("float16", PrimitiveDataType::FLOAT16, std::vector<uint16_t>{0x3b80, 0x3c7f, 0x3c05, 0x3bff});
+    expect_values("int32", PrimitiveDataType::INT32, std::vector<int32_t>{-12800000, 12700000, 500000, -100000});
+    expect_values("int64", PrimitiveDataType::INT64,
+                  std::vector<int64_t>{-1280000000000LL, 1270000000000LL, 50000000000LL, -10000000000LL});
+    expect_values("uint32", PrimitiveDataType::UINT32,
+                  std::vector<uint32_t>{0xfffeff80u, 0xffff007fu, 0xffff0005u, 0xfffeffffu});
+    expect_values("uint64", PrimitiveDataType::UINT64,
+                  std::vector<uint64_t>{0xfffeffffffffff80ULL, 0xffff00000000007fULL, 0xffff000000000005ULL,
+                                        0xfffeffffffffffffULL});
+    expect_values("shape", PrimitiveDataType::INT64, shape);
+
+    // the scalars without dims, like the axes and the indices, as raw data and as typed data. they round-trip
+    // through the onnx export
+    auto add_scalar = [graph](const std::string& name) {
+        auto* initializer = graph->add_initializer();
+        initializer->set_name(name);
+        initializer->set_data_type(onnx::TensorProto_DataType_INT64);
+        return initializer;
+    };
+    const int64_t axis = -3;
+    add_scalar("axis")->set_raw_data(&axis, sizeof(axis));
+    add_scalar("index")->add_int64_data(42);
+    // the scalars are used, so that the topology keeps them
+    auto* sum = graph->add_node();
+    sum->set_op_type("Add");
+    sum->add_input("axis");
+    sum->add_input("index");
+    sum->add_output("sum");
+    graph->add_output()->set_name("sum");
+    graph->mutable_output(1)->mutable_type()->mutable_tensor_type()->set_elem_type(onnx::TensorProto_DataType_INT64);
+    const std::string scalar_data = onnx_model.SerializeAsString();
+    status = io::OnnxSerializer::load_from_memory(scalar_data.data(), scalar_data.size(), model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_TRUE(model->get_graph()->construct_topology().is_ok());
+    const std::string saved_path = testing::TempDir() + "tensor_data_types.onnx";
+    status = io::OnnxSerializer::save_to_file(*model, saved_path);
+    ASSERT_TRUE(status.is_ok()) << status;
+    std::shared_ptr<ir::Model> saved;
+    status = io::OnnxSerializer::load_from_file(saved_path, saved, false);
+    ASSERT_TRUE(status.is_ok()) << status;
+    for (auto* loaded : {model.get(), saved.get()}) {
+        for (auto& item : std::vector<std::pair<std::string, int64_t>>{{"axis", axis}, {"index", 42}}) {
+            ir::Tensor* tensor = loaded->get_graph()->get_initializer(item.first);
+            ASSERT_NE(tensor, nullptr) << item.first;
+            EXPECT_EQ(tensor->shape().dims_num(), 0u) << item.first;
+            EXPECT_EQ(*tensor->data_as<int64_t>(), item.second) << item.first;
+        }
+    }
+    std::remove(saved_path.c_str());
+    graph->mutable_initializer()->RemoveLast();
+    graph->mutable_initializer()->RemoveLast();
+    graph->mutable_node()->RemoveLast();
+    graph->mutable_output()->RemoveLast();
+
+    // a typed field of the wrong size, and a type without a primitive
+    graph->mutable_initializer(1)->add_int32_data(0);
+    std::string broken_data = onnx_model.SerializeAsString();
+    EXPECT_EQ(io::OnnxSerializer::load_from_memory(broken_data.data(), broken_data.size(), model).code(),
+              StatusCode::INVALID_MODEL);
+    graph->mutable_initializer(1)->mutable_int32_data()->RemoveLast();
+    add_initializer("double", onnx::TensorProto_DataType_DOUBLE)->add_double_data(1.0);
+    broken_data = onnx_model.SerializeAsString();
+    EXPECT_EQ(io::OnnxSerializer::load_from_memory(broken_data.data(), broken_data.size(), model).code(),
+              StatusCode::NOT_IMPLEMENTED);
+}
+
+TEST(IOTest, BorrowedMemoryLoad) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    const std::vector<float> weight{1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+
+    // the graph name shifts the offset of the raw data in the buffer through all the alignments of float
+    int in_place = 0;
+    for (size_t padding = 0; padding < sizeof(float); ++padding) {
+        const std::string data = build_add_model(std::string(padding + 1, 'g'), weight);
+        std::vector<float> buffer_storage(data.size() / sizeof(float) + 1);
+        char* buffer = reinterpret_cast<char*>(buffer_storage.data());
+        std::memcpy(buffer, data.data(), data.size());
+
+        std::shared_ptr<ir::Model> model;
+        auto status = io::OnnxSerializer::load_from_memory(buffer, data.size(), model, true);
+        ASSERT_TRUE(status.is_ok()) << status;
+        ir::Tensor* tensor = model->get_graph()->get_initializer("W");
+        ASSERT_NE(tensor, nullptr);
+        for (size_t i = 0; i < weight.size(); ++i) {
+            EXPECT_FLOAT_EQ(tensor->data_as<float>()[i], weight[i]);
+        }
+
+        // the aligned raw data is a view into the caller's buffer
+        const char* tensor_data = static_cast<const char*>(tensor->data_raw());
+        if (!tensor->owns_buffer()) {
+            ++in_place;
+            EXPECT_TRUE(tensor_data >= buffer && tensor_data + sizeof(float) * weight.size() <= buffer + data.size());
+        }
+    }
+    EXPECT_EQ(in_place, 1);
+
+    // a truncated buffer is rejected
+    const std::string data = build_add_model("g", weight);
+    std::shared_ptr<ir::Model> model;
+    EXPECT_EQ(io::OnnxSerializer::load_from_memory(data.data(), data.size() - 3, model, true).code(),
+              StatusCode::INVALID_MODEL);
+}
+
+TEST(IOTest, StreamedLoad) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    const std::string file_path = testing::TempDir() + "streamed_load.onnx";
+
+    // the raw data of a megabyte or more is read straight into a page-aligned mapping, the smaller one into the proto
+    for (size_t weight_size : {size_t(5), size_t(1 << 19)}) {
+        std::vector<float> weight(weight_size);
+        for (size_t i = 0; i < weight.size(); ++i) {
+            weight[i] = 0.5f * static_cast<float>(i % 1000);
+        }
+        const std::string data = build_add_model("g", weight);
+        {
+            std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+            ofs << data;
+        }
+
+        std::shared_ptr<ir::Model> model;
+        auto status = io::OnnxSerializer::load_from_file(file_path, model, false);
+        ASSERT_TRUE(status.is_ok()) << status;
+        ir::Tensor* tensor = model->get_graph()->get_initializer("W");
+        ASSERT_NE(tensor, nullptr);
+        ASSERT_EQ(tensor->shape().element_num(), static_cast<int64_t>(weight.size()));
+        EXPECT_EQ(std::memcmp(tensor->data_raw(), weight.data(), weight.size() * sizeof(float)), 0);
+        EXPECT_EQ(tensor->owns_buffer(), weight_size < (1 << 18));
+        if (!tensor->owns_buffer()) {
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(tensor->data_raw()) % 4096, 0u);
+        }
+
+        // a model truncated in the raw data or in the graph is rejected
+        for (size_t truncated : {data.size() - 3, data.size() / 2}) {
+            {
+                std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+                ofs << data.substr(0, truncated);
+            }
+            EXPECT_EQ(io::OnnxSerializer::load_from_file(file_path, model, false).code(), StatusCode::INVALID_MODEL);
+        }
+    }
+    std::remove(file_path.c_str());
+}
+
+TEST(IOTest, OnnxExport) {
+    ir::NodeShapeManager::instance()->register_all_infer();
+    const std::string onnx_path = testing::TempDir() + "onnx_export.onnx";
+    const std::string saved_path = testing::TempDir() + "onnx_export_saved.onnx";
+
+    // an optimized graph: X -> FusedConv -> Reorder to NCHWc -> Reorder to NCHW -> Y, with a dynamic batch
+    {
+        onnx::ModelProto model;
+        model.set_ir_version(7);
+        model.set_producer_name("test");
+        model.add_opset_import()->set_version(13);
+        auto* prop = model.add_metadata_props();
+        prop->set_key("author");
+        prop->set_value("simple_ai");
+        // the weight was packed by the layout pass
+        prop = model.add_metadata_props();
+        prop->set_key(std::string(ir::kLayoutMetadataPrefix) + "W");
+        prop->set_value("HWIO");
+
+        auto* graph = model.mutable_graph();
+        for (auto* value_info : {graph->add_input(), graph->add_output()}) {
+            value_info->set_name(value_info == &graph->input(0) ? "X" : "Y");
+            auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+            tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+            tensor_type->mutable_shape()->add_dim()->set_dim_param("batch");
+            for (int64_t dim : {8, 4, 4}) {
+                tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+            }
+        }
+
+        std::vector<float> weight(8 * 8);
+        for (size_t i = 0; i < weight.size(); ++i) {
+            weight[i] = 0.25f * static_cast<float>(i % 7);
+        }
+        auto* initializer = graph->add_initializer();
+        initializer->set_name("W");
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        for (int64_t dim : {8, 8, 1, 1}) {
+            initializer->add_dims(dim);
+        }
+        initializer->set_raw_data(weight.data(), weight.size() * sizeof(float));
+        // the weight can be overridden by a feed
+        auto* weight_input = graph->add_input();
+        weight_input->set_name("W");
+        weight_input->mutable_type()->mutable_tensor_type()->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+        for (int64_t dim : {8, 8, 1, 1}) {
+            weight_input->mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+        }
+
+        auto add_node = [graph](const std::string& type, const std::string& input, const std::string& output) {
+            auto* node = graph->add_node();
+            node->set_name(output);
+            node->set_op_type(type);
+            node->set_domain(ir::kSimpleAIDomain);
+            node->add_input(input);
+            node->add_output(output);
+            return node;
+        };
+        auto add_string = [](onnx::NodeProto* node, const std::string& name, const std::string& value) {
+            auto* attr = node->add_attribute();
+            attr->set_name(name);
+            attr->set_type(onnx::AttributeProto_AttributeType_STRING);
+            attr->set_s(value);
+        };
+        auto* conv = add_node(ir::kFusedConvOpType, "X", "conv");
+        conv->add_input("W");
+        add_string(conv, ir::kActivationAttrName, ir::kReluActivation);
+        auto* kernel_shape = conv->add_attribute();
+        kernel_shape->set_name("kernel_shape");
+        kernel_shape->set_type(onnx::AttributeProto_AttributeType_INTS);
+        kernel_shape->add_ints(1);
+        kernel_shape->add_ints(1);
+        // an int8 tensor attribute, like the zero point of a quantized weight
+        auto* zero_point = conv->add_attribute();
+        zero_point->set_name("zero_point");
+        zero_point->set_type(onnx::AttributeProto_AttributeType_TENSOR);
+        zero_point->mutable_t()->set_name("zero_point");
+        zero_point->mutable_t()->set_data_type(onnx::TensorProto_DataType_INT8);
+        zero_point->mutable_t()->add_dims(2);
+        zero_point->mutable_t()->set_raw_data(std::string("\x7f\x80", 2));
+        auto* to_blocked = add_node(ir::kReorderOpType, "conv", "conv/NCHWc");
+        add_string(to_blocked, ir::kSrcLayoutAttrName, "NCHW");
+        add_string(to_blocked, ir::kDstLayoutAttrName, "NCHWc");
+        auto* to_plain = add_node(ir::kReorderOpType, "conv/NCHWc", "Y");
+        add_string(to_plain, ir::kSrcLayoutAttrName, "NCHWc");
+        add_string(to_plain, ir::kDstLayoutAttrName, "NCHW");
+
+        std::ofstream ofs(onnx_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofs << model.SerializeAsString();
+    }
+
+    std::shared_ptr<ir::Model> model;
+    auto status = io::OnnxSerializer::load_from_file(onnx_path, model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(io::OnnxSerializer::save_to_file(*model, saved_path).code(), StatusCode::INVALID_PARAM);
+    ir::Graph* graph = model->get_graph();
+    status = graph->construct_topology();
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(graph->get_nodearg("conv/NCHWc")->shape().layout(), ir::DataLayout::NCHWc);
+    status = io::OnnxSerializer::save_to_file(*model, saved_path);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    // the custom domain is imported, the inferred arg in NCHW gets a value info, the blocked one is left to the shape
+    // inference
+    onnx::ModelProto saved_proto;
+    {
+        std::ifstream ifs(saved_path, std::ios::in | std::ios::binary);
+        ASSERT_TRUE(saved_proto.ParseFromIstream(&ifs));
+    }
+    ASSERT_EQ(saved_proto.opset_import_size(), 2);
+    EXPECT_EQ(saved_proto.opset_import(1).domain(), ir::kSimpleAIDomain);
+    EXPECT_EQ(saved_proto.opset_import(1).version(), ir::kSimpleAIDomainVersion);
+    ASSERT_EQ(saved_proto.graph().value_info_size(), 1);
+    EXPECT_EQ(saved_proto.graph().value_info(0).name(), "conv");
+    EXPECT_EQ(saved_proto.graph().value_info(0).type().tensor_type().shape().dim(0).dim_param(), "batch");
+
+    std::shared_ptr<ir::Model> loaded;
+    status = io::OnnxSerializer::load_from_file(saved_path, loaded);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ir::Graph* loaded_graph = loaded->get_graph();
+    status = loaded_graph->construct_topology();
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(loaded->get_producer_name(), "test");
+    EXPECT_EQ(loaded->get_metadata().at("author"), "simple_ai");
+    EXPECT_EQ(loaded->get_metadata().size(), 1);
+    EXPECT_EQ(loaded->get_domain_version().at(ir::kSimpleAIDomain), ir::kSimpleAIDomainVersion);
+    EXPECT_EQ(loaded_graph->get_inputs()[0]->shape(), graph->get_inputs()[0]->shape());
+    EXPECT_EQ(loaded_graph->get_nodearg("conv/NCHWc")->shape(), graph->get_nodearg("conv/NCHWc")->shape());
+
+    const auto& nodes = graph->get_topological_nodes();
+    const auto& loaded_nodes = loaded_graph->get_topological_nodes();
+    ASSERT_EQ(loaded_nodes.size(), nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        EXPECT_EQ(loaded_nodes[i]->name(), nodes[i]->name());
+        EXPECT_EQ(loaded_nodes[i]->type(), nodes[i]->type());
+        EXPECT_EQ(loaded_nodes[i]->domain(), ir::kSimpleAIDomain);
+        EXPECT_EQ(loaded_nodes[i]->attributes().size(), nodes[i]->attributes().size());
+    }
+    const auto& attributes = loaded_nodes[0]->attributes();
+    EXPECT_EQ(attributes.at(ir::kActivationAttrName)->get_string(), ir::kReluActivation);
+    EXPECT_EQ(attributes.at("kernel_shape")->get_int64s(), std::vector<int64_t>({1, 1}));
+    ir::Tensor* zero_point = attributes.at("zero_point")->get_tensor();
+    ASSERT_EQ(zero_point->data_type(), PrimitiveDataType::INT8);
+    EXPECT_EQ(zero_point->data_as<int8_t>()[0], 127);
+    EXPECT_EQ(zero_point->data_as<int8_t>()[1], -128);
+
+    // the raw data is written as it is, the loaded weight points into the mapping
+    ir::Tensor* weight = graph->get_initializer("W");
+    ir::Tensor* loaded_weight = loaded_graph->get_initializer("W");
+    ASSERT_NE(loaded_weight, nullptr);
+    EXPECT_FALSE(loaded_weight->owns_buffer());
+    EXPECT_EQ(loaded_weight->shape(), weight->shape());
+    EXPECT_EQ(loaded_weight->shape().layout(), ir::DataLayout::HWIO);
+    EXPECT_EQ(loaded_graph->get_nodearg("W")->shape().layout(), ir::DataLayout::HWIO);
+    EXPECT_TRUE(graph->is_graph_input(graph->get_nodearg("W")));
+    EXPECT_TRUE(loaded_graph->is_graph_input(loaded_graph->get_nodearg("W")));
+    EXPECT_EQ(loaded_graph->get_inputs().size(), 1);
+    EXPECT_EQ(std::memcmp(loaded_weight->data_raw(), weight->data_raw(), 8 * 8 * sizeof(float)), 0);
+
+    // the same model produces the same file. the loaded weight points into the first file, it is not overwritten
+    ASSERT_TRUE(io::OnnxSerializer::save_to_file(*loaded, onnx_path).is_ok());
+    std::string data[2];
+    for (int i = 0; i < 2; ++i) {
+        std::ifstream ifs(i == 0 ? saved_path : onnx_path, std::ios::in | std::ios::binary);
+        data[i].assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    EXPECT_EQ(data[1], data[0]);
+    std::remove(onnx_path.c_str());
+    std::remove(saved_path.c_str());
+}
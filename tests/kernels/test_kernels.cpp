@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "framework/allocator_manager.h"
+#include "ir/op_defines.h"
+#include "ir/op_params.h"
+#include "ir/tensor.h"
+#include "kernels/cpu/conv_kernel.h"
+#include "kernels/kernel_manager.h"
+
+using namespace simple_ai;
+using namespace simple_ai::ir;
+using namespace simple_ai::kernels;
+
+namespace {
+
+std::unique_ptr<Tensor> make_tensor(const std::string& name, const std::vector<int64_t>& dims,
+                                    const std::vector<float>& values) {
+    TensorShape shape;
+    shape.set_dims(dims);
+
+    auto tensor = std::make_unique<Tensor>(name);
+    tensor->init(PrimitiveDataType::FLOAT32, shape, AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU));
+    float* data = tensor->data_as<float>();
+    for (size_t i = 0; i < values.size(); ++i) {
+        data[i] = values[i];
+    }
+    return tensor;
+}
+
+}    // namespace
+
+TEST(KernelsTest, Conv) {
+    KernelManager::instance()->register_all_kernels();
+    IKernel* kernel = KernelManager::instance()->get_kernel("Conv");
+    ASSERT_TRUE(kernel != nullptr);
+
+    // 1x1x3x3 input, 1x1x2x2 kernel of ones, no padding
+    auto x = make_tensor("x", {1, 1, 3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+    auto w = make_tensor("w", {1, 1, 2, 2}, {1, 1, 1, 1});
+    auto b = make_tensor("b", {1}, {-20});
+    auto y = make_tensor("y", {1, 1, 2, 2}, {});
+
+    ConvParams conv;
+    std::vector<Tensor*> outputs{y.get()};
+    auto status = kernel->compute("conv", conv, {x.get(), w.get(), b.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    std::vector<float> expected{-8, -4, 4, 8};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(y->data_as<float>()[i], expected[i]);
+    }
+
+    // the fused epilogue: bias, residual and relu
+    IKernel* fused_kernel = KernelManager::instance()->get_kernel(kFusedConvOpType);
+    ASSERT_TRUE(fused_kernel != nullptr);
+
+    auto z = make_tensor("z", {1, 1, 2, 2}, {1, 1, 1, 1});
+    conv.pads = DimVector({0, 0, 0, 0});
+    conv.activation = FusedActivation::RELU;
+
+    status = fused_kernel->compute("fused_conv", conv, {x.get(), w.get(), b.get(), z.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    expected = {0, 0, 5, 9};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(y->data_as<float>()[i], expected[i]);
+    }
+
+    // NHWC: 2 channels, 2 filters of 1x1. the weights packed in HWIO give the same result as the onnx order
+    auto x_nhwc = make_tensor("x", {1, 2, 2, 2}, {1, 1, 2, 0, 0, 1, 1, 2});
+    x_nhwc->shape().set_layout(DataLayout::NHWC);
+    auto w_oihw = make_tensor("w", {2, 2, 1, 1}, {1, 2, 3, 4});
+    auto w_hwio = make_tensor("w", {2, 2, 1, 1}, {});
+    w_hwio->shape().set_layout(DataLayout::HWIO);
+    pack_conv_weights_hwio(w_oihw->data_as<float>(), 2, 2, 1, w_hwio->data_as<float>());
+    EXPECT_FLOAT_EQ(w_hwio->data_as<float>()[1], 3);
+
+    auto y_nhwc = make_tensor("y", {1, 2, 2, 2}, {});
+    y_nhwc->shape().set_layout(DataLayout::NHWC);
+    outputs = {y_nhwc.get()};
+    expected = {3, 7, 2, 6, 2, 4, 5, 11};
+    for (const Tensor* weights : {w_oihw.get(), w_hwio.get()}) {
+        status = kernel->compute("conv", ConvParams(), {x_nhwc.get(), weights}, outputs);
+        ASSERT_TRUE(status.is_ok()) << status;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_FLOAT_EQ(y_nhwc->data_as<float>()[i], expected[i]);
+        }
+    }
+
+    // the packed weights can not be read by the NCHW convolution
+    auto x_nchw = make_tensor("x", {1, 2, 2, 2}, {});
+    auto y_nchw = make_tensor("y", {1, 2, 2, 2}, {});
+    outputs = {y_nchw.get()};
+    status = kernel->compute("conv", ConvParams(), {x_nchw.get(), w_hwio.get()}, outputs);
+    EXPECT_EQ(status.code(), StatusCode::INVALID_PARAM);
+}
+
+TEST(KernelsTest, AddBroadcast) {
+    KernelManager::instance()->register_all_kernels();
+    IKernel* kernel = KernelManager::instance()->get_kernel("Add");
+    ASSERT_TRUE(kernel != nullptr);
+
+    auto a = make_tensor("a", {2, 3}, {1, 2, 3, 4, 5, 6});
+    auto b = make_tensor("b", {2, 1}, {10, 20});
+    auto y = make_tensor("y", {2, 3}, {});
+
+    std::vector<Tensor*> outputs{y.get()};
+    auto status = kernel->compute("add", OpParams(), {a.get(), b.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    std::vector<float> expected{11, 12, 13, 24, 25, 26};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(y->data_as<float>()[i], expected[i]);
+    }
+
+    // the inputs which do not broadcast to the output are rejected instead of being read out of bounds, like the
+    // relu input larger than its output
+    auto large = make_tensor("large", {4, 3}, {});
+    status = kernel->compute("add", OpParams(), {a.get(), large.get()}, outputs);
+    EXPECT_EQ(status.code(), StatusCode::INVALID_PARAM);
+    IKernel* relu_kernel = KernelManager::instance()->get_kernel("Relu");
+    ASSERT_TRUE(relu_kernel != nullptr);
+    status = relu_kernel->compute("relu", OpParams(), {large.get()}, outputs);
+    EXPECT_EQ(status.code(), StatusCode::INVALID_PARAM);
+}
+
+TEST(KernelsTest, Gemm) {
+    KernelManager::instance()->register_all_kernels();
+    IKernel* kernel = KernelManager::instance()->get_kernel("Gemm");
+    ASSERT_TRUE(kernel != nullptr);
+
+    // Y = 2 * A * B' + 0.5 * C, B is transposed, C is broadcast along the rows
+    auto a = make_tensor("a", {2, 3}, {1, 2, 3, 4, 5, 6});
+    auto b = make_tensor("b", {2, 3}, {1, 0, 1, 0, 1, 0});
+    auto c = make_tensor("c", {2}, {10, 20});
+    auto y = make_tensor("y", {2, 2}, {});
+
+    GemmParams gemm;
+    gemm.alpha = 2.0f;
+    gemm.beta = 0.5f;
+    gemm.trans_b = true;
+
+    std::vector<Tensor*> outputs{y.get()};
+    auto status = kernel->compute("gemm", gemm, {a.get(), b.get(), c.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    std::vector<float> expected{13, 14, 25, 20};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(y->data_as<float>()[i], expected[i]);
+    }
+}
+
+TEST(KernelsTest, Reorder) {
+    KernelManager::instance()->register_all_kernels();
+    IKernel* kernel = KernelManager::instance()->get_kernel(kReorderOpType);
+    ASSERT_TRUE(kernel != nullptr);
+
+    // NCHW -> NCHWc -> NHWC -> NCHW
+    std::vector<float> values(2 * 16 * 3 * 2);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i);
+    }
+    auto x = make_tensor("x", {2, 16, 3, 2}, values);
+    auto blocked = make_tensor("blocked", {2, 16, 3, 2}, {});
+    blocked->shape().set_layout(DataLayout::NCHWc);
+    auto nhwc = make_tensor("nhwc", {2, 16, 3, 2}, {});
+    nhwc->shape().set_layout(DataLayout::NHWC);
+    auto y = make_tensor("y", {2, 16, 3, 2}, {});
+
+    // the layouts are read from the input and output shapes
+    OpParams params;
+    std::vector<Tensor*> outputs{blocked.get()};
+    auto status = kernel->compute("reorder", params, {x.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    // n = 1, c = 9, h = 2, w = 1 is in block 1, lane 1
+    const int64_t index = ((1 * 2 + 1) * 3 * 2 + 2 * 2 + 1) * kNCHWcBlockSize + 1;
+    EXPECT_FLOAT_EQ(blocked->data_as<float>()[index], values[((1 * 16 + 9) * 3 + 2) * 2 + 1]);
+
+    outputs = {nhwc.get()};
+    status = kernel->compute("reorder", params, {blocked.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_FLOAT_EQ(nhwc->data_as<float>()[((1 * 3 + 2) * 2 + 1) * 16 + 9], values[((1 * 16 + 9) * 3 + 2) * 2 + 1]);
+
+    outputs = {y.get()};
+    status = kernel->compute("reorder", params, {nhwc.get()}, outputs);
+    ASSERT_TRUE(status.is_ok()) << status;
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_FLOAT_EQ(y->data_as<float>()[i], values[i]);
+    }
+}
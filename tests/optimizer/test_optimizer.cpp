@@ -0,0 +1,659 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/allocator_manager.h"
+#include "ir/model.h"
+#include "ir/node_shape_manager.h"
+#include "ir/op_defines.h"
+#include "kernels/kernel_manager.h"
+#include "optimizer/common_subexpression_elimination.h"
+#include "optimizer/constant_folding.h"
+#include "optimizer/conv_epilogue_fusion.h"
+#include "optimizer/dead_node_elimination.h"
+#include "optimizer/gemm_epilogue_fusion.h"
+#include "optimizer/layout_transformation.h"
+#include "optimizer/pass_manager.h"
+
+using namespace simple_ai;
+using namespace simple_ai::ir;
+using namespace simple_ai::kernels;
+using namespace simple_ai::optimizer;
+
+namespace {
+
+using AttributeMap = std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>;
+using TensorMap = std::unordered_map<std::string, std::unique_ptr<Tensor>>;
+
+IAllocator* cpu_allocator() { return AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU); }
+
+TensorShape make_shape(const std::vector<int64_t>& dims) {
+    TensorShape shape;
+    shape.set_dims(dims);
+    return shape;
+}
+
+/**
+ * @brief A helper to build the graph by hand
+ */
+class GraphBuilder {
+public:
+    GraphBuilder() {
+        m_model = std::make_shared<Model>();
+        m_model->set_graph(std::make_unique<Graph>(*m_model));
+    }
+
+    Graph* graph() { return m_model->get_graph(); }
+
+    void add_input(const std::string& name, const std::vector<int64_t>& dims) {
+        graph()->get_or_create_nodearg(name, NodeArg(name, PrimitiveDataType::FLOAT32, make_shape(dims)));
+        graph()->add_input_name(name);
+    }
+
+    void add_output(const std::string& name) { graph()->add_output_name(name); }
+
+    void add_initializer(const std::string& name, const std::vector<int64_t>& dims, float seed) {
+        auto tensor = std::make_unique<Tensor>(name);
+        tensor->init(PrimitiveDataType::FLOAT32, make_shape(dims), cpu_allocator());
+        float* data = tensor->data_as<float>();
+        for (int64_t i = 0; i < tensor->shape().element_num(); ++i) {
+            data[i] = std::sin(seed + 0.37f * i);
+        }
+
+        graph()->get_or_create_nodearg(name, NodeArg(name, PrimitiveDataType::FLOAT32, tensor->shape()));
+        graph()->add_initializer(std::move(tensor));
+    }
+
+    Node* add_node(const std::string& type, const std::vector<std::string>& inputs,
+                   const std::vector<std::string>& outputs, AttributeMap&& attributes = AttributeMap()) {
+        auto create_args = [this](const std::vector<std::string>& names) {
+            std::vector<NodeArg*> args;
+            for (auto& name : names) {
+                NodeArg* arg = graph()->get_nodearg(name);
+                args.emplace_back(arg ? arg : graph()->get_or_create_nodearg(name, NodeArg(name)));
+            }
+            return args;
+        };
+
+        auto node = std::make_unique<Node>(m_node_id++, *graph());
+        node->init(type + std::to_string(m_node_id), type, "", "", create_args(inputs), create_args(outputs),
+                   std::move(attributes));
+        Node* ptr = node.get();
+        graph()->add_node(std::move(node));
+        return ptr;
+    }
+
+    Status build() {
+        auto ret = graph()->initialize();
+        if (!ret.is_ok()) {
+            return ret;
+        }
+        return graph()->construct_topology();
+    }
+
+private:
+    std::shared_ptr<Model> m_model;
+    int m_node_id{0};
+};
+
+AttributeMap conv_attributes() {
+    AttributeMap attributes;
+    auto pads = std::make_unique<NodeAttribute>("pads", NodeAttributeType::INT64_ARRAY);
+    for (int i = 0; i < 4; ++i) {
+        pads->add_int64(1);
+    }
+    attributes.emplace("pads", std::move(pads));
+    return attributes;
+}
+
+/**
+ * @brief run the graph with the cpu kernels, the graph outputs are saved in `values`
+ */
+Status run_graph(Graph& graph, TensorMap& values) {
+    for (Node* node : graph.get_topological_nodes()) {
+        std::vector<const Tensor*> inputs;
+        for (auto* arg : node->input_args()) {
+            if (arg->name().empty()) {
+                inputs.emplace_back(nullptr);
+            } else if (values.count(arg->name())) {
+                inputs.emplace_back(values[arg->name()].get());
+            } else {
+                inputs.emplace_back(graph.get_initializer(arg->name()));
+            }
+        }
+
+        std::vector<Tensor*> outputs;
+        for (auto* arg : node->output_args()) {
+            auto tensor = std::make_unique<Tensor>(arg->name());
+            tensor->init(PrimitiveDataType::FLOAT32, arg->shape(), cpu_allocator());
+            outputs.emplace_back(tensor.get());
+            values[arg->name()] = std::move(tensor);
+        }
+
+        IKernel* kernel = KernelManager::instance()->get_kernel(node->type());
+        if (!kernel) {
+            return Status(StatusCode::NOT_IMPLEMENTED, "no kernel for " + node->type());
+        }
+
+        auto ret = kernel->compute(node->name(), node->params(), inputs, outputs);
+        if (!ret.is_ok()) {
+            return ret;
+        }
+    }
+
+    return Status::ok();
+}
+
+void expect_same_values(const Tensor* actual, const Tensor* expected) {
+    ASSERT_EQ(actual->shape(), expected->shape());
+    for (int64_t i = 0; i < actual->shape().element_num(); ++i) {
+        EXPECT_NEAR(actual->data_as<float>()[i], expected->data_as<float>()[i], 1e-4f);
+    }
+}
+
+std::unique_ptr<Tensor> make_input(const std::string& name, const std::vector<int64_t>& dims) {
+    auto tensor = std::make_unique<Tensor>(name);
+    tensor->init(PrimitiveDataType::FLOAT32, make_shape(dims), cpu_allocator());
+    float* data = tensor->data_as<float>();
+    for (int64_t i = 0; i < tensor->shape().element_num(); ++i) {
+        data[i] = std::cos(0.11f * i);
+    }
+    return tensor;
+}
+
+/**
+ * @brief A ResNet basic block: Conv -> Add(bias) -> Relu -> Conv -> Add(shortcut) -> Relu
+ */
+void build_resnet_block(GraphBuilder& builder) {
+    builder.add_input("X", {1, 4, 8, 8});
+    builder.add_initializer("W1", {4, 4, 3, 3}, 0.1f);
+    builder.add_initializer("B1", {1, 4, 1, 1}, 0.2f);
+    builder.add_initializer("W2", {4, 4, 3, 3}, 0.3f);
+    builder.add_initializer("B2", {4}, 0.4f);
+    builder.add_output("Y");
+
+    builder.add_node("Conv", {"X", "W1"}, {"conv1"}, conv_attributes());
+    builder.add_node("Add", {"conv1", "B1"}, {"bias1"});
+    builder.add_node("Relu", {"bias1"}, {"relu1"});
+    builder.add_node("Conv", {"relu1", "W2", "B2"}, {"conv2"}, conv_attributes());
+    builder.add_node("Add", {"conv2", "X"}, {"add2"});
+    builder.add_node("Relu", {"add2"}, {"Y"});
+}
+
+/**
+ * @brief A MLP: Gemm -> Add(bias) -> Relu -> Gemm(C) -> Add(residual) -> Relu
+ */
+void build_mlp(GraphBuilder& builder) {
+    builder.add_input("X", {8, 32});
+    builder.add_initializer("W1", {32, 48}, 0.1f);
+    builder.add_initializer("B1", {48}, 0.2f);
+    builder.add_initializer("W2", {48, 48}, 0.3f);
+    builder.add_initializer("C2", {1, 48}, 0.4f);
+    builder.add_output("Y");
+
+    AttributeMap attributes;
+    auto alpha = std::make_unique<NodeAttribute>("alpha", NodeAttributeType::FLOAT);
+    alpha->set_float(0.5f);
+    attributes.emplace("alpha", std::move(alpha));
+    auto beta = std::make_unique<NodeAttribute>("beta", NodeAttributeType::FLOAT);
+    beta->set_float(2.0f);
+    attributes.emplace("beta", std::move(beta));
+
+    builder.add_node("Gemm", {"X", "W1"}, {"gemm1"});
+    builder.add_node("Add", {"gemm1", "B1"}, {"bias1"});
+    builder.add_node("Relu", {"bias1"}, {"relu1"});
+    builder.add_node("Gemm", {"relu1", "W2", "C2"}, {"gemm2"}, std::move(attributes));
+    builder.add_node("Add", {"relu1", "gemm2"}, {"add2"});
+    builder.add_node("Relu", {"add2"}, {"Y"});
+}
+
+}    // namespace
+
+TEST(OptimizerTest, ConvEpilogueFusion) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    // the reference result
+    GraphBuilder reference;
+    build_resnet_block(reference);
+    auto status = reference.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    TensorMap reference_values;
+    reference_values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*reference.graph(), reference_values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    // the fused result
+    GraphBuilder builder;
+    build_resnet_block(builder);
+    status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    ConvEpilogueFusionPass pass;
+    bool modified = false;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    const auto& nodes = builder.graph()->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 2);
+    EXPECT_EQ(nodes[0]->type(), kFusedConvOpType);
+    EXPECT_EQ(nodes[0]->input_args().size(), 3);
+    EXPECT_EQ(nodes[0]->input_args()[2]->name(), "B1");
+    EXPECT_EQ(nodes[1]->type(), kFusedConvOpType);
+    EXPECT_EQ(nodes[1]->input_args().size(), 4);
+    EXPECT_EQ(nodes[1]->input_args()[3]->name(), "X");
+    EXPECT_EQ(nodes[1]->output_args()[0]->name(), "Y");
+
+    TensorMap values;
+    values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*builder.graph(), values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    expect_same_values(values["Y"].get(), reference_values["Y"].get());
+}
+
+TEST(OptimizerTest, ConvEpilogueFusionSkipsSharedOutputs) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    // the conv output is consumed twice, and the relu output is a graph output
+    GraphBuilder builder;
+    builder.add_input("X", {1, 2, 4, 4});
+    builder.add_initializer("W", {2, 2, 3, 3}, 0.5f);
+    builder.add_output("Y");
+    builder.add_output("Z");
+    builder.add_node("Conv", {"X", "W"}, {"conv"}, conv_attributes());
+    builder.add_node("Relu", {"conv"}, {"Y"});
+    builder.add_node("Add", {"conv", "X"}, {"Z"});
+    auto status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    ConvEpilogueFusionPass pass;
+    bool modified = true;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_FALSE(modified);
+    EXPECT_EQ(builder.graph()->get_nodes().size(), 3);
+}
+
+TEST(OptimizerTest, GemmEpilogueFusion) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    GraphBuilder reference;
+    build_mlp(reference);
+    auto status = reference.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    TensorMap reference_values;
+    reference_values["X"] = make_input("X", {8, 32});
+    status = run_graph(*reference.graph(), reference_values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    GraphBuilder builder;
+    build_mlp(builder);
+    status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    GemmEpilogueFusionPass pass;
+    bool modified = false;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    const auto& nodes = builder.graph()->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 2);
+    EXPECT_EQ(nodes[0]->type(), kFusedGemmOpType);
+    EXPECT_EQ(nodes[0]->input_args()[2]->name(), "B1");
+    EXPECT_EQ(nodes[1]->type(), kFusedGemmOpType);
+    EXPECT_EQ(nodes[1]->input_args()[3]->name(), "relu1");
+
+    TensorMap values;
+    values["X"] = make_input("X", {8, 32});
+    status = run_graph(*builder.graph(), values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    expect_same_values(values["Y"].get(), reference_values["Y"].get());
+}
+
+TEST(OptimizerTest, ConstantFolding) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    // Y = X + (Relu(C1) + C2), the part in the brackets is folded
+    auto build = [](GraphBuilder& builder) {
+        builder.add_input("X", {2, 3});
+        builder.add_initializer("C1", {2, 3}, 0.1f);
+        builder.add_initializer("C2", {3}, 0.2f);
+        builder.add_output("Y");
+        builder.add_node("Relu", {"C1"}, {"relu"});
+        builder.add_node("Add", {"relu", "C2"}, {"bias"});
+        builder.add_node("Add", {"X", "bias"}, {"Y"});
+    };
+
+    GraphBuilder reference;
+    build(reference);
+    auto status = reference.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    TensorMap reference_values;
+    reference_values["X"] = make_input("X", {2, 3});
+    status = run_graph(*reference.graph(), reference_values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    GraphBuilder builder;
+    build(builder);
+    status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    ConstantFoldingPass pass;
+    bool modified = false;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    Graph* graph = builder.graph();
+    ASSERT_EQ(graph->get_topological_nodes().size(), 1);
+    EXPECT_TRUE(graph->has_initializer("bias"));
+    EXPECT_FALSE(graph->has_initializer("relu"));
+    EXPECT_FALSE(graph->has_initializer("C1"));
+    EXPECT_FALSE(graph->has_initializer("C2"));
+    EXPECT_EQ(graph->get_nodearg("relu"), nullptr);
+
+    TensorMap values;
+    values["X"] = make_input("X", {2, 3});
+    status = run_graph(*graph, values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    expect_same_values(values["Y"].get(), reference_values["Y"].get());
+
+    // nothing left to fold
+    status = pass.apply(*graph, modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_FALSE(modified);
+}
+
+TEST(OptimizerTest, DeadNodeElimination) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    // Y = Relu(X), the Add branch and the initializer it uses never reach the output
+    GraphBuilder builder;
+    builder.add_input("X", {2, 3});
+    builder.add_initializer("C", {2, 3}, 0.1f);
+    builder.add_output("Y");
+    builder.add_node("Relu", {"X"}, {"Y"});
+    builder.add_node("Add", {"X", "C"}, {"add"});
+    builder.add_node("Relu", {"add"}, {"dead"});
+    auto status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(builder.graph()->get_topological_nodes().size(), 3);
+
+    DeadNodeEliminationPass pass;
+    bool modified = false;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    const auto& nodes = builder.graph()->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0]->output_args()[0]->name(), "Y");
+    EXPECT_EQ(builder.graph()->get_initializer("C"), nullptr);
+
+    // nothing left to remove
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_FALSE(modified);
+}
+
+TEST(OptimizerTest, CommonSubexpressionElimination) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    // Y = Relu(Conv(X, W1)) + Relu(Conv(X, W2)), W1 and W2 are byte-identical
+    auto build = [](GraphBuilder& builder) {
+        builder.add_input("X", {1, 4, 8, 8});
+        builder.add_initializer("W1", {4, 4, 3, 3}, 0.1f);
+        builder.add_initializer("W2", {4, 4, 3, 3}, 0.1f);
+        builder.add_output("Y");
+        builder.add_node("Conv", {"X", "W1"}, {"conv1"}, conv_attributes());
+        builder.add_node("Relu", {"conv1"}, {"relu1"});
+        builder.add_node("Conv", {"X", "W2"}, {"conv2"}, conv_attributes());
+        builder.add_node("Relu", {"conv2"}, {"relu2"});
+        builder.add_node("Add", {"relu1", "relu2"}, {"Y"});
+    };
+
+    GraphBuilder reference;
+    build(reference);
+    auto status = reference.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    TensorMap reference_values;
+    reference_values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*reference.graph(), reference_values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    GraphBuilder builder;
+    build(builder);
+    status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    CommonSubexpressionEliminationPass pass;
+    bool modified = false;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    const auto& nodes = builder.graph()->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 3);
+    EXPECT_EQ(nodes[2]->input_args()[0], nodes[2]->input_args()[1]);
+    EXPECT_EQ(builder.graph()->get_initializers().size(), 1);
+
+    const auto& stats = pass.stats();
+    EXPECT_EQ(stats.removed_nodes, 2);
+    EXPECT_EQ(stats.removed_initializers, 1);
+    // conv: 2 * 256 outputs * 36 multiply-adds, relu: 256 outputs
+    EXPECT_EQ(stats.saved_flops, 2 * 256 * 36 + 256);
+    // weight 144 floats, conv and relu outputs 256 floats each
+    EXPECT_EQ(stats.saved_bytes, (144 + 256 + 256) * sizeof(float));
+
+    TensorMap values;
+    values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*builder.graph(), values);
+    ASSERT_TRUE(status.is_ok()) << status;
+    expect_same_values(values["Y"].get(), reference_values["Y"].get());
+
+    // a second run finds nothing to merge
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_FALSE(modified);
+}
+
+TEST(OptimizerTest, LayoutTransformation) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    GraphBuilder reference;
+    build_resnet_block(reference);
+    auto status = reference.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    TensorMap reference_values;
+    reference_values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*reference.graph(), reference_values);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    // the fused block runs in NHWC with one conversion at each end
+    GraphBuilder builder;
+    build_resnet_block(builder);
+    status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    ConvEpilogueFusionPass fusion;
+    LayoutTransformationPass pass;
+    bool modified = false;
+    status = fusion.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    const auto& nodes = builder.graph()->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 4);
+    EXPECT_EQ(nodes[0]->type(), kReorderOpType);
+    EXPECT_EQ(nodes[1]->type(), kFusedConvOpType);
+    EXPECT_EQ(nodes[1]->output_args()[0]->shape().layout(), DataLayout::NHWC);
+    EXPECT_EQ(nodes[2]->type(), kFusedConvOpType);
+    EXPECT_EQ(nodes[2]->input_args()[3], nodes[0]->output_args()[0]);
+    EXPECT_EQ(nodes[3]->type(), kReorderOpType);
+    EXPECT_EQ(nodes[3]->output_args()[0]->name(), "Y");
+    EXPECT_EQ(nodes[3]->output_args()[0]->shape().layout(), DataLayout::NCHW);
+
+    // the weights are packed once for the NHWC convolution, the unpacked ones are removed
+    for (const std::string name : {"W1", "W2"}) {
+        const Tensor* packed = builder.graph()->get_initializer(name + "/HWIO");
+        ASSERT_TRUE(packed != nullptr);
+        EXPECT_EQ(packed->shape().layout(), DataLayout::HWIO);
+        EXPECT_EQ(builder.graph()->get_initializer(name), nullptr);
+    }
+    EXPECT_EQ(nodes[1]->input_args()[1]->name(), "W1/HWIO");
+    EXPECT_EQ(nodes[1]->input_args()[1]->shape().layout(), DataLayout::HWIO);
+
+    TensorMap values;
+    values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*builder.graph(), values);
+    ASSERT_TRUE(status.is_ok()) << status;
+    expect_same_values(values["Y"].get(), reference_values["Y"].get());
+
+    // nothing changes in the second run
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_FALSE(modified);
+
+    // the unfused block leaves the region at the broadcasting bias Add, the results are still the same
+    GraphBuilder unfused;
+    build_resnet_block(unfused);
+    status = unfused.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+    status = pass.apply(*unfused.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    TensorMap unfused_values;
+    unfused_values["X"] = make_input("X", {1, 4, 8, 8});
+    status = run_graph(*unfused.graph(), unfused_values);
+    ASSERT_TRUE(status.is_ok()) << status;
+    expect_same_values(unfused_values["Y"].get(), reference_values["Y"].get());
+}
+
+TEST(OptimizerTest, LayoutTransformationCancelsInverseReorders) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    auto layout_attributes = [](const std::string& src, const std::string& dst) {
+        AttributeMap attributes;
+        auto src_attr = std::make_unique<NodeAttribute>(kSrcLayoutAttrName, NodeAttributeType::STRING);
+        src_attr->set_string(src);
+        attributes.emplace(kSrcLayoutAttrName, std::move(src_attr));
+        auto dst_attr = std::make_unique<NodeAttribute>(kDstLayoutAttrName, NodeAttributeType::STRING);
+        dst_attr->set_string(dst);
+        attributes.emplace(kDstLayoutAttrName, std::move(dst_attr));
+        return attributes;
+    };
+
+    GraphBuilder builder;
+    builder.add_input("X", {1, 8, 4, 4});
+    builder.add_output("Y");
+    builder.add_node(kReorderOpType, {"X"}, {"blocked"}, layout_attributes("NCHW", "NCHWc"));
+    builder.add_node(kReorderOpType, {"blocked"}, {"plain"}, layout_attributes("NCHWc", "NCHW"));
+    builder.add_node("Relu", {"plain"}, {"Y"});
+    auto status = builder.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(builder.graph()->get_nodearg("blocked")->shape().layout(), DataLayout::NCHWc);
+
+    LayoutTransformationPass pass;
+    bool modified = false;
+    status = pass.apply(*builder.graph(), modified);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(modified);
+
+    const auto& nodes = builder.graph()->get_topological_nodes();
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0]->type(), "Relu");
+    EXPECT_EQ(nodes[0]->input_args()[0]->name(), "X");
+}
+
+TEST(OptimizerTest, PassManager) {
+    NodeShapeManager::instance()->register_all_infer();
+    KernelManager::instance()->register_all_kernels();
+
+    // the ResNet block with a dead branch
+    auto build = [](GraphBuilder& builder) {
+        build_resnet_block(builder);
+        builder.add_node("Relu", {"X"}, {"dead"});
+        return builder.build();
+    };
+
+    GraphBuilder builder;
+    auto status = build(builder);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    PassManager pass_manager;
+    status = pass_manager.run(kExtendedPipeline, *builder.graph());
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(builder.graph()->get_topological_nodes().size(), 2);
+
+    // the second iteration finds nothing to do
+    const auto& report = pass_manager.report();
+    EXPECT_TRUE(report.converged);
+    EXPECT_EQ(report.iterations, 2);
+    ASSERT_EQ(report.passes.size(), 5);
+    for (const auto& stats : report.passes) {
+        EXPECT_EQ(stats.runs, 2);
+        if (stats.name == "DeadNodeElimination") {
+            EXPECT_EQ(stats.modified_runs, 1);
+            EXPECT_EQ(stats.nodes_removed, 1);
+            EXPECT_EQ(stats.bytes_saved, 4 * 8 * 8 * sizeof(float));
+        } else if (stats.name == "ConvEpilogueFusion") {
+            EXPECT_EQ(stats.modified_runs, 1);
+            EXPECT_EQ(stats.nodes_removed, 4);
+            EXPECT_EQ(stats.nodes_added, 0);
+        } else {
+            EXPECT_EQ(stats.modified_runs, 0);
+        }
+    }
+    EXPECT_FALSE(report.to_string().empty());
+
+    // disabled by the environment variable
+    ::setenv(kDisabledPassesEnv, "ConvEpilogueFusion, DeadNodeElimination", 1);
+    GraphBuilder disabled;
+    status = build(disabled);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    PassManager env_pass_manager;
+    env_pass_manager.disable_passes_from_env();
+    ::unsetenv(kDisabledPassesEnv);
+    EXPECT_FALSE(env_pass_manager.is_pass_enabled("ConvEpilogueFusion"));
+    EXPECT_TRUE(env_pass_manager.is_pass_enabled("ConstantFolding"));
+
+    status = env_pass_manager.run(kExtendedPipeline, *disabled.graph());
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(disabled.graph()->get_topological_nodes().size(), 7);
+    EXPECT_EQ(env_pass_manager.report().passes.size(), 3);
+
+    // all passes disabled, and unknown pipelines and passes
+    env_pass_manager.set_pass_enabled("*", false);
+    EXPECT_FALSE(env_pass_manager.is_pass_enabled("ConstantFolding"));
+    status = env_pass_manager.run(kAllPipeline, *disabled.graph());
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_TRUE(env_pass_manager.report().passes.empty());
+
+    EXPECT_FALSE(env_pass_manager.run("unknown", *disabled.graph()).is_ok());
+    EXPECT_FALSE(env_pass_manager.add_pipeline("custom", {"UnknownPass"}).is_ok());
+    EXPECT_TRUE(env_pass_manager.add_pipeline("custom", {"DeadNodeElimination"}).is_ok());
+}
@@ -0,0 +1,667 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/allocator_manager.h"
+#include "io/native_serializer.h"
+#include "io/onnx_serializer.h"
+#include "ir/model.h"
+#include "ir/node_shape_manager.h"
+#include "ir/op_defines.h"
+#include "runtime/executor.h"
+#include "runtime/session.h"
+#include "onnx.proto3.pb.h"
+
+using namespace simple_ai;
+using namespace simple_ai::ir;
+using namespace simple_ai::runtime;
+
+namespace {
+
+IAllocator* cpu_allocator() { return AllocatorManager::instance()->get_allocator(IAllocator::Type::CPU); }
+
+TensorShape make_shape(const std::vector<int64_t>& dims) {
+    TensorShape shape;
+    shape.set_dims(dims);
+    return shape;
+}
+
+std::unique_ptr<Tensor> make_tensor(const std::string& name, const std::vector<int64_t>& dims, float seed) {
+    auto tensor = std::make_unique<Tensor>(name);
+    tensor->init(PrimitiveDataType::FLOAT32, make_shape(dims), cpu_allocator());
+    float* data = tensor->data_as<float>();
+    for (int64_t i = 0; i < tensor->shape().element_num(); ++i) {
+        data[i] = std::sin(seed + 0.37f * i);
+    }
+    return tensor;
+}
+
+/**
+ * @brief A helper to build the graph by hand
+ */
+class ModelBuilder {
+public:
+    ModelBuilder() {
+        m_model = std::make_shared<Model>();
+        m_model->set_graph(std::make_unique<Graph>(*m_model));
+    }
+
+    std::shared_ptr<Model> model() { return m_model; }
+    Graph* graph() { return m_model->get_graph(); }
+
+protected:
+    NodeArg* add_arg(const std::string& name, const TensorShape& shape = TensorShape()) {
+        NodeArg* arg = graph()->get_nodearg(name);
+        return arg ? arg : graph()->get_or_create_nodearg(name, NodeArg(name, PrimitiveDataType::FLOAT32, shape));
+    }
+
+    void add_initializer(const std::string& name, const std::vector<int64_t>& dims, float seed) {
+        auto tensor = make_tensor(name, dims, seed);
+        add_arg(name, tensor->shape());
+        graph()->add_initializer(std::move(tensor));
+    }
+
+    void add_node(const std::string& type, const std::vector<std::string>& inputs, const std::string& output) {
+        std::vector<NodeArg*> input_args;
+        for (auto& name : inputs) {
+            input_args.emplace_back(add_arg(name));
+        }
+
+        auto node = std::make_unique<Node>(m_node_id++, *graph());
+        node->init(output, type, "", "", input_args, {add_arg(output)},
+                   std::unordered_map<std::string, std::unique_ptr<NodeAttribute>>());
+        graph()->add_node(std::move(node));
+    }
+
+private:
+    std::shared_ptr<Model> m_model;
+    int m_node_id{0};
+};
+
+/**
+ * @brief A multi-head model: embedding = Relu(X * W0), head1 = embedding * W1, head2 = embedding * W2.
+ * All of embedding, head1 and head2 are graph outputs.
+ */
+class MultiHeadModel : public ModelBuilder {
+public:
+    Status build(const TensorShape& input_shape = make_shape({4, 8})) {
+        add_arg("X", input_shape);
+        graph()->add_input_name("X");
+        add_initializer("W0", {8, 16}, 0.1f);
+        add_initializer("W1", {16, 4}, 0.2f);
+        add_initializer("W2", {16, 2}, 0.3f);
+
+        add_node("Gemm", {"X", "W0"}, "gemm0");
+        add_node("Relu", {"gemm0"}, "embedding");
+        add_node("Gemm", {"embedding", "W1"}, "head1");
+        add_node("Gemm", {"embedding", "W2"}, "head2");
+        graph()->add_output_name("embedding");
+        graph()->add_output_name("head1");
+        graph()->add_output_name("head2");
+
+        auto ret = graph()->initialize();
+        if (!ret.is_ok()) {
+            return ret;
+        }
+        return graph()->construct_topology();
+    }
+};
+
+/**
+ * @brief A wide model: `branches` branches of X -> Gemm(expand) -> Relu -> Gemm(reduce), summed by an Add chain.
+ * The expanded activations are large, so the peak depends on how many branches are in flight at once
+ */
+class MultiBranchModel : public ModelBuilder {
+public:
+    Status build(int branches) {
+        add_arg("X", make_shape({2, 8}));
+        graph()->add_input_name("X");
+
+        // the nodes are added layer by layer, which is the worst order for the memory
+        for (int i = 0; i < branches; ++i) {
+            add_initializer("We" + std::to_string(i), {8, 256}, 0.1f * i);
+            add_node("Gemm", {"X", "We" + std::to_string(i)}, "expand" + std::to_string(i));
+        }
+        for (int i = 0; i < branches; ++i) {
+            add_node("Relu", {"expand" + std::to_string(i)}, "relu" + std::to_string(i));
+        }
+        for (int i = 0; i < branches; ++i) {
+            add_initializer("Wr" + std::to_string(i), {256, 8}, 0.2f * i);
+            add_node("Gemm", {"relu" + std::to_string(i), "Wr" + std::to_string(i)}, "reduce" + std::to_string(i));
+        }
+
+        std::string sum = "reduce0";
+        for (int i = 1; i < branches; ++i) {
+            std::string output = i == branches - 1 ? "Y" : "sum" + std::to_string(i);
+            add_node("Add", {sum, "reduce" + std::to_string(i)}, output);
+            sum = output;
+        }
+        graph()->add_output_name("Y");
+
+        return graph()->initialize();
+    }
+};
+
+/**
+ * @brief Write the onnx model Y = Gemm(Relu(Gemm(X, W0)), W1), X: [4, 8]
+ */
+void write_onnx_gemm_model(const std::string& file_path) {
+    onnx::ModelProto model;
+    model.set_ir_version(7);
+    model.add_opset_import()->set_version(13);
+
+    auto* graph = model.mutable_graph();
+    auto add_value_info = [](onnx::ValueInfoProto* value_info, const std::string& name, std::vector<int64_t> dims) {
+        value_info->set_name(name);
+        auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+        for (auto dim : dims) {
+            tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+        }
+    };
+    add_value_info(graph->add_input(), "X", {4, 8});
+    add_value_info(graph->add_output(), "Y", {4, 4});
+
+    for (auto& item : std::vector<std::pair<std::string, std::vector<int64_t>>>{{"W0", {8, 16}}, {"W1", {16, 4}}}) {
+        auto tensor = make_tensor(item.first, item.second, 0.1f);
+        auto* initializer = graph->add_initializer();
+        initializer->set_name(item.first);
+        initializer->set_data_type(onnx::TensorProto_DataType_FLOAT);
+        for (auto dim : item.second) {
+            initializer->add_dims(dim);
+        }
+        initializer->set_raw_data(tensor->data_raw(), tensor->shape().element_num() * sizeof(float));
+    }
+
+    auto add_node = [graph](const std::string& type, std::vector<std::string> inputs, const std::string& output) {
+        auto* node = graph->add_node();
+        node->set_name(output);
+        node->set_op_type(type);
+        for (auto& input : inputs) {
+            node->add_input(input);
+        }
+        node->add_output(output);
+    };
+    add_node("Gemm", {"X", "W0"}, "gemm0");
+    add_node("Relu", {"gemm0"}, "relu0");
+    add_node("Gemm", {"relu0", "W1"}, "Y");
+
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    ofs << model.SerializeAsString();
+}
+
+size_t count_cache_entries(const std::string& cache_dir) {
+    size_t count = 0;
+    for (auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        count += entry.path().extension() == ".saim" ? 1 : 0;
+    }
+    return count;
+}
+
+}    // namespace
+
+TEST(RuntimeTest, RunAllOutputs) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    MultiHeadModel model;
+    auto status = model.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    Executor executor(*model.graph());
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+    TensorFetches fetches;
+    status = executor.run(RunOptions(), {{"X", input.get()}}, fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    ASSERT_EQ(fetches.size(), 3);
+    EXPECT_EQ(fetches["embedding"]->shape(), make_shape({4, 16}));
+    EXPECT_EQ(fetches["head1"]->shape(), make_shape({4, 4}));
+    EXPECT_EQ(fetches["head2"]->shape(), make_shape({4, 2}));
+}
+
+TEST(RuntimeTest, RunRequestedOutputs) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    MultiHeadModel model;
+    auto status = model.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    Executor executor(*model.graph());
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+
+    TensorFetches all_fetches;
+    status = executor.run(RunOptions(), {{"X", input.get()}}, all_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    // only the embedding cone runs
+    const std::vector<Node*>* nodes = nullptr;
+    status = executor.get_execution_nodes({"embedding"}, nodes);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(nodes->size(), 2);
+    EXPECT_EQ((*nodes)[0]->type(), "Gemm");
+    EXPECT_EQ((*nodes)[1]->type(), "Relu");
+
+    RunOptions run_options;
+    run_options.output_names = {"embedding"};
+    TensorFetches fetches;
+    status = executor.run(run_options, {{"X", input.get()}}, fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(fetches.size(), 1);
+    for (int64_t i = 0; i < fetches["embedding"]->shape().element_num(); ++i) {
+        EXPECT_FLOAT_EQ(fetches["embedding"]->data_as<float>()[i], all_fetches["embedding"]->data_as<float>()[i]);
+    }
+
+    // the cone is cached per output set, regardless of the order of the names
+    const std::vector<Node*>* cached_nodes = nullptr;
+    status = executor.get_execution_nodes({"embedding"}, cached_nodes);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(cached_nodes, nodes);
+
+    const std::vector<Node*>* head_nodes = nullptr;
+    status = executor.get_execution_nodes({"head2", "embedding"}, head_nodes);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(head_nodes->size(), 3);
+    status = executor.get_execution_nodes({"embedding", "head2"}, cached_nodes);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(cached_nodes, head_nodes);
+
+    // a repeated output is fetched once
+    run_options.output_names = {"head1", "embedding", "head1"};
+    fetches.clear();
+    status = executor.run(run_options, {{"X", input.get()}}, fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(fetches.size(), 2);
+    ASSERT_NE(fetches["head1"], nullptr);
+    for (int64_t i = 0; i < fetches["head1"]->shape().element_num(); ++i) {
+        EXPECT_FLOAT_EQ(fetches["head1"]->data_as<float>()[i], all_fetches["head1"]->data_as<float>()[i]);
+    }
+
+    // not a graph output
+    run_options.output_names = {"gemm0"};
+    status = executor.run(run_options, {{"X", input.get()}}, fetches);
+    EXPECT_FALSE(status.is_ok());
+}
+
+TEST(RuntimeTest, InvalidFeeds) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    MultiHeadModel model;
+    auto status = model.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    // the graph has no dynamic dims, the feeds are still checked before the kernels size their loops by them
+    Executor executor(*model.graph());
+    auto large = make_tensor("X", {64, 8}, 0.5f);
+    auto narrow = std::make_unique<Tensor>("X");
+    narrow->init(PrimitiveDataType::INT16, make_shape({4, 8}), cpu_allocator());
+    auto weight = make_tensor("W0", {8, 8}, 0.5f);
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+    TensorFetches fetches;
+    for (const TensorFeeds& feeds : {TensorFeeds{{"X", large.get()}}, TensorFeeds{{"X", narrow.get()}},
+                                     TensorFeeds{{"X", input.get()}, {"W0", weight.get()}}}) {
+        status = executor.run(RunOptions(), feeds, fetches);
+        EXPECT_EQ(status.code(), StatusCode::INVALID_PARAM) << status;
+    }
+
+    status = executor.run(RunOptions(), {{"X", input.get()}}, fetches);
+    EXPECT_TRUE(status.is_ok()) << status;
+}
+
+TEST(RuntimeTest, MemoryEfficientOrder) {
+    for (int branches : {4, 12}) {
+        MultiBranchModel default_model;
+        auto status = default_model.build(branches);
+        ASSERT_TRUE(status.is_ok()) << status;
+
+        InferenceSession default_session;
+        status = default_session.load(default_model.model());
+        ASSERT_TRUE(status.is_ok()) << status;
+
+        MultiBranchModel model;
+        status = model.build(branches);
+        ASSERT_TRUE(status.is_ok()) << status;
+
+        SessionOptions options;
+        options.execution_order = ExecutionOrder::MEMORY_EFFICIENT;
+        InferenceSession session(options);
+        status = session.load(model.model());
+        ASSERT_TRUE(status.is_ok()) << status;
+
+        // both sessions report both orders
+        const auto& report = session.memory_report();
+        EXPECT_EQ(report.default_peak_bytes, default_session.memory_report().default_peak_bytes);
+        EXPECT_EQ(report.memory_efficient_peak_bytes, default_session.memory_report().memory_efficient_peak_bytes);
+        EXPECT_LT(report.memory_efficient_peak_bytes, report.default_peak_bytes);
+
+        // at most one expanded and one activated branch are live at once
+        const size_t expanded_bytes = 2 * 256 * sizeof(float);
+        const size_t reduced_bytes = 2 * 8 * sizeof(float);
+        EXPECT_LE(report.memory_efficient_peak_bytes, 2 * expanded_bytes + 3 * reduced_bytes);
+
+        size_t peak_bytes = 0;
+        status = calc_peak_memory(*model.graph(), session.execution_order(), peak_bytes);
+        ASSERT_TRUE(status.is_ok()) << status;
+        EXPECT_EQ(peak_bytes, report.memory_efficient_peak_bytes);
+
+        auto input = make_tensor("X", {2, 8}, 0.5f);
+        TensorFetches default_fetches;
+        status = default_session.run(RunOptions(), {{"X", input.get()}}, default_fetches);
+        ASSERT_TRUE(status.is_ok()) << status;
+        TensorFetches fetches;
+        status = session.run(RunOptions(), {{"X", input.get()}}, fetches);
+        ASSERT_TRUE(status.is_ok()) << status;
+
+        for (int64_t i = 0; i < fetches["Y"]->shape().element_num(); ++i) {
+            EXPECT_NEAR(fetches["Y"]->data_as<float>()[i], default_fetches["Y"]->data_as<float>()[i], 1e-4f);
+        }
+    }
+}
+
+TEST(RuntimeTest, SessionOptimizationPipeline) {
+    NodeShapeManager::instance()->register_all_infer();
+    MultiHeadModel reference_model;
+    auto status = reference_model.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    SessionOptions reference_options;
+    reference_options.optimization_pipeline = optimizer::kNonePipeline;
+    InferenceSession reference(reference_options);
+    status = reference.load(reference_model.model());
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(reference.execution_order().size(), 4);
+
+    // Gemm -> Relu is fused, the embedding output is kept
+    MultiHeadModel model;
+    status = model.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    SessionOptions options;
+    options.optimization_pipeline = optimizer::kExtendedPipeline;
+    options.disabled_passes = {"ConstantFolding"};
+    InferenceSession session(options);
+    status = session.load(model.model());
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(session.execution_order().size(), 3);
+    EXPECT_EQ(session.optimization_report().passes.size(), 4);
+
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+    TensorFetches reference_fetches;
+    status = reference.run(RunOptions(), {{"X", input.get()}}, reference_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    TensorFetches fetches;
+    status = session.run(RunOptions(), {{"X", input.get()}}, fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    for (const auto& name : {"embedding", "head1", "head2"}) {
+        ASSERT_EQ(fetches[name]->shape(), reference_fetches[name]->shape());
+        for (int64_t i = 0; i < fetches[name]->shape().element_num(); ++i) {
+            EXPECT_NEAR(fetches[name]->data_as<float>()[i], reference_fetches[name]->data_as<float>()[i], 1e-4f);
+        }
+    }
+}
+
+TEST(RuntimeTest, DynamicInputShapes) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    TensorShape input_shape;
+    input_shape.add_symbolic_dim("batch");
+    input_shape.add_dim(8);
+    MultiHeadModel model;
+    auto status = model.build(input_shape);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(model.graph()->get_nodearg("head1")->shape().symbol(0), "batch");
+
+    Executor executor(*model.graph());
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+    TensorFetches fetches;
+    status = executor.run(RunOptions(), {{"X", input.get()}}, fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(fetches["embedding"]->shape(), make_shape({4, 16}));
+    EXPECT_EQ(fetches["head2"]->shape(), make_shape({4, 2}));
+    EXPECT_EQ(executor.shape_cache_stats().misses, 1);
+
+    // the same input shapes skip the binding
+    TensorFetches same_fetches;
+    status = executor.run(RunOptions(), {{"X", input.get()}}, same_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(executor.shape_cache_stats().misses, 1);
+
+    // a smaller batch, the rows are the leading rows of the first input
+    auto small_input = make_tensor("X", {3, 8}, 0.5f);
+    TensorFetches small_fetches;
+    status = executor.run(RunOptions(), {{"X", small_input.get()}}, small_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(executor.shape_cache_stats().misses, 2);
+    ASSERT_EQ(small_fetches["head1"]->shape(), make_shape({3, 4}));
+    for (int64_t i = 0; i < small_fetches["head1"]->shape().element_num(); ++i) {
+        EXPECT_NEAR(small_fetches["head1"]->data_as<float>()[i], fetches["head1"]->data_as<float>()[i], 1e-5f);
+    }
+
+    // the static dim does not match
+    auto invalid_input = make_tensor("X", {3, 9}, 0.5f);
+    TensorFetches invalid_fetches;
+    status = executor.run(RunOptions(), {{"X", invalid_input.get()}}, invalid_fetches);
+    EXPECT_FALSE(status.is_ok());
+    EXPECT_EQ(executor.shape_cache_stats().misses, 2);
+
+    // the session runs the optimized graph with the bound shapes
+    MultiHeadModel session_model;
+    status = session_model.build(input_shape);
+    ASSERT_TRUE(status.is_ok()) << status;
+    InferenceSession session;
+    status = session.load(session_model.model());
+    ASSERT_TRUE(status.is_ok()) << status;
+    TensorFetches session_fetches;
+    status = session.run(RunOptions(), {{"X", small_input.get()}}, session_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(session_fetches["head2"]->shape(), make_shape({3, 2}));
+    for (int64_t i = 0; i < session_fetches["head2"]->shape().element_num(); ++i) {
+        EXPECT_NEAR(session_fetches["head2"]->data_as<float>()[i], small_fetches["head2"]->data_as<float>()[i], 1e-4f);
+    }
+
+    // a static graph never binds
+    MultiHeadModel static_model;
+    status = static_model.build();
+    ASSERT_TRUE(status.is_ok()) << status;
+    Executor static_executor(*static_model.graph());
+    TensorFetches static_fetches;
+    status = static_executor.run(RunOptions(), {{"X", input.get()}}, static_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(static_executor.shape_cache_stats().misses, 0);
+}
+
+TEST(RuntimeTest, ShapeCache) {
+    NodeShapeManager::instance()->register_all_infer();
+
+    TensorShape input_shape;
+    input_shape.add_symbolic_dim("batch");
+    input_shape.add_dim(8);
+    MultiHeadModel model;
+    auto status = model.build(input_shape);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    auto run_batch = [](Executor& executor, int64_t batch) {
+        auto input = make_tensor("X", {batch, 8}, 0.5f);
+        TensorFetches fetches;
+        auto status = executor.run(RunOptions(), {{"X", input.get()}}, fetches);
+        ASSERT_TRUE(status.is_ok()) << status;
+        EXPECT_EQ(fetches["head1"]->shape(), make_shape({batch, 4}));
+    };
+
+    // the least recently used shapes are evicted
+    Executor executor(*model.graph(), model.graph()->get_topological_nodes(), 2);
+    for (int64_t batch : {1, 8, 1, 32, 1, 8}) {
+        run_batch(executor, batch);
+    }
+    auto stats = executor.shape_cache_stats();
+    EXPECT_EQ(stats.misses, 4);
+    EXPECT_EQ(stats.hits, 2);
+    EXPECT_EQ(stats.evictions, 2);
+
+    // the prewarmed shapes hit on their first runs
+    MultiHeadModel session_model;
+    status = session_model.build(input_shape);
+    ASSERT_TRUE(status.is_ok()) << status;
+    SessionOptions options;
+    options.shape_cache_capacity = 3;
+    options.prewarm_input_shapes = {{{"X", {1, 8}}}, {{"X", {8, 8}}}, {{"X", {32, 8}}}};
+    InferenceSession session(options);
+    status = session.load(session_model.model());
+    ASSERT_TRUE(status.is_ok()) << status;
+    EXPECT_EQ(session.shape_cache_stats().misses, 3);
+
+    for (int64_t batch : {32, 1, 8}) {
+        auto input = make_tensor("X", {batch, 8}, 0.5f);
+        TensorFetches fetches;
+        status = session.run(RunOptions(), {{"X", input.get()}}, fetches);
+        ASSERT_TRUE(status.is_ok()) << status;
+        EXPECT_EQ(fetches["head2"]->shape(), make_shape({batch, 2}));
+    }
+    stats = session.shape_cache_stats();
+    EXPECT_EQ(stats.misses, 3);
+    EXPECT_EQ(stats.hits, 3);
+    EXPECT_EQ(stats.evictions, 0);
+
+    // an invalid prewarmed shape fails the load
+    MultiHeadModel invalid_model;
+    status = invalid_model.build(input_shape);
+    ASSERT_TRUE(status.is_ok()) << status;
+    options.prewarm_input_shapes = {{{"X", {1, 9}}}};
+    InferenceSession invalid_session(options);
+    EXPECT_FALSE(invalid_session.load(invalid_model.model()).is_ok());
+}
+
+TEST(RuntimeTest, ModelCache) {
+    const std::string model_path = testing::TempDir() + "model_cache.onnx";
+    const std::string cache_dir = testing::TempDir() + "simple_ai_model_cache";
+    std::filesystem::remove_all(cache_dir);
+    write_onnx_gemm_model(model_path);
+
+    SessionOptions options;
+    options.optimization_pipeline = optimizer::kExtendedPipeline;
+    options.model_cache_dir = cache_dir;
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+    auto load_and_run = [&input, &model_path](const SessionOptions& options, bool from_cache,
+                                              TensorFetches& fetches) {
+        InferenceSession session(options);
+        auto status = session.load(model_path);
+        ASSERT_TRUE(status.is_ok()) << status;
+        EXPECT_EQ(session.loaded_from_cache(), from_cache);
+        // Gemm -> Relu is fused whether the graph is optimized or loaded
+        EXPECT_EQ(session.execution_order().size(), 2);
+        EXPECT_EQ(session.optimization_report().passes.empty(), from_cache);
+        // the cached order is not scheduled again
+        EXPECT_EQ(session.memory_report().default_peak_bytes == 0, from_cache);
+        status = session.run(RunOptions(), {{"X", input.get()}}, fetches);
+        ASSERT_TRUE(status.is_ok()) << status;
+    };
+
+    // the first session compiles the model and saves the entry, the second one loads it
+    TensorFetches compiled_fetches;
+    load_and_run(options, false, compiled_fetches);
+    EXPECT_EQ(count_cache_entries(cache_dir), 1);
+    TensorFetches cached_fetches;
+    load_and_run(options, true, cached_fetches);
+    ASSERT_EQ(cached_fetches["Y"]->shape(), compiled_fetches["Y"]->shape());
+    for (int64_t i = 0; i < cached_fetches["Y"]->shape().element_num(); ++i) {
+        EXPECT_FLOAT_EQ(cached_fetches["Y"]->data_as<float>()[i], compiled_fetches["Y"]->data_as<float>()[i]);
+    }
+
+    // a rewritten model file is hashed again, the same content finds the same entry
+    write_onnx_gemm_model(model_path);
+    TensorFetches fetches;
+    load_and_run(options, true, fetches);
+
+    // the options which change the compiled graph have their own entry
+    SessionOptions other_options = options;
+    other_options.execution_order = ExecutionOrder::MEMORY_EFFICIENT;
+    load_and_run(other_options, false, fetches);
+    EXPECT_EQ(count_cache_entries(cache_dir), 2);
+    other_options.shape_cache_capacity = 1;
+    load_and_run(other_options, true, fetches);
+
+    // an entry whose execution order runs a node before its producer is compiled again
+    std::vector<std::filesystem::path> entry_paths;
+    for (auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        if (entry.path().extension() == ".saim") {
+            entry_paths.emplace_back(entry.path());
+        }
+    }
+    for (auto& entry_path : entry_paths) {
+        std::shared_ptr<Model> model;
+        std::vector<Node*> execution_order;
+        auto status = io::NativeSerializer::load_from_file(entry_path.string(), model, execution_order);
+        ASSERT_TRUE(status.is_ok()) << status;
+        status = model->get_graph()->construct_topology();
+        ASSERT_TRUE(status.is_ok()) << status;
+        std::reverse(execution_order.begin(), execution_order.end());
+        // the loaded weights point into the entry, the broken one replaces it after it is written
+        const std::string broken_path = entry_path.string() + ".broken";
+        status = io::NativeSerializer::save_to_file(*model, execution_order, broken_path);
+        ASSERT_TRUE(status.is_ok()) << status;
+        std::filesystem::rename(broken_path, entry_path);
+    }
+    load_and_run(options, false, fetches);
+    load_and_run(options, true, fetches);
+
+    // a broken entry is compiled again
+    for (auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        if (entry.path().extension() == ".saim") {
+            std::filesystem::resize_file(entry.path(), 100);
+        }
+    }
+    load_and_run(options, false, fetches);
+    load_and_run(options, true, fetches);
+
+    std::filesystem::remove_all(cache_dir);
+    std::remove(model_path.c_str());
+}
+
+TEST(RuntimeTest, OnnxExport) {
+    NodeShapeManager::instance()->register_all_infer();
+    const std::string model_path = testing::TempDir() + "onnx_export.onnx";
+    const std::string optimized_path = testing::TempDir() + "onnx_export_optimized.onnx";
+    write_onnx_gemm_model(model_path);
+
+    // the optimized graph is exported, another session loads it without optimizing it again
+    std::shared_ptr<Model> model;
+    auto status = io::OnnxSerializer::load_from_file(model_path, model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    SessionOptions options;
+    options.optimization_pipeline = optimizer::kExtendedPipeline;
+    InferenceSession session(options);
+    status = session.load(model);
+    ASSERT_TRUE(status.is_ok()) << status;
+    status = io::OnnxSerializer::save_to_file(*model, optimized_path);
+    ASSERT_TRUE(status.is_ok()) << status;
+
+    SessionOptions optimized_options;
+    optimized_options.optimization_pipeline = optimizer::kNonePipeline;
+    InferenceSession optimized(optimized_options);
+    status = optimized.load(optimized_path);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(optimized.execution_order().size(), session.execution_order().size());
+    EXPECT_EQ(optimized.execution_order()[0]->type(), ir::kFusedGemmOpType);
+
+    auto input = make_tensor("X", {4, 8}, 0.5f);
+    TensorFetches fetches;
+    status = session.run(RunOptions(), {{"X", input.get()}}, fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    TensorFetches optimized_fetches;
+    status = optimized.run(RunOptions(), {{"X", input.get()}}, optimized_fetches);
+    ASSERT_TRUE(status.is_ok()) << status;
+    ASSERT_EQ(optimized_fetches["Y"]->shape(), fetches["Y"]->shape());
+    for (int64_t i = 0; i < fetches["Y"]->shape().element_num(); ++i) {
+        EXPECT_FLOAT_EQ(optimized_fetches["Y"]->data_as<float>()[i], fetches["Y"]->data_as<float>()[i]);
+    }
+
+    std::remove(model_path.c_str());
+    std::remove(optimized_path.c_str());
+}
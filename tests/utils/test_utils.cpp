@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <vector>
 
+#include "utils/thread_pool/simple_thread_pool.h"
 #include "utils/utils.h"
 
 TEST(UtilsTest, String) {
@@ -46,4 +50,38 @@ TEST(UtilsTest, Directory) {
 
     exist = file_exist("./abc/def/cat.txt");
     EXPECT_FALSE(exist);
-}
\ No newline at end of file
+}
+
+TEST(UtilsTest, ThreadPool) {
+    using namespace simple_ai::utils::thread_pool;
+
+    SimpleThreadPool thread_pool(4);
+    EXPECT_EQ(thread_pool.num_threads(), 4);
+    EXPECT_EQ(thread_pool.current_thead_index(), -1);
+
+    // every index runs once, on the pool threads or on the calling thread
+    std::vector<int> counts(1000, 0);
+    std::vector<int> thread_indices(counts.size(), -2);
+    parallel_for(&thread_pool, counts.size(), [&](size_t i) {
+        ++counts[i];
+        thread_indices[i] = thread_pool.current_thead_index();
+    });
+    EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), static_cast<long>(counts.size()));
+    for (int index : thread_indices) {
+        EXPECT_TRUE(index >= -1 && index < 4);
+    }
+
+    // a nullptr pool runs on the calling thread
+    std::vector<int> order;
+    parallel_for(nullptr, 5, [&order](size_t i) { order.push_back(static_cast<int>(i)); });
+    EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+
+    // the nested loops do not wait for a pool which is busy with their parents
+    std::vector<std::atomic<int>> sums(8);
+    parallel_for(&thread_pool, sums.size(), [&](size_t i) {
+        parallel_for(&thread_pool, 100, [&sums, i](size_t j) { sums[i] += static_cast<int>(j); });
+    });
+    for (auto& sum : sums) {
+        EXPECT_EQ(sum.load(), 4950);
+    }
+}